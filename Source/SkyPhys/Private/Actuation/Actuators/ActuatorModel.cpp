@@ -5,4 +5,66 @@
 
 UActuatorModel::UActuatorModel()
 {
-}
\ No newline at end of file
+}
+
+void UActuatorModel::InitialiseActuator()
+{
+	Actuator = SkyPhysCore::FActuatorModel(GetActuatorParameters());
+	Actuator.InitialiseActuator();
+	bActuatorInitialised = true;
+}
+
+SkyPhysCore::FActuatorParameters UActuatorModel::GetActuatorParameters() const
+{
+	SkyPhysCore::FActuatorParameters Parameters;
+	Parameters.RateLimit = RateLimit;
+	Parameters.UpperSaturation = UpperSaturation;
+	Parameters.LowerSaturation = LowerSaturation;
+	Parameters.InitialActuatorState = InitialActuatorState;
+	Parameters.IntegrationMethod = static_cast<SkyPhysCore::EFilterIntegrationMethod>(IntegrationMethod);
+	return Parameters;
+}
+
+float UActuatorModel::ApplyActuatorCommand(float Command, float DeltaTime)
+{
+	if (!bActuatorInitialised)
+	{
+		InitialiseActuator();
+	}
+
+	return Actuator.ApplyActuatorCommand(Command, DeltaTime);
+}
+
+float UActuatorModel::GetActuatorState() const
+{
+	return Actuator.GetActuatorState();
+}
+
+void UActuatorModel::SaveSnapshot(SkyPhysCore::FActuatorSnapshot& Snapshot) const
+{
+	if (bActuatorInitialised)
+	{
+		Actuator.SaveSnapshot(Snapshot);
+	}
+	else
+	{
+		// Not built yet (ie. no commands so far), so this is the state it will be built in.
+		SkyPhysCore::FActuatorModel(GetActuatorParameters()).SaveSnapshot(Snapshot);
+	}
+}
+
+void UActuatorModel::RestoreSnapshot(const SkyPhysCore::FActuatorSnapshot& Snapshot)
+{
+	if (!bActuatorInitialised)
+	{
+		InitialiseActuator();
+	}
+
+	Actuator.RestoreSnapshot(Snapshot);
+}
+
+float UActuatorModel::GetCharacteristicRate() const
+{
+	// The actuator isn't built until its first command, so fall back to the parameters it will be built from.
+	return bActuatorInitialised ? Actuator.GetCharacteristicRate() : SkyPhysCore::FActuatorModel(GetActuatorParameters()).GetCharacteristicRate();
+}
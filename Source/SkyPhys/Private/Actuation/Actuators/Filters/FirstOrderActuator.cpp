@@ -7,51 +7,18 @@ UFirstOrderActuator::UFirstOrderActuator()
 {
 }
 
-void UFirstOrderActuator::InitialiseActuator()
+SkyPhysCore::FActuatorParameters UFirstOrderActuator::GetActuatorParameters() const
 {
-	integrator = Integrator(InitialActuatorState);
-	ActuatorState = InitialActuatorState;
-	bActuatorInitialised = true;
-}
-
-float UFirstOrderActuator::ApplyActuatorCommand(float Command, float DeltaTime)
-{
-	// First order filter is modelled quite simply as:
+	// First order filter is modelled in SkyPhysCore::FActuatorModel as:
 	// -DC->(+)--->(wn/s)-------->
 	//		(-)              |
 	//		 ^               |
 	//		 |				 |
 	//		 -----------------
 
-	if (!bActuatorInitialised)
-	{
-		InitialiseActuator();
-	}
-
-	float Input = Command * DCGain;
-	float Feedback = integrator.X;
-	float IntegratorInput = wn * (Input - Feedback);
-	float IntegratorOutputExpected = integrator.Integrate(DeltaTime, IntegratorInput);
-	float IntegratorOutput = IntegratorOutputExpected;
-
-	if (RateLimit)
-	{
-		IntegratorOutput = FMath::FInterpConstantTo(Feedback, IntegratorOutputExpected, DeltaTime, RateLimit);
-	}
-	if (LowerSaturation)
-	{
-		IntegratorOutput = FMath::Clamp(IntegratorOutput, LowerSaturation, FLT_MAX);
-	}
-	if (UpperSaturation)
-	{
-		IntegratorOutput = FMath::Clamp(IntegratorOutput, -FLT_MAX, UpperSaturation);
-	}
-	ActuatorState = IntegratorOutput;
-
-	return ActuatorState;
-}
-
-float UFirstOrderActuator::GetActuatorState() const
-{
-	return ActuatorState;
+	SkyPhysCore::FActuatorParameters Parameters = Super::GetActuatorParameters();
+	Parameters.Type = SkyPhysCore::EActuatorModelType::FirstOrder;
+	Parameters.wn = wn;
+	Parameters.DCGain = DCGain;
+	return Parameters;
 }
@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Actuation/Propulsion/Propeller/BladeElementPropellerDataAsset.h"
+
+#include "Async/ParallelFor.h"
+#include "Misc/ScopeLock.h"
+
+std::shared_ptr<const SkyPhysCore::FPropellerPerformanceTable> UBladeElementPropellerDataAsset::GetPerformanceTable()
+{
+	FScopeLock Lock(&TableLock);
+
+	if (!PerformanceTable)
+	{
+		SkyPhysCore::FBladeElementTableResolution Resolution;
+		Resolution.NMin = NMin;
+		Resolution.NMax = NMax;
+		Resolution.NumN = NumN;
+		Resolution.JMax = JMax;
+		Resolution.NumJ = NumJ;
+		Resolution.NumInflowAngles = NumInflowAngles;
+
+		PerformanceTable = SkyPhysCore::BuildBladeElementPerformanceTable(GetGeometry(), Resolution, [](int Num, const std::function<void(int)>& Body)
+			{
+				ParallelFor(Num, [&Body](int32 Index) { Body(Index); });
+			});
+	}
+
+	return PerformanceTable;
+}
+
+void UBladeElementPropellerDataAsset::PostLoad()
+{
+	Super::PostLoad();
+
+	if (!HasAnyFlags(RF_ClassDefaultObject))
+	{
+		GetPerformanceTable();
+	}
+}
+
+SkyPhysCore::FBladeElementPropellerGeometry UBladeElementPropellerDataAsset::GetGeometry() const
+{
+	SkyPhysCore::FBladeElementPropellerGeometry Geometry;
+	Geometry.D = D;
+	Geometry.NumBlades = NumBlades;
+
+	Geometry.Stations.reserve(Stations.Num());
+	for (const FBladeStationParameters& StationIter : Stations)
+	{
+		SkyPhysCore::FBladeStation Station;
+		Station.r = StationIter.r;
+		Station.Chord = StationIter.Chord;
+		Station.Twist = FMath::DegreesToRadians(StationIter.Twist);
+		Geometry.Stations.push_back(Station);
+	}
+
+	Geometry.Airfoil.Alpha.reserve(AirfoilPolar.Num());
+	Geometry.Airfoil.CL.reserve(AirfoilPolar.Num());
+	Geometry.Airfoil.CD.reserve(AirfoilPolar.Num());
+	for (const FAirfoilPolarPoint& PointIter : AirfoilPolar)
+	{
+		Geometry.Airfoil.Alpha.push_back(FMath::DegreesToRadians(PointIter.Alpha));
+		Geometry.Airfoil.CL.push_back(PointIter.CL);
+		Geometry.Airfoil.CD.push_back(PointIter.CD);
+	}
+
+	return Geometry;
+}
+
+#if WITH_EDITOR
+void UBladeElementPropellerDataAsset::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// Rebuild the table on next use. Any components already using the old one keep it until they are initialized again.
+	FScopeLock Lock(&TableLock);
+	PerformanceTable.reset();
+}
+#endif
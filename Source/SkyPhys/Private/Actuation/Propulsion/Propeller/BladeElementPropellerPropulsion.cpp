@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Actuation/Propulsion/Propeller/BladeElementPropellerPropulsion.h"
+
+#include "Common/Utils/Helpers.h"
+#include "Actuation/Actuators/ActuatorModel.h"
+#include "Common/Utils/CoreConversions.h"
+
+UBladeElementPropellerPropulsionStaticMeshComponent::UBladeElementPropellerPropulsionStaticMeshComponent()
+{
+}
+
+void UBladeElementPropellerPropulsionStaticMeshComponent::ApplyActuatorCommand(float dtCmd, float DeltaTime)
+{
+	if (ActuatorModel)
+	{
+		PropellerModel.SetRotationalSpeed(RPMToRPS(ActuatorModel->ApplyActuatorCommand(dtCmd, DeltaTime)) * 2 * PI);
+	}
+	else
+	{
+		PropellerModel.SetRotationalSpeed(RPMToRPS(dtCmd * MaxN) * 2 * PI);
+	}
+}
+
+FForcesAndMoments UBladeElementPropellerPropulsionStaticMeshComponent::GetForcesAndMoments(float Rho, FVector Vb, FVector Omegab, FVector Vwb)
+{
+	// The model was built by InitializePropulsion at BeginPlay, as building the table here would stall the physics substeps of every vehicle.
+
+	// Get our current airspeed velocity (in m/s) and the system rotational velocity, in the propeller frame.
+	SkyPhysCore::FVector3 Vap = BodyGeometry.CalculateAirspeed(SkyPhysConversions::ToCore(Vb), SkyPhysConversions::ToCore(Omegab), SkyPhysConversions::ToCore(Vwb));
+	SkyPhysCore::FVector3 Omegap = BodyGeometry.BodyToPropulsor(SkyPhysConversions::ToCore(Omegab));
+
+	// Then get forces and moments in the propeller frame, AT THE PROPELLER, and rotate them into the body frame.
+	return SkyPhysConversions::FromCore(BodyGeometry.PropulsorToBody(PropellerModel.CalculateForcesAndMoments(Rho, Vap, Omegap)));
+}
+
+float UBladeElementPropellerPropulsionStaticMeshComponent::GetMotionState()
+{
+	return PropellerModel.GetMotionState();
+}
+
+void UBladeElementPropellerPropulsionStaticMeshComponent::InitializePropulsion()
+{
+	InitializePropellerPhysics();
+}
+
+void UBladeElementPropellerPropulsionStaticMeshComponent::InitializePropellerPhysics()
+{
+	if (!bPhysicsParametersInitialized)
+	{
+		// The table is built once per data asset (generally when it's loaded) and shared with every other propeller using the same data asset.
+		// Without a data asset the propeller has no thrust or torque.
+		std::shared_ptr<const SkyPhysCore::FPropellerPerformanceTable> Table;
+		SkyPhysCore::FBladeElementPropellerParameters Parameters;
+		Parameters.RotationDirection = (float)(int8)RotationDirection;
+		Parameters.Izz = Izz;
+		if (BladeElementPropellerData)
+		{
+			Parameters.D = BladeElementPropellerData->D;
+			Table = BladeElementPropellerData->GetPerformanceTable();
+		}
+
+		// Keep any rotational speed which has already been commanded.
+		const float omega = PropellerModel.GetMotionState();
+		PropellerModel = SkyPhysCore::FBladeElementPropellerModel(Parameters, MoveTemp(Table));
+		PropellerModel.SetRotationalSpeed(omega);
+
+		bPhysicsParametersInitialized = true;
+	}
+}
@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Actuation/Propulsion/Propeller/PropellerDataAsset.h"
+
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "SkyPhysCore/Actuation/PropellerDatabase.h"
+
+std::shared_ptr<const SkyPhysCore::FPropellerTable> UPropellerDataAsset::GetTable()
+{
+	FScopeLock Lock(&TableLock);
+
+	if (!Table && !Database.FilePath.IsEmpty())
+	{
+		// The table is used in place in the mapped database, which is only mapped once however many assets use it.
+		const FString DatabasePath = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir(), Database.FilePath);
+		if (std::shared_ptr<const SkyPhysCore::FPropellerDatabase> PropellerDatabase = SkyPhysCore::FPropellerDatabase::Open(TCHAR_TO_UTF8(*DatabasePath)))
+		{
+			Table = PropellerDatabase->FindTable(TCHAR_TO_UTF8(*DatabasePropellerName));
+		}
+	}
+
+	if (!Table)
+	{
+		Table = BuildTable(ConstantSpeedPropellerPhysicsParameters);
+	}
+
+	return Table;
+}
+
+std::shared_ptr<const SkyPhysCore::FPropellerTable> UPropellerDataAsset::BuildTable(const TArray<FConstantSpeedPropellerPhysicsParameters>& Data)
+{
+	std::vector<SkyPhysCore::FConstantSpeedPropellerData> ConstantSpeedData;
+	ConstantSpeedData.reserve(Data.Num());
+	for (const FConstantSpeedPropellerPhysicsParameters& ConstantSpeedParametersIter : Data)
+	{
+		SkyPhysCore::FConstantSpeedPropellerData ConstantSpeed;
+		ConstantSpeed.n = ConstantSpeedParametersIter.n;
+		ConstantSpeed.J.assign(ConstantSpeedParametersIter.J.GetData(), ConstantSpeedParametersIter.J.GetData() + ConstantSpeedParametersIter.J.Num());
+		ConstantSpeed.CT.assign(ConstantSpeedParametersIter.CT.GetData(), ConstantSpeedParametersIter.CT.GetData() + ConstantSpeedParametersIter.CT.Num());
+		ConstantSpeed.CP.assign(ConstantSpeedParametersIter.CP.GetData(), ConstantSpeedParametersIter.CP.GetData() + ConstantSpeedParametersIter.CP.Num());
+		ConstantSpeedData.push_back(MoveTemp(ConstantSpeed));
+	}
+
+	return std::make_shared<const SkyPhysCore::FPropellerTable>(ConstantSpeedData);
+}
+
+#if WITH_EDITOR
+void UPropellerDataAsset::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// Rebuild the table on next use. Any components already using the old one keep it until they are initialized again.
+	FScopeLock Lock(&TableLock);
+	Table.reset();
+}
+#endif
@@ -2,6 +2,8 @@
 
 #include "Actuation/Propulsion/Propulsion.h"
 
+#include "Common/Utils/CoreConversions.h"
+
 UPropulsionStaticMeshComponent::UPropulsionStaticMeshComponent()
 {
 }
@@ -11,6 +13,42 @@ void UPropulsionStaticMeshComponent::AssociateActuatorComponent(UActuatorModel*
 	ActuatorModel = pActuatorModel;
 }
 
+void UPropulsionStaticMeshComponent::UpdateBodyGeometry()
+{
+	AActor* Owner = GetOwner();
+	USceneComponent* Root = Owner ? Owner->GetRootComponent() : nullptr;
+	if (!Root)
+	{
+		return;
+	}
+
+	const FTransform RootT = Root->GetComponentTransform();
+	const FTransform PropulsorT = GetComponentTransform();
+
+	// Position relative to the root (ie. the CoG) in the unreal body frame, unaffected by any scaling (and in m).
+	FVector RelativePosition = RootT.GetRotation().UnrotateVector(PropulsorT.GetLocation() - RootT.GetLocation()) / 100.0f;
+
+	// Rotation from the propulsor frame to the unreal body frame
+	SkyPhysCore::FMatrix3 Rpu = SkyPhysConversions::ToCoreRotationMatrix(RootT.GetRotation().Inverse() * PropulsorT.GetRotation());
+
+	// Then flip from the unreal body frame to the body frame (around the Z axis).
+	// Note that the propulsor frame itself is not flipped, so this rotation may include a reflection, which is correct for both forces and moments.
+	BodyGeometry.Position = SkyPhysCore::FVector3(RelativePosition.X, RelativePosition.Y, -RelativePosition.Z);
+	BodyGeometry.Rotation = Rpu;
+	BodyGeometry.Rotation.row(2) = -Rpu.row(2);
+}
+
+void UPropulsionStaticMeshComponent::OnAttachmentChanged()
+{
+	Super::OnAttachmentChanged();
+
+	// Only once play has started, as the owner is responsible for the initial update in BeginPlay (once all components are in place).
+	if (HasBegunPlay())
+	{
+		UpdateBodyGeometry();
+	}
+}
+
 float UPropulsionStaticMeshComponent::RPMToRPS(float RPM)
 {
 	return RPM / 60.0f;
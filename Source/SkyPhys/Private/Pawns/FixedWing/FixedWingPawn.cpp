@@ -25,183 +25,79 @@ void AFixedWingPawn::UpdateActuatorState(float DeltaTime)
 	PropellerMesh->ApplyActuatorCommand(ActuatorCommandState.dt, DeltaTime);
 }
 
-// Calculate Motor Speed (expected Value of 0 -> 1)
-void AFixedWingPawn::ApplyThrustCommand(float Value)
-{
-	// First clamp to make sure we're in the range we expect and then apply
-	ActuatorCommandState.dt = 0.0f;// FMath::Clamp(Value, 0.0f, 1.0f);
-}
-
-// Calculate Forces and Moments for this Flight System Type
-FForcesAndMoments AFixedWingPawn::CalculateAirframeForcesAndMoments()
-{
-	// Update stall parameters prior to calling the update.
-	UpdateAerodynamicStallCalculationParameters();
-
-	return Super::CalculateAirframeForcesAndMoments();
-}
-
-// Augment the Aerodynamic Forces on the Fixed Wing Flight System
-float AFixedWingPawn::CalculateAdditionalCDParameters() const
+void AFixedWingPawn::ConfigureTrimModel(SkyPhysCore::FTrimModel& Model) const
 {
-	const float CDde = AerodynamicControlDerivatives.CD.CDde;
-
-	float de = ActuatorState.de;
+	Super::ConfigureTrimModel(Model);
 
-	float CD = CDde * de;
-
-	return CD;
+	const float MaxDeflection = FMath::DegreesToRadians(MaxTrimControlSurfaceDeflection);
+	Model.MaxElevator = MaxDeflection;
+	Model.MaxAileron = MaxDeflection;
+	Model.MaxRudder = MaxDeflection;
 }
 
-float AFixedWingPawn::CalculateAdditionalCLParameters() const
+void AFixedWingPawn::SaveControlSnapshot(FFlightControlSnapshot& Snapshot) const
 {
-	const float CLde = AerodynamicControlDerivatives.CL.CLde;
-
-	float de = ActuatorState.de;
-
-	float CL = CLde * de;
-
-	return CL;
+	Snapshot.Values[0] = ActuatorState.de;
+	Snapshot.Values[1] = ActuatorState.da;
+	Snapshot.Values[2] = ActuatorState.dr;
+	Snapshot.Values[3] = ActuatorCommandState.de;
+	Snapshot.Values[4] = ActuatorCommandState.da;
+	Snapshot.Values[5] = ActuatorCommandState.dr;
+	Snapshot.Values[6] = ActuatorCommandState.dt;
 }
 
-float AFixedWingPawn::CalculateAdditionalCYParameters() const
+void AFixedWingPawn::RestoreControlSnapshot(const FFlightControlSnapshot& Snapshot)
 {
-	const float CYda = AerodynamicControlDerivatives.CY.CYda;
-	const float CYdr = AerodynamicControlDerivatives.CY.CYdr;
-
-	float da = ActuatorState.da;
-	float dr = ActuatorState.dr;
-
-	float CY = CYda * da + CYdr * dr;
-
-	return CY;
-}
-
-// Augment the CLAlpha and CDAlpha values based on the stall model in place
-FVector2D AFixedWingPawn::CalculateAdjustedCDAlphaCLAlphaForStall(float CDAlpha, float CLAlpha) const
-{
-
-	// ************************ Calculate Stall Model ************************ //
-
-	if (AerodynamicStallParameters.bEnableStallModel)
-	{
-		// We make use of a flat plate stall model which blends between 0 stall and full stall (which occurs at the stall angle, Alpha0) using a transition rate, M.
-
-		float alpha = AirspeedState.alpha;
-
-		float SigmaAlpha = AerodynamicStallCalculationParameters.SigmaAlpha;
-
-		CLAlpha = (1 - SigmaAlpha) * CLAlpha + SigmaAlpha * 2 * FMath::Sign(alpha) * (pow(sin(alpha), 2.0f) * cos(alpha));
-		CDAlpha = (1 - SigmaAlpha) * CDAlpha + SigmaAlpha * 2 * FMath::Sign(alpha) * (pow(sin(alpha), 3.0f));
-	}
-
-	// *********************************************************************** //
-
-	return FVector2D(CDAlpha, CLAlpha);
-}
-
-// Augment the Aerodynamic Moments on the Fixed Wing Flight System
-float AFixedWingPawn::CalculateAdditionalClParameters() const
-{
-	const float CIda = AerodynamicControlDerivatives.CI.CIda;
-	const float CIdr = AerodynamicControlDerivatives.CI.CIdr;
-
-	float da = ActuatorState.da;
-	float dr = ActuatorState.dr;
-
-	float CI = CIda * da + CIdr * dr;
-
-	return CI;
+	ActuatorState.de = Snapshot.Values[0];
+	ActuatorState.da = Snapshot.Values[1];
+	ActuatorState.dr = Snapshot.Values[2];
+	ActuatorCommandState.de = Snapshot.Values[3];
+	ActuatorCommandState.da = Snapshot.Values[4];
+	ActuatorCommandState.dr = Snapshot.Values[5];
+	ActuatorCommandState.dt = Snapshot.Values[6];
 }
 
-float AFixedWingPawn::CalculateAdditionalCmParameters() const
-{
-	const float Cmde = AerodynamicControlDerivatives.Cm.Cmde;
-
-	float de = ActuatorState.de;
-
-	float Cm = Cmde * de;
-
-	return Cm;
-}
-
-float AFixedWingPawn::CalculateAdditionalCnParameters() const
+// Calculate Motor Speed (expected Value of 0 -> 1)
+void AFixedWingPawn::ApplyThrustCommand(float Value)
 {
-	const float Cnda = AerodynamicControlDerivatives.Cn.Cnda;
-	const float Cndr = AerodynamicControlDerivatives.Cn.Cndr;
-
-	float da = ActuatorState.da;
-	float dr = ActuatorState.dr;
-
-	float Cn = Cnda * da + Cndr * dr;
-
-	return Cn;
+	// First clamp to make sure we're in the range we expect and then apply
+	ActuatorCommandState.dt = 0.0f;// FMath::Clamp(Value, 0.0f, 1.0f);
 }
 
-// Adjust the CmAlpha value based on the stall model in place
-float AFixedWingPawn::CalculateAdjustedCmAlphaForStall(float CmAlpha) const
+// Add the Fixed Wing Control Derivatives and Stall Model to the Airframe Aerodynamics
+void AFixedWingPawn::ConfigureAirframeModel(SkyPhysCore::FAirframeModel& Model) const
 {
-
-	// ********************* Set Up Constant Parameters ********************** //
-
-	const float Cmfp = AerodynamicStallParameters.Cmfp;
-
-	// *********************************************************************** //
-
-	// ************************ Calculate Stall Model ************************ //
-
-	if (AerodynamicStallParameters.bEnableStallModel)
-	{
-		// We make use of a flat plate stall model which blends between 0 stall and full stall (which occurs at the stall angle, Alpha0) using a transition rate, M.
-
-		float alpha = AirspeedState.alpha;
-		float SigmaAlpha = AerodynamicStallCalculationParameters.SigmaAlpha;
-
-		CmAlpha = (1 - SigmaAlpha) * CmAlpha + SigmaAlpha * (Cmfp * FMath::Sign(alpha) * pow(sin(alpha), 2.0f));
-	}
-
-	// *********************************************************************** //
-
-	return CmAlpha;
+	Super::ConfigureAirframeModel(Model);
+
+	// Elevator, ailerons and rudder, unless a more specific configuration overrides this.
+	Model.Configuration = SkyPhysCore::EAirframeConfiguration::Standard;
+
+	// Control Derivatives
+	SkyPhysCore::FAerodynamicControlDerivatives& ControlDerivatives = Model.ControlDerivatives;
+
+	ControlDerivatives.CLde = AerodynamicControlDerivatives.CL.CLde;
+	ControlDerivatives.CDde = AerodynamicControlDerivatives.CD.CDde;
+	ControlDerivatives.CYda = AerodynamicControlDerivatives.CY.CYda;
+	ControlDerivatives.CYdr = AerodynamicControlDerivatives.CY.CYdr;
+	ControlDerivatives.CIda = AerodynamicControlDerivatives.CI.CIda;
+	ControlDerivatives.CIdr = AerodynamicControlDerivatives.CI.CIdr;
+	ControlDerivatives.Cmde = AerodynamicControlDerivatives.Cm.Cmde;
+	ControlDerivatives.Cnda = AerodynamicControlDerivatives.Cn.Cnda;
+	ControlDerivatives.Cndr = AerodynamicControlDerivatives.Cn.Cndr;
+
+	// Stall Model
+	// We make use of a flat plate stall model which blends between 0 stall and full stall (which occurs at the stall angle, Alpha0) using a transition rate, M.
+	Model.StallParameters.bEnableStallModel = AerodynamicStallParameters.bEnableStallModel;
+	Model.StallParameters.Alpha0 = AerodynamicStallParameters.Alpha0;
+	Model.StallParameters.M = AerodynamicStallParameters.M;
+	Model.StallParameters.Cmfp = AerodynamicStallParameters.Cmfp;
 }
 
-// Update commonly used parameters for stall calcs
-void AFixedWingPawn::UpdateAerodynamicStallCalculationParameters()
+SkyPhysCore::FControlSurfaceDeflections AFixedWingPawn::GetControlSurfaceDeflections() const
 {
-	// ********************* Set Up Constant Parameters ********************** //
-
-	const float M = AerodynamicStallParameters.M;
-	const float Alpha0 = AerodynamicStallParameters.Alpha0;
-
-	// *********************************************************************** //
-
-	// ************************ Calculate Stall Model ************************ //
-
-	float SigmaAlpha = 0.0f;
-	float alpha = AirspeedState.alpha;
-
-	if (AerodynamicStallParameters.bEnableStallModel)
-	{
-		// We make use of a flat plate stall model which blends between 0 stall and full stall (which occurs at the stall angle, Alpha0) using a transition rate, M and a sigmoid mixing function.
-		// The scaling parameter used is SigmaAlpha.
-
-		float Numerator = (1 + exp(-M * (alpha - Alpha0)) + exp(M * (alpha + Alpha0)));
-		float Denominator = ((1 + exp(-M * (alpha - Alpha0))) * (1 + exp(M * (alpha + Alpha0))));
-
-		// Clamp our numerator and denominator to be between 1 and FLT_MAX, to ensure that we don't get any strange numerical artifacts.
-		Numerator = FMath::Clamp(Numerator, 1.0f, FLT_MAX);
-		Denominator = FMath::Clamp(Denominator, 1.0f, FLT_MAX);
-
-		SigmaAlpha = Numerator / Denominator;
-
-		// If we still get a NaN SigmaAlpha, then just conservatively assume we are fully stalling.
-		if (FMath::IsNaN(SigmaAlpha))
-		{
-			SigmaAlpha = 1.0f;
-		}
-
-	}
-
-	AerodynamicStallCalculationParameters.SigmaAlpha = SigmaAlpha;
-
+	SkyPhysCore::FControlSurfaceDeflections Deflections;
+	Deflections.de = ActuatorState.de;
+	Deflections.da = ActuatorState.da;
+	Deflections.dr = ActuatorState.dr;
+	return Deflections;
 }
@@ -33,6 +33,14 @@ void AFlyingWingPawn::UpdateActuatorState(float DeltaTime)
 	UpdateActuatorAnimationState();
 }
 
+void AFlyingWingPawn::ConfigureAirframeModel(SkyPhysCore::FAirframeModel& Model) const
+{
+	Super::ConfigureAirframeModel(Model);
+
+	// Elevons only (no rudder), so the rudder control derivatives are never evaluated.
+	Model.Configuration = SkyPhysCore::EAirframeConfiguration::FlyingWing;
+}
+
 void AFlyingWingPawn::UpdateActuatorAnimationState()
 {
 	// Then grab the latest actuator states and associate this to the animation state (which will need to be in UE4 units).
@@ -42,6 +42,14 @@ void AVTailPawn::UpdateActuatorState(float DeltaTime)
 	UpdateAileronAngles(DeltaTime);
 }
 
+void AVTailPawn::ConfigureAirframeModel(SkyPhysCore::FAirframeModel& Model) const
+{
+	Super::ConfigureAirframeModel(Model);
+
+	// Ruddervators and ailerons.
+	Model.Configuration = SkyPhysCore::EAirframeConfiguration::VTail;
+}
+
 void AVTailPawn::UpdateActuatorAnimationState()
 {
 	// Grab the latest actuator states and associate this to the animation state (which will need to be in UE4 units) for the Ruddervator
@@ -3,18 +3,22 @@
 
 #include "Pawns/FlyingPawn.h"
 #include "DrawDebugHelpers.h"
-#include "Kismet/GameplayStatics.h"
+#include "Async/ParallelFor.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "Turbulence/TurbulenceModel.h"
 #include "Actuation/Propulsion/Propulsion.h"
-#include "UObject/Field.h"
+#include "Actuation/Actuators/ActuatorModel.h"
+#include "Simulation/FlightPhysicsSubsystem.h"
+#include "SkyPhys.h"
 
 #include "Common/Utils/Helpers.h"
+#include "Common/Utils/CoreConversions.h"
+#include "SkyPhysCore/Common/RandomStream.h"
 
 // Sets default values
 AFlyingPawn::AFlyingPawn()
 {
- 	// Set this pawn to call Tick() every frame. All pawns of this type have custom physics, so will need to tick.
+ 	// Set this pawn to call Tick() every frame. Our physics substeps are driven by the UFlightPhysicsSubsystem, but subclasses (and blueprints) may still want to tick.
 	PrimaryActorTick.bCanEverTick = true;
 	// Give us the ability to pause without ticking 
 	PrimaryActorTick.bTickEvenWhenPaused = false;
@@ -41,89 +45,195 @@ void AFlyingPawn::BeginPlay()
 	AirframeMesh->SetEnableGravity(true);
 	AirframeMesh->SetMassOverrideInKg(NAME_None, SystemCharacteristics.Mass, true); // Override the mass with the mass specified in system characteristics (this just forces things to be consistent, really).
 
-	// Find the UDS Weather Actor (if one has been added to the scene).
-	SetupWeather();
-
-	// Pre-calculate any characteristics that will be needed during play, but might be computationally intensive and shouldn't be re-done if not needed.
-	PreCalculateSystemCharacteristics();
+	// Build everything the substeps need (settings, and our mass properties and aerodynamics models) from the editor properties.
+	BuildSimBlock();
 
 	// Get all of our propulsors so that we can use them to generate forces and moments a bit later.
+	// Their position and orientation relative to the CoG doesn't change in flight, so capture it once now (they will update themselves if re-attached),
+	// and have them build their models now too, rather than on the physics substeps.
 	GetComponents(Propulsors);
+	for (UPropulsionStaticMeshComponent* Propulsor : Propulsors)
+	{
+		Propulsor->UpdateBodyGeometry();
+		Propulsor->InitializePropulsion();
+	}
+
+	// Our propellers are then evaluated together, rather than one virtual call at a time.
+	BuildRotorBank();
 
-	// Bind to the substep tick method.
-	CalculateCustomPhysics.BindUObject(this, &AFlyingPawn::SubstepTick);
+	// Adaptive substepping needs the actuators (as well as the propulsors) to bound the step size.
+	GetComponents(Actuators);
+
+	// Register with the flight physics subsystem, which will call our substep tick from now on.
+	PhysicsSubsystem = GetWorld()->GetSubsystem<UFlightPhysicsSubsystem>();
+	if (PhysicsSubsystem)
+	{
+		// Find the UDS Weather Actor (if one has been added to the scene).
+		PhysicsSubsystem->SetupWeather(WeatherSetup);
+		PhysicsSubsystem->RegisterVehicle(this);
+	}
 }
 
-void AFlyingPawn::SetupWeather()
+void AFlyingPawn::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-
-	// If the UDS Weather Class Type has been defined
-	if (WeatherSetup.UDSWeatherClassType)
+	if (PhysicsSubsystem)
 	{
-		// Then grab the UDS weather actor if it exists
-		TArray<AActor*> WeatherActors;
-		UGameplayStatics::GetAllActorsOfClass(GetWorld(), WeatherSetup.UDSWeatherClassType, WeatherActors);
-		if (WeatherActors.Num() > 0)
-		{
-			// Assume it will be the first returned class (as there should only be one...)
-			UDSWeatherActor = WeatherActors[0];
-		}
+		PhysicsSubsystem->UnregisterVehicle(this);
 	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+// Build the Simulation Block (ie. everything that should only be calculated once on game start, next to the state the substeps update)
+void AFlyingPawn::BuildSimBlock()
+{
+	SimBlock = FFlightSimBlock();
+
+	// Settings
+	SimBlock.IntegrationMethod = static_cast<SkyPhysCore::EIntegrationMethod>(IntegrationMethod);
+	SimBlock.bEnableAdaptiveSubstepping = bEnableAdaptiveSubstepping;
+	SimBlock.TurbulenceModel = bEnableTurbulenceModel ? TurbulenceModel : nullptr;
+
+	// Multi-rate scheduling
+	SimBlock.Scheduler.SetPeriod(SkyPhysCore::EScheduledModel::Turbulence, MultiRateParameters.TurbulencePeriod);
+	SimBlock.Scheduler.SetPeriod(SkyPhysCore::EScheduledModel::Actuators, MultiRateParameters.ActuatorPeriod);
+	SimBlock.Scheduler.SetPeriod(SkyPhysCore::EScheduledModel::Aerodynamics, MultiRateParameters.AerodynamicsPeriod);
+	SimBlock.bInterpolateTurbulence = MultiRateParameters.bInterpolateTurbulence;
+
+	// Mass properties, with our Inertia Tensor and Inverse pre-calculated.
+	SkyPhysCore::FMassProperties& MassProperties = SimBlock.RigidBodyModel.MassProperties;
+
+	MassProperties.Mass = SystemCharacteristics.Mass;
+	MassProperties.Ixx = SystemCharacteristics.Ixx;
+	MassProperties.Iyy = SystemCharacteristics.Iyy;
+	MassProperties.Izz = SystemCharacteristics.Izz;
+	MassProperties.Ixz = SystemCharacteristics.Ixz;
+	MassProperties.PreCalculate();
+
+	// Aerodynamics, and the kernel for its configuration and stall model.
+	ConfigureAirframeModel(SimBlock.AirframeModel);
+	SimBlock.AirframeKernel = SkyPhysCore::SelectAirframeKernel<float>(SimBlock.AirframeModel.Configuration, SimBlock.AirframeModel.StallParameters.bEnableStallModel);
+
+	// Adaptive substepping
+	SkyPhysCore::FAdaptiveStepParameters& StepParameters = SimBlock.StepController.Parameters;
+
+	StepParameters.MinStep = AdaptiveSubstepParameters.MinStep;
+	StepParameters.MaxStep = FMath::Max(AdaptiveSubstepParameters.MaxStep, AdaptiveSubstepParameters.MinStep);
+	StepParameters.Tolerance = AdaptiveSubstepParameters.Tolerance;
+	StepParameters.StabilityFactor = AdaptiveSubstepParameters.StabilityFactor;
+	SimBlock.StepController.Reset();
+	SimBlock.StepController.ResetStats();
 }
 
-// Precalculation of System Characteristics (ie. any parameters that should only be calculated once on game start)
-void AFlyingPawn::PreCalculateSystemCharacteristics()
+void AFlyingPawn::ConfigureAirframeModel(SkyPhysCore::FAirframeModel& Model) const
 {
-	// Our Tensors make use of the Eigen library.
-	using namespace Eigen;
-	// Pre-Calculate our Inertia Tensor and Inverse.
-	SystemCharacteristics.J << SystemCharacteristics.Ixx	, 0									, -SystemCharacteristics.Ixz,
-							   0							, SystemCharacteristics.Iyy			, 0,
-							   -SystemCharacteristics.Ixz	, 0									, SystemCharacteristics.Izz;
+	// No control surfaces by default, so the aerodynamics kernel drops the control derivative terms.
+	Model.Configuration = SkyPhysCore::EAirframeConfiguration::MultiRotor;
+
+	// Geometric Params
+	Model.Geometry.b = GeometricCharacteristics.b;
+	Model.Geometry.c = GeometricCharacteristics.c;
+	Model.Geometry.A = SkyPhysConversions::ToCore(GeometricCharacteristics.A);
 
-	SystemCharacteristics.JInverse = SystemCharacteristics.J.inverse();
+	// Aerodynamic Coefficients
+	SkyPhysCore::FAerodynamicCoefficients& Coefficients = Model.Coefficients;
+
+	// CL
+	Coefficients.CL.CL0 = AerodynamicCoefficients.CL.CL0;
+	Coefficients.CL.CLAlpha = AerodynamicCoefficients.CL.CLAlpha;
+	Coefficients.CL.CLq = AerodynamicCoefficients.CL.CLq;
+
+	// CD
+	Coefficients.CD.CD0 = AerodynamicCoefficients.CD.CD0;
+	Coefficients.CD.CDAlpha = AerodynamicCoefficients.CD.CDAlpha;
+	Coefficients.CD.CDAlpha2 = AerodynamicCoefficients.CD.CDAlpha2;
+	Coefficients.CD.CDq = AerodynamicCoefficients.CD.CDq;
+	Coefficients.CD.CDBeta = AerodynamicCoefficients.CD.CDBeta;
+	Coefficients.CD.CDBeta2 = AerodynamicCoefficients.CD.CDBeta2;
+
+	// CY
+	Coefficients.CY.CY0 = AerodynamicCoefficients.CY.CY0;
+	Coefficients.CY.CYBeta = AerodynamicCoefficients.CY.CYBeta;
+	Coefficients.CY.CYp = AerodynamicCoefficients.CY.CYp;
+	Coefficients.CY.CYr = AerodynamicCoefficients.CY.CYr;
+
+	// Cl
+	Coefficients.CI.CI0 = AerodynamicCoefficients.CI.CI0;
+	Coefficients.CI.CIBeta = AerodynamicCoefficients.CI.CIBeta;
+	Coefficients.CI.CIp = AerodynamicCoefficients.CI.CIp;
+	Coefficients.CI.CIr = AerodynamicCoefficients.CI.CIr;
+
+	// Cm
+	Coefficients.Cm.Cm0 = AerodynamicCoefficients.Cm.Cm0;
+	Coefficients.Cm.CmAlpha = AerodynamicCoefficients.Cm.CmAlpha;
+	Coefficients.Cm.Cmq = AerodynamicCoefficients.Cm.Cmq;
+
+	// Cn
+	Coefficients.Cn.Cn0 = AerodynamicCoefficients.Cn.Cn0;
+	Coefficients.Cn.CnBeta = AerodynamicCoefficients.Cn.CnBeta;
+	Coefficients.Cn.Cnp = AerodynamicCoefficients.Cn.Cnp;
+	Coefficients.Cn.Cnr = AerodynamicCoefficients.Cn.Cnr;
 }
 
-// Called every frame
-void AFlyingPawn::Tick(float DeltaTime)
+// Physics Substep Tick Implementation
+void AFlyingPawn::SubstepTick(float DeltaTime)
 {
-	Super::Tick(DeltaTime);
+	SubstepReadState();
+	SubstepCalculate(DeltaTime);
+	SubstepApply(DeltaTime);
+}
 
-	// Delegate our custom physics substep ticks to occur for every tick.
-	// We expect that our root component here is a mesh.
-	if (PhysicsBody) {
-		PhysicsBody->AddCustomPhysics(CalculateCustomPhysics);
+void AFlyingPawn::SubstepReadState()
+{
+	// In free flight we own the rigid body state, so there is nothing to read back from the physics body.
+	if (SimBlock.bInFreeFlight)
+	{
+		SetSystemState(SimBlock.FreeFlightState);
+		return;
 	}
 
+	// Update the current system state (ie. velocities etc.)
+	UpdateCurrentSystemState();
 }
 
-// Physics Substep Tick Implementation
-void AFlyingPawn::SubstepTick(float DeltaTime, FBodyInstance* BodyInstance)
+void AFlyingPawn::SubstepCalculate(float DeltaTime)
 {
 	// First update state (atmospheric and airspeed)
 	SubstepStateUpdate(DeltaTime);
 
-	// Get Forces and Moments in NEU
-	FForcesAndMoments AirframeForcesAndMoments = CalculateAirframeForcesAndMoments();
-	FForcesAndMoments PropulsionForcesAndMoments = CalculatePropulsionForcesAndMoments();
+	// Get Forces and Moments (in the body frame, at the CoG), or hold those of the last update if they aren't due
+	if (SimBlock.Scheduler.IsDue(SkyPhysCore::EScheduledModel::Aerodynamics))
+	{
+		FForcesAndMoments AirframeForcesAndMoments = CalculateAirframeForcesAndMoments();
+		FForcesAndMoments PropulsionForcesAndMoments = CalculatePropulsionForcesAndMoments();
+		SimBlock.HeldForcesAndMoments = AirframeForcesAndMoments + PropulsionForcesAndMoments;
+	}
 
-	FForcesAndMoments TotalForcesAndMoments = AirframeForcesAndMoments + PropulsionForcesAndMoments;
+	// Integrate these into velocity increments (which, for the higher order methods, evaluates the forces and moments again at intermediate stages)
+	CalculateKinematics(SimBlock.HeldForcesAndMoments, DeltaTime);
+}
 
-	// Apply Forces and Moments into Kinematics
-	ApplyKinematics(TotalForcesAndMoments.Forces, TotalForcesAndMoments.Moments, DeltaTime);
+void AFlyingPawn::SubstepApply(float DeltaTime)
+{
+	// Apply the velocity increments to the physics body
+	ApplyKinematics();
 }
 
 // Update System State during Substep
 void AFlyingPawn::SubstepStateUpdate(float DeltaTime)
 {
-	// First update the current system state (ie. velocities etc.)
-	UpdateCurrentSystemState();
-	// Then update our external atmospheric conditions (wind, turbulence etc.)
+	// Work out which of our models are due on this substep
+	SimBlock.Scheduler.Advance(DeltaTime);
+
+	// Update our external atmospheric conditions (wind, turbulence etc.)
 	UpdateAtmosphericConditionsState(DeltaTime);
 	// Now update our airspeed params based on the above
 	UpdateAirspeedState();
-	// FInally, update the current actuator states
-	UpdateActuatorState(DeltaTime);
+	// FInally, update the current actuator states (over all the time since they were last updated)
+	if (SimBlock.Scheduler.IsDue(SkyPhysCore::EScheduledModel::Actuators))
+	{
+		UpdateActuatorState(SimBlock.Scheduler.GetDeltaTime(SkyPhysCore::EScheduledModel::Actuators));
+	}
 }
 
 // Update the Current System State to be Used in Other Updates
@@ -136,15 +246,12 @@ void AFlyingPawn::UpdateCurrentSystemState()
 
 	FTransform WorldT = PhysicsBody->GetUnrealWorldTransform();
 
-	// Unreal to world frame
-	FRotator Ruw = WorldT.Rotator();
-
-	// Invert to get Rwu
-	FRotator Rwu = Ruw.GetInverse();
+	// Unreal to world frame (from the quaternion, so no trig required)
+	SkyPhysCore::FMatrix3 Ruw = SkyPhysConversions::ToCoreRotationMatrix(WorldT.GetRotation());
 
-	// Save these
-	SystemState.Ruw = Ruw;
-	SystemState.Rwu = Rwu;
+	// Fold in the flip from the body to the unreal frame (around the Z axis), so that we get the body to world DCM.
+	SimBlock.SystemState.Rbw = Ruw;
+	SimBlock.SystemState.Rbw.col(2) = -Ruw.col(2);
 
 	// Get Vb
 	FVector Vb = TransformFromWorldToBody(PhysicsBody->GetUnrealWorldVelocity() / 100);  // Scale to m/s (UE4 uses cm as default unit)
@@ -160,152 +267,141 @@ void AFlyingPawn::UpdateCurrentSystemState()
 	Position *= CmToM;
 
 	// Assign Outputs
-	SystemState.Vb = Vb;
-	SystemState.Omegab = Omegab;
-	SystemState.Position = Position;
+	SimBlock.SystemState.Vb = Vb;
+	SimBlock.SystemState.Omegab = Omegab;
+	SimBlock.SystemState.Position = Position;
 }
 
 // Update the Atmospheric Conditions to be used in this substep
 void AFlyingPawn::UpdateAtmosphericConditionsState(float DeltaTime)
 {
+	// The steady wind is sampled once per substep for all vehicles by the subsystem.
+	FVector Vw = PhysicsSubsystem ? PhysicsSubsystem->GetSteadyWind() : FVector(0.0f);
 
-	FVector Vw = FVector(0.0f);
+	// Check if there is an assigned turbulence model
+	FVector Vtw(0.0f);
 
-	// If we've defined a weather class, then grab the wind value from the weather to sync this.
-	if (UDSWeatherActor)
+	if (SimBlock.TurbulenceModel)
 	{
-		FFloatProperty* WindIntensityProperty = FindFProperty<FFloatProperty>(UDSWeatherActor->GetClass(), FName(*WeatherSetup.UDSWeatherWindIntensityPropertyName));
+		// If there is, and we have enabled turbulence, then calculate and add our turbulence.
 
-		// If we can pull the wind intensity, then get that from the class.
-		if (WindIntensityProperty)
+		// Turbulence is calculated in the body frame, over the time since it was last updated
+		if (SimBlock.Scheduler.IsDue(SkyPhysCore::EScheduledModel::Turbulence))
 		{
-			float WindIntensity = WindIntensityProperty->GetPropertyValue_InContainer(UDSWeatherActor) * WeatherSetup.UDSWindIntensityScalar;
-
-			// Initially assume that the direction is North (ie. 0 rad).
-			float WindDirectionRads = FMath::DegreesToRadians(0);
-
-			FFloatProperty* WindDirectionProperty = FindFProperty<FFloatProperty>(UDSWeatherActor->GetClass(), FName(*WeatherSetup.UDSWeatherWindDirectionPropertyName));
-			// But if our direction property exists, then use this instead.
-			if (WindDirectionProperty)
-			{
-				float WindDirectionDegs = WindDirectionProperty->GetPropertyValue_InContainer(UDSWeatherActor);
-				WindDirectionRads = FMath::DegreesToRadians(WindDirectionDegs);
-			}
-
-			// Use intensity and direction to get our wind vector
-			Vw.X = WindIntensity * cos(WindDirectionRads);
-			Vw.Y = WindIntensity * sin(WindDirectionRads);
-
-			// Ensure we remove any numerical errors we might have with this vector
-			Vw = SkyPhysHelpers::RemoveNumericalErrors(Vw);
-
+			SimBlock.PreviousTurbulence = SimBlock.LatestTurbulence;
+			SimBlock.LatestTurbulence = SimBlock.TurbulenceModel->GetTurbulenceBodyFrame(SimBlock.Scheduler.GetDeltaTime(SkyPhysCore::EScheduledModel::Turbulence), SimBlock.AirspeedState.Va, SimBlock.SystemState.Position.Z, SimBlock.AtmosphericConditionsState.VwLowAltitude.Size());
 		}
 
-	}
-
-	// Check if there is an assigned turbulence model
-	FVector Vtw(0.0f);
-
-	if (bEnableTurbulenceModel && TurbulenceModel)
-	{
-		// If there is, and we have enabled turbulence, then calculate and add our turbulence.
+		FVector Vtb = SimBlock.LatestTurbulence;
+		if (SimBlock.bInterpolateTurbulence)
+		{
+			Vtb = FMath::Lerp(SimBlock.PreviousTurbulence, SimBlock.LatestTurbulence, SimBlock.Scheduler.GetInterpolationAlpha(SkyPhysCore::EScheduledModel::Turbulence));
+		}
 
-		// Turbulence is calculated in the body frame
-		FVector Vtb = TurbulenceModel->GetTurbulenceBodyFrame(DeltaTime, AirspeedState.Va, SystemState.Position.Z, AtmosphericConditionsState.VwLowAltitude.Size());
 		// Convert to world frame before we add it to the global wind vector (which is also in the world frame)
 		Vtw = TransformFromBodyToWorld(Vtb);
 		// Ensure we remove any numerical errors we might have with this vector
 		Vtw = SkyPhysHelpers::RemoveNumericalErrors(Vtw);
 	}
 
-	AtmosphericConditionsState.rho = 1.225f; // Could use temperature from weather class, as well as altitude and atmospheric model to get density.
-	AtmosphericConditionsState.VwLowAltitude = Vw; // Our low altitude wind speed is our atmospheric wind value
-	AtmosphericConditionsState.Vw = Vw + Vtw; // Also set our world wind velocity to this, which we *might* augment with turbulence (if enabled etc.)
+	SimBlock.AtmosphericConditionsState.rho = PhysicsSubsystem ? PhysicsSubsystem->GetAirDensity() : 1.225f;
+	SimBlock.AtmosphericConditionsState.VwLowAltitude = Vw; // Our low altitude wind speed is our atmospheric wind value
+	SimBlock.AtmosphericConditionsState.Vw = Vw + Vtw; // Also set our world wind velocity to this, which we *might* augment with turbulence (if enabled etc.)
 }
 
 // Update the airspeed params to be used in this substep
 void AFlyingPawn::UpdateAirspeedState()
 {
 	// Get wind speed in the body frame
-	FVector Vwb = TransformFromWorldToBody(AtmosphericConditionsState.Vw);
-	// Then get the component velocity (in the body frame)
-	FVector Vb = SystemState.Vb;
-	// Now calculate the airspeed in the body frame
-	FVector Vab = Vb - Vwb;
-
-	// Just make sure our airspeed vector makes sense.
-	Vab = SkyPhysHelpers::RemoveNumericalErrors(Vab);
+	FVector Vwb = TransformFromWorldToBody(SimBlock.AtmosphericConditionsState.Vw);
 
-	// Now calculate our airspeed params
-	float Va = Vab.Size();
-	// Assume alpha and beta are 0 if Va is close to 0 (as they are then technically undefined).
-	float alpha = 0.0f;
-	float beta = 0.0f;
-	if (!FMath::IsNearlyZero(Va) && !FMath::IsNaN(Va))
-	{
-		// If Va is not nearly zero, then we can get an alpha and beta.
-		alpha = atan2(Vab.Z, Vab.X);
-		beta = asin(Vab.Y / Va);
-	}
-
-	// Now assign to outputs
-	AirspeedState.Vwb = Vwb;
-	AirspeedState.Vab = Vab;
-	AirspeedState.Va = Vab.Size();
-	AirspeedState.alpha = alpha;
-	AirspeedState.beta = beta;
+	// Then calculate our airspeed params from this and the component velocity (in the body frame)
+	SimBlock.AirspeedState = SkyPhysCore::CalculateAirspeedState(SkyPhysConversions::ToCore(SimBlock.SystemState.Vb), SkyPhysConversions::ToCore(Vwb));
 }
 
-// Apply Kinematics in the World Frame, with Forces and Moments in the Body Frame (NED)
-void AFlyingPawn::ApplyKinematics(FVector Forces, FVector Moments, float DeltaTime) {
-
-	// ************************* Linear Kinematics ************************* //
-
+// Calculate Kinematics in the World Frame, with Forces and Moments in the Body Frame (NED)
+void AFlyingPawn::CalculateKinematics(const FForcesAndMoments& ForcesAndMoments, float DeltaTime)
+{
 	// Scaling Factors
 	float MToCM = 100.0f;
 
-	// Calculate Linear Differential Velocity
+	// PhysX applies gravity itself, so it is excluded from our velocity increments, but the intermediate stages of the higher order methods still need it.
+	const SkyPhysCore::FVector3 Gravity(0.0f, 0.0f, -GetWorld()->GetGravityZ() / MToCM);
 
-	float mass = SystemCharacteristics.Mass;
+	if (SimBlock.bInFreeFlight)
+	{
+		// In free flight we own the state, so integrate it outright (including gravity, as PhysX isn't simulating the body).
+		if (SimBlock.bEnableAdaptiveSubstepping)
+		{
+			IntegrateAdaptive(SimBlock.FreeFlightState, ForcesAndMoments, Gravity, DeltaTime);
+		}
+		else
+		{
+			bool bInitialStage = true;
+			SimBlock.RigidBodyModel.Integrate(SimBlock.FreeFlightState, Gravity, DeltaTime, SimBlock.IntegrationMethod, [&](const SkyPhysCore::FRigidBodyState& Stage)
+				{
+					if (bInitialStage)
+					{
+						bInitialStage = false;
+						return SkyPhysConversions::ToCore(ForcesAndMoments);
+					}
+
+					return SkyPhysConversions::ToCore(CalculateStageForcesAndMoments(Stage));
+				});
+		}
 
-	// Rearrange F = m dV/dt to dV = dt*(F/m); and scale to cm/s.
-	FVector dVb = DeltaTime * MToCM * Forces / mass;  // Velocity differential, scaled to cm/s
+		return;
+	}
 
-	// Remove numerical errors like small accumulation errors, NaNs etc.
-	dVb = SkyPhysHelpers::RemoveNumericalErrors(dVb);
+	// Express our current state as a core rigid body state, which uses a NED world frame.
+	const SkyPhysCore::FRigidBodyState State = GetRigidBodyState();
 
-	// Apply Linear Differential Velocity in the world frame
-	PhysicsBody->SetLinearVelocity(TransformFromBodyToWorld(dVb), true);
+	// Calculate our Linear (world frame) and Angular (body frame) Differential Velocities
+	SkyPhysCore::FVector3 dVnCore;
+	SkyPhysCore::FVector3 dOmegabCore;
 
-	// ********************************************************************* //
+	if (SimBlock.bEnableAdaptiveSubstepping)
+	{
+		// Integrate a copy of our state in internal steps, and hand PhysX the overall velocity change (less gravity, which it applies itself).
+		SkyPhysCore::FRigidBodyState FinalState = State;
+		IntegrateAdaptive(FinalState, ForcesAndMoments, Gravity, DeltaTime);
 
-	// ************************* Angular Kinematics ************************ //
+		dVnCore = FinalState.Attitude * FinalState.Vb - State.Attitude * State.Vb - Gravity * DeltaTime;
+		dOmegabCore = FinalState.Omegab - State.Omegab;
+	}
+	else
+	{
+		bool bInitialStage = true;
+		SimBlock.RigidBodyModel.CalculateVelocityIncrements(State, Gravity, DeltaTime, SimBlock.IntegrationMethod, [&](const SkyPhysCore::FRigidBodyState& Stage)
+			{
+				// The first stage is our current state, for which we already have the forces and moments.
+				if (bInitialStage)
+				{
+					bInitialStage = false;
+					return SkyPhysConversions::ToCore(ForcesAndMoments);
+				}
+
+				return SkyPhysConversions::ToCore(CalculateStageForcesAndMoments(Stage));
+			}, dVnCore, dOmegabCore);
+	}
 
-	FVector dOmegab(0.0f);
+	// ************************* Linear Kinematics ************************* //
 
-	// The following block will require usage of the Eigen package to do some matrix stuff, so just context block this out of the main scope.
-	{
-		using namespace Eigen;
-		// Calculate Angular Differential Velocity
+	// Back to NEU, and scale to cm/s.
+	FVector dVw = FVector(dVnCore.x(), dVnCore.y(), -dVnCore.z()) * MToCM;
 
-		// Moments in the body frame
-		Vector3d momentsb(Moments.X, Moments.Y, Moments.Z);
-		// Angular velocity in the body frame
-		Vector3d omegab(SystemState.Omegab.X, SystemState.Omegab.Y, SystemState.Omegab.Z);
+	// Remove numerical errors like small accumulation errors, NaNs etc.
+	SimBlock.SubstepLinearVelocityIncrement = SkyPhysHelpers::RemoveNumericalErrors(dVw);
 
-		// dOmegab/dt = JInverse * (Moments - Omegab x ( J * Omegab ) -> with everything in the body frame
-		// dOmegab = JInverse * (Moments - Omegab x ( J * Omegab ) * dt
-		Vector3d domegab = (SystemCharacteristics.JInverse * (momentsb - omegab.cross(SystemCharacteristics.J * omegab))) * DeltaTime;
+	// ********************************************************************* //
 
-		// Convert to UE4 type
-		dOmegab = FVector(domegab(0), domegab(1), domegab(2));
-	}
+	// ************************* Angular Kinematics ************************ //
 
 	// Remove numerical errors like small accumulation errors, NaNs etc.
-	dOmegab = SkyPhysHelpers::RemoveNumericalErrors(dOmegab);
+	FVector dOmegab = SkyPhysHelpers::RemoveNumericalErrors(SkyPhysConversions::FromCore(dOmegabCore));
 
-	// Apply Angular Differential Velocity in the world frame
-	PhysicsBody->SetAngularVelocityInRadians(TransformFromBodyToWorld(-dOmegab), true); // Note: We have to take negative dOmegab due to how PhysicsBody has defined what positive rotation means (which is inconsistent with UE4 def... oh well)
+	// Angular Differential Velocity in the world frame
+	SimBlock.SubstepAngularVelocityIncrement = TransformFromBodyToWorld(-dOmegab); // Note: We have to take negative dOmegab due to how PhysicsBody has defined what positive rotation means (which is inconsistent with UE4 def... oh well)
 
 	// ********************************************************************* //
 
@@ -316,7 +412,7 @@ void AFlyingPawn::ApplyKinematics(FVector Forces, FVector Moments, float DeltaTi
 
 	//// Forces
 
-	//FVector BodyForces = (dVb * mass) / (DeltaTime * MToCM);
+	//FVector BodyForces = (dVb * SystemCharacteristics.Mass) / (DeltaTime * MToCM);
 	//
 	//// Draw Debug Arrows
 
@@ -337,228 +433,446 @@ void AFlyingPawn::ApplyKinematics(FVector Forces, FVector Moments, float DeltaTi
 	// ********************************************************************* //
 }
 
-// Calculate Forces and Moments for this Airframe
-FForcesAndMoments AFlyingPawn::CalculateAirframeForcesAndMoments()
+// Apply the Velocity Increments from CalculateKinematics (in the World Frame)
+void AFlyingPawn::ApplyKinematics()
+{
+	// In free flight the body is moved once per frame instead (see ApplyFreeFlightTransform).
+	if (SimBlock.bInFreeFlight)
+	{
+		return;
+	}
+
+	PhysicsBody->SetLinearVelocity(SimBlock.SubstepLinearVelocityIncrement, true);
+	PhysicsBody->SetAngularVelocityInRadians(SimBlock.SubstepAngularVelocityIncrement, true);
+}
+
+void AFlyingPawn::IntegrateAdaptive(SkyPhysCore::FRigidBodyState& State, const FForcesAndMoments& ForcesAndMoments, const SkyPhysCore::FVector3& Gravity, float DeltaTime)
 {
-	// First Update our Aerodynamic Calculation Parameters
-	UpdateAerodynamicCalculationParameters();
+	const SkyPhysCore::EIntegrationMethod Method = SimBlock.IntegrationMethod;
+	const float MaxCharacteristicRate = CalculateMaxCharacteristicRate();
+
+	// The forces and moments at the start of the substep were calculated by the caller, so only the later internal steps re-evaluate them.
+	bool bHaveStartForcesAndMoments = true;
+	float RemainingTime = DeltaTime;
 
-	// Then calculate forces and moments
-	FVector Forces = CalculateAirframeAerodynamicForces();
-	FVector Moments = CalculateAirframeAerodynamicMoments();
+	while (RemainingTime > SkyPhysCore::SmallNumber)
+	{
+		const float Step = SimBlock.StepController.CalculateNextStep(RemainingTime, MaxCharacteristicRate);
+		const SkyPhysCore::FVector3 StepStartOmegab = State.Omegab;
 
-	return FForcesAndMoments(Forces, Moments);
+		bool bInitialStage = true;
+		SkyPhysCore::FForcesAndMoments StepStartForcesAndMoments;
+		SimBlock.RigidBodyModel.Integrate(State, Gravity, Step, Method, [&](const SkyPhysCore::FRigidBodyState& Stage)
+			{
+				if (!bInitialStage)
+				{
+					return SkyPhysConversions::ToCore(CalculateStageForcesAndMoments(Stage));
+				}
+
+				bInitialStage = false;
+				StepStartForcesAndMoments = bHaveStartForcesAndMoments ? SkyPhysConversions::ToCore(ForcesAndMoments) : SkyPhysConversions::ToCore(CalculateStageForcesAndMoments(Stage));
+				bHaveStartForcesAndMoments = false;
+				return StepStartForcesAndMoments;
+			});
+
+		// Feed the accelerations at the start of this step into the error estimate (ie. the velocity increments over unit time).
+		SkyPhysCore::FVector3 LinearAcceleration;
+		SkyPhysCore::FVector3 AngularAcceleration;
+		SimBlock.RigidBodyModel.CalculateVelocityIncrements(StepStartOmegab, StepStartForcesAndMoments, 1.0f, LinearAcceleration, AngularAcceleration);
+		SimBlock.StepController.Update(LinearAcceleration, AngularAcceleration);
+
+		RemainingTime -= Step;
+	}
 }
 
-void AFlyingPawn::UpdateAerodynamicCalculationParameters() 
+float AFlyingPawn::CalculateMaxCharacteristicRate() const
 {
-	// Geometric Params
-	const float b = GeometricCharacteristics.b;
-	const float c = GeometricCharacteristics.c;
+	const SkyPhysCore::FMassProperties& MassProperties = SimBlock.RigidBodyModel.MassProperties;
 
-	// Airspeed Params
-	float Va = AirspeedState.Va;
+	float MaxRate = SkyPhysCore::CalculateAirframeCharacteristicRate(SimBlock.AirframeModel, MassProperties, SimBlock.AirspeedState.Va, SimBlock.AtmosphericConditionsState.rho);
 
-	// Atmospheric Conditions
-	float rho = AtmosphericConditionsState.rho;
+	for (const UActuatorModel* Actuator : Actuators)
+	{
+		MaxRate = FMath::Max(MaxRate, Actuator->GetCharacteristicRate());
+	}
 
-	// Calculated Params
-	float bOver2Va = 0.0f;
-	float cOver2Va = 0.0f;
+	for (const UPropulsionStaticMeshComponent* Propulsor : Propulsors)
+	{
+		MaxRate = FMath::Max(MaxRate, SkyPhysCore::CalculateGyroscopicCharacteristicRate(Propulsor->GetAngularMomentum(), MassProperties));
+	}
 
-	// If Va isn't 0, we update the above params to their actual values
-	if (!FMath::IsNearlyZero(Va))
+	if (SimBlock.TurbulenceModel)
 	{
-		bOver2Va = b / (2 * Va);
-		cOver2Va = c / (2 * Va);
+		MaxRate = FMath::Max(MaxRate, SimBlock.TurbulenceModel->GetCharacteristicRate(SimBlock.AirspeedState.Va, SimBlock.SystemState.Position.Z));
 	}
 
-	// Assign outputs
-	AerodynamicCalculationParameters.DynamicPressure = 0.5 * rho * pow(Va, 2.0f);
-	AerodynamicCalculationParameters.bOver2Va = bOver2Va;
-	AerodynamicCalculationParameters.cOver2Va = cOver2Va;
+	return MaxRate;
 }
 
-// Calculate the Aerodynamic Forces on the Airframe
-FVector AFlyingPawn::CalculateAirframeAerodynamicForces() const
+bool AFlyingPawn::SaveSnapshot(FFlightPawnSnapshot& Snapshot) const
 {
-	// ********************* Set Up Constant Parameters ********************** //
+	if (Actuators.Num() > FFlightPawnSnapshot::MaxActuators || Propulsors.Num() > FFlightPawnSnapshot::MaxPropulsors)
+	{
+		return false;
+	}
 
-	// Aerodynamic Coefficients
+	// Physics body (or, in free flight, our own rigid body state in the same form, so that the snapshot restores either way)
+	FTransform BodyTransform = PhysicsBody->GetUnrealWorldTransform();
+	FVector BodyLinearVelocity = PhysicsBody->GetUnrealWorldVelocity();
+	FVector BodyAngularVelocity = PhysicsBody->GetUnrealWorldAngularVelocityInRadians();
+	if (SimBlock.bInFreeFlight)
+	{
+		BodyTransform = GetBodyTransform(SimBlock.FreeFlightState);
+		GetBodyVelocities(SimBlock.FreeFlightState, BodyLinearVelocity, BodyAngularVelocity);
+	}
 
-	// CD
-	const float CD0 = AerodynamicCoefficients.CD.CD0;
-	const float CDAlpha = AerodynamicCoefficients.CD.CDAlpha;
-	const float CDAlpha2 = AerodynamicCoefficients.CD.CDAlpha2;
-	const float CDq = AerodynamicCoefficients.CD.CDq;
-	const float CDBeta = AerodynamicCoefficients.CD.CDBeta;
-	const float CDBeta2 = AerodynamicCoefficients.CD.CDBeta2;
+	const FQuat BodyRotation = BodyTransform.GetRotation();
+	Snapshot.BodyLocation = SkyPhysCore::ToSnapshot(SkyPhysConversions::ToCore(BodyTransform.GetTranslation()));
+	Snapshot.BodyRotation = SkyPhysCore::FSnapshotQuaternion{ BodyRotation.X, BodyRotation.Y, BodyRotation.Z, BodyRotation.W };
+	Snapshot.BodyLinearVelocity = SkyPhysCore::ToSnapshot(SkyPhysConversions::ToCore(BodyLinearVelocity));
+	Snapshot.BodyAngularVelocity = SkyPhysCore::ToSnapshot(SkyPhysConversions::ToCore(BodyAngularVelocity));
+
+	// Flight state
+	Snapshot.Vb = SkyPhysCore::ToSnapshot(SkyPhysConversions::ToCore(SimBlock.SystemState.Vb));
+	Snapshot.Omegab = SkyPhysCore::ToSnapshot(SkyPhysConversions::ToCore(SimBlock.SystemState.Omegab));
+	Snapshot.Position = SkyPhysCore::ToSnapshot(SkyPhysConversions::ToCore(SimBlock.SystemState.Position));
+	for (int32 i = 0; i < 9; i++)
+	{
+		Snapshot.Rbw[i] = SimBlock.SystemState.Rbw(i);
+	}
+	Snapshot.Vwb = SkyPhysCore::ToSnapshot(SimBlock.AirspeedState.Vwb);
+	Snapshot.Vab = SkyPhysCore::ToSnapshot(SimBlock.AirspeedState.Vab);
+	Snapshot.Va = SimBlock.AirspeedState.Va;
+	Snapshot.alpha = SimBlock.AirspeedState.alpha;
+	Snapshot.beta = SimBlock.AirspeedState.beta;
+	Snapshot.VwLowAltitude = SkyPhysCore::ToSnapshot(SkyPhysConversions::ToCore(SimBlock.AtmosphericConditionsState.VwLowAltitude));
+	Snapshot.Vw = SkyPhysCore::ToSnapshot(SkyPhysConversions::ToCore(SimBlock.AtmosphericConditionsState.Vw));
+	Snapshot.rho = SimBlock.AtmosphericConditionsState.rho;
+
+	// Actuators and propulsors
+	Snapshot.NumActuators = Actuators.Num();
+	for (int32 i = 0; i < Actuators.Num(); i++)
+	{
+		Actuators[i]->SaveSnapshot(Snapshot.Actuators[i]);
+	}
 
-	// CY
-	const float CY0 = AerodynamicCoefficients.CY.CY0;
-	const float CYBeta = AerodynamicCoefficients.CY.CYBeta;
-	const float CYp = AerodynamicCoefficients.CY.CYp;
-	const float CYr = AerodynamicCoefficients.CY.CYr;
+	Snapshot.NumPropulsors = Propulsors.Num();
+	for (int32 i = 0; i < Propulsors.Num(); i++)
+	{
+		Snapshot.PropulsorMotionStates[i] = Propulsors[i]->GetMotionState();
+	}
 
-	// CL
-	const float CL0 = AerodynamicCoefficients.CL.CL0;
-	const float CLAlpha = AerodynamicCoefficients.CL.CLAlpha;
-	const float CLq = AerodynamicCoefficients.CL.CLq;
+	if (SimBlock.TurbulenceModel)
+	{
+		SimBlock.TurbulenceModel->SaveSnapshot(Snapshot.Turbulence);
+	}
 
-	// *********************************************************************** //
+	SaveControlSnapshot(Snapshot.Control);
 
-	// ****************** Calculate Aerodynamic Coefficients ***************** //
+	SimBlock.Scheduler.SaveSnapshot(Snapshot.Scheduler);
+	Snapshot.PreviousTurbulence = SkyPhysCore::ToSnapshot(SkyPhysConversions::ToCore(SimBlock.PreviousTurbulence));
+	Snapshot.LatestTurbulence = SkyPhysCore::ToSnapshot(SkyPhysConversions::ToCore(SimBlock.LatestTurbulence));
+	Snapshot.HeldForces = SkyPhysCore::ToSnapshot(SkyPhysConversions::ToCore(SimBlock.HeldForcesAndMoments.Forces));
+	Snapshot.HeldMoments = SkyPhysCore::ToSnapshot(SkyPhysConversions::ToCore(SimBlock.HeldForcesAndMoments.Moments));
+
+	return true;
+}
+
+bool AFlyingPawn::RestoreSnapshot(const FFlightPawnSnapshot& Snapshot)
+{
+	if (Snapshot.NumActuators != Actuators.Num() || Snapshot.NumPropulsors != Propulsors.Num())
+	{
+		return false;
+	}
 
-	// Common Values
+	// The snapshot is restored into the physics body, so hand it back to PhysX (free flight picks up again from the next frame).
+	if (SimBlock.bInFreeFlight)
+	{
+		ExitFreeFlight();
+	}
 
-	// Velocity
-	float p = SystemState.Omegab.X;
-	float q = SystemState.Omegab.Y;
-	float r = SystemState.Omegab.Z;
+	// Physics body (teleported, so that nothing is swept between the current and restored positions)
+	const FQuat BodyRotation(Snapshot.BodyRotation.X, Snapshot.BodyRotation.Y, Snapshot.BodyRotation.Z, Snapshot.BodyRotation.W);
+	const FVector BodyLocation = SkyPhysConversions::FromCore(SkyPhysCore::FromSnapshot(Snapshot.BodyLocation));
+	PhysicsBody->SetBodyTransform(FTransform(BodyRotation, BodyLocation), ETeleportType::TeleportPhysics);
+	PhysicsBody->SetLinearVelocity(SkyPhysConversions::FromCore(SkyPhysCore::FromSnapshot(Snapshot.BodyLinearVelocity)), false);
+	PhysicsBody->SetAngularVelocityInRadians(SkyPhysConversions::FromCore(SkyPhysCore::FromSnapshot(Snapshot.BodyAngularVelocity)), false);
+
+	// Flight state
+	SimBlock.SystemState.Vb = SkyPhysConversions::FromCore(SkyPhysCore::FromSnapshot(Snapshot.Vb));
+	SimBlock.SystemState.Omegab = SkyPhysConversions::FromCore(SkyPhysCore::FromSnapshot(Snapshot.Omegab));
+	SimBlock.SystemState.Position = SkyPhysConversions::FromCore(SkyPhysCore::FromSnapshot(Snapshot.Position));
+	for (int32 i = 0; i < 9; i++)
+	{
+		SimBlock.SystemState.Rbw(i) = Snapshot.Rbw[i];
+	}
+	SimBlock.AirspeedState.Vwb = SkyPhysCore::FromSnapshot(Snapshot.Vwb);
+	SimBlock.AirspeedState.Vab = SkyPhysCore::FromSnapshot(Snapshot.Vab);
+	SimBlock.AirspeedState.Va = Snapshot.Va;
+	SimBlock.AirspeedState.alpha = Snapshot.alpha;
+	SimBlock.AirspeedState.beta = Snapshot.beta;
+	SimBlock.AtmosphericConditionsState.VwLowAltitude = SkyPhysConversions::FromCore(SkyPhysCore::FromSnapshot(Snapshot.VwLowAltitude));
+	SimBlock.AtmosphericConditionsState.Vw = SkyPhysConversions::FromCore(SkyPhysCore::FromSnapshot(Snapshot.Vw));
+	SimBlock.AtmosphericConditionsState.rho = Snapshot.rho;
+
+	// Actuators and propulsors
+	for (int32 i = 0; i < Actuators.Num(); i++)
+	{
+		Actuators[i]->RestoreSnapshot(Snapshot.Actuators[i]);
+	}
 
-	// Airspeed Params
-	float alpha = AirspeedState.alpha;
-	float beta = AirspeedState.beta;
+	for (int32 i = 0; i < Propulsors.Num(); i++)
+	{
+		Propulsors[i]->SetMotionState(Snapshot.PropulsorMotionStates[i]);
+	}
 
-	// Calculated Params
-	FVector AerodynamicMultiple = AerodynamicCalculationParameters.DynamicPressure * GeometricCharacteristics.A;
-	float bOver2Va = AerodynamicCalculationParameters.bOver2Va;
-	float cOver2Va = AerodynamicCalculationParameters.cOver2Va;
+	if (SimBlock.TurbulenceModel)
+	{
+		SimBlock.TurbulenceModel->RestoreSnapshot(Snapshot.Turbulence);
+	}
 
-	// We isolate our "alpha" parts of our coefficients as these will be impacted by our stall model (if enabled).
-	float CDALPHA = CD0 + CDAlpha * alpha + CDAlpha2 * pow(alpha, 2.0f);
-	float CLALPHA = CL0 + CLAlpha * alpha;
+	RestoreControlSnapshot(Snapshot.Control);
 
-	// Stall Model (if enabled) here.
+	SimBlock.Scheduler.RestoreSnapshot(Snapshot.Scheduler);
+	SimBlock.PreviousTurbulence = SkyPhysConversions::FromCore(SkyPhysCore::FromSnapshot(Snapshot.PreviousTurbulence));
+	SimBlock.LatestTurbulence = SkyPhysConversions::FromCore(SkyPhysCore::FromSnapshot(Snapshot.LatestTurbulence));
+	SimBlock.HeldForcesAndMoments = FForcesAndMoments(SkyPhysConversions::FromCore(SkyPhysCore::FromSnapshot(Snapshot.HeldForces)), SkyPhysConversions::FromCore(SkyPhysCore::FromSnapshot(Snapshot.HeldMoments)));
 
-	FVector2D CDALPHACLALPHA = CalculateAdjustedCDAlphaCLAlphaForStall(CDALPHA, CLALPHA);
+	// Any velocity increments still waiting to be applied belong to the old state, and the step error history doesn't carry over the jump.
+	SimBlock.SubstepLinearVelocityIncrement = FVector(0.0f);
+	SimBlock.SubstepAngularVelocityIncrement = FVector(0.0f);
+	SimBlock.StepController.Reset();
 
-	CDALPHA = CDALPHACLALPHA.X;
-	CLALPHA = CDALPHACLALPHA.Y;
+	return true;
+}
 
-	// Now add the rest of the coefficient impacts
-	float CDCalc = CDALPHA + CDq * cOver2Va * q + CDBeta * beta + CDBeta2 * pow(beta, 2.0f) + CalculateAdditionalCDParameters();
-	float CLCalc = CLALPHA + CLq * cOver2Va * q + CalculateAdditionalCLParameters();
+void AFlyingPawn::SetRandomSeed(uint64 Seed)
+{
+	if (SimBlock.TurbulenceModel)
+	{
+		SimBlock.TurbulenceModel->SetRandomSeed(SkyPhysCore::FRandomStream::DeriveSeed(Seed, 0));
+	}
+}
 
-	// Side force
-	float CY = CY0 + CYBeta * beta + CYp * bOver2Va * p + CYr * bOver2Va * r + CalculateAdditionalCYParameters();
+void AFlyingPawn::AddToStateHash(SkyPhysCore::FStateHash& Hash) const
+{
+	Hash.Add(SkyPhysConversions::ToCore(SimBlock.SystemState.Position));
+	Hash.Add(SkyPhysConversions::ToCore(SimBlock.SystemState.Vb));
+	Hash.Add(SkyPhysConversions::ToCore(SimBlock.SystemState.Omegab));
+	for (int i = 0; i < 9; i++)
+	{
+		Hash.Add(SimBlock.SystemState.Rbw(i));
+	}
+	Hash.Add(SkyPhysConversions::ToCore(SimBlock.AtmosphericConditionsState.Vw));
 
-	// We need to rotate our aerodynamic forces, which are in the wind frame, to the body frame. We do this with a rotation by alpha and beta.
-	FRotator Rwb(FMath::RadiansToDegrees(alpha), FMath::RadiansToDegrees(beta), 0.0f);
+	for (const UActuatorModel* Actuator : Actuators)
+	{
+		Actuator->AddToHash(Hash);
+	}
 
-	// *********************************************************************** //
+	for (UPropulsionStaticMeshComponent* Propulsor : Propulsors)
+	{
+		Hash.Add(Propulsor->GetMotionState());
+	}
 
-	// We know that CD and CL will be in the negative direction in the wind frame.
-	// Then rotate this into the body frame.
-	FVector Fxyz = Rwb.RotateVector(FVector(-CDCalc, CY, -CLCalc)) * AerodynamicMultiple;
+	if (SimBlock.TurbulenceModel)
+	{
+		SimBlock.TurbulenceModel->AddToHash(Hash);
+	}
 
-	return Fxyz;
+	// The outputs held between the updates of the slower models
+	if (SimBlock.Scheduler.IsMultiRate())
+	{
+		Hash.Add(SkyPhysConversions::ToCore(SimBlock.LatestTurbulence));
+		Hash.Add(SkyPhysConversions::ToCore(SimBlock.HeldForcesAndMoments.Forces));
+		Hash.Add(SkyPhysConversions::ToCore(SimBlock.HeldForcesAndMoments.Moments));
+	}
 }
 
-// Calculate the Aerodynamic Moments on the Airframe
-FVector AFlyingPawn::CalculateAirframeAerodynamicMoments() const
+bool AFlyingPawn::CreateTrimModel(SkyPhysCore::FTrimModel& Model) const
 {
-	// ********************* Set Up Constant Parameters ********************** //
-
-	// Geometric Params
-	const float b = GeometricCharacteristics.b;
-	const float c = GeometricCharacteristics.c;
-
-	// Aerodynamic Coefficients
+	Model = SkyPhysCore::FTrimModel();
+	Model.MassProperties = SimBlock.RigidBodyModel.MassProperties;
+	Model.AirframeModel = SimBlock.AirframeModel;
+	Model.Gravity = SkyPhysCore::FVector3(0.0f, 0.0f, -GetWorld()->GetGravityZ() / 100.0f); // cm/s^2 (Z up) to m/s^2 (Z down)
 
-	// Cl
-	const float CI0 = AerodynamicCoefficients.CI.CI0;
-	const float CIBeta = AerodynamicCoefficients.CI.CIBeta;
-	const float CIp = AerodynamicCoefficients.CI.CIp;
-	const float CIr = AerodynamicCoefficients.CI.CIr;
+	// Leaving a propulsor out would trim (and linearise) a different vehicle, so we don't build the model at all.
+	for (UPropulsionStaticMeshComponent* Propulsor : Propulsors)
+	{
+		SkyPhysCore::FTrimPropulsor TrimPropulsor;
+		if (!Propulsor->GetTrimPropulsor(TrimPropulsor))
+		{
+			UE_LOG(LogSkyPhys, Error, TEXT("%s can't be trimmed, as its propulsor %s (%s) isn't supported by the trim solver"),
+				*GetName(), *Propulsor->GetName(), *Propulsor->GetClass()->GetName());
+			return false;
+		}
+		Model.Propulsors.push_back(TrimPropulsor);
+	}
 
-	// Cm
-	const float Cm0 = AerodynamicCoefficients.Cm.Cm0;
-	const float CmAlpha = AerodynamicCoefficients.Cm.CmAlpha;
-	const float Cmq = AerodynamicCoefficients.Cm.Cmq;
+	ConfigureTrimModel(Model);
 
-	// Cn
-	const float Cn0 = AerodynamicCoefficients.Cn.Cn0;
-	const float CnBeta = AerodynamicCoefficients.Cn.CnBeta;
-	const float Cnp = AerodynamicCoefficients.Cn.Cnp;
-	const float Cnr = AerodynamicCoefficients.Cn.Cnr;
+	return true;
+}
 
-	// *********************************************************************** //
+TArray<FFlightTrimPoint> AFlyingPawn::TrimSweep(const TArray<FFlightTrimCondition>& Conditions) const
+{
+	SkyPhysCore::FTrimModel Model;
+	if (!CreateTrimModel(Model))
+	{
+		return TArray<FFlightTrimPoint>();
+	}
 
-	// ****************** Calculate Aerodynamic Coefficients ***************** //
+	std::vector<SkyPhysCore::FTrimCondition> CoreConditions;
+	CoreConditions.reserve(Conditions.Num());
+	for (const FFlightTrimCondition& Condition : Conditions)
+	{
+		SkyPhysCore::FTrimCondition CoreCondition;
+		CoreCondition.Airspeed = Condition.Airspeed;
+		CoreCondition.FlightPathAngle = FMath::DegreesToRadians(Condition.FlightPathAngle);
+		CoreCondition.Rho = Condition.AirDensity;
+		CoreConditions.push_back(CoreCondition);
+	}
 
-	// Common Values
+	const std::vector<SkyPhysCore::FTrimResult> Results = Model.TrimSweep(CoreConditions, SkyPhysCore::FTrimSettings(), [](int Num, const std::function<void(int)>& Body)
+		{
+			ParallelFor(Num, [&Body](int32 Index) { Body(Index); });
+		});
 
-	// Velocity
-	float p = SystemState.Omegab.X;
-	float q = SystemState.Omegab.Y;
-	float r = SystemState.Omegab.Z;
+	TArray<FFlightTrimPoint> TrimPoints;
+	TrimPoints.Reserve(Conditions.Num());
+	for (const SkyPhysCore::FTrimResult& Result : Results)
+	{
+		const SkyPhysCore::FLinearModel& LinearModel = Result.LinearModel;
+
+		FFlightTrimPoint& TrimPoint = TrimPoints.AddDefaulted_GetRef();
+		TrimPoint.bConverged = Result.bConverged;
+		TrimPoint.Residual = Result.Residual;
+		TrimPoint.Alpha = FMath::RadiansToDegrees(Result.alpha);
+		TrimPoint.Beta = FMath::RadiansToDegrees(Result.beta);
+		TrimPoint.Pitch = FMath::RadiansToDegrees(LinearModel.X0(SkyPhysCore::FLinearModel::Theta));
+		TrimPoint.Elevator = FMath::RadiansToDegrees(Result.Deflections.de);
+		TrimPoint.Aileron = FMath::RadiansToDegrees(Result.Deflections.da);
+		TrimPoint.Rudder = FMath::RadiansToDegrees(Result.Deflections.dr);
+		TrimPoint.PropulsorSpeeds.Append(Result.PropulsorSpeeds.data(), static_cast<int32>(Result.PropulsorSpeeds.size()));
+
+		TrimPoint.NumStates = static_cast<int32>(LinearModel.A.rows());
+		TrimPoint.NumInputs = static_cast<int32>(LinearModel.B.cols());
+		TrimPoint.A.Reserve(static_cast<int32>(LinearModel.A.size()));
+		TrimPoint.B.Reserve(static_cast<int32>(LinearModel.B.size()));
+		for (int32 Row = 0; Row < TrimPoint.NumStates; Row++)
+		{
+			for (int32 Column = 0; Column < TrimPoint.NumStates; Column++)
+			{
+				TrimPoint.A.Add(LinearModel.A(Row, Column));
+			}
+			for (int32 Column = 0; Column < TrimPoint.NumInputs; Column++)
+			{
+				TrimPoint.B.Add(LinearModel.B(Row, Column));
+			}
+		}
+	}
 
-	// Airspeed Params
-	float alpha = AirspeedState.alpha;
-	float beta = AirspeedState.beta;
+	return TrimPoints;
+}
 
-	// Calculated Params
-	FVector AerodynamicMultiple = AerodynamicCalculationParameters.DynamicPressure * GeometricCharacteristics.A;
-	float bOver2Va = AerodynamicCalculationParameters.bOver2Va;
-	float cOver2Va = AerodynamicCalculationParameters.cOver2Va;
+FFlightAdaptiveStepStats AFlyingPawn::GetAdaptiveStepStats() const
+{
+	const SkyPhysCore::FAdaptiveStepStats& CoreStats = SimBlock.StepController.GetStats();
+
+	FFlightAdaptiveStepStats Stats;
+	Stats.NumSteps = CoreStats.NumSteps;
+	Stats.NumStiffnessLimitedSteps = CoreStats.NumStiffnessLimitedSteps;
+	Stats.SimulatedTime = CoreStats.SimulatedTime;
+	Stats.MinStepTaken = CoreStats.MinStepTaken;
+	Stats.MaxStepTaken = CoreStats.MaxStepTaken;
+	Stats.MeanStep = CoreStats.GetMeanStep();
+	Stats.LastErrorEstimate = CoreStats.LastErrorEstimate;
+	return Stats;
+}
 
-	// Calculate
+FForcesAndMoments AFlyingPawn::CalculateStageForcesAndMoments(const SkyPhysCore::FRigidBodyState& Stage)
+{
+	if (!SimBlock.Scheduler.IsDue(SkyPhysCore::EScheduledModel::Aerodynamics))
+	{
+		return SimBlock.HeldForcesAndMoments;
+	}
 
-	float CmALPHA = Cm0 + CmAlpha * alpha;
+	// We temporarily swap the stage into our state, so that the usual (and possibly overridden) force calculations are used as they are.
+	// The actuators, wind and density are all held from the start of the substep.
+	const FSystemState SubstepSystemState = SimBlock.SystemState;
+	const SkyPhysCore::FAirspeedState SubstepAirspeedState = SimBlock.AirspeedState;
 
-	// Flat plate stall for pitching moment
-	CmALPHA = CalculateAdjustedCmAlphaForStall(CmALPHA);
+	SimBlock.SystemState.Vb = SkyPhysConversions::FromCore(Stage.Vb);
+	SimBlock.SystemState.Omegab = SkyPhysConversions::FromCore(Stage.Omegab);
 
-	float CI = CI0 + CIBeta * beta + CIp * bOver2Va * p + CIr * bOver2Va * r + CalculateAdditionalClParameters();
-	float Cm = CmALPHA + Cmq * cOver2Va * q + CalculateAdditionalCmParameters();
-	float Cn = Cn0 + CnBeta * beta + Cnp * bOver2Va * p + Cnr * bOver2Va * r + CalculateAdditionalCnParameters();
+	// Body to NED, flipped back to body to NEU
+	SimBlock.SystemState.Rbw = Stage.Attitude.toRotationMatrix();
+	SimBlock.SystemState.Rbw.row(2) = -SimBlock.SystemState.Rbw.row(2);
 
-	// *********************************************************************** //
+	UpdateAirspeedState();
 
-	FVector Mxyz(CI * b, Cm * c, Cn * b);
+	FForcesAndMoments StageForcesAndMoments = CalculateAirframeForcesAndMoments() + CalculatePropulsionForcesAndMoments();
 
-	Mxyz *= AerodynamicMultiple;
+	SimBlock.SystemState = SubstepSystemState;
+	SimBlock.AirspeedState = SubstepAirspeedState;
 
-	return Mxyz;
+	return StageForcesAndMoments;
 }
 
-FForcesAndMoments AFlyingPawn::CalculatePropulsionForcesAndMoments()
+// Calculate Forces and Moments for this Airframe
+FForcesAndMoments AFlyingPawn::CalculateAirframeForcesAndMoments()
 {
-	// Note that our propulsors are only updated every primary tick, so this will only be an approximation. It should be quite close, but it's quite difficult in UE4 to simulate physics on 
-	// subcomponents whilst still getting constraints etc. to work as intended.
+	// The kernel for our configuration was selected at BeginPlay (this is the same as SimBlock.AirframeModel.CalculateForcesAndMoments).
+	const SkyPhysCore::FForcesAndMoments ForcesAndMoments = SimBlock.AirframeKernel(SimBlock.AirframeModel, SimBlock.AirspeedState, SkyPhysConversions::ToCore(SimBlock.SystemState.Omegab), SimBlock.AtmosphericConditionsState.rho, GetControlSurfaceDeflections());
 
-	FForcesAndMoments CumulativePropulsorForcesAndMomentsAtCG;
+	return SkyPhysConversions::FromCore(ForcesAndMoments);
+}
 
-	float Rho = AtmosphericConditionsState.rho;
-	FVector Vw = AtmosphericConditionsState.Vw;
-	FVector SystemOmega = TransformFromBodyToWorld(SystemState.Omegab);
+void AFlyingPawn::BuildRotorBank()
+{
+	SimBlock.RotorPropellers.Reset();
+	SimBlock.RotorGeometries.Reset();
+	UnbankedPropulsors.Reset();
 
-	for (UPropulsionStaticMeshComponent* Propulsor : Propulsors) 
+	for (UPropulsionStaticMeshComponent* Propulsor : Propulsors)
 	{
-		// First, get all the forces and moments at the origin of the propulsor (in the world frame).
-		FForcesAndMoments PropulsorForcesAndMoments = Propulsor->GetForcesAndMoments(Rho, Vw, SystemOmega);
+		if (const SkyPhysCore::FPropellerModel* PropellerModel = Propulsor->GetPropellerModel())
+		{
+			SimBlock.RotorPropellers.Add(PropellerModel);
+			SimBlock.RotorGeometries.Add(&Propulsor->GetBodyGeometry());
+		}
+		else
+		{
+			UnbankedPropulsors.Add(Propulsor);
+		}
+	}
 
-		// Then we need to calculate the moments due to the propulsor forces acting at a distance to our CG.
+	SimBlock.RotorBank.Resize(SimBlock.RotorPropellers.Num());
+}
 
-		// So first get the relative location
-		// Note that we are only using the locations updated in the primary tick for this, so don't use the physics body.
-		FVector CGLocation = RootComponent->GetComponentLocation();
-		FVector PropulsorLocation = Propulsor->GetComponentLocation(); //Propulsor->GetBodyInstance()->GetUnrealWorldTransform().GetLocation();
+FForcesAndMoments AFlyingPawn::CalculatePropulsionForcesAndMoments()
+{
+	// Everything here is done in the body frame, using the propulsor geometry cached at BeginPlay, so no component transforms are needed.
 
-		// Divide by 100 to get to m from cm (because when we do moment calc next, we expect SI units).
-		// We take the negative of this (which differs from the standard moment cross product direction), because the unreal world frame uses a LHR convention (instead of the standard RHR).
-		FVector r = -(PropulsorLocation - CGLocation)/100.0f;
+	float Rho = SimBlock.AtmosphericConditionsState.rho;
+	FVector Vwb = SkyPhysConversions::FromCore(SimBlock.AirspeedState.Vwb);
 
-		// Then calculate the moments due to these forces using the cross product (r x F)
-		FVector AdditionalMoments = FVector::CrossProduct(r, PropulsorForcesAndMoments.Forces);
+	// All our propellers are evaluated together in one vectorised pass (at their current rotational speeds and geometry), already summed at our CG.
+	for (int32 i = 0; i < SimBlock.RotorPropellers.Num(); i++)
+	{
+		SimBlock.RotorBank.SetRotor(i, *SimBlock.RotorPropellers[i], *SimBlock.RotorGeometries[i]);
+	}
+	FForcesAndMoments CumulativePropulsorForcesAndMomentsAtCG = SkyPhysConversions::FromCore(SimBlock.RotorBank.CalculateForcesAndMoments(
+		Rho, SkyPhysConversions::ToCore(SimBlock.SystemState.Vb), SkyPhysConversions::ToCore(SimBlock.SystemState.Omegab), SimBlock.AirspeedState.Vwb));
 
-		// Finally add these in to the PropulsorForcesAndMoments.
-		PropulsorForcesAndMoments.Moments += AdditionalMoments;
+	// Then any other propulsors, one at a time.
+	for (UPropulsionStaticMeshComponent* Propulsor : UnbankedPropulsors) 
+	{
+		// First, get all the forces and moments at the origin of the propulsor (in the body frame).
+		FForcesAndMoments PropulsorForcesAndMoments = Propulsor->GetForcesAndMoments(Rho, SimBlock.SystemState.Vb, SimBlock.SystemState.Omegab, Vwb);
 
-		// Now we need to convert from the world to the body frame
-		PropulsorForcesAndMoments.Forces = TransformFromWorldToBody(PropulsorForcesAndMoments.Forces);
-		PropulsorForcesAndMoments.Moments = TransformFromWorldToBody(PropulsorForcesAndMoments.Moments);
+		// Then add the moments due to the propulsor forces acting at a distance to our CG (r x F, with r from the cached geometry, in m).
+		PropulsorForcesAndMoments.Moments += SkyPhysConversions::FromCore(Propulsor->GetBodyGeometry().CalculateMomentAboutCoG(SkyPhysConversions::ToCore(PropulsorForcesAndMoments.Forces)));
 
 		// And now we can add all of these forces and moments to our cumulative sum.
 		CumulativePropulsorForcesAndMomentsAtCG += PropulsorForcesAndMoments;
@@ -567,18 +881,137 @@ FForcesAndMoments AFlyingPawn::CalculatePropulsionForcesAndMoments()
 	return CumulativePropulsorForcesAndMomentsAtCG;
 }
 
+void AFlyingPawn::UpdateFreeFlight(float DeltaTime)
+{
+	const bool bWantFreeFlight = bEnableNativeFreeFlight && !IsNearGeometry(DeltaTime);
+
+	if (bWantFreeFlight && !SimBlock.bInFreeFlight)
+	{
+		EnterFreeFlight();
+	}
+	else if (!bWantFreeFlight && SimBlock.bInFreeFlight)
+	{
+		ExitFreeFlight();
+	}
+}
+
+void AFlyingPawn::EnterFreeFlight()
+{
+	// Take over from the physics body where it is now, and then stop PhysX simulating it.
+	UpdateCurrentSystemState();
+	SimBlock.FreeFlightState = GetRigidBodyState();
+
+	AirframeMesh->SetSimulatePhysics(false);
+
+	SimBlock.SubstepLinearVelocityIncrement = FVector(0.0f);
+	SimBlock.SubstepAngularVelocityIncrement = FVector(0.0f);
+	SimBlock.bInFreeFlight = true;
+}
+
+void AFlyingPawn::ExitFreeFlight()
+{
+	SimBlock.bInFreeFlight = false;
+
+	// Hand our state back to PhysX, with the body where we have it and moving as we have it.
+	FVector LinearVelocity;
+	FVector AngularVelocity;
+	GetBodyVelocities(SimBlock.FreeFlightState, LinearVelocity, AngularVelocity);
+
+	AirframeMesh->SetWorldTransform(GetBodyTransform(SimBlock.FreeFlightState), false, nullptr, ETeleportType::TeleportPhysics);
+	AirframeMesh->SetSimulatePhysics(true);
+	PhysicsBody->SetLinearVelocity(LinearVelocity, false);
+	PhysicsBody->SetAngularVelocityInRadians(AngularVelocity, false);
+}
+
+void AFlyingPawn::ApplyFreeFlightTransform()
+{
+	if (!SimBlock.bInFreeFlight)
+	{
+		return;
+	}
+
+	// The body is kinematic, so this moves it to our state over the next physics step (pushing anything in its way), rather than teleporting it.
+	AirframeMesh->SetWorldTransform(GetBodyTransform(SimBlock.FreeFlightState), false, nullptr, ETeleportType::None);
+}
+
+bool AFlyingPawn::IsNearGeometry(float DeltaTime) const
+{
+	FVector LinearVelocity = PhysicsBody->GetUnrealWorldVelocity();
+	if (SimBlock.bInFreeFlight)
+	{
+		FVector AngularVelocity;
+		GetBodyVelocities(SimBlock.FreeFlightState, LinearVelocity, AngularVelocity);
+	}
+
+	// A single sphere overlap against the scene, which the broadphase rejects cheaply when the sky around us is empty.
+	const FBoxSphereBounds& Bounds = AirframeMesh->Bounds;
+	const float Radius = Bounds.SphereRadius + FreeFlightClearance + 2.0f * LinearVelocity.Size() * DeltaTime;
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(SkyPhysFreeFlight), false, this);
+	FCollisionResponseParams ResponseParams;
+	AirframeMesh->InitSweepCollisionParams(QueryParams, ResponseParams);
+
+	return GetWorld()->OverlapAnyTestByChannel(Bounds.Origin, FQuat::Identity, AirframeMesh->GetCollisionObjectType(), FCollisionShape::MakeSphere(Radius), QueryParams, ResponseParams);
+}
+
+SkyPhysCore::FRigidBodyState AFlyingPawn::GetRigidBodyState() const
+{
+	// Flipping the Z axis of the world frame takes Rbw (to NEU) to the body to NED rotation.
+	SkyPhysCore::FMatrix3 Rbn = SimBlock.SystemState.Rbw;
+	Rbn.row(2) = -SimBlock.SystemState.Rbw.row(2);
+
+	SkyPhysCore::FRigidBodyState State;
+	State.Position = SkyPhysCore::FVector3(SimBlock.SystemState.Position.X, SimBlock.SystemState.Position.Y, -SimBlock.SystemState.Position.Z);
+	State.Attitude = SkyPhysCore::FQuaternion(Rbn);
+	State.Vb = SkyPhysConversions::ToCore(SimBlock.SystemState.Vb);
+	State.Omegab = SkyPhysConversions::ToCore(SimBlock.SystemState.Omegab);
+	return State;
+}
+
+void AFlyingPawn::SetSystemState(const SkyPhysCore::FRigidBodyState& State)
+{
+	// Body to NED, flipped back to body to NEU
+	SimBlock.SystemState.Rbw = State.Attitude.toRotationMatrix();
+	SimBlock.SystemState.Rbw.row(2) = -SimBlock.SystemState.Rbw.row(2);
+
+	SimBlock.SystemState.Vb = SkyPhysConversions::FromCore(State.Vb);
+	SimBlock.SystemState.Omegab = SkyPhysConversions::FromCore(State.Omegab);
+	SimBlock.SystemState.Position = FVector(State.Position.x(), State.Position.y(), -State.Position.z());
+}
+
+FTransform AFlyingPawn::GetBodyTransform(const SkyPhysCore::FRigidBodyState& State) const
+{
+	const float MToCM = 100.0f;
+
+	// Body to NEU (as per SetSystemState), and then the flip from the body to the unreal frame, which gives the unreal to world rotation.
+	SkyPhysCore::FMatrix3 Ruw = State.Attitude.toRotationMatrix();
+	Ruw.row(2) = -Ruw.row(2);
+	Ruw.col(2) = -Ruw.col(2);
+
+	return FTransform(SkyPhysConversions::FromCoreRotationMatrix(Ruw), FVector(State.Position.x(), State.Position.y(), -State.Position.z()) * MToCM);
+}
+
+void AFlyingPawn::GetBodyVelocities(const SkyPhysCore::FRigidBodyState& State, FVector& LinearVelocity, FVector& AngularVelocity) const
+{
+	const float MToCM = 100.0f;
+
+	// NED to NEU, in cm/s
+	const SkyPhysCore::FVector3 Vn = State.Attitude * State.Vb;
+	LinearVelocity = FVector(Vn.x(), Vn.y(), -Vn.z()) * MToCM;
+
+	// The physics body uses the opposite definition of positive rotation (see UpdateCurrentSystemState).
+	const SkyPhysCore::FVector3 Omegan = State.Attitude * State.Omegab;
+	AngularVelocity = -FVector(Omegan.x(), Omegan.y(), -Omegan.z());
+}
+
 FVector AFlyingPawn::TransformFromWorldToBody(FVector WorldVector)
 {
-	// To get from the world to the body, we first go from world to unreal
-	FVector UnrealFrame = SystemState.Rwu.RotateVector(WorldVector);
-	// And then from unreal to body (by just flipping around the Z axis)
-	return FVector(UnrealFrame.X, UnrealFrame.Y, -UnrealFrame.Z);
+	// Our body to world DCM already includes the flip between the unreal and body frames, so we just need its transpose.
+	return SkyPhysConversions::FromCore(SimBlock.SystemState.Rbw.transpose() * SkyPhysConversions::ToCore(WorldVector));
 }
 
 FVector AFlyingPawn::TransformFromBodyToWorld(FVector BodyVector)
 {
-	// To get from the body frame to the world frame, we first flip around the body vector so that it's in the unreal frame
-	FVector UnrealFrame(BodyVector.X, BodyVector.Y, -BodyVector.Z);
-	// Then we rotate from unreal to world
-	return SystemState.Ruw.RotateVector(UnrealFrame);
+	// Our body to world DCM already includes the flip between the body and unreal frames.
+	return SkyPhysConversions::FromCore(SimBlock.SystemState.Rbw * SkyPhysConversions::ToCore(BodyVector));
 }
\ No newline at end of file
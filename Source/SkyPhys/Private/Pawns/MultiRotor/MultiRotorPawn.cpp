@@ -12,6 +12,22 @@ void AMultiRotorPawn::UpdateActuatorState(float DeltaTime)
 	Super::UpdateActuatorState(DeltaTime);
 }
 
+void AMultiRotorPawn::SaveControlSnapshot(FFlightControlSnapshot& Snapshot) const
+{
+	Snapshot.Values[0] = MultiRotorCommandState.PitchCommand;
+	Snapshot.Values[1] = MultiRotorCommandState.RollCommand;
+	Snapshot.Values[2] = MultiRotorCommandState.YawCommand;
+	Snapshot.Values[3] = MultiRotorCommandState.ThrustCommand;
+}
+
+void AMultiRotorPawn::RestoreControlSnapshot(const FFlightControlSnapshot& Snapshot)
+{
+	MultiRotorCommandState.PitchCommand = Snapshot.Values[0];
+	MultiRotorCommandState.RollCommand = Snapshot.Values[1];
+	MultiRotorCommandState.YawCommand = Snapshot.Values[2];
+	MultiRotorCommandState.ThrustCommand = Snapshot.Values[3];
+}
+
 void AMultiRotorPawn::ApplyPitchCommand(float Value)
 {
 	Super::ApplyPitchCommand(Value);
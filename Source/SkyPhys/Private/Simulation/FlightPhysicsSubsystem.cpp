@@ -0,0 +1,510 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Simulation/FlightPhysicsSubsystem.h"
+
+#include "Async/ParallelFor.h"
+#include "Engine/GameViewportClient.h"
+#include "EngineUtils.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/App.h"
+#include "Misc/Crc.h"
+#include "PhysicsEngine/PhysicsSettings.h"
+#include "Algo/BinarySearch.h"
+#include "SkyPhysCore/Common/RandomStream.h"
+#include "UObject/Field.h"
+
+#include "Common/Utils/Helpers.h"
+#include "Common/Utils/CoreConversions.h"
+
+DECLARE_CYCLE_STAT(TEXT("Flight Physics Substep"), STAT_FlightPhysicsSubstep, STATGROUP_SkyPhys);
+
+static TAutoConsoleVariable<int32> CVarSkyPhysParallelSubstep(
+	TEXT("skyphys.ParallelSubstep"),
+	1,
+	TEXT("Whether to calculate the flight physics of independent vehicles in parallel during each substep.\n")
+	TEXT("Results are identical either way, as each vehicle only writes to its own state and all physics engine reads/writes happen serially in a fixed order.\n")
+	TEXT("0: Serial, 1: Parallel (default)"),
+	ECVF_Default);
+
+void UFlightPhysicsSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	CalculateCustomPhysics.BindUObject(this, &UFlightPhysicsSubsystem::Substep);
+	PreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &UFlightPhysicsSubsystem::OnWorldPreActorTick);
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UFlightPhysicsSubsystem::OnWorldPostActorTick);
+}
+
+void UFlightPhysicsSubsystem::Deinitialize()
+{
+	if (bInLockstep)
+	{
+		EndLockstep();
+	}
+
+	if (bDeterministic)
+	{
+		EndDeterministic();
+	}
+
+	FWorldDelegates::OnWorldPreActorTick.Remove(PreActorTickHandle);
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	CalculateCustomPhysics.Unbind();
+	Vehicles.Empty();
+
+	Super::Deinitialize();
+}
+
+void UFlightPhysicsSubsystem::RegisterVehicle(AFlyingPawn* Vehicle)
+{
+	if (!Vehicle || Vehicles.Contains(Vehicle))
+	{
+		return;
+	}
+
+	if (bDeterministic)
+	{
+		// Keep the vehicles in name order, so the stepping order doesn't depend on the order they happened to be spawned in.
+		const int32 Index = Algo::LowerBoundBy(Vehicles, Vehicle->GetName(), [](const AFlyingPawn* Other) { return Other ? Other->GetName() : FString(); });
+		Vehicles.Insert(Vehicle, Index);
+		SeedDeterministicVehicle(Vehicle);
+	}
+	else
+	{
+		Vehicles.Add(Vehicle);
+	}
+}
+
+void UFlightPhysicsSubsystem::UnregisterVehicle(AFlyingPawn* Vehicle)
+{
+	// Remove (rather than RemoveSwap) so that the remaining vehicles keep their stepping order.
+	Vehicles.Remove(Vehicle);
+}
+
+void UFlightPhysicsSubsystem::SetupWeather(const FWeatherSetup& InWeatherSetup)
+{
+	// If we already have a weather actor, or the UDS Weather Class Type hasn't been defined, then there is nothing to do.
+	if (UDSWeatherActor || !InWeatherSetup.UDSWeatherClassType)
+	{
+		return;
+	}
+
+	// Grab the UDS weather actor if it exists
+	TArray<AActor*> WeatherActors;
+	UGameplayStatics::GetAllActorsOfClass(GetWorld(), InWeatherSetup.UDSWeatherClassType, WeatherActors);
+	if (WeatherActors.Num() > 0)
+	{
+		// Assume it will be the first returned class (as there should only be one...)
+		UDSWeatherActor = WeatherActors[0];
+		WeatherSetup = InWeatherSetup;
+
+		// Find the properties we need once, so that we don't need to search for these every substep.
+		WindIntensityProperty = FindFProperty<FFloatProperty>(UDSWeatherActor->GetClass(), FName(*WeatherSetup.UDSWeatherWindIntensityPropertyName));
+		WindDirectionProperty = FindFProperty<FFloatProperty>(UDSWeatherActor->GetClass(), FName(*WeatherSetup.UDSWeatherWindDirectionPropertyName));
+	}
+}
+
+void UFlightPhysicsSubsystem::OnWorldPreActorTick(UWorld* InWorld, ELevelTick InLevelTick, float InDeltaSeconds)
+{
+	if (InWorld != GetWorld())
+	{
+		return;
+	}
+
+	// Roll over the frame stats
+	SubstepStats.NumSubstepsLastFrame = NumSubstepsThisFrame;
+	SubstepStats.LastFrameDurationMs = FrameDurationSeconds * 1000.0;
+	NumSubstepsThisFrame = 0;
+	FrameDurationSeconds = 0.0;
+
+	// In lockstep mode, this tick is one of our fixed steps if any are outstanding (otherwise we stay paused).
+	bLockstepStepThisTick = bInLockstep && NumLockstepStepsRemaining > 0 && !InWorld->IsPaused();
+
+	// Physics doesn't run while paused, so don't queue up a substep callback for it.
+	if (InWorld->IsPaused() || Vehicles.Num() == 0)
+	{
+		return;
+	}
+
+	// Hand vehicles between PhysX and native free flight, before physics runs for this frame.
+	for (AFlyingPawn* Vehicle : Vehicles)
+	{
+		if (Vehicle)
+		{
+			Vehicle->UpdateFreeFlight(InDeltaSeconds);
+		}
+	}
+
+	// Custom physics can only be registered against a body, so we use the first vehicle which is being simulated to drive the substeps of all vehicles.
+	// If every vehicle is in free flight, there is no such body, so we step them ourselves once the frame's ticks are done.
+	for (AFlyingPawn* Vehicle : Vehicles)
+	{
+		FBodyInstance* BodyInstance = Vehicle ? Vehicle->GetPhysicsBody() : nullptr;
+		if (BodyInstance && BodyInstance->IsInstanceSimulatingPhysics())
+		{
+			BodyInstance->AddCustomPhysics(CalculateCustomPhysics);
+			return;
+		}
+	}
+
+	bStepWithoutPhysicsThisTick = Vehicles.ContainsByPredicate([](const AFlyingPawn* Vehicle) { return Vehicle && Vehicle->IsInFreeFlight(); });
+}
+
+void UFlightPhysicsSubsystem::OnWorldPostActorTick(UWorld* InWorld, ELevelTick InLevelTick, float InDeltaSeconds)
+{
+	if (InWorld != GetWorld())
+	{
+		return;
+	}
+
+	if (bStepWithoutPhysicsThisTick)
+	{
+		bStepWithoutPhysicsThisTick = false;
+		StepWithoutPhysics(InDeltaSeconds);
+	}
+
+	// Move the free flight vehicles' (kinematic) bodies to where their substeps took them.
+	for (AFlyingPawn* Vehicle : Vehicles)
+	{
+		if (Vehicle && Vehicle->IsInFreeFlight())
+		{
+			Vehicle->ApplyFreeFlightTransform();
+		}
+	}
+
+	if (!bLockstepStepThisTick)
+	{
+		return;
+	}
+
+	bLockstepStepThisTick = false;
+
+	LockstepStats.NumSteps++;
+	LockstepStats.SimulatedTime += InDeltaSeconds;
+
+	if (--NumLockstepStepsRemaining > 0)
+	{
+		return;
+	}
+
+	// That was the last step, so pause until the next Step() call.
+	SetLockstepPaused(true);
+
+	const double WallTime = FPlatformTime::Seconds() - LockstepStartTime;
+	LockstepWallTime += WallTime;
+
+	LockstepStats.WallTime = LockstepWallTime;
+	LockstepStats.RealTimeFactor = LockstepWallTime > 0.0 ? LockstepStats.SimulatedTime / LockstepWallTime : 0.0f;
+	LockstepStats.LastRealTimeFactor = WallTime > 0.0 ? (NumLockstepStepsRequested * LockstepSettings.FixedDeltaTime) / WallTime : 0.0f;
+	NumLockstepStepsRequested = 0;
+
+	OnLockstepStepsComplete.Broadcast(LockstepStats);
+}
+
+void UFlightPhysicsSubsystem::BeginLockstep(const FFlightLockstepSettings& Settings)
+{
+	if (bInLockstep)
+	{
+		EndLockstep();
+	}
+
+	bInLockstep = true;
+	LockstepSettings = Settings;
+	LockstepSettings.FixedDeltaTime = FMath::Max(Settings.FixedDeltaTime, 0.0001f);
+	LockstepStats = FFlightLockstepStats();
+	NumLockstepStepsRemaining = 0;
+	NumLockstepStepsRequested = 0;
+	LockstepWallTime = 0.0;
+
+	// A fixed time step makes every world tick advance by exactly FixedDeltaTime, and benchmarking stops the engine from waiting
+	// on the wall clock (or a max tick rate) between ticks, so ticks run back to back.
+	AcquireFixedTimeStep(EFlightFixedTimeStepHolder::Lockstep, LockstepSettings.FixedDeltaTime);
+	bPreviousBenchmarking = FApp::IsBenchmarking();
+	FApp::SetBenchmarking(true);
+
+	if (UGameViewportClient* GameViewport = GetWorld()->GetGameViewport())
+	{
+		bPreviousDisableWorldRendering = GameViewport->bDisableWorldRendering;
+		GameViewport->bDisableWorldRendering = LockstepSettings.bDisableRendering || bPreviousDisableWorldRendering;
+	}
+
+	if (LockstepSettings.bDisableActorTicks)
+	{
+		for (TActorIterator<AActor> It(GetWorld()); It; ++It)
+		{
+			if (It->IsActorTickEnabled())
+			{
+				It->SetActorTickEnabled(false);
+				LockstepDisabledTickActors.Add(*It);
+			}
+		}
+	}
+
+	SetLockstepPaused(true);
+}
+
+void UFlightPhysicsSubsystem::EndLockstep()
+{
+	if (!bInLockstep)
+	{
+		return;
+	}
+
+	bInLockstep = false;
+	bLockstepStepThisTick = false;
+	NumLockstepStepsRemaining = 0;
+	NumLockstepStepsRequested = 0;
+
+	ReleaseFixedTimeStep(EFlightFixedTimeStepHolder::Lockstep);
+	FApp::SetBenchmarking(bPreviousBenchmarking);
+
+	if (UGameViewportClient* GameViewport = GetWorld()->GetGameViewport())
+	{
+		GameViewport->bDisableWorldRendering = bPreviousDisableWorldRendering;
+	}
+
+	for (const TWeakObjectPtr<AActor>& Actor : LockstepDisabledTickActors)
+	{
+		if (Actor.IsValid())
+		{
+			Actor->SetActorTickEnabled(true);
+		}
+	}
+	LockstepDisabledTickActors.Empty();
+
+	SetLockstepPaused(false);
+}
+
+void UFlightPhysicsSubsystem::Step(int32 NumSteps)
+{
+	if (!bInLockstep || NumSteps <= 0)
+	{
+		return;
+	}
+
+	// Time from here until the steps are complete (which includes any engine overhead between ticks).
+	if (NumLockstepStepsRemaining == 0)
+	{
+		LockstepStartTime = FPlatformTime::Seconds();
+	}
+
+	NumLockstepStepsRemaining += NumSteps;
+	NumLockstepStepsRequested += NumSteps;
+
+	SetLockstepPaused(false);
+}
+
+void UFlightPhysicsSubsystem::BeginDeterministic(const FFlightDeterminismSettings& Settings)
+{
+	if (bDeterministic)
+	{
+		EndDeterministic();
+	}
+
+	bDeterministic = true;
+	DeterminismSettings = Settings;
+	DeterminismSettings.FixedDeltaTime = FMath::Max(Settings.FixedDeltaTime, 0.0001f);
+	DeterministicStepIndex = 0;
+	LastStateHash = 0;
+	RunningStateHash = SkyPhysCore::FStateHash();
+	StateHashHistory.Reset();
+
+	// The engine's fixed time step is our fixed step clock: every world tick (and so every set of physics substeps) then has exactly the
+	// same delta time, however long the frame really took.
+	AcquireFixedTimeStep(EFlightFixedTimeStepHolder::Deterministic, DeterminismSettings.FixedDeltaTime);
+
+	Vehicles.Remove(nullptr);
+	Vehicles.Sort([](const AFlyingPawn& A, const AFlyingPawn& B) { return A.GetName() < B.GetName(); });
+
+	for (AFlyingPawn* Vehicle : Vehicles)
+	{
+		SeedDeterministicVehicle(Vehicle);
+	}
+}
+
+void UFlightPhysicsSubsystem::EndDeterministic()
+{
+	if (!bDeterministic)
+	{
+		return;
+	}
+
+	bDeterministic = false;
+
+	ReleaseFixedTimeStep(EFlightFixedTimeStepHolder::Deterministic);
+}
+
+void UFlightPhysicsSubsystem::SeedDeterministicVehicle(AFlyingPawn* Vehicle) const
+{
+	const uint64 VehicleStream = FCrc::StrCrc32(*Vehicle->GetName());
+	Vehicle->SetRandomSeed(SkyPhysCore::FRandomStream::DeriveSeed(static_cast<uint32>(DeterminismSettings.Seed), VehicleStream));
+}
+
+void UFlightPhysicsSubsystem::UpdateStateHash()
+{
+	SkyPhysCore::FStateHash Hash;
+	Hash.Add(static_cast<uint64>(DeterministicStepIndex));
+	Hash.Add(SkyPhysConversions::ToCore(SteadyWind));
+
+	for (const AFlyingPawn* Vehicle : Vehicles)
+	{
+		if (Vehicle)
+		{
+			Vehicle->AddToStateHash(Hash);
+		}
+	}
+
+	LastStateHash = Hash.Get();
+	RunningStateHash.Add(LastStateHash);
+	DeterministicStepIndex++;
+
+	if (DeterminismSettings.bRecordStateHashHistory)
+	{
+		StateHashHistory.Add(static_cast<int64>(LastStateHash));
+	}
+}
+
+void UFlightPhysicsSubsystem::SetLockstepPaused(bool bPaused)
+{
+	UGameplayStatics::SetGamePaused(this, bPaused);
+}
+
+void UFlightPhysicsSubsystem::AcquireFixedTimeStep(EFlightFixedTimeStepHolder Holder, float FixedDeltaTime)
+{
+	if (FixedTimeStepHolders.Num() == 0)
+	{
+		bPreviousUseFixedTimeStep = FApp::UseFixedTimeStep();
+		PreviousFixedDeltaTime = FApp::GetFixedDeltaTime();
+	}
+
+	FixedTimeStepHolders.RemoveAll([Holder](const TPair<EFlightFixedTimeStepHolder, float>& Hold) { return Hold.Key == Holder; });
+	FixedTimeStepHolders.Emplace(Holder, FixedDeltaTime);
+
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(FixedDeltaTime);
+}
+
+void UFlightPhysicsSubsystem::ReleaseFixedTimeStep(EFlightFixedTimeStepHolder Holder)
+{
+	if (FixedTimeStepHolders.RemoveAll([Holder](const TPair<EFlightFixedTimeStepHolder, float>& Hold) { return Hold.Key == Holder; }) == 0)
+	{
+		return;
+	}
+
+	// Hand the fixed time step back to the latest remaining holder, or back to the engine once nobody holds it.
+	if (FixedTimeStepHolders.Num() > 0)
+	{
+		FApp::SetFixedDeltaTime(FixedTimeStepHolders.Last().Value);
+	}
+	else
+	{
+		FApp::SetUseFixedTimeStep(bPreviousUseFixedTimeStep);
+		FApp::SetFixedDeltaTime(PreviousFixedDeltaTime);
+	}
+}
+
+void UFlightPhysicsSubsystem::Substep(float DeltaTime, FBodyInstance* BodyInstance)
+{
+	SCOPE_CYCLE_COUNTER(STAT_FlightPhysicsSubstep);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	// The atmosphere is sampled once and shared by all vehicles.
+	UpdateSharedAtmosphere();
+
+	// Vehicles are independent until contact (which PhysX handles), so each substep is split into:
+	// 1. Reading each vehicle's state from the physics engine (serial, in registration order).
+	// 2. Calculating each vehicle's forces and moments (parallel, each vehicle only touches its own state).
+	// 3. Applying each vehicle's forces and moments to the physics engine (serial, in registration order).
+	// The results are therefore the same regardless of how many threads take part.
+	int32 NumVehicles = 0;
+	for (AFlyingPawn* Vehicle : Vehicles)
+	{
+		if (Vehicle)
+		{
+			Vehicle->SubstepReadState();
+			NumVehicles++;
+		}
+	}
+
+	if (bDeterministic)
+	{
+		UpdateStateHash();
+	}
+
+	const bool bForceSingleThread = CVarSkyPhysParallelSubstep.GetValueOnAnyThread() == 0;
+	ParallelFor(Vehicles.Num(), [this, DeltaTime](int32 Index)
+		{
+			if (AFlyingPawn* Vehicle = Vehicles[Index])
+			{
+				Vehicle->SubstepCalculate(DeltaTime);
+			}
+		}, bForceSingleThread);
+
+	for (AFlyingPawn* Vehicle : Vehicles)
+	{
+		if (Vehicle)
+		{
+			Vehicle->SubstepApply(DeltaTime);
+		}
+	}
+
+	const double Duration = FPlatformTime::Seconds() - StartTime;
+
+	NumSubstepsThisFrame++;
+	FrameDurationSeconds += Duration;
+
+	SubstepStats.NumVehicles = NumVehicles;
+	SubstepStats.LastSubstepDeltaTime = DeltaTime;
+	SubstepStats.LastSubstepDurationMs = Duration * 1000.0;
+	SubstepStats.MaxSubstepDurationMs = FMath::Max(SubstepStats.MaxSubstepDurationMs, SubstepStats.LastSubstepDurationMs);
+}
+
+void UFlightPhysicsSubsystem::StepWithoutPhysics(float DeltaTime)
+{
+	// Split the frame the same way PhysX would have (see the substepping settings in the project physics settings).
+	const UPhysicsSettings* PhysicsSettings = UPhysicsSettings::Get();
+	const float PhysicsDeltaTime = FMath::Min(DeltaTime, PhysicsSettings->MaxPhysicsDeltaTime);
+
+	int32 NumSubsteps = 1;
+	if (PhysicsSettings->bSubstepping && PhysicsSettings->MaxSubstepDeltaTime > 0.0f)
+	{
+		NumSubsteps = FMath::Clamp(FMath::CeilToInt(PhysicsDeltaTime / PhysicsSettings->MaxSubstepDeltaTime), 1, FMath::Max(PhysicsSettings->MaxSubsteps, 1));
+	}
+
+	for (int32 i = 0; i < NumSubsteps; i++)
+	{
+		Substep(PhysicsDeltaTime / NumSubsteps, nullptr);
+	}
+}
+
+void UFlightPhysicsSubsystem::UpdateSharedAtmosphere()
+{
+	FVector Vw = FVector(0.0f);
+
+	// If we've defined a weather class, then grab the wind value from the weather to sync this.
+	if (UDSWeatherActor && WindIntensityProperty)
+	{
+		float WindIntensity = WindIntensityProperty->GetPropertyValue_InContainer(UDSWeatherActor) * WeatherSetup.UDSWindIntensityScalar;
+
+		// Initially assume that the direction is North (ie. 0 rad).
+		float WindDirectionRads = FMath::DegreesToRadians(0);
+
+		// But if our direction property exists, then use this instead.
+		if (WindDirectionProperty)
+		{
+			float WindDirectionDegs = WindDirectionProperty->GetPropertyValue_InContainer(UDSWeatherActor);
+			WindDirectionRads = FMath::DegreesToRadians(WindDirectionDegs);
+		}
+
+		// Use intensity and direction to get our wind vector
+		Vw.X = WindIntensity * cos(WindDirectionRads);
+		Vw.Y = WindIntensity * sin(WindDirectionRads);
+
+		// Ensure we remove any numerical errors we might have with this vector
+		Vw = SkyPhysHelpers::RemoveNumericalErrors(Vw);
+	}
+
+	SteadyWind = Vw;
+	AirDensity = 1.225f; // Could use temperature from weather class, as well as altitude and atmospheric model to get density.
+}
@@ -2,15 +2,98 @@
 
 #include "Turbulence/Dryden/TurbulenceModelDryden.h"
 
-#include <random>
-
-#include "Common/Utils/Integrator.h"
+#include "Common/Utils/CoreConversions.h"
 #include "Turbulence/Dryden/Dryden.h"
+#include "SkyPhysCore/Turbulence/DrydenModel.h"
 
 UTurbulenceModelDryden::UTurbulenceModelDryden()
 {
 }
 
+float UTurbulenceModelDryden::GetCharacteristicRate(float Va, float Altitude) const
+{
+	// Exponential filters are stable for any step, so only trapezoidal ones limit the step size.
+	const auto IsTrapezoidal = [](const UDrydenModelTFBase* Dryden)
+	{
+		return Dryden && Dryden->GetIntegrationMethod() == SkyPhysCore::EFilterIntegrationMethod::Trapezoidal;
+	};
+
+	const bool bTrapezoidal = IsTrapezoidal(DrydenHu) || IsTrapezoidal(DrydenHv) || IsTrapezoidal(DrydenHw);
+	return bTrapezoidal ? SkyPhysCore::FDrydenTurbulenceModel::CalculateCharacteristicRate(Va, Altitude) : 0.0f;
+}
+
+void UTurbulenceModelDryden::SetRandomSeed(uint64 Seed)
+{
+	if (DrydenHu)
+	{
+		DrydenHu->SetSeed(SkyPhysCore::FRandomStream::DeriveSeed(Seed, 0));
+	}
+
+	if (DrydenHv)
+	{
+		DrydenHv->SetSeed(SkyPhysCore::FRandomStream::DeriveSeed(Seed, 1));
+	}
+
+	if (DrydenHw)
+	{
+		DrydenHw->SetSeed(SkyPhysCore::FRandomStream::DeriveSeed(Seed, 2));
+	}
+}
+
+void UTurbulenceModelDryden::AddToHash(SkyPhysCore::FStateHash& Hash) const
+{
+	if (DrydenHu)
+	{
+		DrydenHu->AddToHash(Hash);
+	}
+
+	if (DrydenHv)
+	{
+		DrydenHv->AddToHash(Hash);
+	}
+
+	if (DrydenHw)
+	{
+		DrydenHw->AddToHash(Hash);
+	}
+}
+
+void UTurbulenceModelDryden::SaveSnapshot(FTurbulenceSnapshot& Snapshot) const
+{
+	if (DrydenHu)
+	{
+		DrydenHu->SaveSnapshot(Snapshot.Filters[0]);
+	}
+
+	if (DrydenHv)
+	{
+		DrydenHv->SaveSnapshot(Snapshot.Filters[1]);
+	}
+
+	if (DrydenHw)
+	{
+		DrydenHw->SaveSnapshot(Snapshot.Filters[2]);
+	}
+}
+
+void UTurbulenceModelDryden::RestoreSnapshot(const FTurbulenceSnapshot& Snapshot)
+{
+	if (DrydenHu)
+	{
+		DrydenHu->RestoreSnapshot(Snapshot.Filters[0]);
+	}
+
+	if (DrydenHv)
+	{
+		DrydenHv->RestoreSnapshot(Snapshot.Filters[1]);
+	}
+
+	if (DrydenHw)
+	{
+		DrydenHw->RestoreSnapshot(Snapshot.Filters[2]);
+	}
+}
+
 FVector UTurbulenceModelDryden::GetTurbulenceBodyFrame(float Dt, float Va, float Altitude, float WindSpeed) const
 {
 
@@ -47,27 +130,10 @@ FVector UTurbulenceModelDryden::GetTurbulenceBodyFrame(float Dt, float Va, float
 
 FVector UTurbulenceModelDryden::GetTurbulenceScaleLengths(float Altitude) const
 {
-	float Lwg = 0.0f;
-	float LugLvg = 0.0f;
-
-	if (Altitude >= 10.0f)
-	{
-		float ClampedAltitude = FMath::Clamp(Altitude, 10.0f, 1000.0f);  // Constrain h to 10ft < h < 1000ft
-
-		Lwg = ClampedAltitude;
-		LugLvg = ClampedAltitude / pow(0.177f + 0.000823f * ClampedAltitude, 1.2f); // MIL-F-8785C pg. 55, Figure 10
-	}
-
-	return FVector(LugLvg, LugLvg, Lwg);
+	return SkyPhysConversions::FromCore(SkyPhysCore::FDrydenTurbulenceModel::GetTurbulenceScaleLengths(Altitude));
 }
 
 FVector UTurbulenceModelDryden::GetTurbulenceRMSIntensities(float Altitude, float WindSpeed20Ft) const
 {
-	float AltitudeClamped = FMath::Clamp(Altitude, 0.0f, 1000.0f);  // Constrain h to 0ft < h < 1000ft
-	float SigmaW = 0.1f * WindSpeed20Ft;
-
-	float SigmaUSigmaV = SigmaW / pow(0.177f + 0.000823f * AltitudeClamped, 0.4f); // MIL-F-8785C pg. 56, Figure 11
-
-	return FVector(SigmaUSigmaV, SigmaUSigmaV, SigmaW);
+	return SkyPhysConversions::FromCore(SkyPhysCore::FDrydenTurbulenceModel::GetTurbulenceRMSIntensities(Altitude, WindSpeed20Ft));
 }
-
@@ -3,6 +3,9 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Common/Utils/Integrator.h"
+#include "SkyPhysCore/Actuation/ActuatorModel.h"
+
 #include "ActuatorModel.generated.h"
 
 UCLASS(Abstract)
@@ -19,19 +22,33 @@ public:
 	// @param DeltaTime - The amount of time since the last actuator command was provided (s) 
 	//
 	// @return The latest state of the actuator (unit depends on the actuator)
-	virtual float ApplyActuatorCommand(float Command, float DeltaTime) PURE_VIRTUAL(UBaseActuator::ApplyActuatorCommand, return 0;);
+	virtual float ApplyActuatorCommand(float Command, float DeltaTime);
 
 	// Get the current state of the actuator.
 	//
 	// @return The latest state of the actuator (unit depends on the actuator)
-	virtual float GetActuatorState() const PURE_VIRTUAL(UBaseActuator::GetActuatorState, return 0;);
+	virtual float GetActuatorState() const;
+
+	// Get the fastest rate of the actuator dynamics (1/s), or 0 for a feedthrough actuator.
+	float GetCharacteristicRate() const;
+
+	// Save or restore the complete dynamic state of the actuator.
+	void SaveSnapshot(SkyPhysCore::FActuatorSnapshot& Snapshot) const;
+	void RestoreSnapshot(const SkyPhysCore::FActuatorSnapshot& Snapshot);
+
+	// Add the actuator state to a state hash.
+	void AddToHash(SkyPhysCore::FStateHash& Hash) const { Actuator.AddToHash(Hash); };
 
 protected:
 
 	// Initialise the actuator
+	void InitialiseActuator();
+
+	// Get the parameters for the engine-independent actuator model.
+	// Override this to set the filter type and any filter specific parameters.
 	//
-	// @return The latest state of the actuator (unit depends on the actuator)
-	virtual void InitialiseActuator() PURE_VIRTUAL(UBaseActuator::InitialiseActuator,);
+	// @return The actuator model parameters
+	virtual SkyPhysCore::FActuatorParameters GetActuatorParameters() const;
 
 	UPROPERTY(EditAnywhere, Category = "Actuator Parameters")
 	float RateLimit = 0.0f;
@@ -45,6 +62,9 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Actuator Parameters")
 	float InitialActuatorState = 0.0f;
 
-	float ActuatorState = 0.0f;
+	UPROPERTY(EditAnywhere, Category = "Actuator Parameters", Meta = (Tooltip = "How the filter is advanced over each command. Exponential is exact and stable for any frame time, so suits fast actuators (high wn)."))
+	ELinearFilterIntegrationMethod IntegrationMethod = ELinearFilterIntegrationMethod::Trapezoidal;
+
+	SkyPhysCore::FActuatorModel Actuator;
 	bool bActuatorInitialised = false;
 };
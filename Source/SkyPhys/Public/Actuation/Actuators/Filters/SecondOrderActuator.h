@@ -5,7 +5,6 @@
 #include "CoreMinimal.h"
 
 #include "Actuation/Actuators/ActuatorModel.h"
-#include "Common/Utils/Integrator.h"
 
 #include "SecondOrderActuator.generated.h"
 
@@ -17,22 +16,9 @@ class SKYPHYS_API USecondOrderActuator : public UActuatorModel
 public:
 	USecondOrderActuator();
 
-	// Apply a new command to the actuator.
-	//
-	// @param Command - The new command to apply to the actuator (unit depends on actuator)
-	// @param DeltaTime - The amount of time since the last actuator command was provided (s)
-	//
-	// @return The latest state of the actuator (unit depends on the actuator)
-	virtual float ApplyActuatorCommand(float Command, float DeltaTime) override;
-
-	// Get the current state of the actuator.
-	//
-	// @return The latest state of the actuator (unit depends on the actuator)
-	virtual float GetActuatorState() const override;
-
 protected:
 
-	virtual void InitialiseActuator() override;
+	virtual SkyPhysCore::FActuatorParameters GetActuatorParameters() const override;
 
 	UPROPERTY(EditAnywhere, Category = "Actuator Parameters", Meta = (Tooltip = "Natural frequency of the filter (rad/s)"))
 	float wn = 0.0f;
@@ -43,8 +29,4 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Actuator Parameters", Meta = (Tooltip = "DC Gain of the filter (unitless)"))
 	float DCGain = 1.0f;
 
-private:
-
-	Integrator integrator1;
-	Integrator integrator2;
 };
\ No newline at end of file
@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <memory>
+
+#include "Engine/DataAsset.h"
+#include "SkyPhysCore/Actuation/BladeElementPropeller.h"
+
+#include "BladeElementPropellerDataAsset.generated.h"
+
+USTRUCT()
+struct FBladeStationParameters
+{
+	GENERATED_BODY()
+	// As per the UIUC propeller database geometry files
+	UPROPERTY(EditAnywhere, Meta = (Tooltip = "Radius (r/R)"))
+	float r = 0.0f;
+	UPROPERTY(EditAnywhere, Meta = (Tooltip = "Chord (c/R)"))
+	float Chord = 0.0f;
+	UPROPERTY(EditAnywhere, Meta = (Tooltip = "Pitch of the section chord to the propeller plane (deg)"))
+	float Twist = 0.0f;
+};
+
+USTRUCT()
+struct FAirfoilPolarPoint
+{
+	GENERATED_BODY()
+	UPROPERTY(EditAnywhere, Meta = (Tooltip = "Angle of attack (deg)"))
+	float Alpha = 0.0f;
+	UPROPERTY(EditAnywhere)
+	float CL = 0.0f;
+	UPROPERTY(EditAnywhere)
+	float CD = 0.0f;
+};
+
+// The blade geometry of a type of propeller, from which its performance over the full envelope (propeller speed, advance ratio and inflow
+// angle) is worked out with blade element momentum theory, for propellers without measured data. As per UPropellerDataAsset, the table is
+// built once per asset (when it's loaded, spread over the task graph) and shared by every propeller component of that type.
+UCLASS(BlueprintType)
+class SKYPHYS_API UBladeElementPropellerDataAsset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, Category = "Blade Geometry", Meta = (Tooltip = "True propeller diameter (m)"))
+	float D = 0.254f;
+
+	UPROPERTY(EditAnywhere, Category = "Blade Geometry", Meta = (ClampMin = "1"))
+	int32 NumBlades = 2;
+
+	UPROPERTY(EditAnywhere, Category = "Blade Geometry", Meta = (Tooltip = "Sorted by radius, from the root (the first station is the edge of the hub) to the tip."))
+	TArray<FBladeStationParameters> Stations;
+
+	UPROPERTY(EditAnywhere, Category = "Blade Geometry", Meta = (Tooltip = "Section lift and drag against angle of attack (sorted by ascending angle of attack). If empty, a thin airfoil is used."))
+	TArray<FAirfoilPolarPoint> AirfoilPolar;
+
+	UPROPERTY(EditAnywhere, Category = "Performance Table", Meta = (Tooltip = "Minimum propeller speed of the table (RPM)"))
+	float NMin = 1000.0f;
+
+	UPROPERTY(EditAnywhere, Category = "Performance Table", Meta = (Tooltip = "Maximum propeller speed of the table (RPM)"))
+	float NMax = 20000.0f;
+
+	UPROPERTY(EditAnywhere, Category = "Performance Table", Meta = (ClampMin = "2"))
+	int32 NumN = 8;
+
+	UPROPERTY(EditAnywhere, Category = "Performance Table", Meta = (Tooltip = "Maximum advance ratio of the table (Unitless)"))
+	float JMax = 1.5f;
+
+	UPROPERTY(EditAnywhere, Category = "Performance Table", Meta = (ClampMin = "2"))
+	int32 NumJ = 31;
+
+	UPROPERTY(EditAnywhere, Category = "Performance Table", Meta = (ClampMin = "2", Tooltip = "Number of inflow angles, from axial flight (0 deg) to axial descent (180 deg)."))
+	int32 NumInflowAngles = 13;
+
+	// Get the performance table of this propeller, building it if it hasn't been already (ie. after an edit). This can take a while, so it
+	// isn't to be called from the physics substeps (see UPropulsionStaticMeshComponent::InitializePropulsion).
+	//
+	// @return The table, which is immutable and can be shared by any number of propeller models
+	std::shared_ptr<const SkyPhysCore::FPropellerPerformanceTable> GetPerformanceTable();
+
+	// Get the blade geometry, in the units of the engine-independent solver.
+	SkyPhysCore::FBladeElementPropellerGeometry GetGeometry() const;
+
+	// Build the performance table up front, rather than when the first propeller is initialized.
+	virtual void PostLoad() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+	std::shared_ptr<const SkyPhysCore::FPropellerPerformanceTable> PerformanceTable;
+
+	// The table can be asked for while it's being built by PostLoad (eg. when that's on the async loading thread).
+	FCriticalSection TableLock;
+};
@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Actuation/Propulsion/Propulsion.h"
+#include "Actuation/Propulsion/Propeller/BladeElementPropellerDataAsset.h"
+#include "Actuation/Propulsion/Propeller/PropellerPropulsion.h"
+#include "Common/Types.h"
+#include "SkyPhysCore/Actuation/BladeElementPropellerModel.h"
+
+#include "BladeElementPropellerPropulsion.generated.h"
+
+// A propeller whose performance comes from its blade geometry (see UBladeElementPropellerDataAsset), rather than from measured CT and CP data.
+// This includes the in-plane force and the change in thrust and torque in oblique inflow (eg. a multirotor in forward flight).
+UCLASS(ClassGroup = "Propulsion", meta = (BlueprintSpawnableComponent))
+class SKYPHYS_API UBladeElementPropellerPropulsionStaticMeshComponent : public UPropulsionStaticMeshComponent
+{
+	GENERATED_BODY()
+
+public:
+	UBladeElementPropellerPropulsionStaticMeshComponent();
+
+	// Apply the propeller command
+	// This will then invoke the actuator driving the propeller and handle the dynamics associated with this
+	//
+	// @param dtCmd: The unitless command signal (expect this to be between 0 and 1)
+	virtual void ApplyActuatorCommand(const float dtCmd, const float DeltaTime) override;
+
+	// Get Propeller Forces and Moments in the airframe body frame, at the origin of the propeller frame (as per UPropellerPropulsionStaticMeshComponent).
+	//
+	// @param Rho: Air density (kg/m^3)
+	// @param Vb: Airframe velocity in the body frame (m/s)
+	// @param Omegab: Airframe rotational velocity in the body frame (rad/s)
+	// @param Vwb: Wind velocity in the body frame (m/s)
+	// 
+	// @return The forces and moments generated by this propeller in the body frame (N, Nm)
+	virtual FForcesAndMoments GetForcesAndMoments(float Rho, FVector Vb, FVector Omegab, FVector Vwb) override;
+
+	// Get the current propeller speed (in SI units)
+	//
+	// @return The current propeller speed (rad/s)
+	virtual float GetMotionState() override;
+
+	virtual void SetMotionState(float MotionState) override { PropellerModel.SetRotationalSpeed(MotionState); };
+
+	virtual float GetAngularMomentum() const override { return PropellerModel.GetAngularMomentum(); };
+
+	// Build the propeller model (and the performance table of its data asset, if it hasn't been already).
+	virtual void InitializePropulsion() override;
+
+	// The trim solver models propellers as per SkyPhysCore::FPropellerModel, which has neither the in-plane force nor the effect of oblique
+	// inflow of the blade element model, so these propellers can't be trimmed.
+	//
+	// @return False
+	virtual bool GetTrimPropulsor(SkyPhysCore::FTrimPropulsor& TrimPropulsor) override { return false; };
+
+private:
+	UPROPERTY(EditAnywhere, Category = "Propeller Physics", Meta = (Tooltip = "Maximum propeller rotational speed (RPM)", AllowPrivateAccess = "true"))
+	float MaxN;
+
+	UPROPERTY(EditAnywhere, Category = "Propeller Physics", Meta = (Tooltip = "The blade geometry of this type of propeller, whose performance table is shared with every other propeller which uses it.", AllowPrivateAccess = "true"))
+	UBladeElementPropellerDataAsset* BladeElementPropellerData = nullptr;
+
+	UPROPERTY(EditAnywhere, Category = "Propeller Physics", Meta = (Tooltip = "The rotation direction of the propeller (Right Hand Rule) about the Z axis.", AllowPrivateAccess = "true"))
+	EPropellerRotationDirection RotationDirection;
+
+	UPROPERTY(EditAnywhere, Category = "Propeller Physics", Meta = (Tooltip = "Mass moment of inertia of the propeller about the Z axis (kg.m^2)", AllowPrivateAccess = "true"))
+	float Izz;
+
+	// The engine-independent propeller model, built from the data asset.
+	SkyPhysCore::FBladeElementPropellerModel PropellerModel;
+	bool bPhysicsParametersInitialized = false;
+
+	// Initialize the system
+	void InitializePropellerPhysics();
+
+};
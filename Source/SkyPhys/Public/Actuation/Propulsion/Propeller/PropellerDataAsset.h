@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <memory>
+
+#include "Engine/DataAsset.h"
+#include "SkyPhysCore/Actuation/PropellerTable.h"
+
+#include "PropellerDataAsset.generated.h"
+
+USTRUCT()
+struct FConstantSpeedPropellerPhysicsParameters
+{
+	GENERATED_BODY()
+	// These are our propeller parameters for a specific propeller speed.
+	UPROPERTY(EditAnywhere)
+	float n; // RPM
+	UPROPERTY(EditAnywhere)
+	TArray<float> J;
+	UPROPERTY(EditAnywhere)
+	TArray<float> CT;
+	UPROPERTY(EditAnywhere)
+	TArray<float> CP;
+};
+
+// The measured CT and CP data of a type of propeller (as per the UIUC propeller database), which every propeller component of that type
+// can reference, rather than each holding (and resampling) its own copy. The resampled table is built once per asset and shared by all of them.
+//
+// The data either comes from a propeller database (cooked by the SkyPhysPropellerImporter tool, see SkyPhysCore::FPropellerDatabase), which
+// is memory mapped and used in place, or is entered on the asset itself.
+UCLASS(BlueprintType)
+class SKYPHYS_API UPropellerDataAsset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, Category = "Propeller Database", Meta = (FilePathFilter = "skyprop", RelativeToGameDir, Tooltip = "A propeller database file, cooked by the SkyPhysPropellerImporter tool. Non-asset files need to be staged when packaging (eg. Additional Non-Asset Directories to Package)."))
+	FFilePath Database;
+
+	UPROPERTY(EditAnywhere, Category = "Propeller Database", Meta = (Tooltip = "The name of the propeller in the database, as per its UIUC data files (eg. apcsp_7x9)."))
+	FString DatabasePropellerName;
+
+	// We will have a set of propeller parameters, based on the propeller speed (sorted by ascending speed).
+	UPROPERTY(EditAnywhere, Category = "Propeller Data", Meta = (Tooltip = "Propeller data entered on this asset, only used if no database propeller is found."))
+	TArray<FConstantSpeedPropellerPhysicsParameters> ConstantSpeedPropellerPhysicsParameters;
+
+	// Get the resampled table of this data, from the database or building it from the data on this asset, on first use.
+	//
+	// @return The table, which is immutable and can be shared by any number of propeller models
+	std::shared_ptr<const SkyPhysCore::FPropellerTable> GetTable();
+
+	// Resample a set of propeller data into a new table.
+	//
+	// @param Data: The data for each propeller speed (sorted by ascending speed)
+	static std::shared_ptr<const SkyPhysCore::FPropellerTable> BuildTable(const TArray<FConstantSpeedPropellerPhysicsParameters>& Data);
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+	std::shared_ptr<const SkyPhysCore::FPropellerTable> Table;
+
+	// The components of each vehicle can be initialized on different threads (see UFlightPhysicsSubsystem).
+	FCriticalSection TableLock;
+};
@@ -5,7 +5,9 @@
 #include "CoreMinimal.h"
 
 #include "Actuation/Propulsion/Propulsion.h"
+#include "Actuation/Propulsion/Propeller/PropellerDataAsset.h"
 #include "Common/Types.h"
+#include "SkyPhysCore/Actuation/PropellerModel.h"
 
 #include "PropellerPropulsion.generated.h"
 
@@ -17,27 +19,12 @@ enum class EPropellerRotationDirection : int8
 	Negative = -1			UMETA(DisplayName = "-Z")
 };
 
-USTRUCT()
-struct FConstantSpeedPropellerPhysicsParameters
-{
-	GENERATED_BODY()
-	// These are our propeller parameters for a specific propeller speed.
-	UPROPERTY(EditAnywhere)
-	float n; // RPM
-	UPROPERTY(EditAnywhere)
-	TArray<float> J;
-	UPROPERTY(EditAnywhere)
-	TArray<float> CT;
-	UPROPERTY(EditAnywhere)
-	TArray<float> CP;
-};
-
 USTRUCT()
 struct FPropellerPhysicsParameters
 {
 	GENERATED_BODY()
 	// We will have a set of propeller parameters, based on the propeller speed. 
-	UPROPERTY(EditAnywhere)
+	UPROPERTY(EditAnywhere, Meta = (Tooltip = "Propeller data for this component alone, only used if no Propeller Data asset is set."))
 	TArray<FConstantSpeedPropellerPhysicsParameters> ConstantSpeedPropellerPhysicsParameters;
 
 	UPROPERTY(EditAnywhere, Meta = (Tooltip = "The rotation direction of the propeller (Right Hand Rule) about the Z axis."))
@@ -53,42 +40,6 @@ struct FPropellerPhysicsParameters
 	float D;
 };
 
-// Calculation Structs
-struct FPropellerPhysicsCalculationParameters
-{
-	bool bPhysicsParametersInitialized = false;
-
-	// Variables
-	TArray<float> NArray; // Array of propeller speeds
-};
-
-// Results Structs
-struct FAerodynamicConstantResults
-{
-	float CT;
-	float CP;
-
-	FAerodynamicConstantResults(float CT, float CP) : CT(CT), CP(CP) {};
-};
-
-// State Structs
-USTRUCT(BlueprintType)
-struct FPropellerState
-{
-	GENERATED_BODY()
-
-	FVector V = FVector(0); // Current propeller airstream inflow velocity (m/s)
-
-	float omega = 0.0f; // Current propeller rotational speed (rad/s)
-	float Rho = 0.0f; // Current air density at the propeller (kg/m^3)
-	float J = 0.0f; // Current advance ratio (unitless)
-	float AerodynamicConstant = 0.0f; // The aerodynamic constant for thrust (rho * n^2 * D^4).
-
-	// Rotations from world to unreal and vice versa.
-	FRotator Rwu;
-	FRotator Ruw;
-};
-
 UCLASS(ClassGroup = "Propulsion", meta = (BlueprintSpawnableComponent))
 class SKYPHYS_API UPropellerPropulsionStaticMeshComponent : public UPropulsionStaticMeshComponent
 {
@@ -103,70 +54,52 @@ public:
 	// @param dtCmd: The unitless command signal (expect this to be between 0 and 1)
 	virtual void ApplyActuatorCommand(const float dtCmd, const float DeltaTime) override;
 
-	// Get Propeller Forces and Moments in the world frame. 
+	// Get Propeller Forces and Moments in the airframe body frame. 
 	// Note that the propeller frame will generally be with the z-axis pointing down for a multirotor, or toward the back of the aircraft for a fixed wing. 
 	// Right hand rule will then determine what "clockwise" and "anticlockwise" mean. 
 	// "Positive thrust", or in other words actually actively generating thrust, will result in a negative Z thrust in the propeller body frame. 
 	//
-	// Calculate the forces and moments generated by this propeller in the world frame, at the origin of the propeller frame (ie. you will need to get the moments yourself!)
+	// Calculate the forces and moments generated by this propeller in the airframe body frame, at the origin of the propeller frame (ie. you will need to get the moments yourself!)
 	// 
 	// @param Rho: Air density (kg/m^3)
-	// @param SystemOmega: Root body rotational velocity in the world frame (rad/s)
-	// @param Vw: Wind velocity in the world frame (NEU) (m/s)
+	// @param Vb: Airframe velocity in the body frame (m/s)
+	// @param Omegab: Airframe rotational velocity in the body frame (rad/s)
+	// @param Vwb: Wind velocity in the body frame (m/s)
 	// 
-	// @return The forces and moments generated by this propeller in the world frame (N, Nm)
-	virtual FForcesAndMoments GetForcesAndMoments(float Rho, FVector Vw, FVector SystemOmega) override;
+	// @return The forces and moments generated by this propeller in the body frame (N, Nm)
+	virtual FForcesAndMoments GetForcesAndMoments(float Rho, FVector Vb, FVector Omegab, FVector Vwb) override;
 
 	// Get the current propeller speed (in SI units)
 	//
 	// @return The current propeller speed (rad/s)
 	virtual float GetMotionState() override;
 
+	virtual void SetMotionState(float MotionState) override { PropellerModel.SetRotationalSpeed(MotionState); };
+
+	virtual float GetAngularMomentum() const override { return PropellerModel.GetAngularMomentum(); };
+
+	// Build the propeller model (sharing the table of its data asset, if it has one).
+	virtual void InitializePropulsion() override;
+
+	virtual bool GetTrimPropulsor(SkyPhysCore::FTrimPropulsor& TrimPropulsor) override;
+
+	virtual const SkyPhysCore::FPropellerModel* GetPropellerModel() override;
+
 private:
 	UPROPERTY(EditAnywhere, Category = "Propeller Physics", Meta = (Tooltip = "Maximum propeller rotational speed (RPM)", AllowPrivateAccess = "true"))
 	float MaxN;
 
+	UPROPERTY(EditAnywhere, Category = "Propeller Physics", Meta = (Tooltip = "The CT and CP data of this type of propeller, shared with every other propeller which uses it.", AllowPrivateAccess = "true"))
+	UPropellerDataAsset* PropellerData = nullptr;
+
 	UPROPERTY(EditAnywhere, Category = "Propeller Physics", meta = (AllowPrivateAccess = "true"))
 	FPropellerPhysicsParameters PhysicsParameters;
 
-	// State Parameters
-	FPropellerState PropellerState;
+	// The engine-independent propeller model, built from the physics parameters.
+	SkyPhysCore::FPropellerModel PropellerModel;
+	bool bPhysicsParametersInitialized = false;
 
 	// Initialize the system
 	void InitializePropellerPhysics();
 
-	// Update the system parameters
-	void UpdatePropellerState(float Rho, FVector Vw);
-
-	// Calculate the forces generated by this propeller in the propeller frame
-	FVector CalculateForces(float CT);
-	// Thrust, T, forces on the propeller (ie. in the (0, 0, Vz)b direction)
-	FVector CalculateThrustForces(float CT);
-	// Side, H forces on the propeller (ie. in the (Vx, Vy, 0)b plane)
-	FVector CalculateSideForces(float T);
-	// Calculate the moments generated by this propeller in the propeller frame
-	FVector CalculateMoments(float CP, FVector SystemOmega);
-	// Calculate the aerodynamic moments on the propeller (ie. via CQ)
-	FVector CalculateAerodynamicMoments(float CP);
-	// Calculate the gyroscopic moments on the propeller
-	FVector CalculateGyroscopicMoments(FVector SystemOmega);
-
-	// Utilities
-
-	// Transform from the world frame to the propulsor body frame
-	FVector TransformFromWorldToBody(FVector WorldVector);
-	// Transform from the propulsor body frame to the world frame
-	FVector TransformFromBodyToWorld(FVector BodyVector);
-
-	// Get aerodynamic constants
-	//
-	// @param n Propeller speed (RPM)
-	// @param J Advance ratio (unitless)
-	//
-	// @return Aerodynamic Constants
-	FAerodynamicConstantResults GetAerodynamicConstants(float n, float J);
-
-	// Calculation Parameters
-	FPropellerPhysicsCalculationParameters PropellerPhysicsCalculationParameters;
-
 };
\ No newline at end of file
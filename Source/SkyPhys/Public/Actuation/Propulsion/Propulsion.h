@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "Common/Types.h"
+#include "SkyPhysCore/Actuation/PropulsorGeometry.h"
+#include "SkyPhysCore/Simulation/Trim.h"
 
 #include "Propulsion.generated.h"
 
@@ -25,31 +27,67 @@ public:
 	// @param DeltaTime: The amount of time since the last command signal (s)
 	virtual void ApplyActuatorCommand(const float dtCmd, const float DeltaTime) PURE_VIRTUAL(UPropulsionStaticMeshComponent::ApplyActuatorCommand, );
 
-	// Get Propulsion Forces and Moments in the world frame. 
+	// Get Propulsion Forces and Moments in the airframe body frame. 
 	// Note that the propulsion frame will generally be with the z-axis pointing down for a multirotor, or toward the back of the aircraft for a fixed wing. 
 	// Right hand rule will then determine what "clockwise" and "anticlockwise" mean. 
 	// "Positive thrust", or in other words actually actively generating thrust, will result in a negative Z thrust in the propulsor body frame. 
 	//
-	// Calculate the forces and moments generated by this propulsor in the world frame, at the origin of the propulsor frame (ie. you will need to get the moments yourself!)
+	// Calculate the forces and moments generated by this propulsor in the airframe body frame, at the origin of the propulsor frame (ie. you will need to get the moments yourself!)
+	// The propulsor velocity is derived from the airframe state and the cached body geometry (see GetBodyGeometry()).
 	// 
 	// @param Rho: Air density (kg/m^3)
-	// @param SystemOmega: Root body rotational velocity in the world frame (rad/s)
-	// @param Vw: Wind velocity in the world frame (NEU) (m/s)
+	// @param Vb: Airframe velocity in the body frame (m/s)
+	// @param Omegab: Airframe rotational velocity in the body frame (rad/s)
+	// @param Vwb: Wind velocity in the body frame (m/s)
 	// 
-	// @return The forces and moments generated by this propulsor in the world frame (N, Nm)
-	virtual FForcesAndMoments GetForcesAndMoments(float Rho, FVector Vw, FVector SystemOmega) PURE_VIRTUAL(UPropulsionStaticMeshComponent::GetForcesAndMoments, return FForcesAndMoments(););
+	// @return The forces and moments generated by this propulsor in the body frame (N, Nm)
+	virtual FForcesAndMoments GetForcesAndMoments(float Rho, FVector Vb, FVector Omegab, FVector Vwb) PURE_VIRTUAL(UPropulsionStaticMeshComponent::GetForcesAndMoments, return FForcesAndMoments(););
 
 	// Get the current motion state of the propulsor (eg. propeller speed in SI units for a propeller)
 	//
 	// @return The current motion state of the propulsion element
 	virtual float GetMotionState() PURE_VIRTUAL(UPropulsionStaticMeshComponent::GetMotionState, return 0.0f;);
 
+	// Set the current motion state of the propulsor (eg. when restoring a snapshot)
+	//
+	// @param MotionState: The motion state, as per GetMotionState()
+	virtual void SetMotionState(float MotionState) {};
+
+	// Get the angular momentum of the spinning parts of the propulsor about its spin axis, which couples into the airframe gyroscopically.
+	//
+	// @return The angular momentum (kg.m^2/s)
+	virtual float GetAngularMomentum() const { return 0.0f; };
+
+	// Build anything this propulsor needs before it's first stepped (eg. its propeller tables), so that none of that work (or its
+	// allocations) happens on the physics substeps. Called by the owning pawn at BeginPlay, on the game thread.
+	virtual void InitializePropulsion() {};
+
+	// Get this propulsor as seen by the trim solver (see SkyPhysCore::FTrimModel).
+	//
+	// @return False if this propulsor can't be trimmed (and so neither can its vehicle, see AFlyingPawn::CreateTrimModel)
+	virtual bool GetTrimPropulsor(SkyPhysCore::FTrimPropulsor& TrimPropulsor) { return false; };
+
+	// Get the propeller model of this propulsor (which it owns, and keeps up to date with its rotational speed), so that the owner can evaluate
+	// it along with its other propellers in a single vectorised pass (see SkyPhysCore::FRotorBank), rather than through GetForcesAndMoments().
+	//
+	// @return The propeller model, or null if this propulsor isn't a propeller
+	virtual const SkyPhysCore::FPropellerModel* GetPropellerModel() { return nullptr; };
+
 	// Associate an actuator component to this propulsion model.
 	// This actuator model will be responsible for managing the dynamics of the propulsion model.
 	//
 	// @param ActuatorModel: The actuator model to associate to this propulsion model.
 	void AssociateActuatorComponent(UActuatorModel* pActuatorModel);
 
+	// Capture where this propulsor sits relative to the owning actor's root component (ie. the CoG), in the body frame.
+	// This is done once at BeginPlay, and again whenever the attachment changes, so that we don't need to query component transforms every substep.
+	void UpdateBodyGeometry();
+
+	// Get the propulsor position and orientation relative to the CoG, in the body frame.
+	const SkyPhysCore::FPropulsorGeometry& GetBodyGeometry() const { return BodyGeometry; };
+
+	virtual void OnAttachmentChanged() override;
+
 protected:
 
 	// Methods
@@ -72,4 +110,7 @@ protected:
 
 	// The actuator model to be used (if specified, otherwise just straight feedthrough with no dynamics)
 	UActuatorModel* ActuatorModel;
+
+	// Position and orientation relative to the CoG, in the body frame.
+	SkyPhysCore::FPropulsorGeometry BodyGeometry;
 };
\ No newline at end of file
@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Common/Types.h"
+#include "SkyPhysCore/Common/CoreTypes.h"
+
+// Conversions between UE4 types and the engine-independent SkyPhysCore types.
+// Note that these do not change frames or units, they only change the type.
+namespace SkyPhysConversions
+{
+	inline SkyPhysCore::FVector3 ToCore(const FVector& Vector)
+	{
+		return SkyPhysCore::FVector3(Vector.X, Vector.Y, Vector.Z);
+	}
+
+	inline FVector FromCore(const SkyPhysCore::FVector3& Vector)
+	{
+		return FVector(Vector.x(), Vector.y(), Vector.z());
+	}
+
+	inline SkyPhysCore::FForcesAndMoments ToCore(const FForcesAndMoments& ForcesAndMoments)
+	{
+		return SkyPhysCore::FForcesAndMoments(ToCore(ForcesAndMoments.Forces), ToCore(ForcesAndMoments.Moments));
+	}
+
+	inline FForcesAndMoments FromCore(const SkyPhysCore::FForcesAndMoments& ForcesAndMoments)
+	{
+		return FForcesAndMoments(FromCore(ForcesAndMoments.Forces), FromCore(ForcesAndMoments.Moments));
+	}
+
+	// Get the rotation matrix of a UE4 quaternion, such that ToCoreRotationMatrix(Q) * V == Q.RotateVector(V).
+	// Unlike FRotator, this doesn't need any trig.
+	inline SkyPhysCore::FMatrix3 ToCoreRotationMatrix(const FQuat& Q)
+	{
+		return SkyPhysCore::FQuaternion(Q.W, Q.X, Q.Y, Q.Z).toRotationMatrix();
+	}
+
+	// Get the UE4 quaternion of a rotation matrix (the inverse of ToCoreRotationMatrix).
+	inline FQuat FromCoreRotationMatrix(const SkyPhysCore::FMatrix3& R)
+	{
+		const SkyPhysCore::FQuaternion Q(R);
+		return FQuat(Q.x(), Q.y(), Q.z(), Q.w());
+	}
+}
@@ -159,12 +159,6 @@ struct FFixedWingActuatorCommandState
 	float dt = 0.0f; // Propulsion level (Unitless)
 };
 
-// Calculation Structs
-struct FAerodynamicStallCalculationParameters
-{
-	float SigmaAlpha = 0.0f;
-};
-
 // ************************************************ //
 
 UCLASS(Abstract, NotBlueprintable)
@@ -184,6 +178,9 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Aerodynamic Parameters")
 	FAerodynamicStallParameters AerodynamicStallParameters;
 
+	UPROPERTY(EditAnywhere, Category = "Trim", Meta = (Tooltip = "The largest control surface deflection the trim solver may use (deg)", ClampMin = "0.0"))
+	float MaxTrimControlSurfaceDeflection = 25.0f;
+
 protected:
 
 	// Components
@@ -196,23 +193,18 @@ protected:
 	// Called to update the current actuator state
 	virtual void UpdateActuatorState(float DeltaTime) override;
 
-	// Called to calculate forces and moments for this body
-	virtual FForcesAndMoments CalculateAirframeForcesAndMoments() override;
-	
-	// Augment our forces in the body frame
-	virtual float CalculateAdditionalCDParameters() const override;
-	virtual float CalculateAdditionalCLParameters() const override;
-	virtual float CalculateAdditionalCYParameters() const override;
+	// Add our control derivatives and stall model to the airframe aerodynamics model
+	virtual void ConfigureAirframeModel(SkyPhysCore::FAirframeModel& Model) const override;
+
+	// Our control surfaces can be used to trim
+	virtual void ConfigureTrimModel(SkyPhysCore::FTrimModel& Model) const override;
 
-	// Augment our moments in the body frame
-	virtual float CalculateAdditionalClParameters() const override;
-	virtual float CalculateAdditionalCmParameters() const override;
-	virtual float CalculateAdditionalCnParameters() const override;
+	// Our actuator states and commands are part of the pawn snapshot
+	virtual void SaveControlSnapshot(FFlightControlSnapshot& Snapshot) const override;
+	virtual void RestoreControlSnapshot(const FFlightControlSnapshot& Snapshot) override;
 
-	// Stall Modelling
-	void UpdateAerodynamicStallCalculationParameters();
-	virtual FVector2D CalculateAdjustedCDAlphaCLAlphaForStall(float CDAlpha, float CLAlpha) const override;
-	virtual float CalculateAdjustedCmAlphaForStall(float CmAlpha) const override;
+	// Our control surface deflections augment the airframe forces and moments
+	virtual SkyPhysCore::FControlSurfaceDeflections GetControlSurfaceDeflections() const override;
 
 	// Input Calculations
 
@@ -222,6 +214,4 @@ protected:
 	// Parameters
 	FFixedWingActuatorState ActuatorState;
 	FFixedWingActuatorCommandState ActuatorCommandState;
-
-	FAerodynamicStallCalculationParameters AerodynamicStallCalculationParameters;
 };
@@ -75,6 +75,9 @@ protected:
 	// Called to update the actuator animation state
 	virtual void UpdateActuatorAnimationState() override;
 
+	// Flying wings have no rudder
+	virtual void ConfigureAirframeModel(SkyPhysCore::FAirframeModel& Model) const override;
+
 	// Calculate Elevator Angle (expected Value of -1 -> 1)
 	virtual void ApplyPitchCommand(float Value) override;
 	// Calculate Aileron Angle (expected Value of -1 -> 1)
@@ -97,6 +97,9 @@ protected:
 	// Called to update the actuator animation state
 	virtual void UpdateActuatorAnimationState() override;
 
+	// Select the V-tail airframe configuration
+	virtual void ConfigureAirframeModel(SkyPhysCore::FAirframeModel& Model) const override;
+
 	// Calculate Elevator Angle (expected Value of -1 -> 1)
 	virtual void ApplyPitchCommand(float Value) override;
 	// Calculate Aileron Angle (expected Value of -1 -> 1)
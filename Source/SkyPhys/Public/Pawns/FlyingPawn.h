@@ -3,9 +3,18 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "Eigen/Eigen"
 #include "GameFramework/Pawn.h"
 #include "Common/Types.h"
+#include "SkyPhysCore/Actuation/RotorBank.h"
+#include "SkyPhysCore/Aerodynamics/AirframeKernel.h"
+#include "SkyPhysCore/Aerodynamics/AirframeModel.h"
+#include "SkyPhysCore/Dynamics/RigidBodyModel.h"
+#include "SkyPhysCore/Common/StateHash.h"
+#include "SkyPhysCore/Simulation/AdaptiveStep.h"
+#include "SkyPhysCore/Simulation/MultiRateScheduler.h"
+#include "SkyPhysCore/Simulation/Trim.h"
+#include "SkyPhysCore/Simulation/VehicleSnapshot.h"
+#include "Turbulence/TurbulenceModel.h"
 
 #include "FlyingPawn.generated.h"
 
@@ -13,6 +22,7 @@
 class UTurbulenceModel;
 class UPropulsionStaticMeshComponent;
 class UActuatorModel;
+class UFlightPhysicsSubsystem;
 
 // ################# Aerodynamics ################# //
 
@@ -172,10 +182,6 @@ struct FSystemCharacteristics
 
 	UPROPERTY(EditAnywhere, Meta = (DisplayName = "Ixz/Izx (kg.m^2)"))
 	float Ixz; // Assumed same as Izx
-
-	// We will pre-calculate J and JInverse as these aren't going to change during runtime.
-	Eigen::Matrix3d J;
-	Eigen::Matrix3d JInverse;
 };
 
 // ################################################ //
@@ -222,18 +228,88 @@ struct FWeatherSetup
 
 // ################################################ //
 
-// State Structs
+// ################## Integration ################# //
+
+// Mirrors SkyPhysCore::EIntegrationMethod (in the same order)
+UENUM()
+enum class EFlightIntegrationMethod : uint8
+{
+	SemiImplicitEuler	UMETA(DisplayName = "Semi-Implicit Euler"),
+	Heun				UMETA(DisplayName = "Heun (2nd Order)"),
+	RK4					UMETA(DisplayName = "RK4 (4th Order)")
+};
+
+// Adaptive substepping parameters (see SkyPhysCore::FAdaptiveStepParameters)
+USTRUCT()
+struct FFlightAdaptiveSubstepParameters
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Meta = (DisplayName = "Min Step (s)", ClampMin = "0.0001"))
+	float MinStep = 0.0005f;
+
+	UPROPERTY(EditAnywhere, Meta = (DisplayName = "Max Step (s)", ClampMin = "0.0001"))
+	float MaxStep = 0.02f;
+
+	UPROPERTY(EditAnywhere, Meta = (Tooltip = "Allowed local error estimate per step, on the linear (m/s) and angular (rad/s) velocities", ClampMin = "0.0"))
+	float Tolerance = 0.01f;
 
-struct FAirspeedState
+	UPROPERTY(EditAnywhere, Meta = (Tooltip = "Step limit as a fraction of the fastest time constant of the vehicle (aerodynamic damping, actuators, turbulence, gyroscopic coupling)", ClampMin = "0.01"))
+	float StabilityFactor = 0.5f;
+};
+
+// How often each model is updated, relative to the physics substeps (see SkyPhysCore::FMultiRateScheduler). A period of 0 updates a model on
+// every substep, and a model is otherwise updated on the substep nearest to its period (covering all the time since its last update).
+USTRUCT()
+struct FFlightMultiRateParameters
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Meta = (DisplayName = "Turbulence Period (s)", ClampMin = "0.0", Tooltip = "Time between turbulence updates. The turbulence changes on a ~0.1s scale, so rarely needs updating every substep."))
+	float TurbulencePeriod = 0.0f;
+
+	UPROPERTY(EditAnywhere, Meta = (Tooltip = "Interpolate the turbulence between its updates rather than holding it (which delays it by one period)."))
+	bool bInterpolateTurbulence = false;
+
+	UPROPERTY(EditAnywhere, Meta = (DisplayName = "Actuator Period (s)", ClampMin = "0.0", Tooltip = "Time between actuator updates. Their outputs are held in between."))
+	float ActuatorPeriod = 0.0f;
+
+	UPROPERTY(EditAnywhere, Meta = (DisplayName = "Aerodynamics Period (s)", ClampMin = "0.0", Tooltip = "Time between updates of the airframe and propulsion forces and moments. These are held in between (including over the intermediate stages of the integration method)."))
+	float AerodynamicsPeriod = 0.0f;
+};
+
+// Statistics on the steps chosen by adaptive substepping (mirrors SkyPhysCore::FAdaptiveStepStats)
+USTRUCT(BlueprintType)
+struct FFlightAdaptiveStepStats
 {
-	FVector Vwb = FVector(0.0f); // Wind speed (m/s) in the body frame
-	FVector Vab = FVector(0.0f); // Airspeed (m/s) in the body frame (ie. Vb - Vwb)
+	GENERATED_BODY()
 
-	float Va = 0.0f; // Airspeed (m/s)
-	float alpha = 0.0f; // Angle of attack (rad)
-	float beta = 0.0f; // Sideslip angle (rad)
+	UPROPERTY(BlueprintReadOnly)
+	int32 NumSteps = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 NumStiffnessLimitedSteps = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	float SimulatedTime = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float MinStepTaken = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float MaxStepTaken = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float MeanStep = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float LastErrorEstimate = 0.0f;
 };
 
+// ################################################ //
+
+// State Structs
+
 struct FAtmosphericConditionsState
 {
 	FVector VwLowAltitude = FVector(0.0f); // Low altitude wind speed (m/s) in world frame
@@ -248,19 +324,169 @@ struct FSystemState
 	FVector Position = FVector(0.0f); // (N, E, U)
 	
 	// Rotations
-	FRotator Ruw = FRotator(); // Rotator from unreal to world frame
-	FRotator Rwu = FRotator(); // Rotator from world to unreal frame
+	// DCM from the body frame (FRD) to the world frame (NEU), calculated once per substep. This includes the flip between the 
+	// unreal (Z up) and body (Z down) frames, so its transpose goes straight from the world frame to the body frame.
+	SkyPhysCore::FMatrix3 Rbw = SkyPhysCore::FMatrix3::Identity();
+};
+
+// Everything a physics substep reads or writes, packed into one cache line aligned block (rather than spread through the actor, which is
+// mostly editor properties and actor bookkeeping). The settings and models are built from the editor properties at BeginPlay, after which
+// only the state changes. Ordered by how often it is touched: the per-substep state first, then the settings, then the models.
+struct alignas(64) FFlightSimBlock
+{
+	// State, as of the current substep
+	FSystemState SystemState;
+	SkyPhysCore::FAirspeedState AirspeedState;
+	FAtmosphericConditionsState AtmosphericConditionsState;
+
+	// Models updated slower than the substeps hold their outputs in between: the previous and latest turbulence (body frame, m/s) and the
+	// airframe and propulsion forces and moments (body frame, at the CoG) of their latest update.
+	FVector PreviousTurbulence = FVector(0.0f);
+	FVector LatestTurbulence = FVector(0.0f);
+	FForcesAndMoments HeldForcesAndMoments;
+
+	// Velocity increments calculated for the current substep (in the unreal world frame, as expected by the physics body), waiting to be applied.
+	FVector SubstepLinearVelocityIncrement = FVector(0.0f); // (cm/s)
+	FVector SubstepAngularVelocityIncrement = FVector(0.0f); // (rad/s)
+
+	// Whether we are in native free flight, in which case FreeFlightState is the rigid body state (rather than the physics body).
+	bool bInFreeFlight = false;
+	SkyPhysCore::FRigidBodyState FreeFlightState;
+
+	// Settings
+	SkyPhysCore::EIntegrationMethod IntegrationMethod = SkyPhysCore::EIntegrationMethod::SemiImplicitEuler;
+	bool bEnableAdaptiveSubstepping = false;
+	bool bInterpolateTurbulence = false;
+	UTurbulenceModel* TurbulenceModel = nullptr; // Only set if turbulence is enabled (and owned by the pawn's TurbulenceModel property)
+	SkyPhysCore::FMultiRateScheduler Scheduler; // Runs the turbulence, actuators and aerodynamics at their own periods
+
+	// Models. The airframe kernel is selected once (for the configuration and stall model), rather than on every call.
+	SkyPhysCore::FAirframeKernelFunction AirframeKernel = nullptr;
+	SkyPhysCore::FAirframeModel AirframeModel;
+	SkyPhysCore::FRigidBodyModel RigidBodyModel;
+	SkyPhysCore::FAdaptiveStepController StepController; // Chooses the internal step sizes when adaptive substepping is enabled
+
+	// The propellers among our propulsors, evaluated together in one vectorised pass, along with their models and geometry (which are owned
+	// by their components, and so always current).
+	SkyPhysCore::FRotorBank RotorBank;
+	TArray<const SkyPhysCore::FPropellerModel*, TInlineAllocator<8>> RotorPropellers;
+	TArray<const SkyPhysCore::FPropulsorGeometry*, TInlineAllocator<8>> RotorGeometries;
+};
+
+// A flight condition to trim for (see SkyPhysCore::FTrimCondition): steady, straight, wings level flight in still air.
+USTRUCT(BlueprintType)
+struct FFlightTrimCondition
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (Tooltip = "Airspeed (m/s). 0 trims for hover.", ClampMin = "0.0"))
+	float Airspeed = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (Tooltip = "Climb angle (deg)"))
+	float FlightPathAngle = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (Tooltip = "Air density (kg/m^3), ie. the altitude", ClampMin = "0.0"))
+	float AirDensity = 1.225f;
+};
+
+// A trimmed flight condition, and the linear model about it (see SkyPhysCore::FTrimResult and SkyPhysCore::FLinearModel).
+USTRUCT(BlueprintType)
+struct FFlightTrimPoint
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	bool bConverged = false;
+
+	UPROPERTY(BlueprintReadOnly, Meta = (Tooltip = "The largest residual acceleration (m/s^2, rad/s^2) or climb rate error (m/s) at the solution"))
+	float Residual = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Meta = (Tooltip = "Angle of attack (deg)"))
+	float Alpha = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Meta = (Tooltip = "Sideslip angle (deg)"))
+	float Beta = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Meta = (Tooltip = "Pitch attitude (deg)"))
+	float Pitch = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Meta = (Tooltip = "Control surface deflections (deg)"))
+	float Elevator = 0.0f;
+	UPROPERTY(BlueprintReadOnly)
+	float Aileron = 0.0f;
+	UPROPERTY(BlueprintReadOnly)
+	float Rudder = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Meta = (Tooltip = "Propeller speeds (rad/s)"))
+	TArray<float> PropulsorSpeeds;
+
+	// Linear model about the trimmed point, in SI units and radians. States are (u, v, w, p, q, r, phi, theta, psi, N, E, D) and inputs are
+	// (de, da, dr, propulsor speeds). A and B are row major.
+	UPROPERTY(BlueprintReadOnly)
+	int32 NumStates = 0;
+	UPROPERTY(BlueprintReadOnly)
+	int32 NumInputs = 0;
+	UPROPERTY(BlueprintReadOnly)
+	TArray<float> A;
+	UPROPERTY(BlueprintReadOnly)
+	TArray<float> B;
 };
 
-// Calculation Structs
+// The command and actuator state owned by a pawn subclass (eg. the current commands), packed as plain values.
+struct FFlightControlSnapshot
+{
+	static constexpr int32 MaxValues = 16;
+	float Values[MaxValues];
+};
 
-struct FAerodynamicCalculationParameters
+// The complete dynamic state of an AFlyingPawn (the physics body, flight state, actuators, propulsors, turbulence and the pawn's own
+// commands), in one contiguous, trivially copyable block. Saving or restoring one takes microseconds, so many what-if branches can be forked
+// from one point without respawning actors. The model parameters aren't included, so a snapshot can only be restored to the pawn it was
+// saved from (or an identical one).
+struct FFlightPawnSnapshot
 {
-	float DynamicPressure = 0.0f; // Current dynamic pressure of the aircraft (0.5 * rho * Va^2)
-	float cOver2Va = 0.0f;
-	float bOver2Va = 0.0f;
+	static constexpr int32 MaxActuators = 16;
+	static constexpr int32 MaxPropulsors = 8;
+
+	// Physics body (unreal world frame, cm and cm/s)
+	SkyPhysCore::FSnapshotVector3 BodyLocation;
+	SkyPhysCore::FSnapshotQuaternion BodyRotation;
+	SkyPhysCore::FSnapshotVector3 BodyLinearVelocity;
+	SkyPhysCore::FSnapshotVector3 BodyAngularVelocity; // (rad/s)
+
+	// Flight state, as of the last substep
+	SkyPhysCore::FSnapshotVector3 Vb;
+	SkyPhysCore::FSnapshotVector3 Omegab;
+	SkyPhysCore::FSnapshotVector3 Position;
+	float Rbw[9];
+	SkyPhysCore::FSnapshotVector3 Vwb;
+	SkyPhysCore::FSnapshotVector3 Vab;
+	float Va;
+	float alpha;
+	float beta;
+	SkyPhysCore::FSnapshotVector3 VwLowAltitude;
+	SkyPhysCore::FSnapshotVector3 Vw;
+	float rho;
+
+	// Actuators and propulsors (in component order)
+	int32 NumActuators;
+	SkyPhysCore::FActuatorSnapshot Actuators[MaxActuators];
+	int32 NumPropulsors;
+	float PropulsorMotionStates[MaxPropulsors];
+
+	FTurbulenceSnapshot Turbulence;
+	FFlightControlSnapshot Control;
+
+	// Multi-rate scheduling (when each model last ran, but not the periods), and the outputs held in between
+	SkyPhysCore::FMultiRateSchedulerSnapshot Scheduler;
+	SkyPhysCore::FSnapshotVector3 PreviousTurbulence;
+	SkyPhysCore::FSnapshotVector3 LatestTurbulence;
+	SkyPhysCore::FSnapshotVector3 HeldForces;
+	SkyPhysCore::FSnapshotVector3 HeldMoments;
 };
 
+static_assert(std::is_trivially_copyable<FFlightPawnSnapshot>::value, "FFlightPawnSnapshot must stay memcpy-able");
+
 // This class is abstract and is intended to serve as a base, but should not be used directly.
 UCLASS(Abstract, NotBlueprintable)
 class SKYPHYS_API AFlyingPawn : public APawn
@@ -271,11 +497,71 @@ public:
 	// Sets default values for this pawn's properties
 	AFlyingPawn();
 
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
+	// Physics substep tick, called by the UFlightPhysicsSubsystem for every physics substep.
+	// This is equivalent to calling SubstepReadState(), SubstepCalculate() and then SubstepApply().
+	// None of these allocate: every model is built at BeginPlay, and everything a substep needs is held by value (see FAllocationTracker,
+	// which checks the same step path headless). Anything added to the substep path must keep to this.
+	void SubstepTick(float DeltaTime);
+
+	// The three phases of a physics substep, which the UFlightPhysicsSubsystem runs over all vehicles in turn.
+
+	// Read our current state from the physics body. This reads from the physics engine, so is run serially.
+	void SubstepReadState();
+
+	// Update our state and calculate the forces and moments for this substep. This only touches this vehicle, so can run in parallel with other vehicles.
+	void SubstepCalculate(float DeltaTime);
+
+	// Apply the velocity increments calculated in SubstepCalculate to the physics body. This writes to the physics engine, so is run serially.
+	void SubstepApply(float DeltaTime);
+
+	// Get the body instance which the flight physics are applied to.
+	FBodyInstance* GetPhysicsBody() const { return PhysicsBody; };
 
-	// Physics substep tick
-	virtual void SubstepTick(float DeltaTime, FBodyInstance* BodyInstance);
+	// Seed every random element of the vehicle (ie. the turbulence), each from its own stream of the given seed.
+	// As with the state hash and snapshots, this covers the turbulence model only if it was enabled when the pawn began play.
+	void SetRandomSeed(uint64 Seed);
+
+	// Add the complete dynamic state of the vehicle (as read from the physics body at the start of this substep, plus the actuators,
+	// propulsors, wind and turbulence) to a state hash.
+	void AddToStateHash(SkyPhysCore::FStateHash& Hash) const;
+
+	// Save the complete dynamic state of the pawn.
+	//
+	// @return False (leaving the snapshot incomplete) if the pawn has more actuators or propulsors than a snapshot can hold
+	bool SaveSnapshot(FFlightPawnSnapshot& Snapshot) const;
+
+	// Restore the complete dynamic state of the pawn (teleporting the physics body), from a snapshot saved from this pawn.
+	//
+	// @return False (leaving the pawn unchanged) if the snapshot doesn't match the actuators and propulsors of this pawn
+	bool RestoreSnapshot(const FFlightPawnSnapshot& Snapshot);
+
+	// Build the trim model of this vehicle, from the models set up at BeginPlay.
+	//
+	// @param Model: Set to the trim model
+	//
+	// @return False (logging an error) if any of the propulsors can't be trimmed (see UPropulsionStaticMeshComponent::GetTrimPropulsor)
+	bool CreateTrimModel(SkyPhysCore::FTrimModel& Model) const;
+
+	// Trim the vehicle at each condition (in parallel) and linearise about each trimmed point. This doesn't touch the vehicle's own state.
+	// If the vehicle can't be trimmed (see CreateTrimModel), no points are returned.
+	UFUNCTION(BlueprintCallable, Category = "Flight Physics|Trim")
+	TArray<FFlightTrimPoint> TrimSweep(const TArray<FFlightTrimCondition>& Conditions) const;
+
+	// Get the statistics on the steps chosen by adaptive substepping (since BeginPlay).
+	UFUNCTION(BlueprintCallable, Category = "Flight Physics")
+	FFlightAdaptiveStepStats GetAdaptiveStepStats() const;
+
+	// Enter or leave native free flight (see bEnableNativeFreeFlight), depending on whether there is any geometry near the vehicle.
+	// This switches the physics body between simulated and kinematic, so is called on the game thread, once per frame before physics.
+	void UpdateFreeFlight(float DeltaTime);
+
+	// Move the (kinematic) physics body to our free flight state. This moves the airframe component, so is called on the game thread,
+	// once per frame after physics.
+	void ApplyFreeFlightTransform();
+
+	// Whether SkyPhys is integrating the rigid body itself (driving the physics body kinematically), rather than PhysX.
+	UFUNCTION(BlueprintCallable, Category = "Flight Physics")
+	bool IsInFreeFlight() const { return SimBlock.bInFreeFlight; };
 
 private:
 	// Components
@@ -284,14 +570,14 @@ private:
 
 	// Methods
 
-	// Find and assign the UDS Weather Actor (if it exists).
-	void SetupWeather();
+	// Build the simulation block (settings and engine-independent models) from our editor properties
+	void BuildSimBlock();
 
-	// Pre-calculate system characteristics
-	void PreCalculateSystemCharacteristics();
+	// Gather the propellers among our propulsors into the rotor bank, leaving the rest (UnbankedPropulsors) to be evaluated one at a time.
+	void BuildRotorBank();
 
 	// Update our system state
-	// This gets called in SubstepStateUpdate()
+	// This gets called in SubstepReadState()
 	void UpdateCurrentSystemState();
 
 	// Update our wind speed (in the world frame), and our density. As well as any other atmospheric parameters.
@@ -302,18 +588,51 @@ private:
 	// This gets called in SubstepStateUpdate()
 	void UpdateAirspeedState();
 
-	// Update our Aerodynamic Calculation Parameters
-	void UpdateAerodynamicCalculationParameters();
+	// Calculate the velocity increments over this substep from the forces and moments (body frame, at the CoG), using our integration method.
+	// This gets called in SubstepCalculate()
+	void CalculateKinematics(const FForcesAndMoments& ForcesAndMoments, float DeltaTime);
+
+	// Integrate the state over DeltaTime in as many internal steps as the step controller chooses, with the forces and moments at the start.
+	// The actuators, wind and density are held over the substep, as they are for the intermediate stages.
+	void IntegrateAdaptive(SkyPhysCore::FRigidBodyState& State, const FForcesAndMoments& ForcesAndMoments, const SkyPhysCore::FVector3& Gravity, float DeltaTime);
+
+	// Get the fastest characteristic rate (ie. the inverse of the fastest time constant) of this vehicle at its current state (1/s).
+	float CalculateMaxCharacteristicRate() const;
 
-	// Apply Kinematics
-	void ApplyKinematics(FVector Forces, FVector Moments, float DeltaTime);
+	// Calculate the airframe and propulsion forces and moments at an intermediate integration stage (with the actuators, wind and density held).
+	// If the aerodynamics aren't due on this substep, these are the held forces and moments of their latest update instead.
+	FForcesAndMoments CalculateStageForcesAndMoments(const SkyPhysCore::FRigidBodyState& Stage);
+
+	// Apply the velocity increments to the physics body
+	// This gets called in SubstepApply()
+	void ApplyKinematics();
+
+	// Hand the rigid body over from PhysX to our own integration, or back again.
+	void EnterFreeFlight();
+	void ExitFreeFlight();
+
+	// Whether any geometry (including other vehicles) is within our bounds, plus the free flight clearance and the distance we could
+	// cover over the next two frames.
+	bool IsNearGeometry(float DeltaTime) const;
+
+	// Express our system state as a core rigid body state (world frame NED, m), and the reverse.
+	SkyPhysCore::FRigidBodyState GetRigidBodyState() const;
+	void SetSystemState(const SkyPhysCore::FRigidBodyState& State);
+
+	// The physics body transform and velocities (unreal world frame, cm) of a core rigid body state.
+	FTransform GetBodyTransform(const SkyPhysCore::FRigidBodyState& State) const;
+	void GetBodyVelocities(const SkyPhysCore::FRigidBodyState& State, FVector& LinearVelocity, FVector& AngularVelocity) const;
 
 	// Parameters
 	FBodyInstance* PhysicsBody;
-	AActor* UDSWeatherActor;
 
-	// Custom Physics Delegator
-	FCalculateCustomPhysics CalculateCustomPhysics;
+	// The subsystem which steps our physics (and provides the shared atmosphere).
+	UPROPERTY()
+	UFlightPhysicsSubsystem* PhysicsSubsystem;
+
+	// All the actuators attached to the system (which bound the adaptive substep size).
+	TInlineComponentArray<UActuatorModel*> Actuators;
+
 
 protected:
 
@@ -326,6 +645,24 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Geometric Parameters")
 	FGeometricCharacteristics GeometricCharacteristics;
 
+	UPROPERTY(EditAnywhere, Category = "General Setup", Meta = (Tooltip = "How the flight dynamics are integrated over each physics substep. The higher order methods re-evaluate the forces and moments at intermediate stages, so cost more per substep, but stay accurate (and stable) with much larger substeps."))
+	EFlightIntegrationMethod IntegrationMethod = EFlightIntegrationMethod::SemiImplicitEuler;
+
+	UPROPERTY(EditAnywhere, Category = "General Setup|Adaptive Substepping", Meta = (Tooltip = "Split each physics substep into internal steps sized for this vehicle, from an error estimate and its stiffness. Benign flight then takes one step per substep, and aggressive flight several smaller ones."))
+	bool bEnableAdaptiveSubstepping = false;
+
+	UPROPERTY(EditAnywhere, Category = "General Setup|Adaptive Substepping", Meta = (EditCondition = "bEnableAdaptiveSubstepping"))
+	FFlightAdaptiveSubstepParameters AdaptiveSubstepParameters;
+
+	UPROPERTY(EditAnywhere, Category = "General Setup|Multi-Rate", Meta = (Tooltip = "Update the turbulence, actuators and aerodynamics at their own periods rather than on every substep, so the CPU time goes to the dynamics which need it."))
+	FFlightMultiRateParameters MultiRateParameters;
+
+	UPROPERTY(EditAnywhere, Category = "General Setup|Free Flight", Meta = (Tooltip = "While there is no geometry near the vehicle, integrate the rigid body here and drive the physics body kinematically, rather than writing velocities to PhysX and reading them back every substep. PhysX takes over again as soon as anything comes near."))
+	bool bEnableNativeFreeFlight = false;
+
+	UPROPERTY(EditAnywhere, Category = "General Setup|Free Flight", Meta = (EditCondition = "bEnableNativeFreeFlight", ClampMin = "0.0", Tooltip = "Clearance (cm) beyond the vehicle's bounds (and the distance it could cover over the next two frames) within which any geometry hands the vehicle back to PhysX."))
+	float FreeFlightClearance = 500.0f;
+
 	UPROPERTY(EditAnywhere, Category = "Aerodynamic Parameters")
 	FAerodynamicCoefficients AerodynamicCoefficients; // All flying systems should have a similar set of aerodynamic coefficients/derivatives. Zero out the ones you don't need.
 
@@ -346,11 +683,14 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	// Called when the game ends or when destroyed
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	// Apply any state updates necessary prior to forces and moments calculation.
 	virtual void SubstepStateUpdate(float DeltaTime);
 
 	// Update the current actuator state (based on the current actuator command, which will be calculated/applied seperately)
-	// This gets called in SubstepStateUpdate()
+	// This gets called in SubstepStateUpdate(), only when the actuators are due (with the time since their last update)
 	virtual void UpdateActuatorState(float DeltaTime) {};
 
 	// Update the current actuator animation state (based on the current actuator state)
@@ -358,44 +698,26 @@ protected:
 
 	// Calculate the Airframe Forces and Moments (excludes all propulsion elements)
 	// 
-	// @return The forces and moments generated by the airframe, to be applied at the CoG, expressed in the world frame.
+	// @return The forces and moments generated by the airframe, to be applied at the CoG, expressed in the body frame.
 	virtual FForcesAndMoments CalculateAirframeForcesAndMoments();
 
-	// ######### Airframe Aerodynamic Forces ########## //
-
-	// Calculate our airframe aerodynamic forces in the body frame
-	virtual FVector CalculateAirframeAerodynamicForces() const;
-
-	// Adjust CDAlpha and CLAlpha with a stall model (if you'd like to implement one - otherwise nothing happens).
-	virtual FVector2D CalculateAdjustedCDAlphaCLAlphaForStall(float CDAlpha, float CLAlpha) const { return FVector2D(CDAlpha, CLAlpha); };
-
-	// Calculate any additional CD, CL, CY parameters to be added to the total
-	// This will usually be due to things like control surfaces etc. as all body parameters are accounted for.
-	virtual float CalculateAdditionalCDParameters() const { return 0.0f; };
-	virtual float CalculateAdditionalCLParameters() const { return 0.0f; };
-	virtual float CalculateAdditionalCYParameters() const { return 0.0f; };
+	// Configure the airframe aerodynamics model (called once at BeginPlay).
+	// Override this to add any additional aerodynamic parameters (eg. control derivatives, stall model), and to select the airframe configuration.
+	virtual void ConfigureAirframeModel(SkyPhysCore::FAirframeModel& Model) const;
 
-	// ################################################ //
+	// Add anything the base class doesn't know about (eg. the control surface limits) to the trim model.
+	virtual void ConfigureTrimModel(SkyPhysCore::FTrimModel& Model) const {};
 
-	// ######## Airframe Aerodynamic Moments ########## //
+	// Save or restore the command and actuator state owned by a subclass (see SaveSnapshot()).
+	virtual void SaveControlSnapshot(FFlightControlSnapshot& Snapshot) const {};
+	virtual void RestoreControlSnapshot(const FFlightControlSnapshot& Snapshot) {};
 
-	// Calculate our airframe aerodynamic moments in the body frame
-	virtual FVector CalculateAirframeAerodynamicMoments() const;
-
-	// Adjust CmAlpha with a stall model (if you'd like to implement one - otherwise nothing happens).
-	virtual float CalculateAdjustedCmAlphaForStall(float CmAlpha) const { return CmAlpha; };
-
-	// Calculate any additional Cl, Cm, Cn parameters to be added to the total
-	// This will usually be due to things like control surfaces etc. as all body parameters are accounted for.
-	virtual float CalculateAdditionalClParameters() const { return 0.0f; };
-	virtual float CalculateAdditionalCmParameters() const { return 0.0f; };
-	virtual float CalculateAdditionalCnParameters() const { return 0.0f; };
-
-	// ################################################ //
+	// Get the current control surface deflections, which feed into the airframe aerodynamics model.
+	virtual SkyPhysCore::FControlSurfaceDeflections GetControlSurfaceDeflections() const { return SkyPhysCore::FControlSurfaceDeflections(); };
 
 	// Calculate the Propulsion Forces and Moments
 	// 
-	// @return The forces and moments generated by all propulsion elements, to be applied at the CoG, expressed in the world frame.
+	// @return The forces and moments generated by all propulsion elements, to be applied at the CoG, expressed in the body frame.
 	virtual FForcesAndMoments CalculatePropulsionForcesAndMoments();
 
 	// Input Calculations
@@ -418,12 +740,8 @@ protected:
 
 	// Components
 	TInlineComponentArray<UPropulsionStaticMeshComponent*> Propulsors; // All the propulsive elements attached to the system.
+	TInlineComponentArray<UPropulsionStaticMeshComponent*> UnbankedPropulsors; // Those which aren't in the rotor bank (ie. aren't propellers).
 
-	// State
-	FSystemState SystemState;
-	FAirspeedState AirspeedState;
-	FAtmosphericConditionsState AtmosphericConditionsState;
-
-	// Calculation State
-	FAerodynamicCalculationParameters AerodynamicCalculationParameters;
+	// The state, settings and models used by the substeps (see FFlightSimBlock)
+	FFlightSimBlock SimBlock;
 };
@@ -77,6 +77,10 @@ protected:
 	// Called to update the current actuator state
 	virtual void UpdateActuatorState(float DeltaTime) override;
 
+	// Our commands are part of the pawn snapshot
+	virtual void SaveControlSnapshot(FFlightControlSnapshot& Snapshot) const override;
+	virtual void RestoreControlSnapshot(const FFlightControlSnapshot& Snapshot) override;
+
 	// Input Calculations
 
 	// Calculate Elevator Angle (expected Value of -1 -> 1)
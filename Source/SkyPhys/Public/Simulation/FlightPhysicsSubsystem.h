@@ -0,0 +1,305 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Pawns/FlyingPawn.h"
+
+#include "FlightPhysicsSubsystem.generated.h"
+
+DECLARE_STATS_GROUP(TEXT("SkyPhys"), STATGROUP_SkyPhys, STATCAT_Advanced);
+
+// Timing of the flight physics substeps, updated every substep.
+USTRUCT(BlueprintType)
+struct FFlightPhysicsSubstepStats
+{
+	GENERATED_BODY()
+
+	// Number of substeps run in the last frame
+	UPROPERTY(BlueprintReadOnly)
+	int32 NumSubstepsLastFrame = 0;
+
+	// Number of vehicles stepped in the last substep
+	UPROPERTY(BlueprintReadOnly)
+	int32 NumVehicles = 0;
+
+	// Simulated time of the last substep (s)
+	UPROPERTY(BlueprintReadOnly)
+	float LastSubstepDeltaTime = 0.0f;
+
+	// Wall clock time taken to step all vehicles in the last substep (ms)
+	UPROPERTY(BlueprintReadOnly)
+	float LastSubstepDurationMs = 0.0f;
+
+	// Wall clock time taken to step all vehicles over the last frame (ms)
+	UPROPERTY(BlueprintReadOnly)
+	float LastFrameDurationMs = 0.0f;
+
+	// Worst substep wall clock time since the start of play (ms)
+	UPROPERTY(BlueprintReadOnly)
+	float MaxSubstepDurationMs = 0.0f;
+};
+
+// Settings for lockstep mode (see UFlightPhysicsSubsystem::BeginLockstep).
+USTRUCT(BlueprintType)
+struct FFlightLockstepSettings
+{
+	GENERATED_BODY()
+
+	// Simulated time of every step (s). Each step is one world tick, which PhysX splits into substeps as per the project physics settings
+	// (so a FixedDeltaTime no larger than the max substep delta time gives exactly one flight physics substep per step).
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (ClampMin = "0.0001"))
+	float FixedDeltaTime = 0.01f;
+
+	// Skip rendering the world while in lockstep mode.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bDisableRendering = true;
+
+	// Disable the (game) ticks of all actors in the world while in lockstep mode. Physics (and so the flight physics) still run.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bDisableActorTicks = false;
+};
+
+// Simulated vs. wall clock time in lockstep mode.
+USTRUCT(BlueprintType)
+struct FFlightLockstepStats
+{
+	GENERATED_BODY()
+
+	// Number of steps taken since lockstep mode began
+	UPROPERTY(BlueprintReadOnly)
+	int64 NumSteps = 0;
+
+	// Simulated time since lockstep mode began (s)
+	UPROPERTY(BlueprintReadOnly)
+	float SimulatedTime = 0.0f;
+
+	// Wall clock time spent stepping since lockstep mode began (s)
+	UPROPERTY(BlueprintReadOnly)
+	float WallTime = 0.0f;
+
+	// Simulated time over wall clock time since lockstep mode began
+	UPROPERTY(BlueprintReadOnly)
+	float RealTimeFactor = 0.0f;
+
+	// Simulated time over wall clock time of the last completed Step() call
+	UPROPERTY(BlueprintReadOnly)
+	float LastRealTimeFactor = 0.0f;
+};
+
+// Settings for deterministic mode (see UFlightPhysicsSubsystem::BeginDeterministic).
+USTRUCT(BlueprintType)
+struct FFlightDeterminismSettings
+{
+	GENERATED_BODY()
+
+	// The top level seed, from which every vehicle (and every random model within it) gets its own stream.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 Seed = 0;
+
+	// Simulated time of every world tick (s), regardless of how long the frames actually take.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (ClampMin = "0.0001"))
+	float FixedDeltaTime = 1.0f / 120.0f;
+
+	// Keep the state hash of every substep (see GetStateHashHistory), rather than just the last and running hashes.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bRecordStateHashHistory = false;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnFlightLockstepStepsComplete, const FFlightLockstepStats&, Stats);
+
+// The modes which can hold the engine's fixed time step (see UFlightPhysicsSubsystem::AcquireFixedTimeStep).
+enum class EFlightFixedTimeStepHolder : uint8
+{
+	Lockstep,
+	Deterministic
+};
+
+// A single place where all flying pawns in a world get their physics substeps from.
+//
+// Rather than each pawn re-registering its own custom physics delegate every frame, pawns register with this subsystem once at BeginPlay.
+// The subsystem then registers one custom physics delegate per frame (on the body of one of the registered vehicles, as PhysX only offers
+// substep callbacks per body), and in that callback samples the shared atmosphere once and steps every registered vehicle in order.
+UCLASS()
+class SKYPHYS_API UFlightPhysicsSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Register a vehicle, so that it gets stepped every physics substep (until it is unregistered).
+	void RegisterVehicle(AFlyingPawn* Vehicle);
+
+	// Unregister a vehicle (eg. on EndPlay).
+	void UnregisterVehicle(AFlyingPawn* Vehicle);
+
+	// Set up the UDS weather actor used for the shared wind. Only the first valid setup is used, as there should only be one weather actor in a world.
+	void SetupWeather(const FWeatherSetup& InWeatherSetup);
+
+	// Get the steady (ie. excluding turbulence) wind in the world frame (NEU) (m/s), as sampled at the start of this substep.
+	FVector GetSteadyWind() const { return SteadyWind; };
+
+	// Get the air density (kg/m^3), as sampled at the start of this substep.
+	float GetAirDensity() const { return AirDensity; };
+
+	UFUNCTION(BlueprintCallable, Category = "SkyPhys")
+	FFlightPhysicsSubstepStats GetSubstepStats() const { return SubstepStats; };
+
+	// Lockstep mode, for stepping the simulation as fast as the CPU allows (eg. for batch training), decoupled from the wall clock.
+	// The world is paused between Step() calls, and every world tick while stepping advances every vehicle by the same fixed delta time.
+
+	// Enter lockstep mode. The world is paused until the first Step() call.
+	UFUNCTION(BlueprintCallable, Category = "SkyPhys|Lockstep")
+	void BeginLockstep(const FFlightLockstepSettings& Settings);
+
+	// Leave lockstep mode, restoring the engine timing, rendering and actor ticks, and unpausing the world.
+	UFUNCTION(BlueprintCallable, Category = "SkyPhys|Lockstep")
+	void EndLockstep();
+
+	// Advance the simulation by NumSteps fixed steps (queued on top of any steps still outstanding). The steps run over the following
+	// world ticks, without waiting on the wall clock, after which the world is paused again and OnLockstepStepsComplete is broadcast.
+	UFUNCTION(BlueprintCallable, Category = "SkyPhys|Lockstep")
+	void Step(int32 NumSteps);
+
+	UFUNCTION(BlueprintCallable, Category = "SkyPhys|Lockstep")
+	bool IsInLockstep() const { return bInLockstep; };
+
+	// Whether any steps of the last Step() call are still outstanding.
+	UFUNCTION(BlueprintCallable, Category = "SkyPhys|Lockstep")
+	bool IsStepping() const { return NumLockstepStepsRemaining > 0; };
+
+	UFUNCTION(BlueprintCallable, Category = "SkyPhys|Lockstep")
+	FFlightLockstepStats GetLockstepStats() const { return LockstepStats; };
+
+	// Deterministic mode, so that the same seed and commands give the same (bit-identical) trajectory.
+	// Every world tick advances by the same fixed delta time, every random model is seeded from one seed, and vehicles are stepped in
+	// name order. A hash of the state of all vehicles is taken every substep, so that runs can be compared cheaply.
+	// For PhysX to be deterministic too, enable "Enable Enhanced Determinism" in the project physics settings.
+
+	// Enter deterministic mode, reseeding every registered vehicle (and any registered later).
+	UFUNCTION(BlueprintCallable, Category = "SkyPhys|Determinism")
+	void BeginDeterministic(const FFlightDeterminismSettings& Settings);
+
+	// Leave deterministic mode, restoring the engine timing.
+	UFUNCTION(BlueprintCallable, Category = "SkyPhys|Determinism")
+	void EndDeterministic();
+
+	UFUNCTION(BlueprintCallable, Category = "SkyPhys|Determinism")
+	bool IsDeterministic() const { return bDeterministic; };
+
+	// Number of substeps since deterministic mode began
+	UFUNCTION(BlueprintCallable, Category = "SkyPhys|Determinism")
+	int64 GetDeterministicStepIndex() const { return DeterministicStepIndex; };
+
+	// Hash of the state of all vehicles at the start of the last substep
+	UFUNCTION(BlueprintCallable, Category = "SkyPhys|Determinism")
+	int64 GetStateHash() const { return static_cast<int64>(LastStateHash); };
+
+	// Hash of every state hash since deterministic mode began, so one value covers the whole run.
+	UFUNCTION(BlueprintCallable, Category = "SkyPhys|Determinism")
+	int64 GetRunningStateHash() const { return static_cast<int64>(RunningStateHash.Get()); };
+
+	// The state hash of every substep since deterministic mode began (if bRecordStateHashHistory is set).
+	UFUNCTION(BlueprintCallable, Category = "SkyPhys|Determinism")
+	const TArray<int64>& GetStateHashHistory() const { return StateHashHistory; };
+
+	// Called once all the steps of a Step() call have been taken.
+	UPROPERTY(BlueprintAssignable, Category = "SkyPhys|Lockstep")
+	FOnFlightLockstepStepsComplete OnLockstepStepsComplete;
+
+private:
+	// Called at the start of every world tick, to register our substep delegate for this frame.
+	void OnWorldPreActorTick(UWorld* InWorld, ELevelTick InLevelTick, float InDeltaSeconds);
+
+	// Called at the end of every world tick, to pause again once the lockstep steps have been taken.
+	void OnWorldPostActorTick(UWorld* InWorld, ELevelTick InLevelTick, float InDeltaSeconds);
+
+	// Seed a vehicle for deterministic mode, from its name (so the seed doesn't depend on the order vehicles were registered in).
+	void SeedDeterministicVehicle(AFlyingPawn* Vehicle) const;
+
+	// Update the state hashes from the state of all vehicles (after they have read their state for this substep).
+	void UpdateStateHash();
+
+	// Pause or unpause the world for lockstep mode.
+	void SetLockstepPaused(bool bPaused);
+
+	// The engine's fixed time step (FApp::UseFixedTimeStep / FixedDeltaTime) is global, and more than one mode can need it at once, so this is
+	// the only place it's changed. The first holder saves the engine's own setting, which is restored once the last holder releases it,
+	// whatever order they end in. While held, the fixed delta time is that of the latest holder.
+	//
+	// @param Holder: The mode taking the fixed time step (taking it again just updates its delta time)
+	// @param FixedDeltaTime: The delta time of every world tick (s)
+	void AcquireFixedTimeStep(EFlightFixedTimeStepHolder Holder, float FixedDeltaTime);
+
+	// Release the fixed time step held by a mode (if it holds it).
+	void ReleaseFixedTimeStep(EFlightFixedTimeStepHolder Holder);
+
+	// Physics substep, which steps all registered vehicles.
+	// This doesn't allocate either (see AFlyingPawn::SubstepTick), other than growing the state hash history when it is being recorded.
+	void Substep(float DeltaTime, FBodyInstance* BodyInstance);
+
+	// Step all registered vehicles over a frame without PhysX (ie. when every vehicle is in native free flight), in the same substeps.
+	void StepWithoutPhysics(float DeltaTime);
+
+	// Sample the atmosphere shared by all vehicles (wind and density).
+	void UpdateSharedAtmosphere();
+
+	// All registered vehicles, stepped in registration order.
+	UPROPERTY()
+	TArray<AFlyingPawn*> Vehicles;
+
+	UPROPERTY()
+	AActor* UDSWeatherActor;
+
+	FWeatherSetup WeatherSetup;
+
+	// Cached UDS weather properties (these are looked up once instead of every substep).
+	FFloatProperty* WindIntensityProperty = nullptr;
+	FFloatProperty* WindDirectionProperty = nullptr;
+
+	// Shared atmosphere
+	FVector SteadyWind = FVector(0.0f);
+	float AirDensity = 1.225f;
+
+	FCalculateCustomPhysics CalculateCustomPhysics;
+	FDelegateHandle PreActorTickHandle;
+	FDelegateHandle PostActorTickHandle;
+
+	// Whether no vehicle body is being simulated this frame (so no substep callback is registered), in which case we step them ourselves.
+	bool bStepWithoutPhysicsThisTick = false;
+
+	FFlightPhysicsSubstepStats SubstepStats;
+	int32 NumSubstepsThisFrame = 0;
+	double FrameDurationSeconds = 0.0;
+
+	// Lockstep mode
+	bool bInLockstep = false;
+	FFlightLockstepSettings LockstepSettings;
+	FFlightLockstepStats LockstepStats;
+	int32 NumLockstepStepsRemaining = 0;
+	int32 NumLockstepStepsRequested = 0;
+	bool bLockstepStepThisTick = false;
+	double LockstepStartTime = 0.0;
+	double LockstepWallTime = 0.0;
+
+	// Deterministic mode
+	bool bDeterministic = false;
+	FFlightDeterminismSettings DeterminismSettings;
+	int64 DeterministicStepIndex = 0;
+	uint64 LastStateHash = 0;
+	SkyPhysCore::FStateHash RunningStateHash;
+	TArray<int64> StateHashHistory;
+
+	// Holders of the fixed time step, in the order they took it, and the engine's own setting from before the first one did.
+	TArray<TPair<EFlightFixedTimeStepHolder, float>, TInlineAllocator<2>> FixedTimeStepHolders;
+	bool bPreviousUseFixedTimeStep = false;
+	double PreviousFixedDeltaTime = 0.0;
+
+	// Engine state to restore on EndLockstep
+	bool bPreviousBenchmarking = false;
+	bool bPreviousDisableWorldRendering = false;
+	TArray<TWeakObjectPtr<AActor>> LockstepDisabledTickActors;
+};
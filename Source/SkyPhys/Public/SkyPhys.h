@@ -5,6 +5,8 @@
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
 
+SKYPHYS_API DECLARE_LOG_CATEGORY_EXTERN(LogSkyPhys, Log, All);
+
 class FSkyPhysModule : public IModuleInterface
 {
 public:
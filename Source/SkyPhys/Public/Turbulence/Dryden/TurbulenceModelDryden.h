@@ -19,6 +19,15 @@ public:
 
 	virtual FVector GetTurbulenceBodyFrame(float Dt, float Va, float Altitude, float WindSpeed) const override;
 
+	virtual float GetCharacteristicRate(float Va, float Altitude) const override;
+
+	virtual void SetRandomSeed(uint64 Seed) override;
+
+	virtual void AddToHash(SkyPhysCore::FStateHash& Hash) const override;
+
+	virtual void SaveSnapshot(FTurbulenceSnapshot& Snapshot) const override;
+	virtual void RestoreSnapshot(const FTurbulenceSnapshot& Snapshot) override;
+
 private:
 
 	UPROPERTY(EditAnywhere, Instanced, BlueprintReadWrite, meta = (AllowPrivateAccess = "true", DisplayName = "Dryden Turbulence Hu Model", Tooltip = "Body i Axis (u Velocity) Dryden Model"))
@@ -3,8 +3,17 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "SkyPhysCore/Common/StateHash.h"
+#include "SkyPhysCore/Turbulence/DrydenModel.h"
+
 #include "TurbulenceModel.generated.h"
 
+// The complete dynamic state of a turbulence model (trivially copyable). Models use as many filters as they need (eg. Dryden uses one per body axis).
+struct FTurbulenceSnapshot
+{
+	SkyPhysCore::FDrydenFilterSnapshot Filters[3];
+};
+
 UCLASS(EditInlineNew, Abstract)
 class SKYPHYS_API UTurbulenceModel : public UObject
 {
@@ -15,6 +24,22 @@ public:
 
 	virtual FVector GetTurbulenceBodyFrame(float Dt, float Va, float Altitude, float WindSpeed) const PURE_VIRTUAL(UTurbulenceModel::GetTurbulenceBodyFrame, return FVector{};);
 
+	// Get the fastest rate of the turbulence model dynamics (1/s), or 0 if it has none.
+	//
+	// @param Va: Airspeed (m/s)
+	// @param Altitude: Altitude (m)
+	virtual float GetCharacteristicRate(float Va, float Altitude) const { return 0.0f; };
+
+	// Seed every random element of the model, each from its own stream of the given seed.
+	virtual void SetRandomSeed(uint64 Seed) {};
+
+	// Save or restore the complete dynamic state of the model (including any random streams).
+	virtual void SaveSnapshot(FTurbulenceSnapshot& Snapshot) const {};
+	virtual void RestoreSnapshot(const FTurbulenceSnapshot& Snapshot) {};
+
+	// Add the model state to a state hash.
+	virtual void AddToHash(SkyPhysCore::FStateHash& Hash) const {};
+
 protected:
 
 	// Methods
@@ -8,11 +8,13 @@ public class SkyPhys : ModuleRules
 	public SkyPhys(ReadOnlyTargetRules Target) : base(Target)
 	{
 		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		// The public SkyPhysCore headers are C++17, so anything including them needs to be too.
+		CppStandard = CppStandardVersion.Cpp17;
 		string PluginPath = Utils.MakePathRelativeTo(ModuleDirectory, Target.RelativeEnginePath);
 		PublicIncludePaths.AddRange(
 			new string[] 
 			{
-				Path.Combine(ModuleDirectory, "Dependencies"),
 				// ... add public include paths required here ...
 			}
 			);
@@ -30,6 +32,7 @@ public class SkyPhys : ModuleRules
 			new string[]
 			{
 				"Core",
+				"SkyPhysCore",
 				// ... add other public dependencies that you statically link with here ...
 			}
 			);
@@ -0,0 +1,226 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SkyPhysCore/Actuation/ActuatorModel.h"
+
+#include <cfloat>
+#include <cmath>
+
+#include "SkyPhysCore/Common/MathUtils.h"
+
+namespace SkyPhysCore
+{
+	void FActuatorModel::InitialiseActuator()
+	{
+		switch (Parameters.Type)
+		{
+		case EActuatorModelType::FirstOrder:
+			Integrator1 = Integrator(Parameters.InitialActuatorState);
+			break;
+
+		case EActuatorModelType::SecondOrder:
+			Integrator1 = Integrator(0.0f);
+			Integrator2 = Integrator(Parameters.InitialActuatorState);
+			break;
+
+		default:
+			break;
+		}
+
+		ActuatorState = Parameters.InitialActuatorState;
+		bActuatorInitialised = true;
+	}
+
+	float FActuatorModel::GetCharacteristicRate() const
+	{
+		if (Parameters.IntegrationMethod == EFilterIntegrationMethod::Exponential)
+		{
+			return 0.0f;
+		}
+
+		switch (Parameters.Type)
+		{
+		case EActuatorModelType::FirstOrder:
+			return Parameters.wn;
+		case EActuatorModelType::SecondOrder:
+			// Overdamped filters have a real pole faster than wn
+			return Parameters.zeta > 1.0f ? Parameters.wn * (Parameters.zeta + sqrt(Parameters.zeta * Parameters.zeta - 1.0f)) : Parameters.wn;
+		default:
+			return 0.0f;
+		}
+	}
+
+	float FActuatorModel::ApplyActuatorCommand(float Command, float DeltaTime)
+	{
+		if (!bActuatorInitialised)
+		{
+			InitialiseActuator();
+		}
+
+		switch (Parameters.Type)
+		{
+		case EActuatorModelType::FirstOrder:
+			ActuatorState = Parameters.IntegrationMethod == EFilterIntegrationMethod::Exponential ?
+				ApplyFirstOrderExponential(Command, DeltaTime) : ApplyFirstOrderDynamics(Command, DeltaTime);
+			break;
+
+		case EActuatorModelType::SecondOrder:
+			ActuatorState = Parameters.IntegrationMethod == EFilterIntegrationMethod::Exponential ?
+				ApplySecondOrderExponential(Command, DeltaTime) : ApplySecondOrderDynamics(Command, DeltaTime);
+			break;
+
+		default:
+			ActuatorState = Command * Parameters.DCGain;
+			break;
+		}
+
+		return ActuatorState;
+	}
+
+	float FActuatorModel::ApplyFirstOrderDynamics(float Command, float DeltaTime)
+	{
+		// First order filter is modelled quite simply as:
+		// -DC->(+)--->(wn/s)-------->
+		//		(-)              |
+		//		 ^               |
+		//		 |				 |
+		//		 -----------------
+
+		const float wn = Parameters.wn;
+
+		float Input = Command * Parameters.DCGain;
+		float Feedback = Integrator1.X;
+		float IntegratorInput = wn * (Input - Feedback);
+		float IntegratorOutputExpected = Integrator1.Integrate(DeltaTime, IntegratorInput);
+
+		return ApplyLimits(Feedback, IntegratorOutputExpected, DeltaTime);
+	}
+
+	float FActuatorModel::ApplySecondOrderDynamics(float Command, float DeltaTime)
+	{
+		// Second order filter is modelled quite simply as:
+		// 
+		// ---(DC*wn^2)----(+)--->(+)--->(1/s)--------(1/s)--------->
+		//				   (-)	  (-)				|		|
+		//					|	   ^				|		|
+		//					|	   |				|		|
+		//					|	   ---(2*zeta*wn)----		|
+		//					|								|
+		//					-------------(wn^2)--------------			
+		//
+		// Integrator 1 is first in the feedforward path
+		// Integrator 2 is second in the feedforward path
+		// Feedback 2 is first in the feedforward path
+		// Feedback 1 is second in the feedforward path
+
+		const float wn = Parameters.wn;
+		const float zeta = Parameters.zeta;
+
+		float Input = Command * Parameters.DCGain * pow(wn, 2.0f);
+		float Feedback2 = Integrator2.X * pow(wn, 2.0f);
+		float Feedback1 = Integrator1.X * 2 * zeta * wn;
+
+		float Integrator1Input = Input - Feedback2 - Feedback1;
+		float Integrator1Output = Integrator1.Integrate(DeltaTime, Integrator1Input);
+
+		float Integrator2Input = Integrator1Output;
+		float Integrator2Current = Integrator2.X;
+		float Integrator2OutputExpected = Integrator2.Integrate(DeltaTime, Integrator2Input);
+
+		return ApplyLimits(Integrator2Current, Integrator2OutputExpected, DeltaTime);
+	}
+
+	float FActuatorModel::ApplyFirstOrderExponential(float Command, float DeltaTime)
+	{
+		// The same filter as ApplyFirstOrderDynamics, solved exactly for the command held over the step:
+		// x(t + Dt) = x(t) + (Input - x(t)) * (1 - exp(-wn * Dt))
+
+		const double wn = Parameters.wn;
+
+		const double Input = Command * Parameters.DCGain;
+		const float Current = Integrator1.X;
+		const double Next = Current - (Input - Current) * expm1(-wn * DeltaTime);
+
+		// The integrator input is kept as the rate at the new state, so the state reads the same as a trapezoidal actuator's.
+		const float IntegratorOutputExpected = Integrator1.SetState(static_cast<float>(Next), static_cast<float>(wn * (Input - Next)));
+
+		return ApplyLimits(Current, IntegratorOutputExpected, DeltaTime);
+	}
+
+	float FActuatorModel::ApplySecondOrderExponential(float Command, float DeltaTime)
+	{
+		// The same filter as ApplySecondOrderDynamics, solved exactly for the command held over the step.
+		// In terms of the error from the steady state (e = x - Input) and the rate (v, ie. Integrator 1):
+		//
+		// [e; v](t + Dt) = exp(A * Dt) * [e; v](t), where A = [0, 1; -wn^2, -2*zeta*wn]
+		//
+		// A = sigma*I + N, where sigma = -zeta*wn and N = [zeta*wn, 1; -wn^2, -zeta*wn], and N^2 = delta*I (delta = wn^2 * (zeta^2 - 1)).
+		// So exp(A * Dt) = exp(sigma * Dt) * (C*I + S*N), where with q = sqrt(|delta|):
+		// Overdamped: C = cosh(q * Dt), S = sinh(q * Dt) / q
+		// Underdamped: C = cos(q * Dt), S = sin(q * Dt) / q
+		// Critically damped: C = 1, S = Dt
+
+		const double wn = Parameters.wn;
+		const double zeta = Parameters.zeta;
+		const double Dt = DeltaTime;
+		const double sigma = -zeta * wn;
+
+		const double Input = Command * Parameters.DCGain;
+		const double Error = Integrator2.X - Input;
+		const double Rate = Integrator1.X;
+
+		const double delta = wn * wn * (zeta * zeta - 1.0);
+		const double q = sqrt(fabs(delta));
+
+		double ExpC = 0.0; // exp(sigma * Dt) * C
+		double ExpS = 0.0; // exp(sigma * Dt) * S
+		if (q * Dt < 1.e-6)
+		{
+			ExpC = exp(sigma * Dt);
+			ExpS = ExpC * Dt;
+		}
+		else if (delta > 0.0)
+		{
+			// Both poles are real, so use their exponentials directly (as cosh and sinh overflow long before exp(sigma * Dt) * cosh does).
+			const double ExpSlow = exp((sigma + q) * Dt);
+			const double ExpFast = exp((sigma - q) * Dt);
+			ExpC = 0.5 * (ExpSlow + ExpFast);
+			ExpS = 0.5 * (ExpSlow - ExpFast) / q;
+		}
+		else
+		{
+			const double Exp = exp(sigma * Dt);
+			ExpC = Exp * cos(q * Dt);
+			ExpS = Exp * sin(q * Dt) / q;
+		}
+
+		const double NextError = (ExpC - sigma * ExpS) * Error + ExpS * Rate;
+		const double NextRate = -wn * wn * ExpS * Error + (ExpC + sigma * ExpS) * Rate;
+
+		// As per the trapezoidal actuator, integrator 1 is the rate (with the acceleration as its input), and integrator 2 is the position.
+		const float Integrator2Current = Integrator2.X;
+		Integrator1.SetState(static_cast<float>(NextRate), static_cast<float>(-wn * wn * NextError + 2.0 * sigma * NextRate));
+		const float Integrator2OutputExpected = Integrator2.SetState(static_cast<float>(Input + NextError), static_cast<float>(NextRate));
+
+		return ApplyLimits(Integrator2Current, Integrator2OutputExpected, DeltaTime);
+	}
+
+	float FActuatorModel::ApplyLimits(float Current, float Expected, float DeltaTime) const
+	{
+		float Output = Expected;
+
+		if (Parameters.RateLimit)
+		{
+			Output = InterpConstantTo(Current, Expected, DeltaTime, Parameters.RateLimit);
+		}
+		if (Parameters.LowerSaturation)
+		{
+			Output = Clamp(Output, Parameters.LowerSaturation, FLT_MAX);
+		}
+		if (Parameters.UpperSaturation)
+		{
+			Output = Clamp(Output, -FLT_MAX, Parameters.UpperSaturation);
+		}
+
+		return Output;
+	}
+}
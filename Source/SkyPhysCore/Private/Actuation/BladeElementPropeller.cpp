@@ -0,0 +1,235 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SkyPhysCore/Actuation/BladeElementPropeller.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "SkyPhysCore/Common/MathUtils.h"
+
+namespace SkyPhysCore
+{
+	void FAirfoilPolar::Evaluate(float InAlpha, float& OutCL, float& OutCD) const
+	{
+		// The thin airfoil used if there's no data
+		static const FAirfoilPolar ThinAirfoil = { { -0.2f, 0.2f }, { -0.4f * Pi, 0.4f * Pi }, { 0.01f, 0.01f } };
+		const FAirfoilPolar& Polar = (Alpha.empty() || CL.size() != Alpha.size() || CD.size() != Alpha.size()) ? ThinAirfoil : *this;
+		const std::vector<float>& AlphaArray = Polar.Alpha;
+		const int NumAlpha = static_cast<int>(AlphaArray.size());
+
+		const float WrappedAlpha = std::remainder(InAlpha, 2.0f * Pi);
+
+		// Within the data, interpolate linearly.
+		if (WrappedAlpha >= AlphaArray.front() && WrappedAlpha <= AlphaArray.back())
+		{
+			int a2i = static_cast<int>(std::upper_bound(AlphaArray.begin(), AlphaArray.end(), WrappedAlpha) - AlphaArray.begin());
+			a2i = a2i < NumAlpha ? a2i : NumAlpha - 1;
+			const int a1i = a2i > 0 ? a2i - 1 : 0;
+
+			const float Range = AlphaArray[a2i] - AlphaArray[a1i];
+			const float aFrac = IsNearlyZero(Range) ? 0.0f : (WrappedAlpha - AlphaArray[a1i]) / Range;
+			OutCL = Polar.CL[a1i] + aFrac * (Polar.CL[a2i] - Polar.CL[a1i]);
+			OutCD = Polar.CD[a1i] + aFrac * (Polar.CD[a2i] - Polar.CD[a1i]);
+			return;
+		}
+
+		// Beyond it, the section is stalled, so blend from the end of the data into a flat plate (normal force coefficient 2 * sin(alpha)).
+		const int Edge = WrappedAlpha < AlphaArray.front() ? 0 : NumAlpha - 1;
+		const float Blend = std::min(std::fabs(WrappedAlpha - AlphaArray[Edge]) / StallBlendAngle, 1.0f);
+		const float FlatPlateCL = std::sin(2.0f * WrappedAlpha);
+		const float FlatPlateCD = 2.0f * std::sin(WrappedAlpha) * std::sin(WrappedAlpha);
+
+		OutCL = Polar.CL[Edge] + Blend * (FlatPlateCL - Polar.CL[Edge]);
+		OutCD = Polar.CD[Edge] + Blend * (FlatPlateCD - Polar.CD[Edge]);
+	}
+
+	// Interpolate the chord (m) and twist (rad) of the blade at a radius (m).
+	static void InterpolateStation(const FBladeElementPropellerGeometry& Geometry, float r, float& OutChord, float& OutTwist)
+	{
+		const std::vector<FBladeStation>& Stations = Geometry.Stations;
+		const float R = 0.5f * Geometry.D;
+		const float rOverR = r / R;
+
+		int s2i = static_cast<int>(std::upper_bound(Stations.begin(), Stations.end(), rOverR,
+			[](float Value, const FBladeStation& Station) { return Value < Station.r; }) - Stations.begin());
+		s2i = Clamp(s2i, 1, static_cast<int>(Stations.size()) - 1);
+		const int s1i = s2i - 1;
+
+		const float Range = Stations[s2i].r - Stations[s1i].r;
+		const float sFrac = IsNearlyZero(Range) ? 0.0f : Clamp((rOverR - Stations[s1i].r) / Range, 0.0f, 1.0f);
+		OutChord = (Stations[s1i].Chord + sFrac * (Stations[s2i].Chord - Stations[s1i].Chord)) * R;
+		OutTwist = Stations[s1i].Twist + sFrac * (Stations[s2i].Twist - Stations[s1i].Twist);
+	}
+
+	// The loads of the blade elements of one annulus (per unit span and air density, summed over the blades and averaged around the disc).
+	struct FAnnulusLoads
+	{
+		float Thrust = 0.0f; // Along the propeller axis
+		float TangentialForce = 0.0f; // Against the blade motion (ie. torque / r)
+		float InPlaneForce = 0.0f; // Against the in-plane airspeed
+	};
+
+	// Everything about one annulus which doesn't depend on its induced velocity.
+	struct FAnnulus
+	{
+		const FBladeElementPropellerGeometry* Geometry;
+		float r, Chord, Twist;
+		float Omega; // Propeller rotational speed (rad/s)
+		float Vax, Vip; // Axial (into the disc) and in-plane airspeeds (m/s)
+		int NumAzimuths;
+		float SinAzimuth[BladeElement::NumAzimuths];
+
+		FAnnulusLoads CalculateBladeLoads(float vi) const
+		{
+			FAnnulusLoads Loads;
+			const float Up = Vax + vi;
+
+			for (int k = 0; k < NumAzimuths; k++)
+			{
+				// The in-plane airspeed adds to the tangential speed of the advancing blade, and takes from the retreating one.
+				const float Ut = Omega * r + Vip * SinAzimuth[k];
+				const float W2 = Up * Up + Ut * Ut;
+				const float phi = std::atan2(Up, Ut);
+
+				float CL, CD;
+				Geometry->Airfoil.Evaluate(Twist - phi, CL, CD);
+
+				// Prandtl-Glauert correction of the lift for compressibility
+				const float Mach = std::min(std::sqrt(W2) / BladeElement::SpeedOfSound, BladeElement::MaxMachNumber);
+				CL /= std::sqrt(1.0f - Mach * Mach);
+
+				const float q = 0.5f * W2 * Chord;
+				const float Lift = q * CL;
+				const float Drag = q * CD;
+				const float TangentialForce = Lift * std::sin(phi) + Drag * std::cos(phi);
+
+				Loads.Thrust += Lift * std::cos(phi) - Drag * std::sin(phi);
+				Loads.TangentialForce += TangentialForce;
+				Loads.InPlaneForce += TangentialForce * SinAzimuth[k];
+			}
+
+			const float Scale = static_cast<float>(Geometry->NumBlades) / NumAzimuths;
+			Loads.Thrust *= Scale;
+			Loads.TangentialForce *= Scale;
+			Loads.InPlaneForce *= Scale;
+			return Loads;
+		}
+
+		// The thrust of the momentum of the flow through the annulus (as per Glauert), with Prandtl's tip loss.
+		float CalculateMomentumThrust(float vi) const
+		{
+			const float R = 0.5f * Geometry->D;
+			const float Up = Vax + vi;
+			const float SinPhi = std::fabs(Up) / std::max(std::sqrt(Up * Up + Omega * r * Omega * r), SmallNumber);
+			const float f = 0.5f * Geometry->NumBlades * (R - r) / (r * std::max(SinPhi, SmallNumber));
+			const float TipLoss = std::max((2.0f / Pi) * std::acos(std::min(std::exp(-f), 1.0f)), 0.05f);
+
+			return 4.0f * Pi * r * TipLoss * vi * std::sqrt(Vip * Vip + Up * Up);
+		}
+	};
+
+	FPropellerPerformance SolveBladeElementPerformance(const FBladeElementPropellerGeometry& Geometry, float n, float J, float InflowAngle)
+	{
+		FPropellerPerformance Performance;
+
+		const float D = Geometry.D;
+		const float nRPS = n / 60.0f;
+		if (Geometry.Stations.size() < 2 || Geometry.NumBlades <= 0 || !(D > 0.0f) || !(nRPS > 0.0f))
+		{
+			return Performance;
+		}
+
+		const float R = 0.5f * D;
+		const float V = J * nRPS * D;
+
+		FAnnulus Annulus;
+		Annulus.Geometry = &Geometry;
+		Annulus.Omega = 2.0f * Pi * nRPS;
+		Annulus.Vax = V * std::cos(InflowAngle);
+		Annulus.Vip = std::fabs(V * std::sin(InflowAngle));
+
+		// In axial flow every blade position is the same.
+		Annulus.NumAzimuths = Annulus.Vip > SmallNumber ? BladeElement::NumAzimuths : 1;
+		for (int k = 0; k < Annulus.NumAzimuths; k++)
+		{
+			Annulus.SinAzimuth[k] = Annulus.NumAzimuths > 1 ? std::sin(2.0f * Pi * (k + 0.5f) / Annulus.NumAzimuths) : 0.0f;
+		}
+
+		// The induced velocity always lies within this bracket (where the blades are fully stalled one way or the other).
+		const float MaxInducedVelocity = 2.0f * (V + Annulus.Omega * R) + 1.0f;
+
+		const float rHub = Geometry.Stations.front().r * R;
+		const float rTip = std::min(Geometry.Stations.back().r, 1.0f) * R;
+		const float dr = (rTip - rHub) / BladeElement::NumAnnuli;
+
+		float T = 0.0f;
+		float Q = 0.0f;
+		float H = 0.0f;
+		for (int i = 0; i < BladeElement::NumAnnuli; i++)
+		{
+			Annulus.r = rHub + (i + 0.5f) * dr;
+			InterpolateStation(Geometry, Annulus.r, Annulus.Chord, Annulus.Twist);
+
+			// The momentum thrust isn't monotonic in the induced velocity over its whole range, so the balance is bracketed by the sign of the blade
+			// thrust without any. Positive thrust speeds up the flow through the disc (vi >= 0). Negative thrust (windmilling) slows it (vi <= 0), which
+			// momentum theory only covers until the axial flow through the disc has lost half of its speed (beyond which the wake is turbulent),
+			// so vi is held at that limit if the blades want more. Within each bracket the blade thrust falls and the momentum thrust rises with vi,
+			// so bisect for where they balance.
+			float Low = 0.0f;
+			float High = MaxInducedVelocity;
+			if (Annulus.CalculateBladeLoads(0.0f).Thrust < 0.0f)
+			{
+				Low = Annulus.Vax > 0.0f ? -0.5f * Annulus.Vax : -MaxInducedVelocity;
+				High = 0.0f;
+			}
+			for (int Iteration = 0; Iteration < BladeElement::NumIterations; Iteration++)
+			{
+				const float vi = 0.5f * (Low + High);
+				if (Annulus.CalculateBladeLoads(vi).Thrust > Annulus.CalculateMomentumThrust(vi))
+				{
+					Low = vi;
+				}
+				else
+				{
+					High = vi;
+				}
+			}
+
+			const FAnnulusLoads Loads = Annulus.CalculateBladeLoads(0.5f * (Low + High));
+			T += Loads.Thrust * dr;
+			Q += Loads.TangentialForce * Annulus.r * dr;
+			H += Loads.InPlaneForce * dr;
+		}
+
+		// Coefficients (at unit air density, as the loads were calculated)
+		const float D4 = D * D * D * D;
+		Performance.CT = T / (nRPS * nRPS * D4);
+		Performance.CP = Q * Annulus.Omega / (nRPS * nRPS * nRPS * D4 * D);
+		Performance.CH = H / (nRPS * nRPS * D4);
+		return Performance;
+	}
+
+	std::shared_ptr<const FPropellerPerformanceTable> BuildBladeElementPerformanceTable(const FBladeElementPropellerGeometry& Geometry,
+		const FBladeElementTableResolution& Resolution, const FParallelFor& ParallelFor)
+	{
+		using FAxis = FPropellerPerformanceTable::FAxis;
+		const FAxis NAxis(Resolution.NMin, std::max(Resolution.NMax, Resolution.NMin), std::max(Resolution.NumN, 2));
+		const FAxis JAxis(0.0f, std::max(Resolution.JMax, 0.0f), std::max(Resolution.NumJ, 2));
+		const FAxis AngleAxis(0.0f, Pi, std::max(Resolution.NumInflowAngles, 2));
+
+		std::shared_ptr<FPropellerPerformanceTable> Table = std::make_shared<FPropellerPerformanceTable>(NAxis, JAxis, AngleAxis);
+
+		// Each (n, J) line of inflow angles is independent, and fills its own part of the table.
+		ParallelFor(NAxis.Num * JAxis.Num, [&](int Index)
+			{
+				const int ni = Index / JAxis.Num;
+				const int ji = Index % JAxis.Num;
+				for (int ai = 0; ai < AngleAxis.Num; ai++)
+				{
+					Table->SetPerformance(ni, ji, ai, SolveBladeElementPerformance(Geometry, NAxis.GetPoint(ni), JAxis.GetPoint(ji), AngleAxis.GetPoint(ai)));
+				}
+			});
+
+		return Table;
+	}
+}
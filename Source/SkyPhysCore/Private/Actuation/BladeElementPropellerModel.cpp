@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SkyPhysCore/Actuation/BladeElementPropellerModel.h"
+
+#include <cmath>
+#include <utility>
+
+#include "SkyPhysCore/Common/MathUtils.h"
+
+namespace SkyPhysCore
+{
+	// The table of a propeller without any data (all 0s), shared by all of them.
+	static const std::shared_ptr<const FPropellerPerformanceTable>& GetEmptyTable()
+	{
+		static const std::shared_ptr<const FPropellerPerformanceTable> EmptyTable = std::make_shared<const FPropellerPerformanceTable>();
+		return EmptyTable;
+	}
+
+	FBladeElementPropellerModel::FBladeElementPropellerModel() : Table(GetEmptyTable())
+	{
+	}
+
+	FBladeElementPropellerModel::FBladeElementPropellerModel(const FBladeElementPropellerParameters& Parameters, std::shared_ptr<const FPropellerPerformanceTable> Table)
+		: Parameters(Parameters), Table(Table ? std::move(Table) : GetEmptyTable())
+	{
+	}
+
+	FForcesAndMoments FBladeElementPropellerModel::CalculateForcesAndMoments(float Rho, const FVector3& Va, const FVector3& SystemOmega) const
+	{
+		const float D = Parameters.D;
+		const float RotationDirection = Parameters.RotationDirection;
+
+		// The operating point: advance ratio, and the angle of the airspeed to the propeller axis (0 when advancing along the thrust, -Z).
+		// Without airspeed or rotation, the inflow angle doesn't matter (and at zero rotation, neither does the advance ratio).
+		const FVector3 V = RemoveNumericalErrors(Va);
+		const float VNorm = V.norm();
+		const float VInPlane = std::sqrt(V.x() * V.x() + V.y() * V.y());
+		const float n = omega / (2 * Pi);
+
+		float J = 0.0f;
+		float InflowAngle = 0.0f;
+		if (!IsNearlyZero(VNorm) && !IsNearlyZero(n))
+		{
+			J = VNorm / (std::fabs(n) * D);
+			InflowAngle = std::atan2(VInPlane, -V.z());
+		}
+
+		const FPropellerPerformance Performance = Table->Lookup(RadPerSToRPM(omega), J, InflowAngle);
+		const float AerodynamicConstant = Rho * n * n * (D * D * D * D);
+
+		// Thrust, T, and the in-plane force, H, against the in-plane airspeed.
+		const float T = Performance.CT * AerodynamicConstant;
+		FVector3 Forces(0.0f, 0.0f, -T);
+		if (!IsNearlyZero(VInPlane))
+		{
+			const float H = Performance.CH * AerodynamicConstant;
+			Forces.x() = -H * V.x() / VInPlane;
+			Forces.y() = -H * V.y() / VInPlane;
+		}
+
+		// Aerodynamic moments, Q = -RotationDirection * CP / (2 * Pi) * AerodynamicConstant * D
+		const float Q = -RotationDirection * (Performance.CP / (2.0f * Pi)) * AerodynamicConstant * D;
+
+		// Gyroscopic moments, G = RotationDirection * Izz * omega * (SystemOmega x k)
+		const FVector3 G = (RotationDirection * Parameters.Izz * omega) * SystemOmega.cross(FVector3::UnitZ());
+
+		return FForcesAndMoments(Forces, FVector3(0.0f, 0.0f, Q) + G);
+	}
+}
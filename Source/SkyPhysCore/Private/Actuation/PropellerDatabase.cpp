@@ -0,0 +1,276 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SkyPhysCore/Actuation/PropellerDatabase.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+
+#if defined(_WIN32)
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace SkyPhysCore
+{
+	class FPropellerDatabase::FMappedFile
+	{
+	public:
+		explicit FMappedFile(const std::string& Path)
+		{
+#if defined(_WIN32)
+			// The path is UTF-8, so open it as a wide path.
+			const int NumChars = MultiByteToWideChar(CP_UTF8, 0, Path.c_str(), -1, nullptr, 0);
+			std::wstring WidePath(NumChars > 0 ? NumChars : 0, L'\0');
+			if (NumChars <= 0 || MultiByteToWideChar(CP_UTF8, 0, Path.c_str(), -1, &WidePath[0], NumChars) <= 0)
+			{
+				return;
+			}
+
+			const HANDLE FileHandle = CreateFileW(WidePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (FileHandle == INVALID_HANDLE_VALUE)
+			{
+				return;
+			}
+
+			LARGE_INTEGER FileSize;
+			if (GetFileSizeEx(FileHandle, &FileSize) && FileSize.QuadPart > 0)
+			{
+				const HANDLE MappingHandle = CreateFileMappingW(FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				if (MappingHandle)
+				{
+					Data = static_cast<const char*>(MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0));
+					Size = Data ? static_cast<uint64_t>(FileSize.QuadPart) : 0;
+					// The view keeps the mapping open.
+					CloseHandle(MappingHandle);
+				}
+			}
+			CloseHandle(FileHandle);
+#else
+			const int FileDescriptor = open(Path.c_str(), O_RDONLY);
+			if (FileDescriptor < 0)
+			{
+				return;
+			}
+
+			struct stat FileStat;
+			if (fstat(FileDescriptor, &FileStat) == 0 && FileStat.st_size > 0)
+			{
+				void* Mapping = mmap(nullptr, static_cast<size_t>(FileStat.st_size), PROT_READ, MAP_PRIVATE, FileDescriptor, 0);
+				if (Mapping != MAP_FAILED)
+				{
+					Data = static_cast<const char*>(Mapping);
+					Size = static_cast<uint64_t>(FileStat.st_size);
+				}
+			}
+			// The mapping keeps the file open.
+			close(FileDescriptor);
+#endif
+		};
+
+		~FMappedFile()
+		{
+			if (Data)
+			{
+#if defined(_WIN32)
+				UnmapViewOfFile(Data);
+#else
+				munmap(const_cast<char*>(Data), static_cast<size_t>(Size));
+#endif
+			}
+		};
+
+		FMappedFile(const FMappedFile&) = delete;
+		FMappedFile& operator=(const FMappedFile&) = delete;
+
+		const char* Data = nullptr;
+		uint64_t Size = 0;
+	};
+
+	// Compare a name in an entry (which is always null terminated) with another.
+	static int CompareName(const FPropellerDatabaseEntry& Entry, const char* Name)
+	{
+		return std::strncmp(Entry.Name, Name, FPropellerDatabaseEntry::MaxNameLength + 1);
+	}
+
+	static uint64_t AlignOffset(uint64_t Offset)
+	{
+		return (Offset + FPropellerDatabase::Alignment - 1) / FPropellerDatabase::Alignment * FPropellerDatabase::Alignment;
+	}
+
+	std::shared_ptr<const FPropellerDatabase> FPropellerDatabase::Open(const std::string& Path)
+	{
+		// The databases which are open, so each file is only mapped once (and unmapped once nothing is using it).
+		static std::mutex OpenDatabasesMutex;
+		static std::map<std::string, std::weak_ptr<const FPropellerDatabase>> OpenDatabases;
+
+		std::lock_guard<std::mutex> Lock(OpenDatabasesMutex);
+
+		std::weak_ptr<const FPropellerDatabase>& OpenDatabase = OpenDatabases[Path];
+		if (std::shared_ptr<const FPropellerDatabase> Database = OpenDatabase.lock())
+		{
+			return Database;
+		}
+
+		std::shared_ptr<const FMappedFile> File = std::make_shared<const FMappedFile>(Path);
+		if (!File->Data || File->Size < sizeof(FPropellerDatabaseHeader))
+		{
+			OpenDatabases.erase(Path);
+			return nullptr;
+		}
+
+		// Only the header and the entry names are checked here (so every name can be used as a C string), and then each table when it's first used.
+		const FPropellerDatabaseHeader* Header = reinterpret_cast<const FPropellerDatabaseHeader*>(File->Data);
+		if (std::memcmp(Header->Magic, Magic, sizeof(Magic)) != 0 || Header->Version != Version || Header->ByteOrderMark != ByteOrderMark
+			|| Header->FileSize != File->Size || sizeof(FPropellerDatabaseHeader) + static_cast<uint64_t>(Header->NumPropellers) * sizeof(FPropellerDatabaseEntry) > File->Size)
+		{
+			OpenDatabases.erase(Path);
+			return nullptr;
+		}
+
+		const FPropellerDatabaseEntry* Entries = reinterpret_cast<const FPropellerDatabaseEntry*>(File->Data + sizeof(FPropellerDatabaseHeader));
+		for (uint32_t i = 0; i < Header->NumPropellers; i++)
+		{
+			if (std::memchr(Entries[i].Name, '\0', sizeof(Entries[i].Name)) == nullptr)
+			{
+				OpenDatabases.erase(Path);
+				return nullptr;
+			}
+		}
+
+		std::shared_ptr<const FPropellerDatabase> Database(new FPropellerDatabase(std::move(File)));
+		OpenDatabase = Database;
+		return Database;
+	}
+
+	FPropellerDatabase::FPropellerDatabase(std::shared_ptr<const FMappedFile> File) : File(std::move(File))
+	{
+		Header = reinterpret_cast<const FPropellerDatabaseHeader*>(this->File->Data);
+		Entries = reinterpret_cast<const FPropellerDatabaseEntry*>(this->File->Data + sizeof(FPropellerDatabaseHeader));
+	}
+
+	int FPropellerDatabase::Find(const std::string& Name) const
+	{
+		const FPropellerDatabaseEntry* End = Entries + GetNumPropellers();
+		const FPropellerDatabaseEntry* Entry = std::lower_bound(Entries, End, Name.c_str(),
+			[](const FPropellerDatabaseEntry& Entry, const char* Name) { return CompareName(Entry, Name) < 0; });
+
+		return (Entry != End && CompareName(*Entry, Name.c_str()) == 0) ? static_cast<int>(Entry - Entries) : -1;
+	}
+
+	std::shared_ptr<const FPropellerTable> FPropellerDatabase::GetTable(int Index) const
+	{
+		if (Index < 0 || Index >= GetNumPropellers())
+		{
+			return nullptr;
+		}
+
+		const FPropellerDatabaseEntry& Entry = Entries[Index];
+
+		// The grid has to be valid (which also bounds the size of its coefficients)...
+		const bool bValidAxes = Entry.NumN >= 2 && Entry.NumJ >= 2 && Entry.NumN <= static_cast<uint32_t>(FPropellerTable::MaxNumSamples) && Entry.NumJ <= static_cast<uint32_t>(FPropellerTable::MaxNumSamples)
+			&& std::isfinite(Entry.NMin) && std::isfinite(Entry.NMax) && Entry.NMax >= Entry.NMin
+			&& std::isfinite(Entry.JMin) && std::isfinite(Entry.JMax) && Entry.JMax >= Entry.JMin;
+		if (!bValidAxes)
+		{
+			return nullptr;
+		}
+
+		// ...and its coefficients within the file (checked without adding to the offset, which could wrap around).
+		const uint64_t NumCoefficientBytes = static_cast<uint64_t>(Entry.NumN) * Entry.NumJ * 2 * sizeof(float);
+		if (Entry.CoefficientsOffset % Alignment != 0 || Entry.CoefficientsOffset > File->Size || NumCoefficientBytes > File->Size - Entry.CoefficientsOffset)
+		{
+			return nullptr;
+		}
+
+		return std::make_shared<const FPropellerTable>(
+			FPropellerTable::FAxis(Entry.NMin, Entry.NMax, static_cast<int>(Entry.NumN)),
+			FPropellerTable::FAxis(Entry.JMin, Entry.JMax, static_cast<int>(Entry.NumJ)),
+			reinterpret_cast<const float*>(File->Data + Entry.CoefficientsOffset),
+			File);
+	}
+
+	std::shared_ptr<const FPropellerTable> FPropellerDatabase::FindTable(const std::string& Name) const
+	{
+		return GetTable(Find(Name));
+	}
+
+	bool FPropellerDatabase::Write(const std::string& Path, const std::vector<std::pair<std::string, FPropellerTable>>& Propellers)
+	{
+		// The entries are sorted by name, for Find.
+		std::vector<const std::pair<std::string, FPropellerTable>*> SortedPropellers;
+		SortedPropellers.reserve(Propellers.size());
+		for (const std::pair<std::string, FPropellerTable>& Propeller : Propellers)
+		{
+			if (Propeller.first.empty() || Propeller.first.size() > FPropellerDatabaseEntry::MaxNameLength)
+			{
+				return false;
+			}
+			SortedPropellers.push_back(&Propeller);
+		}
+		std::sort(SortedPropellers.begin(), SortedPropellers.end(), [](const auto* A, const auto* B) { return std::strcmp(A->first.c_str(), B->first.c_str()) < 0; });
+		for (size_t i = 1; i < SortedPropellers.size(); i++)
+		{
+			if (SortedPropellers[i]->first == SortedPropellers[i - 1]->first)
+			{
+				return false;
+			}
+		}
+
+		// Lay out the file, and then fill it in.
+		std::vector<FPropellerDatabaseEntry> Entries(SortedPropellers.size());
+		uint64_t Offset = AlignOffset(sizeof(FPropellerDatabaseHeader) + Entries.size() * sizeof(FPropellerDatabaseEntry));
+		for (size_t i = 0; i < SortedPropellers.size(); i++)
+		{
+			const FPropellerTable& Table = SortedPropellers[i]->second;
+			FPropellerDatabaseEntry& Entry = Entries[i];
+			std::memset(&Entry, 0, sizeof(Entry));
+			std::memcpy(Entry.Name, SortedPropellers[i]->first.c_str(), SortedPropellers[i]->first.size());
+			Entry.NMin = Table.GetNAxis().Min;
+			Entry.NMax = Table.GetNAxis().Max;
+			Entry.JMin = Table.GetJAxis().Min;
+			Entry.JMax = Table.GetJAxis().Max;
+			Entry.NumN = static_cast<uint32_t>(Table.GetNumN());
+			Entry.NumJ = static_cast<uint32_t>(Table.GetNumJ());
+			Entry.CoefficientsOffset = Offset;
+			Offset = AlignOffset(Offset + static_cast<uint64_t>(Entry.NumN) * Entry.NumJ * 2 * sizeof(float));
+		}
+
+		FPropellerDatabaseHeader Header;
+		std::memset(&Header, 0, sizeof(Header));
+		std::memcpy(Header.Magic, Magic, sizeof(Magic));
+		Header.Version = Version;
+		Header.ByteOrderMark = ByteOrderMark;
+		Header.NumPropellers = static_cast<uint32_t>(Entries.size());
+		Header.FileSize = Offset;
+
+		std::vector<char> Buffer(static_cast<size_t>(Offset), 0);
+		std::memcpy(Buffer.data(), &Header, sizeof(Header));
+		if (!Entries.empty())
+		{
+			std::memcpy(Buffer.data() + sizeof(Header), Entries.data(), Entries.size() * sizeof(FPropellerDatabaseEntry));
+		}
+		for (size_t i = 0; i < SortedPropellers.size(); i++)
+		{
+			const FPropellerTable& Table = SortedPropellers[i]->second;
+			std::memcpy(Buffer.data() + Entries[i].CoefficientsOffset, Table.GetCoefficients(), static_cast<size_t>(Table.GetNumN()) * Table.GetNumJ() * 2 * sizeof(float));
+		}
+
+		std::ofstream Stream(Path, std::ios::binary | std::ios::trunc);
+		Stream.write(Buffer.data(), static_cast<std::streamsize>(Buffer.size()));
+		return static_cast<bool>(Stream);
+	}
+}
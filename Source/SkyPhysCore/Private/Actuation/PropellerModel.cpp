@@ -0,0 +1,246 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SkyPhysCore/Actuation/PropellerModel.h"
+
+#include <cfloat>
+#include <cmath>
+#include <utility>
+
+#include "SkyPhysCore/Common/MathUtils.h"
+
+namespace SkyPhysCore
+{
+	// The table of a propeller without any data (all 0s), shared by all of them.
+	static const std::shared_ptr<const FPropellerTable>& GetEmptyTable()
+	{
+		static const std::shared_ptr<const FPropellerTable> EmptyTable = std::make_shared<const FPropellerTable>();
+		return EmptyTable;
+	}
+
+	FPropellerModel::FPropellerModel() : Table(GetEmptyTable())
+	{
+	}
+
+	FPropellerModel::FPropellerModel(const FPropellerParameters& Parameters)
+		: FPropellerModel(Parameters, std::make_shared<const FPropellerTable>(Parameters.ConstantSpeedData))
+	{
+		// The data is resampled onto the table once here, so the lookups on every step are just index arithmetic.
+	}
+
+	FPropellerModel::FPropellerModel(const FPropellerParameters& Parameters, std::shared_ptr<const FPropellerTable> Table) : Parameters(Parameters), Table(std::move(Table))
+	{
+		// We only keep the data in the table.
+		this->Parameters.ConstantSpeedData = std::vector<FConstantSpeedPropellerData>();
+		if (!this->Table)
+		{
+			this->Table = GetEmptyTable();
+		}
+	}
+
+	FForcesAndMoments FPropellerModel::CalculateForcesAndMoments(float Rho, const FVector3& Va, const FVector3& SystemOmega)
+	{
+		// First update the propeller state
+		UpdatePropellerState(Rho, Va);
+
+		// Get the aerodynamic constants
+		FAerodynamicConstantResults AerodynamicConstants = GetAerodynamicConstants(RadPerSToRPM(PropellerState.omega), PropellerState.J);
+
+		// Here we calculate our forces in the propeller body frame. 
+		// This will be defined as the same rotation as the airframe body frame for a multirotor due to the Z axis being downward, 
+		// but will be rotated by 90 degrees around Y for a fixed wing due to the thrust (Z axis) being aligned with the airframe X axis.
+
+		// Our forces generated by the propeller include our thrust,
+		FVector3 T = CalculateThrustForces(AerodynamicConstants.CT);
+		// As well as our side/hub force.
+		FVector3 H = CalculateSideForces(T.norm());
+
+		// Our moments will comprise of aerodynamic moments
+		FVector3 Q = CalculateAerodynamicMoments(AerodynamicConstants.CP);
+		// As well as gyroscopic moments due to rotation of a very quickly rotating body (a propeller) about another rotation axis (the airframe).
+		FVector3 G = CalculateGyroscopicMoments(SystemOmega);
+
+		return FForcesAndMoments(T + H, Q + G);
+	}
+
+	void FPropellerModel::UpdatePropellerState(float Rho, const FVector3& Va)
+	{
+		PropellerState.V = RemoveNumericalErrors(Va);
+
+		// Set the air density
+		PropellerState.Rho = Rho;
+
+		// Calculate and assign the advance ratio
+		float n = PropellerState.omega / (2 * Pi);
+		// Set advance ratio to either -FLT_MAX (arbitrarily large negative number that should cause us to clip with our interp method) or to the actual calculated value based on rotational speed,
+		// unless V is zero, then set it to 0.
+		PropellerState.J = 0.0f;
+		const float V = PropellerState.V.norm();
+		if (!IsNearlyZero(V))
+		{
+			PropellerState.J = IsNearlyZero(n) ? -FLT_MAX : V / (n * Parameters.D);
+		}
+
+		// Calculate and assign the aerodynamic constant
+		PropellerState.AerodynamicConstant = Rho * pow(n, 2.0f) * pow(Parameters.D, 4.0f);
+	}
+
+	FVector3 FPropellerModel::CalculateThrustForces(float CT) const
+	{
+		// Calculate thrust magnitude from coefficient
+		float T = CT * PropellerState.AerodynamicConstant;
+
+		// We know that thrust will always be in the negative Z direction in the propeller body frame.
+		return FVector3(0.0f, 0.0f, -T);
+	}
+
+	FVector3 FPropellerModel::CalculateSideForces(float T) const
+	{
+		// We calculate side forces (or hub forces), H, based on a lumped drag model as derived in:
+		// M. Bangura, Aerodynamics and Control of Quadrotors, The Australian National University, 2017
+
+		// This includes:
+
+		// Induced drag, Di, which is the drag due to having semi or fully rigid propeller blades which do not flap:
+		// Di = -T*Ki*Vh
+
+		// Translational drag, Dt, which is the drag due to the bending of the induced velocity streamtube of the airflow as it goes through
+		// the rotor during translational motion.
+		// Dt = -T*Kt*Vh
+
+		// Profile drag, Dp, which is the drag caused by the transverse velocity of the rotor blades as they move through the air.
+		// Dp = -T*Kp*Vg
+
+		// The total drag therefore is:
+		// D = Di + Dt + Dp
+		// D = -T*Kr*V
+
+		// Where:
+		// Kr = [c, 0, 0;
+		//		 0, c, 0;
+		//	     0, 0, 0]
+		// Where c is a lumped drag coefficient (by default we assume 0.01 as per the above reference), where it should be noted that we have divided by 4 as the author
+		// has lumped all rotor effects for the quadrotor into a single coefficient and we only want this for a single propeller.
+
+		// It does not include blade flapping, as we assume rigid blades are being modelled.
+
+		FVector3 D = FVector3::Zero();
+
+		if (!IsNearlyZero(T) && !IsNearlyZero(PropellerState.V.norm()))
+		{
+			// Kr is diagonal, so we only need to scale the in-plane components of V.
+			D = -T * Parameters.Cd * FVector3(PropellerState.V.x(), PropellerState.V.y(), 0.0f);
+		}
+
+		// Our lumped drag model is now returned as our H force.
+		return D;
+	}
+
+	FVector3 FPropellerModel::CalculateAerodynamicMoments(float CP) const
+	{
+		// Get torque coefficient from the pre-calculated power coefficient
+		float CQ = CP / (2.0f * Pi);
+		// Calculate torque magnitude from coefficient
+		float Q = CQ * PropellerState.AerodynamicConstant * Parameters.D;
+		// Adjust our direction based on the rotation of the propeller (torque will be in the opposite direction).
+		Q *= -Parameters.RotationDirection;
+		return FVector3(0.0f, 0.0f, Q);
+	}
+
+	FVector3 FPropellerModel::CalculateGyroscopicMoments(const FVector3& SystemOmega) const
+	{
+		// Gyroscopic effect is calculated as:
+		// G = I*omega*(OMEGA x k) (as can be found here: http://www.gyroscopes.org/math2.asp)
+		// where:
+		// I is the moment of inertia of our spinning body (so our propeller in this case)
+		// omega is the propeller rotational velocity (rad/s)
+		// SystemOmega is the airframe rotational velocity (rad/s), which we expect to already be in the propeller frame.
+		// k is the "z" direction of the propeller (which should be the only rotation axis for the propeller), which we cross with OMEGA to get the direction of the effect.
+		return Parameters.RotationDirection * Parameters.Izz * PropellerState.omega * SystemOmega.cross(FVector3::UnitZ());
+	}
+
+	FForcesAndMoments FPropellerModel::CalculateForcesAndMomentsJacobian(float Rho, const FVector3& Va, const FVector3& SystemOmega, float omega, FPropellerJacobian& Jacobian) const
+	{
+		// Columns of the Jacobian
+		enum EInput { AirspeedX, AirspeedY, AirspeedZ, OmegaX, OmegaY, OmegaZ, PropellerSpeed };
+		using FInputRow = Eigen::Matrix<float, 1, 7>;
+
+		Jacobian.setZero();
+
+		const float D = Parameters.D;
+		const float RotationDirection = Parameters.RotationDirection;
+
+		// Propeller state (as per UpdatePropellerState)
+		const FVector3 V = RemoveNumericalErrors(Va);
+		const float VNorm = V.norm();
+		const float n = omega / (2 * Pi);
+		const float dndomega = 1.0f / (2 * Pi);
+
+		float J = 0.0f;
+		FInputRow dJ = FInputRow::Zero();
+		if (!IsNearlyZero(VNorm))
+		{
+			if (IsNearlyZero(n))
+			{
+				J = -FLT_MAX;
+			}
+			else
+			{
+				J = VNorm / (n * D);
+				dJ.head<3>() = V.transpose() / (VNorm * n * D);
+				dJ(PropellerSpeed) = -J / n * dndomega;
+			}
+		}
+
+		const float AerodynamicConstant = Rho * n * n * pow(D, 4.0f);
+		const float dAerodynamicConstant = 2.0f * Rho * n * pow(D, 4.0f) * dndomega;
+
+		// CT and CP, chained through n (in RPM) and J
+		FAerodynamicConstantResults dCdn(0.0f, 0.0f);
+		FAerodynamicConstantResults dCdJ(0.0f, 0.0f);
+		const FAerodynamicConstantResults Constants = Table->Lookup(RadPerSToRPM(omega), J, dCdn, dCdJ);
+
+		FInputRow dCT = dCdJ.CT * dJ;
+		FInputRow dCP = dCdJ.CP * dJ;
+		dCT(PropellerSpeed) += dCdn.CT * RadPerSToRPM(1.0f);
+		dCP(PropellerSpeed) += dCdn.CP * RadPerSToRPM(1.0f);
+
+		// Thrust, T
+		const float T = Constants.CT * AerodynamicConstant;
+		FInputRow dT = dCT * AerodynamicConstant;
+		dT(PropellerSpeed) += Constants.CT * dAerodynamicConstant;
+
+		// Side forces, H = -|T| * Cd * (Vx, Vy, 0), which always oppose the airspeed (even with negative thrust, as per CalculateSideForces).
+		// This is continuous through zero airspeed (where the model skips it).
+		const float Cd = Parameters.Cd;
+		const float AbsT = std::fabs(T);
+		const FInputRow dAbsT = (T < 0.0f ? -1.0f : 1.0f) * dT;
+		FVector3 Forces(-AbsT * Cd * V.x(), -AbsT * Cd * V.y(), -T);
+		if (IsNearlyZero(T) || IsNearlyZero(VNorm))
+		{
+			Forces.x() = 0.0f;
+			Forces.y() = 0.0f;
+		}
+
+		Jacobian.row(0) = -Cd * V.x() * dAbsT;
+		Jacobian.row(1) = -Cd * V.y() * dAbsT;
+		Jacobian(0, AirspeedX) -= AbsT * Cd;
+		Jacobian(1, AirspeedY) -= AbsT * Cd;
+		Jacobian.row(2) = -dT;
+
+		// Aerodynamic moments, Q = -RotationDirection * CP / (2 * Pi) * AerodynamicConstant * D
+		const float QScale = -RotationDirection * D / (2.0f * Pi);
+		const float Q = QScale * Constants.CP * AerodynamicConstant;
+		Jacobian.row(5) = QScale * AerodynamicConstant * dCP;
+		Jacobian(5, PropellerSpeed) += QScale * Constants.CP * dAerodynamicConstant;
+
+		// Gyroscopic moments, G = RotationDirection * Izz * omega * (SystemOmega x k) = RotationDirection * Izz * omega * (Wy, -Wx, 0)
+		const float GyroscopicScale = RotationDirection * Parameters.Izz;
+		const FVector3 G = GyroscopicScale * omega * SystemOmega.cross(FVector3::UnitZ());
+		Jacobian(3, OmegaY) += GyroscopicScale * omega;
+		Jacobian(4, OmegaX) -= GyroscopicScale * omega;
+		Jacobian(3, PropellerSpeed) += GyroscopicScale * SystemOmega.y();
+		Jacobian(4, PropellerSpeed) -= GyroscopicScale * SystemOmega.x();
+
+		return FForcesAndMoments(Forces, FVector3(0.0f, 0.0f, Q) + G);
+	}
+}
@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SkyPhysCore/Actuation/PropellerPerformanceTable.h"
+
+namespace SkyPhysCore
+{
+	// Blend two sets of coefficients (A + Frac * (B - A)).
+	static FPropellerPerformance Blend(const FPropellerPerformance& A, const FPropellerPerformance& B, float Frac)
+	{
+		FPropellerPerformance Result;
+		Result.CT = A.CT + Frac * (B.CT - A.CT);
+		Result.CP = A.CP + Frac * (B.CP - A.CP);
+		Result.CH = A.CH + Frac * (B.CH - A.CH);
+		return Result;
+	}
+
+	FPropellerPerformanceTable::FPropellerPerformanceTable() : FPropellerPerformanceTable(FAxis(), FAxis(), FAxis())
+	{
+	}
+
+	FPropellerPerformanceTable::FPropellerPerformanceTable(const FAxis& NAxis, const FAxis& JAxis, const FAxis& AngleAxis)
+		: NAxis(NAxis), JAxis(JAxis), AngleAxis(AngleAxis), Performance(NAxis.Num * JAxis.Num * AngleAxis.Num)
+	{
+	}
+
+	void FPropellerPerformanceTable::SetPerformance(int ni, int ji, int ai, const FPropellerPerformance& InPerformance)
+	{
+		Performance[GetIndex(ni, ji, ai)] = InPerformance;
+	}
+
+	FPropellerPerformance FPropellerPerformanceTable::Lookup(float n, float J, float InflowAngle) const
+	{
+		int ni, ji, ai;
+		float nFrac, jFrac, aFrac;
+		NAxis.Locate(n, ni, nFrac);
+		JAxis.Locate(J, ji, jFrac);
+		AngleAxis.Locate(InflowAngle, ai, aFrac);
+
+		// Interpolate along the inflow angle at each of the 4 (n, J) corners of the cell, then along J, and then along n.
+		const FPropellerPerformance* P11 = &Performance[GetIndex(ni, ji, ai)];
+		const FPropellerPerformance* P12 = P11 + AngleAxis.Num;
+		const FPropellerPerformance* P21 = P11 + JAxis.Num * AngleAxis.Num;
+		const FPropellerPerformance* P22 = P21 + AngleAxis.Num;
+
+		const FPropellerPerformance N1 = Blend(Blend(P11[0], P11[1], aFrac), Blend(P12[0], P12[1], aFrac), jFrac);
+		const FPropellerPerformance N2 = Blend(Blend(P21[0], P21[1], aFrac), Blend(P22[0], P22[1], aFrac), jFrac);
+
+		return Blend(N1, N2, nFrac);
+	}
+}
@@ -0,0 +1,188 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SkyPhysCore/Actuation/PropellerTable.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <utility>
+
+namespace SkyPhysCore
+{
+	// Interpolate CT and CP linearly along J for a single propeller speed of the measured data.
+	static FAerodynamicConstantResults InterpolateAlongJ(const FConstantSpeedPropellerData& Data, float J)
+	{
+		const std::vector<float>& JArray = Data.J;
+		const int NumJ = static_cast<int>(JArray.size());
+
+		if (NumJ == 0)
+		{
+			return FAerodynamicConstantResults(0.0f, 0.0f);
+		}
+
+		// Extract which indices are on either side of our value.
+		int j2i = static_cast<int>(std::upper_bound(JArray.begin(), JArray.end(), J) - JArray.begin()); // This returns the index of the first value > the value provided, so will be our second element.
+		j2i = j2i < NumJ ? j2i : NumJ - 1;
+		int j1i = j2i > 0 ? j2i - 1 : 0;
+
+		float CT = Data.CT[j1i];
+		float CP = Data.CP[j1i];
+
+		// Now only interpolate between j1 and j2 if they are not the same
+		if (j1i != j2i)
+		{
+			const float j1 = JArray[j1i];
+			const float j2 = JArray[j2i];
+
+			// Now get the J fraction (measured from j1, as that is what we are blending from), which we will use for interpolation along this axis
+			const float jFrac = Clamp(IsNearlyZero(j2 - j1) ? 0.0f : (J - j1) / (j2 - j1), 0.0f, 1.0f);
+
+			CT += jFrac * (Data.CT[j2i] - Data.CT[j1i]);
+			CP += jFrac * (Data.CP[j2i] - Data.CP[j1i]);
+		}
+
+		return FAerodynamicConstantResults(CT, CP);
+	}
+
+	// Interpolate CT and CP linearly along J and then n, directly from the measured data.
+	static FAerodynamicConstantResults InterpolateData(const std::vector<FConstantSpeedPropellerData>& ConstantSpeedData, float n, float J)
+	{
+		const int NumN = static_cast<int>(ConstantSpeedData.size());
+
+		// First get where we are along n (the first speed > n is our second element)
+		int n2i = static_cast<int>(std::upper_bound(ConstantSpeedData.begin(), ConstantSpeedData.end(), n,
+			[](float Value, const FConstantSpeedPropellerData& Data) { return Value < Data.n; }) - ConstantSpeedData.begin());
+		n2i = n2i < NumN ? n2i : NumN - 1;
+		int n1i = n2i > 0 ? n2i - 1 : 0;
+
+		FAerodynamicConstantResults Results = InterpolateAlongJ(ConstantSpeedData[n1i], J);
+
+		// We only need to interpolate along the N axis if N1 != N2
+		if (n1i != n2i)
+		{
+			const float n1 = ConstantSpeedData[n1i].n;
+			const float n2 = ConstantSpeedData[n2i].n;
+			const float nFrac = Clamp((n - n1) / (n2 - n1), 0.0f, 1.0f);
+
+			const FAerodynamicConstantResults Results2 = InterpolateAlongJ(ConstantSpeedData[n2i], J);
+			Results.CT += nFrac * (Results2.CT - Results.CT);
+			Results.CP += nFrac * (Results2.CP - Results.CP);
+		}
+
+		return Results;
+	}
+
+	// The number of grid points to cover a range at (no coarser than) the finest spacing of the data, divided by the oversampling.
+	static int GetNumSamples(float Range, float MinSpacing)
+	{
+		if (!(Range > 0.0f) || !(MinSpacing > 0.0f) || MinSpacing >= FLT_MAX)
+		{
+			return 2;
+		}
+		const float NumIntervals = std::ceil(Range * FPropellerTable::Oversampling / MinSpacing - 1.e-3f);
+		return static_cast<int>(Clamp(NumIntervals + 1.0f, 2.0f, static_cast<float>(FPropellerTable::MaxNumSamples)));
+	}
+
+	FPropellerTable::FPropellerTable() : FPropellerTable(std::vector<FConstantSpeedPropellerData>())
+	{
+	}
+
+	FPropellerTable::FPropellerTable(const std::vector<FConstantSpeedPropellerData>& ConstantSpeedData)
+	{
+		// Work out the extent and spacing of the grid from the data.
+		float MinNSpacing = FLT_MAX;
+		float MinJSpacing = FLT_MAX;
+		float JMin = FLT_MAX;
+		float JMax = -FLT_MAX;
+
+		for (size_t i = 0; i < ConstantSpeedData.size(); i++)
+		{
+			const std::vector<float>& JArray = ConstantSpeedData[i].J;
+			if (i > 0 && ConstantSpeedData[i].n > ConstantSpeedData[i - 1].n)
+			{
+				MinNSpacing = std::min(MinNSpacing, ConstantSpeedData[i].n - ConstantSpeedData[i - 1].n);
+			}
+			for (size_t j = 1; j < JArray.size(); j++)
+			{
+				if (JArray[j] > JArray[j - 1])
+				{
+					MinJSpacing = std::min(MinJSpacing, JArray[j] - JArray[j - 1]);
+				}
+			}
+			if (!JArray.empty())
+			{
+				JMin = std::min(JMin, JArray.front());
+				JMax = std::max(JMax, JArray.back());
+			}
+		}
+
+		float NMin = 0.0f;
+		float NMax = 0.0f;
+		if (!ConstantSpeedData.empty())
+		{
+			NMin = ConstantSpeedData.front().n;
+			NMax = std::max(ConstantSpeedData.back().n, NMin);
+		}
+		if (JMin > JMax)
+		{
+			JMin = 0.0f;
+			JMax = 0.0f;
+		}
+
+		NAxis = FAxis(NMin, NMax, GetNumSamples(NMax - NMin, MinNSpacing));
+		JAxis = FAxis(JMin, JMax, GetNumSamples(JMax - JMin, MinJSpacing));
+
+		// Then sample the data at each grid point (so anywhere the data is clamped, such as beyond the J of one speed, is kept).
+		std::shared_ptr<std::vector<float>> Grid = std::make_shared<std::vector<float>>(NAxis.Num * JAxis.Num * 2, 0.0f);
+		if (!ConstantSpeedData.empty())
+		{
+			for (int ni = 0; ni < NAxis.Num; ni++)
+			{
+				for (int ji = 0; ji < JAxis.Num; ji++)
+				{
+					const FAerodynamicConstantResults Results = InterpolateData(ConstantSpeedData, NAxis.GetPoint(ni), JAxis.GetPoint(ji));
+					(*Grid)[(ni * JAxis.Num + ji) * 2] = Results.CT;
+					(*Grid)[(ni * JAxis.Num + ji) * 2 + 1] = Results.CP;
+				}
+			}
+		}
+
+		Coefficients = Grid->data();
+		Owner = std::move(Grid);
+	}
+
+	FPropellerTable::FPropellerTable(const FAxis& NAxis, const FAxis& JAxis, const float* Coefficients, std::shared_ptr<const void> Owner)
+		: NAxis(NAxis), JAxis(JAxis), Coefficients(Coefficients), Owner(std::move(Owner))
+	{
+	}
+
+	FAerodynamicConstantResults FPropellerTable::Lookup(float n, float J, FAerodynamicConstantResults& dn, FAerodynamicConstantResults& dJ) const
+	{
+		int ni, ji;
+		float nFrac, jFrac;
+		NAxis.Locate(n, ni, nFrac);
+		JAxis.Locate(J, ji, jFrac);
+
+		const float* C1 = Coefficients + (ni * JAxis.Num + ji) * 2;
+		const float* C2 = C1 + JAxis.Num * 2;
+
+		const float dCT1 = C1[2] - C1[0];
+		const float dCP1 = C1[3] - C1[1];
+		const float dCT2 = C2[2] - C2[0];
+		const float dCP2 = C2[3] - C2[1];
+
+		const float CT1 = C1[0] + jFrac * dCT1;
+		const float CP1 = C1[1] + jFrac * dCP1;
+		const float CT2 = C2[0] + jFrac * dCT2;
+		const float CP2 = C2[1] + jFrac * dCP2;
+
+		// The slopes of this cell, unless we've been clamped to the edge of the grid.
+		const float dnScale = NAxis.IsInside(n) ? NAxis.InvStep : 0.0f;
+		const float dJScale = JAxis.IsInside(J) ? JAxis.InvStep : 0.0f;
+
+		dn = FAerodynamicConstantResults((CT2 - CT1) * dnScale, (CP2 - CP1) * dnScale);
+		dJ = FAerodynamicConstantResults((dCT1 + nFrac * (dCT2 - dCT1)) * dJScale, (dCP1 + nFrac * (dCP2 - dCP1)) * dJScale);
+
+		return FAerodynamicConstantResults(CT1 + nFrac * (CT2 - CT1), CP1 + nFrac * (CP2 - CP1));
+	}
+}
@@ -0,0 +1,165 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SkyPhysCore/Actuation/RotorBank.h"
+
+#include <cfloat>
+#include <cmath>
+
+#include "SkyPhysCore/Common/MathUtils.h"
+
+namespace SkyPhysCore
+{
+	void FRotorBank::Resize(int Num)
+	{
+		NumRotors = Num;
+
+		// The padding lanes are left as rotors with no diameter or speed, so they evaluate to 0 (and are never summed).
+		const int NumLanes = (Num + LaneMultiple - 1) / LaneMultiple * LaneMultiple;
+		for (FBatchArray* Array : {
+			&Px, &Py, &Pz,
+			&R00, &R01, &R02, &R10, &R11, &R12, &R20, &R21, &R22,
+			&RotationDirection, &Cd, &Izz, &D, &D4,
+			&NMin, &NMax, &NInvStep, &NLastCell,
+			&JMin, &JMax, &JInvStep, &JLastCell,
+			&omega,
+			&Fx, &Fy, &Fz, &Mx, &My, &Mz,
+			&Wx, &Wy, &Wz, &Vx, &Vy, &Vz, &Omegax, &Omegay, &HasNaN, &VNorm,
+			&n, &J, &AerodynamicConstant, &NPosition, &JPosition, &NCell, &JCell, &NFrac, &JFrac,
+			&CT11, &CP11, &CT12, &CP12, &CT21, &CP21, &CT22, &CP22, &CT, &CP,
+			&T, &H, &Gyroscopic, &Q })
+		{
+			Array->setZero(NumLanes);
+		}
+
+		Tables.assign(Num, nullptr);
+	}
+
+	void FRotorBank::SetRotor(int Index, const FPropellerModel& Propeller, const FPropulsorGeometry& Geometry)
+	{
+		Px[Index] = Geometry.Position.x(); Py[Index] = Geometry.Position.y(); Pz[Index] = Geometry.Position.z();
+
+		const FMatrix3& R = Geometry.Rotation;
+		R00[Index] = R(0, 0); R01[Index] = R(0, 1); R02[Index] = R(0, 2);
+		R10[Index] = R(1, 0); R11[Index] = R(1, 1); R12[Index] = R(1, 2);
+		R20[Index] = R(2, 0); R21[Index] = R(2, 1); R22[Index] = R(2, 2);
+
+		const FPropellerParameters& Parameters = Propeller.GetParameters();
+		RotationDirection[Index] = Parameters.RotationDirection;
+		Cd[Index] = Parameters.Cd;
+		Izz[Index] = Parameters.Izz;
+		if (D[Index] != Parameters.D)
+		{
+			D[Index] = Parameters.D;
+			D4[Index] = std::pow(Parameters.D, 4.0f);
+		}
+
+		const FPropellerTable& Table = Propeller.GetTable();
+		const FPropellerTable::FAxis& NAxis = Table.GetNAxis();
+		const FPropellerTable::FAxis& JAxis = Table.GetJAxis();
+		NMin[Index] = NAxis.Min; NMax[Index] = NAxis.Max; NInvStep[Index] = NAxis.InvStep; NLastCell[Index] = static_cast<float>(NAxis.Num - 2);
+		JMin[Index] = JAxis.Min; JMax[Index] = JAxis.Max; JInvStep[Index] = JAxis.InvStep; JLastCell[Index] = static_cast<float>(JAxis.Num - 2);
+		Tables[Index] = &Table;
+
+		omega[Index] = Propeller.GetMotionState();
+	}
+
+	FForcesAndMoments FRotorBank::CalculateForcesAndMoments(float Rho, const FVector3& Vb, const FVector3& Omegab, const FVector3& Vwb)
+	{
+		// This follows FPropellerModel::CalculateForcesAndMoments (and the geometry of FPropulsorGeometry) exactly, but each line is evaluated
+		// across the whole bank. Every expression is assigned straight into a preallocated array, so that Eigen can vectorise it without creating
+		// any temporaries.
+
+		// ******************************** Inflow ******************************** //
+
+		// The airspeed of each rotor in the body frame (v + omega x r - vw), and then in the propeller frame (R^T), along with the body rotational velocity.
+		Wx = (Vb.x() + (Omegab.y() * Pz - Omegab.z() * Py)) - Vwb.x();
+		Wy = (Vb.y() + (Omegab.z() * Px - Omegab.x() * Pz)) - Vwb.y();
+		Wz = (Vb.z() + (Omegab.x() * Py - Omegab.y() * Px)) - Vwb.z();
+
+		Vx = R00 * Wx + R10 * Wy + R20 * Wz;
+		Vy = R01 * Wx + R11 * Wy + R21 * Wz;
+		Vz = R02 * Wx + R12 * Wy + R22 * Wz;
+
+		Omegax = R00 * Omegab.x() + R10 * Omegab.y() + R20 * Omegab.z();
+		Omegay = R01 * Omegab.x() + R11 * Omegab.y() + R21 * Omegab.z();
+
+		// Remove small numerical errors (as per RemoveNumericalErrors), where a NaN in any component zeroes the whole airspeed.
+		const float ErrorTolerance = 0.0001f;
+		HasNaN = (Vx.isNaN() || Vy.isNaN() || Vz.isNaN()).cast<float>();
+		Vx = (HasNaN > 0.0f || Vx.abs() <= ErrorTolerance).select(0.0f, Vx);
+		Vy = (HasNaN > 0.0f || Vy.abs() <= ErrorTolerance).select(0.0f, Vy);
+		Vz = (HasNaN > 0.0f || Vz.abs() <= ErrorTolerance).select(0.0f, Vz);
+
+		// ***************************** Advance Ratio **************************** //
+
+		VNorm = (Vx.square() + Vy.square() + Vz.square()).sqrt();
+		n = omega / (2 * Pi);
+
+		// 0 at zero airspeed, and -FLT_MAX (so we clip to the table) at zero propeller speed.
+		J = (VNorm.abs() <= SmallNumber).select(0.0f, (n.abs() <= SmallNumber).select(-FLT_MAX, VNorm / (n * D)));
+
+		AerodynamicConstant = Rho * n.square() * D4;
+
+		// ***************************** Coefficients ***************************** //
+
+		// Locate each rotor on its table's grid (as per FPropellerTable::FAxis::Locate, with n in RPM). The positions are never negative, so
+		// truncating them (which vectorises everywhere, unlike floor) finds the cell below.
+		NPosition = ((n * 60.0f < NMin).select(NMin, (n * 60.0f < NMax).select(n * 60.0f, NMax)) - NMin) * NInvStep;
+		NCell = NPosition.cast<int>().cast<float>().min(NLastCell);
+		NFrac = NPosition - NCell;
+
+		JPosition = ((J < JMin).select(JMin, (J < JMax).select(J, JMax)) - JMin) * JInvStep;
+		JCell = JPosition.cast<int>().cast<float>().min(JLastCell);
+		JFrac = JPosition - JCell;
+
+		// Gather the (CT, CP) pairs at the corners of each rotor's cell, which is the only part done one rotor at a time.
+		for (int i = 0; i < Num(); i++)
+		{
+			const FPropellerTable& Table = *Tables[i];
+			const int NumJ = Table.GetNumJ();
+			const float* C1 = Table.GetCoefficients() + (static_cast<int>(NCell[i]) * NumJ + static_cast<int>(JCell[i])) * 2;
+			const float* C2 = C1 + NumJ * 2;
+
+			CT11[i] = C1[0]; CP11[i] = C1[1]; CT12[i] = C1[2]; CP12[i] = C1[3];
+			CT21[i] = C2[0]; CP21[i] = C2[1]; CT22[i] = C2[2]; CP22[i] = C2[3];
+		}
+
+		// Interpolate along J, and then along n (as per FPropellerTable::Lookup).
+		CT = (CT11 + JFrac * (CT12 - CT11)) + NFrac * ((CT21 + JFrac * (CT22 - CT21)) - (CT11 + JFrac * (CT12 - CT11)));
+		CP = (CP11 + JFrac * (CP12 - CP11)) + NFrac * ((CP21 + JFrac * (CP22 - CP21)) - (CP11 + JFrac * (CP12 - CP11)));
+
+		// **************************** Forces and Moments ************************ //
+
+		// Thrust along -Z, and side forces from the lumped drag model (scaled by the thrust magnitude), in the propeller frame
+		T = CT * AerodynamicConstant;
+		H = (T.abs() <= SmallNumber || VNorm.abs() <= SmallNumber).select(0.0f, -T.abs() * Cd);
+
+		// Aerodynamic moments (against the rotation direction) and gyroscopic moments (Izz * omega * (SystemOmega x k)), in the propeller frame
+		Gyroscopic = RotationDirection * Izz * omega;
+		Q = (CP / (2.0f * Pi)) * AerodynamicConstant * D * -RotationDirection;
+
+		// Rotate the forces (H * Vx, H * Vy, -T) and moments (G * Omegay, G * -Omegax, Q) into the body frame, and add the moments of the forces
+		// acting at a distance to our CoG (r x F).
+		Fx = R00 * (H * Vx) + R01 * (H * Vy) + R02 * -T;
+		Fy = R10 * (H * Vx) + R11 * (H * Vy) + R12 * -T;
+		Fz = R20 * (H * Vx) + R21 * (H * Vy) + R22 * -T;
+
+		Mx = (R00 * (Gyroscopic * Omegay) + R01 * (Gyroscopic * -Omegax) + R02 * Q) + (Py * Fz - Pz * Fy);
+		My = (R10 * (Gyroscopic * Omegay) + R11 * (Gyroscopic * -Omegax) + R12 * Q) + (Pz * Fx - Px * Fz);
+		Mz = (R20 * (Gyroscopic * Omegay) + R21 * (Gyroscopic * -Omegax) + R22 * Q) + (Px * Fy - Py * Fx);
+
+		// Sum the rotors in order (rather than as a vectorised reduction), so the result is the same whatever the SIMD width.
+		FForcesAndMoments CumulativeForcesAndMomentsAtCG;
+		for (int i = 0; i < Num(); i++)
+		{
+			CumulativeForcesAndMomentsAtCG += GetForcesAndMoments(i);
+		}
+
+		return CumulativeForcesAndMomentsAtCG;
+	}
+
+	FForcesAndMoments FRotorBank::GetForcesAndMoments(int Index) const
+	{
+		return FForcesAndMoments(FVector3(Fx[Index], Fy[Index], Fz[Index]), FVector3(Mx[Index], My[Index], Mz[Index]));
+	}
+}
@@ -0,0 +1,145 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SkyPhysCore/Aerodynamics/AirframeBatch.h"
+
+#include <cfloat>
+
+#include "SkyPhysCore/Aerodynamics/AirframeKernel.h"
+#include "SkyPhysCore/Common/MathUtils.h"
+
+namespace SkyPhysCore
+{
+	void FAirframeBatchCoefficients::Resize(int Num)
+	{
+		for (FBatchArray* Array : {
+			&CL0, &CLAlpha, &CLq, &CLde,
+			&CD0, &CDAlpha, &CDAlpha2, &CDq, &CDBeta, &CDBeta2, &CDde,
+			&CY0, &CYBeta, &CYp, &CYr, &CYda, &CYdr,
+			&CI0, &CIBeta, &CIp, &CIr, &CIda, &CIdr,
+			&Cm0, &CmAlpha, &Cmq, &Cmde,
+			&Cn0, &CnBeta, &Cnp, &Cnr, &Cnda, &Cndr,
+			&StallEnabled, &Alpha0, &M, &Cmfp,
+			&b, &c, &Ax, &Ay, &Az })
+		{
+			Array->setZero(Num);
+		}
+	}
+
+	void FAirframeBatchCoefficients::Set(int Index, const FAirframeModel& Airframe)
+	{
+		const FAerodynamicCoefficients& Coeffs = Airframe.Coefficients;
+		const FAerodynamicControlDerivatives& Ctrl = Airframe.ControlDerivatives;
+		const FAerodynamicStallParameters& Stall = Airframe.StallParameters;
+		const FGeometricCharacteristics& Geometry = Airframe.Geometry;
+
+		// The batch adds every control derivative term, so zero the derivatives of any surfaces this configuration doesn't have
+		// (which the kernel removes at compile time).
+		const FAirframeControlSurfaces Surfaces = GetAirframeControlSurfaces(Airframe.Configuration);
+		const float ElevatorMask = Surfaces.bHasElevator ? 1.0f : 0.0f;
+		const float AileronMask = Surfaces.bHasAileron ? 1.0f : 0.0f;
+		const float RudderMask = Surfaces.bHasRudder ? 1.0f : 0.0f;
+
+		CL0[Index] = Coeffs.CL.CL0; CLAlpha[Index] = Coeffs.CL.CLAlpha; CLq[Index] = Coeffs.CL.CLq; CLde[Index] = ElevatorMask * Ctrl.CLde;
+
+		CD0[Index] = Coeffs.CD.CD0; CDAlpha[Index] = Coeffs.CD.CDAlpha; CDAlpha2[Index] = Coeffs.CD.CDAlpha2; CDq[Index] = Coeffs.CD.CDq;
+		CDBeta[Index] = Coeffs.CD.CDBeta; CDBeta2[Index] = Coeffs.CD.CDBeta2; CDde[Index] = ElevatorMask * Ctrl.CDde;
+
+		CY0[Index] = Coeffs.CY.CY0; CYBeta[Index] = Coeffs.CY.CYBeta; CYp[Index] = Coeffs.CY.CYp; CYr[Index] = Coeffs.CY.CYr;
+		CYda[Index] = AileronMask * Ctrl.CYda; CYdr[Index] = RudderMask * Ctrl.CYdr;
+
+		CI0[Index] = Coeffs.CI.CI0; CIBeta[Index] = Coeffs.CI.CIBeta; CIp[Index] = Coeffs.CI.CIp; CIr[Index] = Coeffs.CI.CIr;
+		CIda[Index] = AileronMask * Ctrl.CIda; CIdr[Index] = RudderMask * Ctrl.CIdr;
+
+		Cm0[Index] = Coeffs.Cm.Cm0; CmAlpha[Index] = Coeffs.Cm.CmAlpha; Cmq[Index] = Coeffs.Cm.Cmq; Cmde[Index] = ElevatorMask * Ctrl.Cmde;
+
+		Cn0[Index] = Coeffs.Cn.Cn0; CnBeta[Index] = Coeffs.Cn.CnBeta; Cnp[Index] = Coeffs.Cn.Cnp; Cnr[Index] = Coeffs.Cn.Cnr;
+		Cnda[Index] = AileronMask * Ctrl.Cnda; Cndr[Index] = RudderMask * Ctrl.Cndr;
+
+		StallEnabled[Index] = Stall.bEnableStallModel ? 1.0f : 0.0f;
+		Alpha0[Index] = Stall.Alpha0; M[Index] = Stall.M; Cmfp[Index] = Stall.Cmfp;
+
+		b[Index] = Geometry.b; c[Index] = Geometry.c;
+		Ax[Index] = Geometry.A.x(); Ay[Index] = Geometry.A.y(); Az[Index] = Geometry.A.z();
+	}
+
+	void FAirframeBatch::Resize(int Num)
+	{
+		Coefficients.Resize(Num);
+
+		for (FBatchArray* Array : {
+			&alpha, &beta, &Va, &p, &q, &r, &Rho, &de, &da, &dr,
+			&Fx, &Fy, &Fz, &Mx, &My, &Mz,
+			&DynamicPressure, &cOver2Va, &bOver2Va, &SigmaAlpha, &ExpLower, &ExpUpper,
+			&sa, &ca, &sb, &cb,
+			&CDCalc, &CYCalc, &CLCalc })
+		{
+			Array->setZero(Num);
+		}
+	}
+
+	void FAirframeBatch::SetInputs(int Index, const FAirspeedState& AirspeedState, const FVector3& Omegab, float InRho, const FControlSurfaceDeflections& Deflections)
+	{
+		alpha[Index] = AirspeedState.alpha;
+		beta[Index] = AirspeedState.beta;
+		Va[Index] = AirspeedState.Va;
+		p[Index] = Omegab.x();
+		q[Index] = Omegab.y();
+		r[Index] = Omegab.z();
+		Rho[Index] = InRho;
+		de[Index] = Deflections.de;
+		da[Index] = Deflections.da;
+		dr[Index] = Deflections.dr;
+	}
+
+	void FAirframeBatch::CalculateForcesAndMoments()
+	{
+		// This follows FAirframeModel exactly, but each line is evaluated across the whole batch. Every expression is assigned straight into
+		// a preallocated array, so that Eigen can vectorise it without creating any temporaries.
+		const FAirframeBatchCoefficients& C = Coefficients;
+
+		// ********************* Aerodynamic Calculation Parameters ********************* //
+
+		DynamicPressure = 0.5f * Rho * Va.square();
+		// If Va is nearly 0, these are 0 (as per FAirframeModel).
+		bOver2Va = (Va.abs() > SmallNumber).select(C.b / (2.0f * Va), 0.0f);
+		cOver2Va = (Va.abs() > SmallNumber).select(C.c / (2.0f * Va), 0.0f);
+
+		// Sigmoid stall blending parameter, SigmaAlpha (0 where the stall model is disabled)
+		ExpLower = (-C.M * (alpha - C.Alpha0)).exp();
+		ExpUpper = (C.M * (alpha + C.Alpha0)).exp();
+		SigmaAlpha = (1.0f + ExpLower + ExpUpper).max(1.0f).min(FLT_MAX) / ((1.0f + ExpLower) * (1.0f + ExpUpper)).max(1.0f).min(FLT_MAX);
+		SigmaAlpha = SigmaAlpha.isNaN().select(1.0f, SigmaAlpha);
+		SigmaAlpha = (C.StallEnabled > 0.0f).select(SigmaAlpha, 0.0f);
+
+		sa = alpha.sin();
+		ca = alpha.cos();
+		sb = beta.sin();
+		cb = beta.cos();
+
+		// ******************************** Forces ******************************** //
+
+		// Flat plate stall blended into the "alpha" parts of the coefficients, followed by the rest of the coefficient impacts.
+		CDCalc = (1.0f - SigmaAlpha) * (C.CD0 + C.CDAlpha * alpha + C.CDAlpha2 * alpha.square()) + SigmaAlpha * 2.0f * alpha.sign() * sa.cube()
+			+ C.CDq * cOver2Va * q + C.CDBeta * beta + C.CDBeta2 * beta.square() + C.CDde * de;
+		CLCalc = (1.0f - SigmaAlpha) * (C.CL0 + C.CLAlpha * alpha) + SigmaAlpha * 2.0f * alpha.sign() * sa.square() * ca
+			+ C.CLq * cOver2Va * q + C.CLde * de;
+		CYCalc = C.CY0 + C.CYBeta * beta + C.CYp * bOver2Va * p + C.CYr * bOver2Va * r + C.CYda * da + C.CYdr * dr;
+
+		// Rotate (-CD, CY, -CL) from the wind frame to the body frame, as per TAirframeKernel::CalculateForcesAndMoments.
+		Fx = (-CDCalc * ca * cb - CYCalc * sb + CLCalc * sa * cb) * DynamicPressure * C.Ax;
+		Fy = (-CDCalc * ca * sb + CYCalc * cb + CLCalc * sa * sb) * DynamicPressure * C.Ay;
+		Fz = (-CDCalc * sa - CLCalc * ca) * DynamicPressure * C.Az;
+
+		// ******************************** Moments ******************************* //
+
+		Mx = (C.CI0 + C.CIBeta * beta + C.CIp * bOver2Va * p + C.CIr * bOver2Va * r + C.CIda * da + C.CIdr * dr) * C.b * DynamicPressure * C.Ax;
+		My = ((1.0f - SigmaAlpha) * (C.Cm0 + C.CmAlpha * alpha) + SigmaAlpha * C.Cmfp * alpha.sign() * sa.square()
+			+ C.Cmq * cOver2Va * q + C.Cmde * de) * C.c * DynamicPressure * C.Ay;
+		Mz = (C.Cn0 + C.CnBeta * beta + C.Cnp * bOver2Va * p + C.Cnr * bOver2Va * r + C.Cnda * da + C.Cndr * dr) * C.b * DynamicPressure * C.Az;
+	}
+
+	FForcesAndMoments FAirframeBatch::GetForcesAndMoments(int Index) const
+	{
+		return FForcesAndMoments(FVector3(Fx[Index], Fy[Index], Fz[Index]), FVector3(Mx[Index], My[Index], Mz[Index]));
+	}
+}
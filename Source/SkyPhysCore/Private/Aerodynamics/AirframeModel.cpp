@@ -0,0 +1,242 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SkyPhysCore/Aerodynamics/AirframeModel.h"
+
+#include "SkyPhysCore/Aerodynamics/AirframeKernel.h"
+
+#include <cfloat>
+#include <cmath>
+
+#include "SkyPhysCore/Common/MathUtils.h"
+
+namespace SkyPhysCore
+{
+	FAirspeedState CalculateAirspeedState(const FVector3& Vb, const FVector3& Vwb)
+	{
+		return CalculateAirspeedStateT(Vb, Vwb);
+	}
+
+	FAirspeedStated CalculateAirspeedState(const FVector3d& Vb, const FVector3d& Vwb)
+	{
+		return CalculateAirspeedStateT(Vb, Vwb);
+	}
+
+	FForcesAndMoments FAirframeModel::CalculateForcesAndMoments(const FAirspeedState& AirspeedState, const FVector3& Omegab, float Rho, const FControlSurfaceDeflections& Deflections) const
+	{
+		return SelectAirframeKernel<float>(Configuration, StallParameters.bEnableStallModel)(*this, AirspeedState, Omegab, Rho, Deflections);
+	}
+
+	FForcesAndMomentsd FAirframeModel::CalculateForcesAndMoments(const FAirspeedStated& AirspeedState, const FVector3d& Omegab, double Rho, const FControlSurfaceDeflectionsd& Deflections) const
+	{
+		return SelectAirframeKernel<double>(Configuration, StallParameters.bEnableStallModel)(*this, AirspeedState, Omegab, Rho, Deflections);
+	}
+
+	FAirframeJacobian FAirframeModel::CalculateJacobian(const FAirspeedState& AirspeedState, const FVector3& Omegab, float Rho, const FControlSurfaceDeflections& Deflections) const
+	{
+		// This follows TAirframeKernel term by term, carrying the derivative of each term with respect to the kernel inputs
+		// (alpha, beta, Va, p, q, r, de, da, dr), and is then chained through to the airspeed in the body frame.
+		enum EInput { Alpha, Beta, Airspeed, P, Q, R, De, Da, Dr, NumInputs };
+		using FInputRow = Eigen::Matrix<float, 1, NumInputs>;
+
+		FAirframeJacobian Jacobian = FAirframeJacobian::Zero();
+
+		const float Va = AirspeedState.Va;
+		if (IsNearlyZero(Va))
+		{
+			return Jacobian;
+		}
+
+		const FAerodynamicCoefficients& C = Coefficients;
+		const FAerodynamicControlDerivatives& Ctrl = ControlDerivatives;
+
+		// Only the surfaces this configuration actually has contribute (as per the kernel's configuration policies).
+		const FAirframeControlSurfaces Surfaces = GetAirframeControlSurfaces(Configuration);
+		const bool bHasElevator = Surfaces.bHasElevator;
+		const bool bHasAileron = Surfaces.bHasAileron;
+		const bool bHasRudder = Surfaces.bHasRudder;
+
+		const float de = bHasElevator ? Deflections.de : 0.0f;
+		const float da = bHasAileron ? Deflections.da : 0.0f;
+		const float dr = bHasRudder ? Deflections.dr : 0.0f;
+
+		const float p = Omegab.x();
+		const float q = Omegab.y();
+		const float r = Omegab.z();
+		const float alpha = AirspeedState.alpha;
+		const float beta = AirspeedState.beta;
+
+		const float sa = sin(alpha);
+		const float ca = cos(alpha);
+		const float sb = sin(beta);
+		const float cb = cos(beta);
+
+		// 1/(2Va), which scales the rate derivatives, and its derivative with respect to Va
+		const float k = 1.0f / (2.0f * Va);
+		const float dk = -2.0f * k * k;
+		const float b = Geometry.b;
+		const float c = Geometry.c;
+
+		const float DynamicPressure = 0.5f * Rho * Va * Va;
+		const float dDynamicPressure = Rho * Va;
+
+		// Stall blending, and its derivative with respect to alpha
+		float SigmaAlpha = 0.0f;
+		float dSigmaAlpha = 0.0f;
+		if (StallParameters.bEnableStallModel)
+		{
+			const float M = StallParameters.M;
+			const float ExpLower = exp(-M * (alpha - StallParameters.Alpha0));
+			const float ExpUpper = exp(M * (alpha + StallParameters.Alpha0));
+			const float Numerator = 1 + ExpLower + ExpUpper;
+			const float Denominator = (1 + ExpLower) * (1 + ExpUpper);
+			const float dNumerator = -M * ExpLower + M * ExpUpper;
+			const float dDenominator = -M * ExpLower * (1 + ExpUpper) + (1 + ExpLower) * M * ExpUpper;
+
+			SigmaAlpha = Numerator / Denominator;
+			dSigmaAlpha = (dNumerator * Denominator - Numerator * dDenominator) / (Denominator * Denominator);
+
+			// Far enough past the transition, the exponentials overflow and the kernel clamps to a fully stalled (constant) blend.
+			if (!std::isfinite(SigmaAlpha) || !std::isfinite(dSigmaAlpha))
+			{
+				SigmaAlpha = 1.0f;
+				dSigmaAlpha = 0.0f;
+			}
+		}
+
+		const float s = Sign(alpha);
+
+		// ******************************** Forces ******************************* //
+
+		const float CLALPHALinear = C.CL.CL0 + C.CL.CLAlpha * alpha;
+		const float CDALPHALinear = C.CD.CD0 + C.CD.CDAlpha * alpha + C.CD.CDAlpha2 * alpha * alpha;
+		const float CmALPHALinear = C.Cm.Cm0 + C.Cm.CmAlpha * alpha;
+
+		const float CLALPHA = (1 - SigmaAlpha) * CLALPHALinear + SigmaAlpha * 2 * s * (sa * sa * ca);
+		const float CDALPHA = (1 - SigmaAlpha) * CDALPHALinear + SigmaAlpha * 2 * s * (sa * sa * sa);
+		const float CmALPHA = (1 - SigmaAlpha) * CmALPHALinear + SigmaAlpha * (StallParameters.Cmfp * s * sa * sa);
+
+		const float dCLALPHA = -dSigmaAlpha * CLALPHALinear + (1 - SigmaAlpha) * C.CL.CLAlpha
+			+ dSigmaAlpha * 2 * s * (sa * sa * ca) + SigmaAlpha * 2 * s * (2 * sa * ca * ca - sa * sa * sa);
+		const float dCDALPHA = -dSigmaAlpha * CDALPHALinear + (1 - SigmaAlpha) * (C.CD.CDAlpha + 2 * C.CD.CDAlpha2 * alpha)
+			+ dSigmaAlpha * 2 * s * (sa * sa * sa) + SigmaAlpha * 2 * s * (3 * sa * sa * ca);
+		const float dCmALPHA = -dSigmaAlpha * CmALPHALinear + (1 - SigmaAlpha) * C.Cm.CmAlpha
+			+ dSigmaAlpha * StallParameters.Cmfp * s * sa * sa + SigmaAlpha * StallParameters.Cmfp * s * 2 * sa * ca;
+
+		// Coefficients, and their derivatives
+		const float CDCalc = CDALPHA + C.CD.CDq * c * k * q + C.CD.CDBeta * beta + C.CD.CDBeta2 * beta * beta + Ctrl.CDde * de;
+		const float CLCalc = CLALPHA + C.CL.CLq * c * k * q + Ctrl.CLde * de;
+		const float CYCalc = C.CY.CY0 + C.CY.CYBeta * beta + C.CY.CYp * b * k * p + C.CY.CYr * b * k * r + Ctrl.CYda * da + Ctrl.CYdr * dr;
+
+		FInputRow dCD = FInputRow::Zero();
+		dCD(Alpha) = dCDALPHA;
+		dCD(Beta) = C.CD.CDBeta + 2 * C.CD.CDBeta2 * beta;
+		dCD(Airspeed) = C.CD.CDq * c * dk * q;
+		dCD(Q) = C.CD.CDq * c * k;
+		dCD(De) = bHasElevator ? Ctrl.CDde : 0.0f;
+
+		FInputRow dCL = FInputRow::Zero();
+		dCL(Alpha) = dCLALPHA;
+		dCL(Airspeed) = C.CL.CLq * c * dk * q;
+		dCL(Q) = C.CL.CLq * c * k;
+		dCL(De) = bHasElevator ? Ctrl.CLde : 0.0f;
+
+		FInputRow dCY = FInputRow::Zero();
+		dCY(Beta) = C.CY.CYBeta;
+		dCY(Airspeed) = (C.CY.CYp * p + C.CY.CYr * r) * b * dk;
+		dCY(P) = C.CY.CYp * b * k;
+		dCY(R) = C.CY.CYr * b * k;
+		dCY(Da) = bHasAileron ? Ctrl.CYda : 0.0f;
+		dCY(Dr) = bHasRudder ? Ctrl.CYdr : 0.0f;
+
+		// Wind to body rotation (as per the kernel), and its derivatives
+		const FVector3 Fw(-CDCalc, CYCalc, -CLCalc);
+		Eigen::Matrix<float, 3, NumInputs> dFw;
+		dFw << -dCD, dCY, -dCL;
+
+		FMatrix3 Rbw;
+		Rbw << ca * cb, -sb, -sa * cb,
+			   ca * sb, cb, -sa * sb,
+			   sa, 0.0f, ca;
+
+		FMatrix3 dRbwdAlpha;
+		dRbwdAlpha << -sa * cb, 0.0f, -ca * cb,
+					  -sa * sb, 0.0f, -ca * sb,
+					  ca, 0.0f, -sa;
+
+		FMatrix3 dRbwdBeta;
+		dRbwdBeta << -ca * sb, -cb, sa * sb,
+					 ca * cb, -sb, -sa * cb,
+					 0.0f, 0.0f, 0.0f;
+
+		const FVector3 Fxyz = Rbw * Fw;
+		Eigen::Matrix<float, 3, NumInputs> dFxyz = Rbw * dFw;
+		dFxyz.col(Alpha) += dRbwdAlpha * Fw;
+		dFxyz.col(Beta) += dRbwdBeta * Fw;
+
+		// ******************************* Moments ******************************* //
+
+		const float CICalc = C.CI.CI0 + C.CI.CIBeta * beta + C.CI.CIp * b * k * p + C.CI.CIr * b * k * r + Ctrl.CIda * da + Ctrl.CIdr * dr;
+		const float CmCalc = CmALPHA + C.Cm.Cmq * c * k * q + Ctrl.Cmde * de;
+		const float CnCalc = C.Cn.Cn0 + C.Cn.CnBeta * beta + C.Cn.Cnp * b * k * p + C.Cn.Cnr * b * k * r + Ctrl.Cnda * da + Ctrl.Cndr * dr;
+
+		FInputRow dCI = FInputRow::Zero();
+		dCI(Beta) = C.CI.CIBeta;
+		dCI(Airspeed) = (C.CI.CIp * p + C.CI.CIr * r) * b * dk;
+		dCI(P) = C.CI.CIp * b * k;
+		dCI(R) = C.CI.CIr * b * k;
+		dCI(Da) = bHasAileron ? Ctrl.CIda : 0.0f;
+		dCI(Dr) = bHasRudder ? Ctrl.CIdr : 0.0f;
+
+		FInputRow dCm = FInputRow::Zero();
+		dCm(Alpha) = dCmALPHA;
+		dCm(Airspeed) = C.Cm.Cmq * c * dk * q;
+		dCm(Q) = C.Cm.Cmq * c * k;
+		dCm(De) = bHasElevator ? Ctrl.Cmde : 0.0f;
+
+		FInputRow dCn = FInputRow::Zero();
+		dCn(Beta) = C.Cn.CnBeta;
+		dCn(Airspeed) = (C.Cn.Cnp * p + C.Cn.Cnr * r) * b * dk;
+		dCn(P) = C.Cn.Cnp * b * k;
+		dCn(R) = C.Cn.Cnr * b * k;
+		dCn(Da) = bHasAileron ? Ctrl.Cnda : 0.0f;
+		dCn(Dr) = bHasRudder ? Ctrl.Cndr : 0.0f;
+
+		const FVector3 Mxyz(CICalc * b, CmCalc * c, CnCalc * b);
+		Eigen::Matrix<float, 3, NumInputs> dMxyz;
+		dMxyz << dCI * b, dCm * c, dCn * b;
+
+		// ************************ Dynamic Pressure Scaling ********************* //
+
+		// Forces and moments are the coefficients scaled by DynamicPressure * A (per axis).
+		Eigen::Matrix<float, 6, NumInputs> dForcesAndMoments;
+		dForcesAndMoments.topRows<3>() = (Geometry.A * DynamicPressure).asDiagonal() * dFxyz;
+		dForcesAndMoments.bottomRows<3>() = (Geometry.A * DynamicPressure).asDiagonal() * dMxyz;
+		dForcesAndMoments.block<3, 1>(0, Airspeed) += Fxyz.cwiseProduct(Geometry.A) * dDynamicPressure;
+		dForcesAndMoments.block<3, 1>(3, Airspeed) += Mxyz.cwiseProduct(Geometry.A) * dDynamicPressure;
+
+		// ****************** Chain Through to the Body Airspeed ***************** //
+
+		// Va = |Vab|, alpha = atan2(w, u) and beta = asin(v / Va)
+		const float u = AirspeedState.Vab.x();
+		const float v = AirspeedState.Vab.y();
+		const float w = AirspeedState.Vab.z();
+		const float uw2 = u * u + w * w;
+		const float uw = sqrt(uw2);
+
+		Eigen::Matrix<float, 3, 3> dAirspeedParameters = Eigen::Matrix<float, 3, 3>::Zero(); // Rows: alpha, beta, Va. Columns: u, v, w.
+		if (!IsNearlyZero(uw2))
+		{
+			dAirspeedParameters.row(0) << -w / uw2, 0.0f, u / uw2;
+			dAirspeedParameters.row(1) << -v * u / (Va * Va * uw), uw / (Va * Va), -v * w / (Va * Va * uw);
+		}
+		dAirspeedParameters.row(2) = AirspeedState.Vab.transpose() / Va;
+
+		Jacobian.leftCols<3>() = dForcesAndMoments.leftCols<3>() * dAirspeedParameters;
+		Jacobian.rightCols<6>() = dForcesAndMoments.rightCols<6>();
+
+		return Jacobian;
+	}
+
+	template TAirframeKernelFunction<float> SelectAirframeKernel<float>(EAirframeConfiguration, bool);
+	template TAirframeKernelFunction<double> SelectAirframeKernel<double>(EAirframeConfiguration, bool);
+}
@@ -0,0 +1,37 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SkyPhysCore/Common/AllocationTracker.h"
+
+#include <atomic>
+
+namespace SkyPhysCore
+{
+	namespace AllocationTrackerDetail
+	{
+		bool bTracking = false;
+
+		// For the whole process, so the allocations of other threads (eg. FTaskPool workers stepping a fleet) are counted too.
+		// Only the totals matter, so the increments don't need to be ordered with anything else.
+		std::atomic<uint64_t> NumAllocations(0);
+		std::atomic<uint64_t> NumBytes(0);
+	}
+
+	void FAllocationTracker::RecordAllocation(size_t Size)
+	{
+		AllocationTrackerDetail::NumAllocations.fetch_add(1, std::memory_order_relaxed);
+		AllocationTrackerDetail::NumBytes.fetch_add(Size, std::memory_order_relaxed);
+	}
+
+	FAllocationCounts FAllocationTracker::GetCounts()
+	{
+		FAllocationCounts Counts;
+		Counts.NumAllocations = AllocationTrackerDetail::NumAllocations.load(std::memory_order_relaxed);
+		Counts.NumBytes = AllocationTrackerDetail::NumBytes.load(std::memory_order_relaxed);
+		return Counts;
+	}
+
+	bool FAllocationTracker::IsTracking()
+	{
+		return AllocationTrackerDetail::bTracking;
+	}
+}
@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SkyPhysCore/Common/TaskPool.h"
+
+namespace SkyPhysCore
+{
+	FTaskPool::FTaskPool(int NumWorkers)
+	{
+		Workers.reserve(NumWorkers > 0 ? NumWorkers : 0);
+		for (int i = 0; i < NumWorkers; i++)
+		{
+			// Thread 0 is the calling thread, so workers start at 1.
+			Workers.emplace_back(&FTaskPool::WorkerLoop, this, i + 1);
+		}
+	}
+
+	FTaskPool::~FTaskPool()
+	{
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			bStop = true;
+		}
+		WorkReady.notify_all();
+
+		for (std::thread& Worker : Workers)
+		{
+			Worker.join();
+		}
+	}
+
+	void FTaskPool::ParallelFor(int InNum, const std::function<void(int)>& InBody)
+	{
+		if (Workers.empty() || InNum <= 1)
+		{
+			SerialFor(InNum, InBody);
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			Body = &InBody;
+			Num = InNum;
+			NumPending = static_cast<int>(Workers.size());
+			Generation++;
+		}
+		WorkReady.notify_all();
+
+		// The calling thread takes the first chunk
+		RunChunk(0);
+
+		std::unique_lock<std::mutex> Lock(Mutex);
+		WorkDone.wait(Lock, [this] { return NumPending == 0; });
+		Body = nullptr;
+	}
+
+	void FTaskPool::WorkerLoop(int ThreadIndex)
+	{
+		uint64_t LastGeneration = 0;
+
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> Lock(Mutex);
+				WorkReady.wait(Lock, [this, LastGeneration] { return bStop || Generation != LastGeneration; });
+				if (bStop)
+				{
+					return;
+				}
+				LastGeneration = Generation;
+			}
+
+			RunChunk(ThreadIndex);
+
+			bool bLast = false;
+			{
+				std::lock_guard<std::mutex> Lock(Mutex);
+				bLast = (--NumPending == 0);
+			}
+			if (bLast)
+			{
+				WorkDone.notify_one();
+			}
+		}
+	}
+
+	void FTaskPool::RunChunk(int ThreadIndex)
+	{
+		// Contiguous chunks, so that each thread works through neighbouring vehicles.
+		const int64_t Threads = NumThreads();
+		const int Begin = static_cast<int>((static_cast<int64_t>(Num) * ThreadIndex) / Threads);
+		const int End = static_cast<int>((static_cast<int64_t>(Num) * (ThreadIndex + 1)) / Threads);
+
+		for (int i = Begin; i < End; i++)
+		{
+			(*Body)(i);
+		}
+	}
+}
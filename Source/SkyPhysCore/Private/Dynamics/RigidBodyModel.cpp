@@ -0,0 +1,133 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SkyPhysCore/Dynamics/RigidBodyModel.h"
+
+#include "SkyPhysCore/Common/MathUtils.h"
+
+namespace SkyPhysCore
+{
+	template<typename TScalar>
+	void TMassProperties<TScalar>::PreCalculate()
+	{
+		J << Ixx		, TScalar(0)	, -Ixz,
+			 TScalar(0)	, Iyy		, TScalar(0),
+			 -Ixz		, TScalar(0)	, Izz;
+
+		JInverse = J.inverse();
+	}
+
+	template<typename TScalar>
+	TRigidBodyStage<TScalar> TRigidBodyStage<TScalar>::FromState(const TRigidBodyState<TScalar>& State)
+	{
+		TRigidBodyStage Stage;
+		Stage.Position = State.Position;
+		Stage.Vw = State.Attitude * State.Vb;
+		Stage.Attitude = State.Attitude.coeffs();
+		Stage.Omegab = State.Omegab;
+		return Stage;
+	}
+
+	template<typename TScalar>
+	TRigidBodyState<TScalar> TRigidBodyStage<TScalar>::ToState() const
+	{
+		TRigidBodyState<TScalar> State;
+		State.Position = Position;
+		State.Attitude.coeffs() = Attitude;
+		State.Attitude.normalize();
+		State.Vb = State.Attitude.conjugate() * Vw;
+		State.Omegab = Omegab;
+		return State;
+	}
+
+	template<typename TScalar>
+	TRigidBodyStage<TScalar> TRigidBodyStage<TScalar>::Advance(const TRigidBodyStage& Derivative, TScalar DeltaTime) const
+	{
+		TRigidBodyStage Stage;
+		Stage.Position = Position + Derivative.Position * DeltaTime;
+		Stage.Vw = Vw + Derivative.Vw * DeltaTime;
+		Stage.Attitude = Attitude + Derivative.Attitude * DeltaTime;
+		Stage.Omegab = Omegab + Derivative.Omegab * DeltaTime;
+		return Stage;
+	}
+
+	template<typename TScalar>
+	void TRigidBodyModel<TScalar>::CalculateVelocityIncrements(const FVector3& Omegab, const FForcesAndMoments& ForcesAndMoments, TScalar DeltaTime, FVector3& dVb, FVector3& dOmegab) const
+	{
+		// ************************* Linear Kinematics ************************* //
+
+		// Rearrange F = m dV/dt to dV = dt*(F/m)
+		dVb = DeltaTime * ForcesAndMoments.Forces / MassProperties.Mass;
+
+		// ************************* Angular Kinematics ************************ //
+
+		// dOmegab/dt = JInverse * (Moments - Omegab x ( J * Omegab ) -> with everything in the body frame
+		// dOmegab = JInverse * (Moments - Omegab x ( J * Omegab ) * dt
+		dOmegab = (MassProperties.JInverse * (ForcesAndMoments.Moments - Omegab.cross(MassProperties.J * Omegab))) * DeltaTime;
+	}
+
+	template<typename TScalar>
+	void TRigidBodyModel<TScalar>::Integrate(FRigidBodyState& State, const FForcesAndMoments& ForcesAndMoments, const FVector3& Gravity, TScalar DeltaTime) const
+	{
+		FVector3 dVb;
+		FVector3 dOmegab;
+		CalculateVelocityIncrements(State.Omegab, ForcesAndMoments, DeltaTime, dVb, dOmegab);
+
+		const TMatrix3<TScalar> Rwb = State.Attitude.toRotationMatrix();
+
+		// Velocities are updated first, and then used to update the pose (semi-implicit Euler).
+		// Linear velocity is integrated in the world frame, so that we don't need to account for the rotating body frame.
+		FVector3 Vw = Rwb * (State.Vb + dVb) + Gravity * DeltaTime;
+		State.Omegab += dOmegab;
+
+		State.Position += Vw * DeltaTime;
+
+		// Rotate the attitude by the body rotation over this step
+		const FVector3 dTheta = State.Omegab * DeltaTime;
+		const TScalar Angle = dTheta.norm();
+		if (!IsNearlyZero(Angle))
+		{
+			State.Attitude = State.Attitude * TQuaternion<TScalar>(Eigen::AngleAxis<TScalar>(Angle, dTheta / Angle));
+			State.Attitude.normalize();
+		}
+		else
+		{
+			// To first order (which leaves the attitude as it is for no rotation at all, but keeps its derivative with respect to the rotation).
+			State.Attitude.coeffs() += TScalar(0.5) * (State.Attitude * TQuaternion<TScalar>(TScalar(0), dTheta.x(), dTheta.y(), dTheta.z())).coeffs();
+		}
+
+		// And then express our linear velocity in the (new) body frame
+		State.Vb = State.Attitude.conjugate() * Vw;
+	}
+
+	template<typename TScalar>
+	TRigidBodyStage<TScalar> TRigidBodyModel<TScalar>::CalculateDerivative(const FRigidBodyStage& Stage, const FForcesAndMoments& ForcesAndMoments, const FVector3& Gravity) const
+	{
+		TQuaternion<TScalar> Attitude;
+		Attitude.coeffs() = Stage.Attitude;
+		Attitude.normalize();
+
+		// The angular acceleration is the same as our velocity increment over unit time.
+		FVector3 dVb;
+		FVector3 dOmegab;
+		CalculateVelocityIncrements(Stage.Omegab, ForcesAndMoments, TScalar(1), dVb, dOmegab);
+
+		FRigidBodyStage Derivative;
+		Derivative.Position = Stage.Vw;
+		Derivative.Vw = Attitude * dVb + Gravity;
+		// dq/dt = 0.5 * q * (0, Omegab)
+		Derivative.Attitude = TScalar(0.5) * (Attitude * TQuaternion<TScalar>(TScalar(0), Stage.Omegab.x(), Stage.Omegab.y(), Stage.Omegab.z())).coeffs();
+		Derivative.Omegab = dOmegab;
+		return Derivative;
+	}
+
+	template struct TMassProperties<float>;
+	template struct TMassProperties<double>;
+	template struct TRigidBodyStage<float>;
+	template struct TRigidBodyStage<double>;
+	template class TRigidBodyModel<float>;
+	template class TRigidBodyModel<double>;
+
+	template struct TMassProperties<FDual>;
+	template struct TRigidBodyStage<FDual>;
+	template class TRigidBodyModel<FDual>;
+}
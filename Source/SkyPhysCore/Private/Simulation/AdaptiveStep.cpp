@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SkyPhysCore/Simulation/AdaptiveStep.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "SkyPhysCore/Common/MathUtils.h"
+
+namespace SkyPhysCore
+{
+	float FAdaptiveStepController::CalculateNextStep(float RemainingTime, float MaxCharacteristicRate)
+	{
+		// Start from the step the error estimate allows (or the largest step, until we have an estimate), and then limit this by the stiffness.
+		float Step = ErrorStep > 0.0f ? ErrorStep : Parameters.MaxStep;
+
+		bool bStiffnessLimited = false;
+		if (MaxCharacteristicRate > 0.0f && Parameters.StabilityFactor / MaxCharacteristicRate < Step)
+		{
+			Step = Parameters.StabilityFactor / MaxCharacteristicRate;
+			bStiffnessLimited = true;
+		}
+
+		Step = Clamp(Step, Parameters.MinStep, Parameters.MaxStep);
+
+		// Cover the remaining time exactly, splitting the last two steps evenly rather than leaving a tiny one at the end.
+		if (RemainingTime <= Step)
+		{
+			Step = RemainingTime;
+		}
+		else if (RemainingTime < 2.0f * Step)
+		{
+			Step = 0.5f * RemainingTime;
+		}
+
+		CurrentStep = Step;
+
+		Stats.MinStepTaken = Stats.NumSteps > 0 ? std::min(Stats.MinStepTaken, Step) : Step;
+		Stats.MaxStepTaken = std::max(Stats.MaxStepTaken, Step);
+		Stats.LastStep = Step;
+		Stats.SimulatedTime += Step;
+		Stats.NumSteps++;
+		if (bStiffnessLimited)
+		{
+			Stats.NumStiffnessLimitedSteps++;
+		}
+
+		return Step;
+	}
+
+	void FAdaptiveStepController::Update(const FVector3& LinearAcceleration, const FVector3& AngularAcceleration)
+	{
+		if (bHaveAccelerations && PreviousStep > 0.0f)
+		{
+			// The difference between an Euler and a trapezoidal step over the previous step
+			const float LinearError = (LinearAcceleration - PreviousLinearAcceleration).norm();
+			const float AngularError = (AngularAcceleration - PreviousAngularAcceleration).norm();
+			const float ErrorEstimate = 0.5f * PreviousStep * std::max(LinearError, AngularError);
+
+			// The estimate is first order, so the step scales with the square root of the error ratio. The change is limited per step (and has some
+			// safety margin), so that a single noisy estimate doesn't throw the step size around. As the estimate lags a step behind, the growth is
+			// also limited relative to the step just taken (which may already have been cut, eg. by the stiffness limit or a previous estimate).
+			const float Scale = ErrorEstimate > SmallNumber ? Clamp(0.9f * std::sqrt(Parameters.Tolerance / ErrorEstimate), 0.2f, 2.0f) : 2.0f;
+			ErrorStep = Clamp(std::min(PreviousStep * Scale, 2.0f * CurrentStep), Parameters.MinStep, Parameters.MaxStep);
+
+			Stats.LastErrorEstimate = ErrorEstimate;
+		}
+
+		PreviousLinearAcceleration = LinearAcceleration;
+		PreviousAngularAcceleration = AngularAcceleration;
+		PreviousStep = CurrentStep;
+		bHaveAccelerations = true;
+	}
+
+	void FAdaptiveStepController::Reset()
+	{
+		ErrorStep = 0.0f;
+		CurrentStep = 0.0f;
+		PreviousStep = 0.0f;
+		bHaveAccelerations = false;
+	}
+
+	float CalculateAirframeCharacteristicRate(const FAirframeModel& Airframe, const FMassProperties& MassProperties, float Va, float Rho)
+	{
+		const FAerodynamicCoefficients& C = Airframe.Coefficients;
+		const FGeometricCharacteristics& G = Airframe.Geometry;
+
+		const float Ixx = std::max(MassProperties.Ixx, SmallNumber);
+		const float Iyy = std::max(MassProperties.Iyy, SmallNumber);
+		const float Izz = std::max(MassProperties.Izz, SmallNumber);
+		const float Mass = std::max(MassProperties.Mass, SmallNumber);
+
+		// Damping rates are the derivative of the moment (or force) with respect to the rate (or velocity) it damps, over the inertia (or mass).
+		// eg. dl/dp = 0.5 * rho * Va^2 * S * b * CIp * b / (2 * Va), so the roll damping rate is rho * Va * S * b^2 * |CIp| / (4 * Ixx).
+		const float RollDamping = Rho * Va * G.A.x() * G.b * G.b * std::abs(C.CI.CIp) / (4.0f * Ixx);
+		const float PitchDamping = Rho * Va * G.A.y() * G.c * G.c * std::abs(C.Cm.Cmq) / (4.0f * Iyy);
+		const float YawDamping = Rho * Va * G.A.z() * G.b * G.b * std::abs(C.Cn.Cnr) / (4.0f * Izz);
+		const float HeaveDamping = Rho * Va * G.A.z() * std::abs(C.CL.CLAlpha) / (2.0f * Mass);
+
+		// And the short period frequency due to the pitch stiffness
+		const float PitchStiffness = std::sqrt(0.5f * Rho * Va * Va * G.A.y() * G.c * std::abs(C.Cm.CmAlpha) / Iyy);
+
+		return std::max({ RollDamping, PitchDamping, YawDamping, HeaveDamping, PitchStiffness });
+	}
+
+	float CalculateGyroscopicCharacteristicRate(float AngularMomentum, const FMassProperties& MassProperties)
+	{
+		const float MinInertia = std::max(std::min({ MassProperties.Ixx, MassProperties.Iyy, MassProperties.Izz }), SmallNumber);
+		return std::abs(AngularMomentum) / MinInertia;
+	}
+}
@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SkyPhysCore/Simulation/Fleet.h"
+
+#include <chrono>
+
+namespace SkyPhysCore
+{
+	int FFleet::AddVehicle(const FVehicle& Vehicle)
+	{
+		Vehicles.push_back(Vehicle);
+
+		// Resizing the batch clears it, so all of the airframes need to be set again (this only happens when the fleet changes).
+		AirframeBatch.Resize(Num());
+		for (int i = 0; i < Num(); i++)
+		{
+			AirframeBatch.SetAirframe(i, Vehicles[i].AirframeModel);
+		}
+
+		return Num() - 1;
+	}
+
+	void FFleet::Reset()
+	{
+		Vehicles.clear();
+		AirframeBatch.Resize(0);
+	}
+
+	int FFleet::Advance(float FrameDeltaTime)
+	{
+		const int NumSteps = Clock.Advance(FrameDeltaTime);
+		for (int i = 0; i < NumSteps; i++)
+		{
+			Step(Clock.GetFixedDeltaTime());
+		}
+
+		return NumSteps;
+	}
+
+	void FFleet::SetRandomSeed(uint64_t Seed)
+	{
+		for (int i = 0; i < Num(); i++)
+		{
+			Vehicles[i].SetRandomSeed(FRandomStream::DeriveSeed(Seed, i));
+		}
+	}
+
+	uint64_t FFleet::CalculateStateHash() const
+	{
+		FStateHash Hash;
+		for (const FVehicle& Vehicle : Vehicles)
+		{
+			Vehicle.AddToHash(Hash);
+		}
+
+		return Hash.Get();
+	}
+
+	FLockstepStats FFleet::Step(int NumSteps, float DeltaTime)
+	{
+		const std::chrono::steady_clock::time_point StartTime = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < NumSteps; i++)
+		{
+			Step(DeltaTime);
+		}
+
+		FLockstepStats Stats;
+		Stats.NumSteps = NumSteps;
+		Stats.SimulatedTime = static_cast<double>(NumSteps) * DeltaTime;
+		Stats.WallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+
+		LockstepStats.NumSteps += Stats.NumSteps;
+		LockstepStats.SimulatedTime += Stats.SimulatedTime;
+		LockstepStats.WallTime += Stats.WallTime;
+
+		return Stats;
+	}
+
+	void FFleet::Step(float DeltaTime)
+	{
+		// First update the state of each vehicle, and gather the airframe inputs.
+		ParallelFor(Num(), [this, DeltaTime](int i)
+			{
+				FVehicle& Vehicle = Vehicles[i];
+				Vehicle.UpdateState(DeltaTime);
+				AirframeBatch.SetInputs(i, Vehicle.AirspeedState, Vehicle.RigidBodyState.Omegab, Vehicle.AtmosphericConditionsState.rho, Vehicle.ControlSurfaceDeflections);
+			});
+
+		// Then calculate the airframe forces and moments for the whole fleet at once.
+		AirframeBatch.CalculateForcesAndMoments();
+
+		// And finally apply these (with propulsion) to each vehicle.
+		ParallelFor(Num(), [this, DeltaTime](int i)
+			{
+				Vehicles[i].ApplyForcesAndMoments(AirframeBatch.GetForcesAndMoments(i), DeltaTime);
+			});
+	}
+}
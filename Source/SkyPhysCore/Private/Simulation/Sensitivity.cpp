@@ -0,0 +1,290 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SkyPhysCore/Simulation/Sensitivity.h"
+
+#include <vector>
+
+#include "SkyPhysCore/Aerodynamics/AirframeKernel.h"
+#include "SkyPhysCore/Common/Dual.h"
+#include "SkyPhysCore/Common/MathUtils.h"
+#include "SkyPhysCore/Simulation/Vehicle.h"
+
+namespace SkyPhysCore
+{
+	using FDualVector3 = TVector3<FDual>;
+	using FDualMatrix3 = TMatrix3<FDual>;
+	using FDualQuaternion = TQuaternion<FDual>;
+
+	namespace
+	{
+		// Hands out the variables of one evaluation of the step, in the order of the directions (the states, then the inputs, then the parameters).
+		// Only FDual::NumDirections of them are seeded per evaluation (from FirstDirection), and the rest are constants.
+		class FDualSeeder
+		{
+		public:
+			explicit FDualSeeder(int FirstDirection) : FirstDirection(FirstDirection) {};
+
+			FDual Next(double Value)
+			{
+				const int Direction = NumDirections++ - FirstDirection;
+				return (Direction >= 0 && Direction < FDual::NumDirections) ? FDual::Variable(Value, Direction) : FDual(Value);
+			};
+
+			// The number of directions handed out so far
+			int GetNumDirections() const { return NumDirections; };
+
+		private:
+			int FirstDirection = 0;
+			int NumDirections = 0;
+		};
+	}
+
+	// Call Function(Coefficient, DualCoefficient) for each aerodynamic coefficient, in declaration order.
+	template<typename TFunction>
+	static void ForEachAerodynamicCoefficient(const FAerodynamicCoefficients& C, TAerodynamicCoefficients<FDual>& Dual, TFunction&& Function)
+	{
+		Function(C.CL.CL0, Dual.CL.CL0);
+		Function(C.CL.CLAlpha, Dual.CL.CLAlpha);
+		Function(C.CL.CLq, Dual.CL.CLq);
+
+		Function(C.CD.CD0, Dual.CD.CD0);
+		Function(C.CD.CDAlpha, Dual.CD.CDAlpha);
+		Function(C.CD.CDAlpha2, Dual.CD.CDAlpha2);
+		Function(C.CD.CDq, Dual.CD.CDq);
+		Function(C.CD.CDBeta, Dual.CD.CDBeta);
+		Function(C.CD.CDBeta2, Dual.CD.CDBeta2);
+
+		Function(C.CY.CY0, Dual.CY.CY0);
+		Function(C.CY.CYBeta, Dual.CY.CYBeta);
+		Function(C.CY.CYp, Dual.CY.CYp);
+		Function(C.CY.CYr, Dual.CY.CYr);
+
+		Function(C.CI.CI0, Dual.CI.CI0);
+		Function(C.CI.CIBeta, Dual.CI.CIBeta);
+		Function(C.CI.CIp, Dual.CI.CIp);
+		Function(C.CI.CIr, Dual.CI.CIr);
+
+		Function(C.Cm.Cm0, Dual.Cm.Cm0);
+		Function(C.Cm.CmAlpha, Dual.Cm.CmAlpha);
+		Function(C.Cm.Cmq, Dual.Cm.Cmq);
+
+		Function(C.Cn.Cn0, Dual.Cn.Cn0);
+		Function(C.Cn.CnBeta, Dual.Cn.CnBeta);
+		Function(C.Cn.Cnp, Dual.Cn.Cnp);
+		Function(C.Cn.Cnr, Dual.Cn.Cnr);
+	}
+
+	// Call Function(Derivative, DualDerivative) for each control derivative, in declaration order.
+	template<typename TFunction>
+	static void ForEachControlDerivative(const FAerodynamicControlDerivatives& Ctrl, TAerodynamicControlDerivatives<FDual>& Dual, TFunction&& Function)
+	{
+		Function(Ctrl.CLde, Dual.CLde);
+		Function(Ctrl.CDde, Dual.CDde);
+		Function(Ctrl.CYda, Dual.CYda);
+		Function(Ctrl.CYdr, Dual.CYdr);
+		Function(Ctrl.CIda, Dual.CIda);
+		Function(Ctrl.CIdr, Dual.CIdr);
+		Function(Ctrl.Cmde, Dual.Cmde);
+		Function(Ctrl.Cnda, Dual.Cnda);
+		Function(Ctrl.Cndr, Dual.Cndr);
+	}
+
+	static FVector3d GetValue(const FDualVector3& Vector)
+	{
+		return FVector3d(Vector.x().Value, Vector.y().Value, Vector.z().Value);
+	}
+
+	// Evaluate one step of the vehicle in dual numbers, with the directions seeded by Seeder.
+	static TRigidBodyState<FDual> EvaluateStep(const FVehicle& Vehicle, float DeltaTime, const FSensitivityParameters& Parameters, FDualSeeder& Seeder)
+	{
+		const int NumPropulsors = static_cast<int>(Vehicle.Propulsors.size());
+
+		// One at a time, as the directions are handed out in order (and the order of evaluation of constructor arguments isn't defined).
+		auto SeedVector = [&](const FVector3& Vector)
+		{
+			FDualVector3 DualVector;
+			for (int i = 0; i < 3; i++)
+			{
+				DualVector(i) = Seeder.Next(Vector(i));
+			}
+			return DualVector;
+		};
+
+		// Parameters are only seeded if their group is enabled.
+		auto SeedParameter = [&](bool bEnabled, float Value)
+		{
+			return bEnabled ? Seeder.Next(Value) : FDual(Value);
+		};
+
+		// ***************************** States ***************************** //
+
+		const FRigidBodyState& State = Vehicle.RigidBodyState;
+
+		TRigidBodyState<FDual> DualState;
+		DualState.Position = SeedVector(State.Position);
+
+		// Attitude * exp(dAttitude), to first order (which is all the derivatives need)
+		const FDualVector3 dAttitude = SeedVector(FVector3::Zero());
+		DualState.Attitude = State.Attitude.cast<FDual>() * FDualQuaternion(FDual(1), 0.5 * dAttitude.x(), 0.5 * dAttitude.y(), 0.5 * dAttitude.z());
+
+		DualState.Vb = SeedVector(State.Vb);
+		DualState.Omegab = SeedVector(State.Omegab);
+
+		// ***************************** Inputs ***************************** //
+
+		TControlSurfaceDeflections<FDual> Deflections;
+		Deflections.de = Seeder.Next(Vehicle.ControlSurfaceDeflections.de);
+		Deflections.da = Seeder.Next(Vehicle.ControlSurfaceDeflections.da);
+		Deflections.dr = Seeder.Next(Vehicle.ControlSurfaceDeflections.dr);
+
+		std::vector<FDual> PropellerSpeeds;
+		PropellerSpeeds.reserve(NumPropulsors);
+		for (const FPropulsor& Propulsor : Vehicle.Propulsors)
+		{
+			PropellerSpeeds.push_back(Seeder.Next(Propulsor.Propeller.GetMotionState()));
+		}
+
+		// *************************** Parameters *************************** //
+
+		const FMassProperties& MassProperties = Vehicle.RigidBodyModel.MassProperties;
+
+		TRigidBodyModel<FDual> RigidBodyModel;
+		TMassProperties<FDual>& DualMassProperties = RigidBodyModel.MassProperties;
+		DualMassProperties.Mass = SeedParameter(Parameters.bMassProperties, MassProperties.Mass);
+		DualMassProperties.Ixx = SeedParameter(Parameters.bMassProperties, MassProperties.Ixx);
+		DualMassProperties.Iyy = SeedParameter(Parameters.bMassProperties, MassProperties.Iyy);
+		DualMassProperties.Izz = SeedParameter(Parameters.bMassProperties, MassProperties.Izz);
+		DualMassProperties.Ixz = SeedParameter(Parameters.bMassProperties, MassProperties.Ixz);
+		DualMassProperties.PreCalculate();
+
+		std::vector<FDual> PropellerCd;
+		std::vector<FDual> PropellerIzz;
+		PropellerCd.reserve(NumPropulsors);
+		PropellerIzz.reserve(NumPropulsors);
+		for (const FPropulsor& Propulsor : Vehicle.Propulsors)
+		{
+			PropellerCd.push_back(SeedParameter(Parameters.bPropellers, Propulsor.Propeller.GetParameters().Cd));
+			PropellerIzz.push_back(SeedParameter(Parameters.bPropellers, Propulsor.Propeller.GetParameters().Izz));
+		}
+
+		const FAirframeModel& AirframeModel = Vehicle.AirframeModel;
+
+		TAirframeParameters<FDual> Airframe;
+		Airframe.StallParameters = AirframeModel.StallParameters;
+		Airframe.Geometry = AirframeModel.Geometry;
+		ForEachAerodynamicCoefficient(AirframeModel.Coefficients, Airframe.Coefficients, [&](float Coefficient, FDual& DualCoefficient)
+			{
+				DualCoefficient = SeedParameter(Parameters.bAerodynamicCoefficients, Coefficient);
+			});
+		ForEachControlDerivative(AirframeModel.ControlDerivatives, Airframe.ControlDerivatives, [&](float Derivative, FDual& DualDerivative)
+			{
+				DualDerivative = SeedParameter(Parameters.bControlDerivatives, Derivative);
+			});
+
+		// ****************************** Step ****************************** //
+
+		const TAirframeKernelFunction<FDual, TAirframeParameters<FDual>> AirframeKernel =
+			SelectAirframeKernel<FDual, TAirframeParameters<FDual>>(AirframeModel.Configuration, AirframeModel.StallParameters.bEnableStallModel);
+
+		// The wind and density are held over the step.
+		const FDual Rho = FDual(Vehicle.AtmosphericConditionsState.rho);
+		const FDualVector3 Vw = Vehicle.AtmosphericConditionsState.Vw.cast<FDual>();
+
+		// As per FVehicle::CalculateStageForcesAndMoments (and so FVehicle::CalculatePropulsionForcesAndMoments and FPropulsorGeometry).
+		auto CalculateForcesAndMoments = [&](const TRigidBodyState<FDual>& Stage)
+		{
+			const FDualVector3 Vwb = Stage.Attitude.conjugate() * Vw;
+
+			TForcesAndMoments<FDual> ForcesAndMoments = AirframeKernel(Airframe, CalculateAirspeedStateT(Stage.Vb, Vwb), Stage.Omegab, Rho, Deflections);
+
+			for (int i = 0; i < NumPropulsors; i++)
+			{
+				const FPropulsor& Propulsor = Vehicle.Propulsors[i];
+				const FDualMatrix3 Rotation = Propulsor.Geometry.Rotation.cast<FDual>();
+				const FDualVector3 Position = Propulsor.Geometry.Position.cast<FDual>();
+
+				const FDualVector3 Vap = Rotation.transpose() * (Stage.Vb + Stage.Omegab.cross(Position) - Vwb);
+				const TForcesAndMoments<FDual> PropulsorForcesAndMoments = Propulsor.Propeller.CalculateForcesAndMoments(
+					Rho, Vap, FDualVector3(Rotation.transpose() * Stage.Omegab), PropellerSpeeds[i], PropellerCd[i], PropellerIzz[i]);
+
+				const FDualVector3 Forces = Rotation * PropulsorForcesAndMoments.Forces;
+				ForcesAndMoments += TForcesAndMoments<FDual>(Forces, Rotation * PropulsorForcesAndMoments.Moments + Position.cross(Forces));
+			}
+
+			return ForcesAndMoments;
+		};
+
+		RigidBodyModel.Integrate(DualState, Vehicle.Gravity.cast<FDual>(), FDual(DeltaTime), Vehicle.IntegrationMethod, CalculateForcesAndMoments);
+
+		return DualState;
+	}
+
+	FStepSensitivity CalculateStepSensitivity(const FVehicle& Vehicle, float DeltaTime, const FSensitivityParameters& Parameters)
+	{
+		using SS = FStepSensitivity;
+
+		const int NumInputs = 3 + static_cast<int>(Vehicle.Propulsors.size());
+
+		FStepSensitivity Result;
+
+		// The total number of directions is counted by the first evaluation, and then as many more are made as it takes to cover them all.
+		int NumDirections = 0;
+		int FirstDirection = 0;
+		do
+		{
+			FDualSeeder Seeder(FirstDirection);
+			const TRigidBodyState<FDual> NextState = EvaluateStep(Vehicle, DeltaTime, Parameters, Seeder);
+
+			// The attitude derivatives as a rotation vector in the body frame, 2 * vec(conj(Attitude) * Attitude(x)) to first order.
+			const FQuaterniond Attitude(NextState.Attitude.w().Value, NextState.Attitude.x().Value, NextState.Attitude.y().Value, NextState.Attitude.z().Value);
+			const FDualVector3 dAttitude = 2.0 * (Attitude.cast<FDual>().conjugate() * NextState.Attitude).vec();
+
+			if (Result.NumEvaluations == 0)
+			{
+				NumDirections = Seeder.GetNumDirections();
+
+				Result.NextState.Position = GetValue(NextState.Position);
+				Result.NextState.Attitude = Attitude;
+				Result.NextState.Vb = GetValue(NextState.Vb);
+				Result.NextState.Omegab = GetValue(NextState.Omegab);
+
+				Result.StateJacobian = Eigen::MatrixXd::Zero(SS::NumStates, SS::NumStates);
+				Result.InputJacobian = Eigen::MatrixXd::Zero(SS::NumStates, NumInputs);
+				Result.ParameterJacobian = Eigen::MatrixXd::Zero(SS::NumStates, NumDirections - SS::NumStates - NumInputs);
+			}
+
+			Eigen::Matrix<double, SS::NumStates, FDual::NumDirections> Derivatives;
+			for (int i = 0; i < 3; i++)
+			{
+				Derivatives.row(SS::North + i) = NextState.Position(i).Derivatives.transpose();
+				Derivatives.row(SS::AttitudeX + i) = dAttitude(i).Derivatives.transpose();
+				Derivatives.row(SS::U + i) = NextState.Vb(i).Derivatives.transpose();
+				Derivatives.row(SS::P + i) = NextState.Omegab(i).Derivatives.transpose();
+			}
+
+			// Each direction is a column of one of the Jacobians.
+			for (int i = 0; i < FDual::NumDirections && FirstDirection + i < NumDirections; i++)
+			{
+				const int Direction = FirstDirection + i;
+				if (Direction < SS::NumStates)
+				{
+					Result.StateJacobian.col(Direction) = Derivatives.col(i);
+				}
+				else if (Direction < SS::NumStates + NumInputs)
+				{
+					Result.InputJacobian.col(Direction - SS::NumStates) = Derivatives.col(i);
+				}
+				else
+				{
+					Result.ParameterJacobian.col(Direction - SS::NumStates - NumInputs) = Derivatives.col(i);
+				}
+			}
+
+			Result.NumEvaluations++;
+			FirstDirection += FDual::NumDirections;
+		}
+		while (FirstDirection < NumDirections);
+
+		return Result;
+	}
+}
@@ -0,0 +1,424 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SkyPhysCore/Simulation/Trim.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "SkyPhysCore/Common/MathUtils.h"
+#include "SkyPhysCore/Simulation/Vehicle.h"
+
+namespace SkyPhysCore
+{
+	// Cross product matrix, such that Skew(a) * b == a x b
+	static FMatrix3 Skew(const FVector3& Vector)
+	{
+		FMatrix3 Matrix;
+		Matrix << 0.0f, -Vector.z(), Vector.y(),
+				  Vector.z(), 0.0f, -Vector.x(),
+				  -Vector.y(), Vector.x(), 0.0f;
+		return Matrix;
+	}
+
+	// The deflection at full command of a control surface actuator (rad), within any saturation limits.
+	static float CalculateControlSurfaceLimit(const FActuatorModel& Actuator)
+	{
+		const FActuatorParameters& Parameters = Actuator.GetParameters();
+
+		float Limit = std::abs(Parameters.DCGain);
+		if (!IsNearlyZero(Parameters.UpperSaturation))
+		{
+			Limit = std::min(Limit, std::abs(Parameters.UpperSaturation));
+		}
+		if (!IsNearlyZero(Parameters.LowerSaturation))
+		{
+			Limit = std::min(Limit, std::abs(Parameters.LowerSaturation));
+		}
+		return Limit;
+	}
+
+	FTrimModel::FTrimModel(const FVehicle& Vehicle)
+	{
+		MassProperties = Vehicle.RigidBodyModel.MassProperties;
+		AirframeModel = Vehicle.AirframeModel;
+		Gravity = Vehicle.Gravity;
+
+		MaxElevator = CalculateControlSurfaceLimit(Vehicle.Elevator.Actuator);
+		MaxAileron = CalculateControlSurfaceLimit(Vehicle.Aileron.Actuator);
+		MaxRudder = CalculateControlSurfaceLimit(Vehicle.Rudder.Actuator);
+
+		Propulsors.reserve(Vehicle.Propulsors.size());
+		for (const FPropulsor& Propulsor : Vehicle.Propulsors)
+		{
+			FTrimPropulsor TrimPropulsor;
+			TrimPropulsor.Propeller = Propulsor.Propeller;
+			TrimPropulsor.Geometry = Propulsor.Geometry;
+			TrimPropulsor.MaxSpeed = RPMToRadPerS(std::abs(Propulsor.Motor.GetParameters().DCGain));
+			Propulsors.push_back(TrimPropulsor);
+		}
+	}
+
+	void FTrimModel::CalculateDerivative(const Eigen::VectorXf& X, const Eigen::VectorXf& U, float Rho, Eigen::VectorXf& XDot, Eigen::MatrixXf* A, Eigen::MatrixXf* B) const
+	{
+		using LM = FLinearModel;
+
+		const int NumU = NumInputs();
+		const bool bJacobian = A || B;
+
+		const FVector3 Vb = X.segment<3>(LM::U);
+		const FVector3 Omegab = X.segment<3>(LM::P);
+		const float phi = X(LM::Phi);
+		const float theta = X(LM::Theta);
+		const float psi = X(LM::Psi);
+
+		FControlSurfaceDeflections Deflections;
+		Deflections.de = U(LM::Elevator);
+		Deflections.da = U(LM::Aileron);
+		Deflections.dr = U(LM::Rudder);
+
+		// Body to world rotation (ZYX), and its derivatives with respect to each Euler angle
+		const FMatrix3 Rx = Eigen::AngleAxisf(phi, FVector3::UnitX()).toRotationMatrix();
+		const FMatrix3 Ry = Eigen::AngleAxisf(theta, FVector3::UnitY()).toRotationMatrix();
+		const FMatrix3 Rz = Eigen::AngleAxisf(psi, FVector3::UnitZ()).toRotationMatrix();
+		const FMatrix3 Rbw = Rz * Ry * Rx;
+
+		// ************************ Forces and Moments *********************** //
+
+		// Still air, so the airspeed is the body velocity.
+		const FAirspeedState AirspeedState = CalculateAirspeedState(Vb, FVector3::Zero());
+		FForcesAndMoments ForcesAndMoments = AirframeModel.CalculateForcesAndMoments(AirspeedState, Omegab, Rho, Deflections);
+
+		// Partial derivatives of the forces and moments (rows) with respect to Vb, Omegab and the inputs
+		Eigen::Matrix<float, 6, 3> dFMdVb = Eigen::Matrix<float, 6, 3>::Zero();
+		Eigen::Matrix<float, 6, 3> dFMdOmegab = Eigen::Matrix<float, 6, 3>::Zero();
+		Eigen::MatrixXf dFMdU = Eigen::MatrixXf::Zero(6, NumU);
+
+		if (bJacobian)
+		{
+			const FAirframeJacobian AirframeJacobian = AirframeModel.CalculateJacobian(AirspeedState, Omegab, Rho, Deflections);
+			dFMdVb = AirframeJacobian.leftCols<3>();
+			dFMdOmegab = AirframeJacobian.middleCols<3>(3);
+			dFMdU.leftCols<3>() = AirframeJacobian.rightCols<3>();
+		}
+
+		for (int i = 0; i < static_cast<int>(Propulsors.size()); i++)
+		{
+			const FTrimPropulsor& Propulsor = Propulsors[i];
+			const FPropulsorGeometry& Geometry = Propulsor.Geometry;
+			const FMatrix3& Rpb = Geometry.Rotation;
+
+			FPropellerJacobian PropellerJacobian;
+			const FForcesAndMoments PropulsorForcesAndMoments = Propulsor.Propeller.CalculateForcesAndMomentsJacobian(
+				Rho, Geometry.CalculateAirspeed(Vb, Omegab, FVector3::Zero()), Geometry.BodyToPropulsor(Omegab), U(LM::FirstPropulsor + i), PropellerJacobian);
+
+			// As per FVehicle, rotate into the body frame and add the moment of the forces about the CoG.
+			FForcesAndMoments BodyForcesAndMoments = Geometry.PropulsorToBody(PropulsorForcesAndMoments);
+			BodyForcesAndMoments.Moments += Geometry.CalculateMomentAboutCoG(BodyForcesAndMoments.Forces);
+			ForcesAndMoments += BodyForcesAndMoments;
+
+			if (bJacobian)
+			{
+				// The propeller airspeed is Rpb^T * (Vb + Omegab x r), and its rotational velocity Rpb^T * Omegab.
+				const FMatrix3 dVapdVb = Rpb.transpose();
+				const FMatrix3 dVapdOmegab = -Rpb.transpose() * Skew(Geometry.Position);
+
+				Eigen::Matrix<float, 6, 7> BodyJacobian;
+				BodyJacobian.topRows<3>() = Rpb * PropellerJacobian.topRows<3>();
+				BodyJacobian.bottomRows<3>() = Rpb * PropellerJacobian.bottomRows<3>() + Skew(Geometry.Position) * BodyJacobian.topRows<3>();
+
+				dFMdVb += BodyJacobian.leftCols<3>() * dVapdVb;
+				dFMdOmegab += BodyJacobian.leftCols<3>() * dVapdOmegab + BodyJacobian.middleCols<3>(3) * Rpb.transpose();
+				dFMdU.col(LM::FirstPropulsor + i) = BodyJacobian.col(6);
+			}
+		}
+
+		// ************************* Rigid Body ************************* //
+
+		const float Mass = MassProperties.Mass;
+		const FMatrix3& J = MassProperties.J;
+		const FMatrix3& JInverse = MassProperties.JInverse;
+
+		const float sphi = sin(phi);
+		const float cphi = cos(phi);
+		const float stheta = sin(theta);
+		const float ctheta = cos(theta);
+		const float ttheta = stheta / ctheta;
+
+		XDot.resize(LM::NumStates);
+		XDot.segment<3>(LM::U) = ForcesAndMoments.Forces / Mass + Rbw.transpose() * Gravity - Omegab.cross(Vb);
+		XDot.segment<3>(LM::P) = JInverse * (ForcesAndMoments.Moments - Omegab.cross(J * Omegab));
+
+		const float p = Omegab.x();
+		const float q = Omegab.y();
+		const float r = Omegab.z();
+		XDot(LM::Phi) = p + (q * sphi + r * cphi) * ttheta;
+		XDot(LM::Theta) = q * cphi - r * sphi;
+		XDot(LM::Psi) = (q * sphi + r * cphi) / ctheta;
+		XDot.segment<3>(LM::North) = Rbw * Vb;
+
+		if (!bJacobian)
+		{
+			return;
+		}
+
+		const FMatrix3 dRbwdPhi = Rbw * Skew(FVector3::UnitX());
+		const FMatrix3 dRbwdTheta = Rz * Ry * Skew(FVector3::UnitY()) * Rx;
+		const FMatrix3 dRbwdPsi = Skew(FVector3::UnitZ()) * Rbw;
+
+		if (A)
+		{
+			Eigen::MatrixXf& AMatrix = *A;
+			AMatrix = Eigen::MatrixXf::Zero(LM::NumStates, LM::NumStates);
+
+			// Linear acceleration
+			AMatrix.block<3, 3>(LM::U, LM::U) = dFMdVb.topRows<3>() / Mass - Skew(Omegab);
+			AMatrix.block<3, 3>(LM::U, LM::P) = dFMdOmegab.topRows<3>() / Mass + Skew(Vb);
+			AMatrix.block<3, 1>(LM::U, LM::Phi) = dRbwdPhi.transpose() * Gravity;
+			AMatrix.block<3, 1>(LM::U, LM::Theta) = dRbwdTheta.transpose() * Gravity;
+			AMatrix.block<3, 1>(LM::U, LM::Psi) = dRbwdPsi.transpose() * Gravity;
+
+			// Angular acceleration
+			AMatrix.block<3, 3>(LM::P, LM::U) = JInverse * dFMdVb.bottomRows<3>();
+			AMatrix.block<3, 3>(LM::P, LM::P) = JInverse * (dFMdOmegab.bottomRows<3>() - (Skew(Omegab) * J - Skew(J * Omegab)));
+
+			// Euler angle rates
+			AMatrix.block<3, 3>(LM::Phi, LM::P) << 1.0f, sphi * ttheta, cphi * ttheta,
+												   0.0f, cphi, -sphi,
+												   0.0f, sphi / ctheta, cphi / ctheta;
+			AMatrix(LM::Phi, LM::Phi) = (q * cphi - r * sphi) * ttheta;
+			AMatrix(LM::Phi, LM::Theta) = (q * sphi + r * cphi) / (ctheta * ctheta);
+			AMatrix(LM::Theta, LM::Phi) = -q * sphi - r * cphi;
+			AMatrix(LM::Psi, LM::Phi) = (q * cphi - r * sphi) / ctheta;
+			AMatrix(LM::Psi, LM::Theta) = (q * sphi + r * cphi) * stheta / (ctheta * ctheta);
+
+			// Position
+			AMatrix.block<3, 3>(LM::North, LM::U) = Rbw;
+			AMatrix.block<3, 1>(LM::North, LM::Phi) = dRbwdPhi * Vb;
+			AMatrix.block<3, 1>(LM::North, LM::Theta) = dRbwdTheta * Vb;
+			AMatrix.block<3, 1>(LM::North, LM::Psi) = dRbwdPsi * Vb;
+		}
+
+		if (B)
+		{
+			Eigen::MatrixXf& BMatrix = *B;
+			BMatrix = Eigen::MatrixXf::Zero(LM::NumStates, NumU);
+			BMatrix.middleRows<3>(LM::U) = dFMdU.topRows<3>() / Mass;
+			BMatrix.middleRows<3>(LM::P) = JInverse * dFMdU.bottomRows<3>();
+		}
+	}
+
+	FLinearModel FTrimModel::Linearize(const Eigen::VectorXf& X0, const Eigen::VectorXf& U0, float Rho) const
+	{
+		FLinearModel LinearModel;
+		LinearModel.X0 = X0;
+		LinearModel.U0 = U0;
+
+		Eigen::VectorXf XDot;
+		CalculateDerivative(X0, U0, Rho, XDot, &LinearModel.A, &LinearModel.B);
+
+		return LinearModel;
+	}
+
+	FTrimResult FTrimModel::Trim(const FTrimCondition& Condition, const FTrimSettings& Settings) const
+	{
+		using LM = FLinearModel;
+
+		// Unknowns: alpha, beta, theta, then the inputs (de, da, dr, omega_0, ...)
+		enum EUnknown { Alpha, Beta, Theta, FirstInput };
+		// Residuals: the linear and angular accelerations, and the climb rate error
+		const int NumResiduals = 7;
+
+		const int NumU = NumInputs();
+		const int NumUnknowns = FirstInput + NumU;
+		const float Va = Condition.Airspeed;
+		const float ClimbRate = Va * sin(Condition.FlightPathAngle);
+
+		// Limits of each unknown, where an unknown with equal limits is held.
+		Eigen::VectorXf Lower = Eigen::VectorXf::Zero(NumUnknowns);
+		Eigen::VectorXf Upper = Eigen::VectorXf::Zero(NumUnknowns);
+
+		// Alpha and beta are undefined without any airspeed.
+		if (!IsNearlyZero(Va))
+		{
+			Lower(Alpha) = -Pi / 2.0f;
+			Upper(Alpha) = Pi / 2.0f;
+			Lower(Beta) = -Pi / 2.0f;
+			Upper(Beta) = Pi / 2.0f;
+		}
+		Lower(Theta) = -Pi / 2.0f + 0.01f;
+		Upper(Theta) = Pi / 2.0f - 0.01f;
+
+		const bool bHasControlSurfaces = AirframeModel.Configuration != EAirframeConfiguration::MultiRotor;
+		const bool bHasRudder = AirframeModel.Configuration == EAirframeConfiguration::VTail || AirframeModel.Configuration == EAirframeConfiguration::Standard;
+		const float Limits[3] = { bHasControlSurfaces ? MaxElevator : 0.0f, bHasControlSurfaces ? MaxAileron : 0.0f, bHasRudder ? MaxRudder : 0.0f };
+		for (int i = 0; i < 3; i++)
+		{
+			Lower(FirstInput + i) = -Limits[i];
+			Upper(FirstInput + i) = Limits[i];
+		}
+		for (int i = 0; i < static_cast<int>(Propulsors.size()); i++)
+		{
+			Upper(FirstInput + LM::FirstPropulsor + i) = Propulsors[i].MaxSpeed;
+		}
+
+		// Initial guess: level attitude relative to the flight path, neutral controls and full speed propellers (where the propeller data
+		// is at its lowest advance ratio, so the thrust still responds to speed).
+		Eigen::VectorXf z = Eigen::VectorXf::Zero(NumUnknowns);
+		z(Theta) = Condition.FlightPathAngle;
+		z.tail(Propulsors.size()) = Upper.tail(Propulsors.size());
+		z = z.cwiseMax(Lower).cwiseMin(Upper);
+
+		// The state and inputs for a set of unknowns (wings level, no rotation, at the origin with a heading of 0)
+		auto ToStateAndInputs = [&](const Eigen::VectorXf& Unknowns, Eigen::VectorXf& X, Eigen::VectorXf& U)
+		{
+			X = Eigen::VectorXf::Zero(LM::NumStates);
+			X(LM::U) = Va * cos(Unknowns(Alpha)) * cos(Unknowns(Beta));
+			X(LM::V) = Va * sin(Unknowns(Beta));
+			X(LM::W) = Va * sin(Unknowns(Alpha)) * cos(Unknowns(Beta));
+			X(LM::Theta) = Unknowns(Theta);
+			U = Unknowns.tail(NumU);
+		};
+
+		// Residuals (and optionally their Jacobian, by chaining A and B through the unknowns)
+		auto CalculateResiduals = [&](const Eigen::VectorXf& Unknowns, Eigen::VectorXf& Residuals, Eigen::MatrixXf* Jacobian)
+		{
+			Eigen::VectorXf X;
+			Eigen::VectorXf U;
+			ToStateAndInputs(Unknowns, X, U);
+
+			Eigen::VectorXf XDot;
+			Eigen::MatrixXf A;
+			Eigen::MatrixXf B;
+			CalculateDerivative(X, U, Condition.Rho, XDot, Jacobian ? &A : nullptr, Jacobian ? &B : nullptr);
+
+			Residuals.resize(NumResiduals);
+			Residuals.head<6>() = XDot.segment<6>(LM::U);
+			Residuals(6) = XDot(LM::Down) + ClimbRate;
+
+			if (!Jacobian)
+			{
+				return;
+			}
+
+			// dX/d(unknowns)
+			const float sa = sin(Unknowns(Alpha));
+			const float ca = cos(Unknowns(Alpha));
+			const float sb = sin(Unknowns(Beta));
+			const float cb = cos(Unknowns(Beta));
+
+			Eigen::MatrixXf dX = Eigen::MatrixXf::Zero(LM::NumStates, NumUnknowns);
+			dX.block<3, 1>(LM::U, Alpha) = Va * FVector3(-sa * cb, 0.0f, ca * cb);
+			dX.block<3, 1>(LM::U, Beta) = Va * FVector3(-ca * sb, cb, -sa * sb);
+			dX(LM::Theta, Theta) = 1.0f;
+
+			Eigen::MatrixXf dXDot = A * dX;
+			dXDot.rightCols(NumU) += B;
+
+			Jacobian->resize(NumResiduals, NumUnknowns);
+			Jacobian->topRows<6>() = dXDot.middleRows<6>(LM::U);
+			Jacobian->row(6) = dXDot.row(LM::Down);
+
+			// Held unknowns don't move.
+			for (int i = 0; i < NumUnknowns; i++)
+			{
+				if (Lower(i) >= Upper(i))
+				{
+					Jacobian->col(i).setZero();
+				}
+			}
+		};
+
+		// ********************** Levenberg-Marquardt ********************** //
+
+		FTrimResult Result;
+
+		Eigen::VectorXf Residuals;
+		Eigen::MatrixXf Jacobian;
+		float Lambda = 1.e-3f;
+
+		for (Result.NumIterations = 0; Result.NumIterations < Settings.MaxIterations; Result.NumIterations++)
+		{
+			CalculateResiduals(z, Residuals, &Jacobian);
+			if (Residuals.cwiseAbs().maxCoeff() <= Settings.Tolerance)
+			{
+				break;
+			}
+
+			// The normal equations are solved in double, as the unknowns span several orders of magnitude (angles and propeller speeds).
+			const Eigen::MatrixXd Jd = Jacobian.cast<double>();
+			const Eigen::MatrixXd H = Jd.transpose() * Jd;
+			const Eigen::VectorXd g = Jd.transpose() * Residuals.cast<double>();
+			const double Cost = Residuals.squaredNorm();
+
+			bool bImproved = false;
+			for (int Attempt = 0; Attempt < 16 && !bImproved; Attempt++)
+			{
+				// Marquardt's scaling of the damping by the diagonal, with a floor to keep held (zero) columns solvable.
+				Eigen::MatrixXd Damped = H;
+				for (int i = 0; i < NumUnknowns; i++)
+				{
+					Damped(i, i) += Lambda * std::max(H(i, i), 1.e-6);
+				}
+
+				const Eigen::VectorXf Step = -Damped.ldlt().solve(g).cast<float>();
+				const Eigen::VectorXf Candidate = (z + Step).cwiseMax(Lower).cwiseMin(Upper);
+
+				Eigen::VectorXf CandidateResiduals;
+				CalculateResiduals(Candidate, CandidateResiduals, nullptr);
+
+				if (CandidateResiduals.squaredNorm() < Cost)
+				{
+					z = Candidate;
+					Lambda = std::max(Lambda / 3.0f, 1.e-9f);
+					bImproved = true;
+				}
+				else
+				{
+					Lambda *= 4.0f;
+				}
+			}
+
+			// We've stalled (eg. against a limit), so this condition can't be trimmed any further.
+			if (!bImproved)
+			{
+				CalculateResiduals(z, Residuals, nullptr);
+				break;
+			}
+		}
+
+		Result.Residual = Residuals.cwiseAbs().maxCoeff();
+		Result.bConverged = Result.Residual <= Settings.Tolerance;
+
+		// ************************** Results ************************** //
+
+		Eigen::VectorXf X;
+		Eigen::VectorXf U;
+		ToStateAndInputs(z, X, U);
+
+		Result.alpha = z(Alpha);
+		Result.beta = z(Beta);
+		Result.State.Vb = X.segment<3>(LM::U);
+		Result.State.Attitude = FQuaternion(Eigen::AngleAxisf(z(Theta), FVector3::UnitY()));
+		Result.Deflections.de = U(LM::Elevator);
+		Result.Deflections.da = U(LM::Aileron);
+		Result.Deflections.dr = U(LM::Rudder);
+		Result.PropulsorSpeeds.assign(U.data() + LM::FirstPropulsor, U.data() + U.size());
+
+		Result.LinearModel = Linearize(X, U, Condition.Rho);
+
+		return Result;
+	}
+
+	std::vector<FTrimResult> FTrimModel::TrimSweep(const std::vector<FTrimCondition>& Conditions, const FTrimSettings& Settings, const FParallelFor& ParallelFor) const
+	{
+		std::vector<FTrimResult> Results(Conditions.size());
+
+		// Each condition is independent (and the model is const), so they can all be trimmed at once.
+		ParallelFor(static_cast<int>(Conditions.size()), [&](int Index)
+			{
+				Results[Index] = Trim(Conditions[Index], Settings);
+			});
+
+		return Results;
+	}
+}
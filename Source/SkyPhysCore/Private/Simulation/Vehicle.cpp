@@ -0,0 +1,363 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SkyPhysCore/Simulation/Vehicle.h"
+
+#include <algorithm>
+
+#include "SkyPhysCore/Common/MathUtils.h"
+
+namespace SkyPhysCore
+{
+	void FVehicle::Step(float DeltaTime)
+	{
+		// First update state (atmospheric, airspeed and actuators)
+		UpdateState(DeltaTime);
+
+		// Get Forces and Moments in the body frame (unless they are held over this step)
+		FForcesAndMoments AirframeForcesAndMoments;
+		if (Scheduler.IsDue(EScheduledModel::Aerodynamics))
+		{
+			AirframeForcesAndMoments = AirframeModel.CalculateForcesAndMoments(AirspeedState, RigidBodyState.Omegab, AtmosphericConditionsState.rho, ControlSurfaceDeflections);
+		}
+
+		// Apply Forces and Moments into Kinematics
+		ApplyForcesAndMoments(AirframeForcesAndMoments, DeltaTime);
+	}
+
+	int FVehicle::StepAdaptive(float DeltaTime)
+	{
+		int NumSteps = 0;
+		float RemainingTime = DeltaTime;
+
+		while (RemainingTime > SmallNumber)
+		{
+			const FVector3 StepStartOmegab = RigidBodyState.Omegab;
+			const float StepSize = StepController.CalculateNextStep(RemainingTime, CalculateMaxCharacteristicRate());
+
+			Step(StepSize);
+
+			// Feed the accelerations at the start of this step into the error estimate (ie. the velocity increments over unit time).
+			FVector3 LinearAcceleration;
+			FVector3 AngularAcceleration;
+			RigidBodyModel.CalculateVelocityIncrements(StepStartOmegab, StepStartForcesAndMoments, 1.0f, LinearAcceleration, AngularAcceleration);
+			StepController.Update(LinearAcceleration, AngularAcceleration);
+
+			RemainingTime -= StepSize;
+			NumSteps++;
+		}
+
+		return NumSteps;
+	}
+
+	float FVehicle::CalculateMaxCharacteristicRate() const
+	{
+		const FMassProperties& MassProperties = RigidBodyModel.MassProperties;
+
+		float MaxRate = CalculateAirframeCharacteristicRate(AirframeModel, MassProperties, AirspeedState.Va, AtmosphericConditionsState.rho);
+
+		MaxRate = std::max(MaxRate, Elevator.Actuator.GetCharacteristicRate());
+		MaxRate = std::max(MaxRate, Aileron.Actuator.GetCharacteristicRate());
+		MaxRate = std::max(MaxRate, Rudder.Actuator.GetCharacteristicRate());
+
+		for (const FPropulsor& Propulsor : Propulsors)
+		{
+			MaxRate = std::max(MaxRate, Propulsor.Motor.GetCharacteristicRate());
+			MaxRate = std::max(MaxRate, CalculateGyroscopicCharacteristicRate(Propulsor.Propeller.GetAngularMomentum(), MassProperties));
+		}
+
+		if (bEnableTurbulenceModel)
+		{
+			MaxRate = std::max(MaxRate, TurbulenceModel.GetCharacteristicRate(AirspeedState.Va, -RigidBodyState.Position.z()));
+		}
+
+		return MaxRate;
+	}
+
+	void FVehicle::SetRandomSeed(uint64_t Seed)
+	{
+		TurbulenceModel.SetSeed(FRandomStream::DeriveSeed(Seed, 0));
+	}
+
+	uint64_t FVehicle::CalculateStateHash() const
+	{
+		FStateHash Hash;
+		AddToHash(Hash);
+		return Hash.Get();
+	}
+
+	bool FVehicle::SaveSnapshot(FVehicleSnapshot& Snapshot) const
+	{
+		if (Propulsors.size() > FVehicleSnapshot::MaxPropulsors)
+		{
+			return false;
+		}
+
+		Snapshot.Position = ToSnapshot(RigidBodyState.Position);
+		Snapshot.Attitude = ToSnapshot(RigidBodyState.Attitude);
+		Snapshot.Vb = ToSnapshot(RigidBodyState.Vb);
+		Snapshot.Omegab = ToSnapshot(RigidBodyState.Omegab);
+
+		Snapshot.VwLowAltitude = ToSnapshot(AtmosphericConditionsState.VwLowAltitude);
+		Snapshot.Vw = ToSnapshot(AtmosphericConditionsState.Vw);
+		Snapshot.rho = AtmosphericConditionsState.rho;
+		Snapshot.Vwb = ToSnapshot(AirspeedState.Vwb);
+		Snapshot.Vab = ToSnapshot(AirspeedState.Vab);
+		Snapshot.Va = AirspeedState.Va;
+		Snapshot.alpha = AirspeedState.alpha;
+		Snapshot.beta = AirspeedState.beta;
+
+		Elevator.Actuator.SaveSnapshot(Snapshot.Elevator);
+		Aileron.Actuator.SaveSnapshot(Snapshot.Aileron);
+		Rudder.Actuator.SaveSnapshot(Snapshot.Rudder);
+		Snapshot.ElevatorCommand = Elevator.Command;
+		Snapshot.AileronCommand = Aileron.Command;
+		Snapshot.RudderCommand = Rudder.Command;
+		Snapshot.de = ControlSurfaceDeflections.de;
+		Snapshot.da = ControlSurfaceDeflections.da;
+		Snapshot.dr = ControlSurfaceDeflections.dr;
+
+		Snapshot.NumPropulsors = static_cast<int32_t>(Propulsors.size());
+		for (int i = 0; i < Snapshot.NumPropulsors; i++)
+		{
+			const FPropulsor& Propulsor = Propulsors[i];
+			Propulsor.Motor.SaveSnapshot(Snapshot.Propulsors[i].Motor);
+			Snapshot.Propulsors[i].omega = Propulsor.Propeller.GetMotionState();
+			Snapshot.Propulsors[i].Command = Propulsor.Command;
+		}
+
+		TurbulenceModel.Hu.SaveSnapshot(Snapshot.Hu);
+		TurbulenceModel.Hv.SaveSnapshot(Snapshot.Hv);
+		TurbulenceModel.Hw.SaveSnapshot(Snapshot.Hw);
+
+		Scheduler.SaveSnapshot(Snapshot.Scheduler);
+		Snapshot.PreviousTurbulence = ToSnapshot(PreviousTurbulence);
+		Snapshot.LatestTurbulence = ToSnapshot(LatestTurbulence);
+		Snapshot.HeldForces = ToSnapshot(StepStartForcesAndMoments.Forces);
+		Snapshot.HeldMoments = ToSnapshot(StepStartForcesAndMoments.Moments);
+
+		return true;
+	}
+
+	bool FVehicle::RestoreSnapshot(const FVehicleSnapshot& Snapshot)
+	{
+		if (Snapshot.NumPropulsors != static_cast<int32_t>(Propulsors.size()))
+		{
+			return false;
+		}
+
+		RigidBodyState.Position = FromSnapshot(Snapshot.Position);
+		RigidBodyState.Attitude = FromSnapshot(Snapshot.Attitude);
+		RigidBodyState.Vb = FromSnapshot(Snapshot.Vb);
+		RigidBodyState.Omegab = FromSnapshot(Snapshot.Omegab);
+
+		AtmosphericConditionsState.VwLowAltitude = FromSnapshot(Snapshot.VwLowAltitude);
+		AtmosphericConditionsState.Vw = FromSnapshot(Snapshot.Vw);
+		AtmosphericConditionsState.rho = Snapshot.rho;
+		AirspeedState.Vwb = FromSnapshot(Snapshot.Vwb);
+		AirspeedState.Vab = FromSnapshot(Snapshot.Vab);
+		AirspeedState.Va = Snapshot.Va;
+		AirspeedState.alpha = Snapshot.alpha;
+		AirspeedState.beta = Snapshot.beta;
+
+		Elevator.Actuator.RestoreSnapshot(Snapshot.Elevator);
+		Aileron.Actuator.RestoreSnapshot(Snapshot.Aileron);
+		Rudder.Actuator.RestoreSnapshot(Snapshot.Rudder);
+		Elevator.Command = Snapshot.ElevatorCommand;
+		Aileron.Command = Snapshot.AileronCommand;
+		Rudder.Command = Snapshot.RudderCommand;
+		ControlSurfaceDeflections.de = Snapshot.de;
+		ControlSurfaceDeflections.da = Snapshot.da;
+		ControlSurfaceDeflections.dr = Snapshot.dr;
+
+		for (int i = 0; i < Snapshot.NumPropulsors; i++)
+		{
+			FPropulsor& Propulsor = Propulsors[i];
+			Propulsor.Motor.RestoreSnapshot(Snapshot.Propulsors[i].Motor);
+			Propulsor.Propeller.SetRotationalSpeed(Snapshot.Propulsors[i].omega);
+			Propulsor.Command = Snapshot.Propulsors[i].Command;
+		}
+
+		TurbulenceModel.Hu.RestoreSnapshot(Snapshot.Hu);
+		TurbulenceModel.Hv.RestoreSnapshot(Snapshot.Hv);
+		TurbulenceModel.Hw.RestoreSnapshot(Snapshot.Hw);
+
+		Scheduler.RestoreSnapshot(Snapshot.Scheduler);
+		PreviousTurbulence = FromSnapshot(Snapshot.PreviousTurbulence);
+		LatestTurbulence = FromSnapshot(Snapshot.LatestTurbulence);
+		StepStartForcesAndMoments = FForcesAndMoments(FromSnapshot(Snapshot.HeldForces), FromSnapshot(Snapshot.HeldMoments));
+
+		StepController.Reset();
+
+		return true;
+	}
+
+	void FVehicle::AddToHash(FStateHash& Hash) const
+	{
+		Hash.Add(RigidBodyState.Position);
+		Hash.Add(RigidBodyState.Attitude);
+		Hash.Add(RigidBodyState.Vb);
+		Hash.Add(RigidBodyState.Omegab);
+		Hash.Add(AtmosphericConditionsState.Vw);
+
+		Elevator.Actuator.AddToHash(Hash);
+		Aileron.Actuator.AddToHash(Hash);
+		Rudder.Actuator.AddToHash(Hash);
+
+		for (const FPropulsor& Propulsor : Propulsors)
+		{
+			Propulsor.Motor.AddToHash(Hash);
+			Hash.Add(Propulsor.Propeller.GetMotionState());
+		}
+
+		if (bEnableTurbulenceModel)
+		{
+			TurbulenceModel.Hu.AddToHash(Hash);
+			TurbulenceModel.Hv.AddToHash(Hash);
+			TurbulenceModel.Hw.AddToHash(Hash);
+		}
+
+		// The outputs held between the updates of the slower models
+		if (Scheduler.IsMultiRate())
+		{
+			Hash.Add(LatestTurbulence);
+			Hash.Add(StepStartForcesAndMoments.Forces);
+			Hash.Add(StepStartForcesAndMoments.Moments);
+		}
+	}
+
+	void FVehicle::UpdateState(float DeltaTime)
+	{
+		Scheduler.Advance(DeltaTime);
+
+		UpdateAtmosphericConditionsState();
+		UpdateAirspeedState();
+		UpdateActuatorState();
+	}
+
+	void FVehicle::ApplyForcesAndMoments(const FForcesAndMoments& AirframeForcesAndMoments, float DeltaTime)
+	{
+		UpdateRotorBank();
+
+		bool bInitialStage = true;
+
+		RigidBodyModel.Integrate(RigidBodyState, Gravity, DeltaTime, IntegrationMethod, [&](const FRigidBodyState& Stage)
+			{
+				// The first stage is our current state, for which we've already been given the airframe forces and moments (or are holding them).
+				if (bInitialStage && Scheduler.IsDue(EScheduledModel::Aerodynamics))
+				{
+					bInitialStage = false;
+					StepStartForcesAndMoments = AirframeForcesAndMoments + CalculatePropulsionForcesAndMoments(Stage, AirspeedState.Vwb);
+					return StepStartForcesAndMoments;
+				}
+
+				return CalculateStageForcesAndMoments(Stage);
+			});
+	}
+
+	void FVehicle::SetControlSurfaceCommands(float ElevatorCommand, float AileronCommand, float RudderCommand)
+	{
+		Elevator.Command = Clamp(ElevatorCommand, -1.0f, 1.0f);
+		Aileron.Command = Clamp(AileronCommand, -1.0f, 1.0f);
+		Rudder.Command = Clamp(RudderCommand, -1.0f, 1.0f);
+	}
+
+	void FVehicle::SetPropulsorCommand(int PropulsorIndex, float Command)
+	{
+		if (PropulsorIndex >= 0 && PropulsorIndex < static_cast<int>(Propulsors.size()))
+		{
+			Propulsors[PropulsorIndex].Command = Clamp(Command, 0.0f, 1.0f);
+		}
+	}
+
+	void FVehicle::UpdateAtmosphericConditionsState()
+	{
+		// Check if there is an assigned turbulence model
+		FVector3 Vtw = FVector3::Zero();
+
+		if (bEnableTurbulenceModel)
+		{
+			// Turbulence is calculated in the body frame, over the time since it was last updated
+			if (Scheduler.IsDue(EScheduledModel::Turbulence))
+			{
+				const float Altitude = -RigidBodyState.Position.z();
+				PreviousTurbulence = LatestTurbulence;
+				LatestTurbulence = TurbulenceModel.GetTurbulenceBodyFrame(Scheduler.GetDeltaTime(EScheduledModel::Turbulence), AirspeedState.Va, Altitude, AtmosphericConditionsState.VwLowAltitude.norm());
+			}
+
+			FVector3 Vtb = LatestTurbulence;
+			if (bInterpolateTurbulence)
+			{
+				Vtb = PreviousTurbulence + Scheduler.GetInterpolationAlpha(EScheduledModel::Turbulence) * (LatestTurbulence - PreviousTurbulence);
+			}
+
+			// Convert to world frame before we add it to the global wind vector (which is also in the world frame)
+			Vtw = RemoveNumericalErrors(RigidBodyState.Attitude * Vtb);
+		}
+
+		AtmosphericConditionsState.rho = 1.225f;
+		AtmosphericConditionsState.VwLowAltitude = SteadyWind;
+		AtmosphericConditionsState.Vw = SteadyWind + Vtw;
+	}
+
+	void FVehicle::UpdateAirspeedState()
+	{
+		// Get wind speed in the body frame
+		FVector3 Vwb = RigidBodyState.Attitude.conjugate() * AtmosphericConditionsState.Vw;
+		AirspeedState = CalculateAirspeedState(RigidBodyState.Vb, Vwb);
+	}
+
+	void FVehicle::UpdateActuatorState()
+	{
+		// The actuator outputs are held until they are next due, and then cover all the time since.
+		if (!Scheduler.IsDue(EScheduledModel::Actuators))
+		{
+			return;
+		}
+		const float DeltaTime = Scheduler.GetDeltaTime(EScheduledModel::Actuators);
+
+		ControlSurfaceDeflections.de = Elevator.Actuator.ApplyActuatorCommand(Elevator.Command, DeltaTime);
+		ControlSurfaceDeflections.da = Aileron.Actuator.ApplyActuatorCommand(Aileron.Command, DeltaTime);
+		ControlSurfaceDeflections.dr = Rudder.Actuator.ApplyActuatorCommand(Rudder.Command, DeltaTime);
+
+		for (FPropulsor& Propulsor : Propulsors)
+		{
+			Propulsor.Propeller.SetRotationalSpeed(RPMToRadPerS(Propulsor.Motor.ApplyActuatorCommand(Propulsor.Command, DeltaTime)));
+		}
+	}
+
+	void FVehicle::UpdateRotorBank()
+	{
+		if (RotorBank.Num() != static_cast<int>(Propulsors.size()))
+		{
+			RotorBank.Resize(static_cast<int>(Propulsors.size()));
+		}
+
+		for (int i = 0; i < RotorBank.Num(); i++)
+		{
+			RotorBank.SetRotor(i, Propulsors[i].Propeller, Propulsors[i].Geometry);
+		}
+	}
+
+	FForcesAndMoments FVehicle::CalculatePropulsionForcesAndMoments(const FRigidBodyState& State, const FVector3& Vwb)
+	{
+		// All the propellers are evaluated in one vectorised pass, at the propeller speeds held in the bank for this step. The propulsors move with
+		// the airframe, so the bank works out their airspeeds (that of the CoG plus the rotational component), and sums their forces and moments at the CoG.
+		return RotorBank.CalculateForcesAndMoments(AtmosphericConditionsState.rho, State.Vb, State.Omegab, Vwb);
+	}
+
+	FForcesAndMoments FVehicle::CalculateStageForcesAndMoments(const FRigidBodyState& Stage)
+	{
+		if (!Scheduler.IsDue(EScheduledModel::Aerodynamics))
+		{
+			return StepStartForcesAndMoments;
+		}
+
+		// The wind is held in the world frame, so the stage attitude changes its body frame components.
+		const FVector3 Vwb = Stage.Attitude.conjugate() * AtmosphericConditionsState.Vw;
+		const FAirspeedState StageAirspeedState = CalculateAirspeedState(Stage.Vb, Vwb);
+
+		FForcesAndMoments ForcesAndMoments = AirframeModel.CalculateForcesAndMoments(StageAirspeedState, Stage.Omegab, AtmosphericConditionsState.rho, ControlSurfaceDeflections);
+		ForcesAndMoments += CalculatePropulsionForcesAndMoments(Stage, Vwb);
+		return ForcesAndMoments;
+	}
+}
@@ -0,0 +1,6 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+// This is the only UE4-dependent file in SkyPhysCore, and is excluded from the CMake build.
+#include "Modules/ModuleManager.h"
+
+IMPLEMENT_MODULE(FDefaultModuleImpl, SkyPhysCore)
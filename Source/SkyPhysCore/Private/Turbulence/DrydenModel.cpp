@@ -0,0 +1,266 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SkyPhysCore/Turbulence/DrydenModel.h"
+
+#include <cfloat>
+#include <cmath>
+
+#include "SkyPhysCore/Common/MathUtils.h"
+
+namespace SkyPhysCore
+{
+	void FDrydenFilter::Initialize()
+	{
+		WhiteNoise = FRandomStream(Seed); // Normal distribution of Mean = 0, Variance/StdDev = 1
+		NumSamples = 0;
+		Integrator1 = Integrator(0.0f, Ts);
+		Integrator2 = Integrator(0.0f, Ts);
+		IsInitialized = true;
+	}
+
+	float FDrydenFilter::GetTurbulence(float Va, float Dt, float L, float Sigma)
+	{
+		if (!IsInitialized)
+		{
+			Initialize();
+		}
+		// Ensure that Va is sensible before passing it through
+		Va = (std::isnan(Va) || IsNearlyZero(Va)) ? 0 : Va;
+		// Generate our noise from the (portable) seeded stream, as a normal distribution.
+		// This is band limited white noise, which is scaled to sigma/sqrt(Ts) in order to have correct scaling in a discrete sim.
+		// More information on this process can be found here: https://github.com/ethz-asl/kalibr/wiki/IMU-Noise-Model
+		// And this is also what is done in the Simulink White Noise model as part of the Dryden Wind Turbulence block.
+		// Note: The Pi scaling comes from Simulink - not 100% sure where they got this from.
+		// Exponential filters hold each sample for the whole of Dt instead, so scale to that.
+		const bool bExponential = IntegrationMethod == EFilterIntegrationMethod::Exponential && Dt > 0.0f;
+		float noise = sqrtf(Pi / (bExponential ? Dt : Ts)) * WhiteNoise.NextNormal();
+		NumSamples++;
+		float turbulenceFts = Filter(Dt, Va, L, Sigma, noise);
+		turbulenceFts = (std::isnan(turbulenceFts) || IsNearlyZero(turbulenceFts)) ? 0.0f : turbulenceFts;
+		return turbulenceFts;
+	}
+
+	void FDrydenFilter::SetSeed(uint64_t InSeed)
+	{
+		Seed = InSeed;
+		IsInitialized = false;
+	}
+
+	void FDrydenFilter::SaveSnapshot(FDrydenFilterSnapshot& Snapshot) const
+	{
+		Snapshot.WhiteNoise = WhiteNoise;
+		Snapshot.Integrator1 = Integrator1;
+		Snapshot.Integrator2 = Integrator2;
+		Snapshot.Seed = Seed;
+		Snapshot.NumSamples = NumSamples;
+		Snapshot.IsInitialized = IsInitialized;
+	}
+
+	void FDrydenFilter::RestoreSnapshot(const FDrydenFilterSnapshot& Snapshot)
+	{
+		WhiteNoise = Snapshot.WhiteNoise;
+		Integrator1 = Snapshot.Integrator1;
+		Integrator2 = Snapshot.Integrator2;
+		Seed = Snapshot.Seed;
+		NumSamples = Snapshot.NumSamples;
+		IsInitialized = Snapshot.IsInitialized;
+	}
+
+	void FDrydenFilter::AddToHash(FStateHash& Hash) const
+	{
+		Hash.Add(Seed);
+		Hash.Add(NumSamples);
+		Hash.Add(Integrator1.X);
+		Hash.Add(Integrator1.UPrev);
+		Hash.Add(Integrator2.X);
+		Hash.Add(Integrator2.UPrev);
+	}
+
+	float FDrydenFilter::Filter(float Dt, float Va, float L, float Sigma, float Noise)
+	{
+		if (IntegrationMethod == EFilterIntegrationMethod::Exponential)
+		{
+			return Axis == EDrydenAxis::U ? FilterHuExponential(Dt, Va, L, Sigma, Noise) : FilterHvHwExponential(Dt, Va, L, Sigma, Noise);
+		}
+		return Axis == EDrydenAxis::U ? FilterHu(Dt, Va, L, Sigma, Noise) : FilterHvHw(Dt, Va, L, Sigma, Noise);
+	}
+
+	float FDrydenFilter::FilterHu(float Dt, float Va, float L, float Sigma, float Noise)
+	{
+		//This process matches that found in Hugw(s) within the Dryden Wind Turbulence Model (Continuous) in Simulink
+		//I've tried to keep the variable names consistent with Simulink where possible.
+
+		// Make Lug_over_Va as large as possible without being NaN if Va is nearly zero.
+		float Lug_over_Va = FLT_MAX;
+		if (!IsNearlyZero(Va))
+		{
+			Lug_over_Va = L / Va;
+		}
+		float feedback_input = sqrtf((Lug_over_Va) * (2.0f / Pi)) * Noise;
+		float summing_output = feedback_input - Integrator1.X;
+		float w = summing_output / Lug_over_Va;
+		float ug_p = Integrator1.Integrate(Dt, w);
+		return Sigma * ug_p;
+	}
+
+	float FDrydenFilter::FilterHvHw(float Dt, float Va, float L, float Sigma, float Noise)
+	{
+		//This process matches that found in Hvgw(s) and Hwgw(s) (which share the same form) within the Dryden Wind Turbulence Model (Continuous) in Simulink
+		//I've tried to keep the variable names consistent with Simulink where possible.
+
+		//This is the first stage, up until the integrator named vg_p1/wg_p1
+
+		// Make L_over_Va as large as possible without being NaN if Va is nearly zero.
+		float L_over_Va = FLT_MAX;
+		if (!IsNearlyZero(Va))
+		{
+			L_over_Va = L / Va;
+		}
+		float feedback_input = sqrtf((L_over_Va) * (1.0f / Pi)) * Noise;
+		float summing1_output = feedback_input - Integrator1.X;
+		float w1 = summing1_output / L_over_Va; //They've used the name "w" twice, so w1 and w2 for us
+		float g_p1 = Integrator1.Integrate(Dt, w1);
+		// Second part of the integration, from vg_p1/wg_p1 onward
+		float summing2_input_2 = sqrt(3.0f) * L_over_Va * w1; //Second summing input to the second summing junction.
+		float summing2_output = g_p1 + summing2_input_2 - Integrator2.X;
+		float w2 = summing2_output / L_over_Va;
+		float g_p2 = Integrator2.Integrate(Dt, w2);
+		return Sigma * g_p2;
+	}
+
+	float FDrydenFilter::FilterHuExponential(float Dt, float Va, float L, float Sigma, float Noise)
+	{
+		// The same filter as FilterHu, ug_p' = (feedback_input - ug_p) * Va/L, solved exactly for the noise held over Dt:
+		// ug_p(t + Dt) = ug_p(t) + (feedback_input - ug_p(t)) * (1 - exp(-Dt * Va/L))
+		// Written in terms of the change, so that it is exactly held when Va is nearly zero (and feedback_input is huge).
+
+		float Lug_over_Va = FLT_MAX;
+		if (!IsNearlyZero(Va))
+		{
+			Lug_over_Va = L / Va;
+		}
+		const double feedback_input = sqrt(static_cast<double>(Lug_over_Va) * (2.0 / Pi)) * Noise;
+		const double ug_p = Integrator1.X;
+		const double Decay = -expm1(-Dt / static_cast<double>(Lug_over_Va)); // 1 - exp(-Dt * Va/L)
+		const double ug_p_next = ug_p + (feedback_input - ug_p) * Decay;
+
+		// The integrator input is kept as the rate at the new state (as per the trapezoidal filter).
+		Integrator1.SetState(static_cast<float>(ug_p_next), static_cast<float>((feedback_input - ug_p_next) / Lug_over_Va));
+		return Sigma * Integrator1.X;
+	}
+
+	float FDrydenFilter::FilterHvHwExponential(float Dt, float Va, float L, float Sigma, float Noise)
+	{
+		// The same filter as FilterHvHw, with T = L/Va and f = feedback_input:
+		// g_p1' = (f - g_p1) / T
+		// g_p2' = (g_p1 + sqrt(3) * (f - g_p1) - g_p2) / T
+		// Both states settle to f, and in terms of their errors from it (e1 = g_p1 - f, e2 = g_p2 - f) this is a repeated pole at -1/T:
+		// e1(t + Dt) = E * e1(t)
+		// e2(t + Dt) = E * (e2(t) + (1 - sqrt(3)) * (Dt / T) * e1(t)), where E = exp(-Dt / T)
+		// Written in terms of the change, so that it is exactly held when Va is nearly zero (and f is huge).
+
+		float L_over_Va = FLT_MAX;
+		if (!IsNearlyZero(Va))
+		{
+			L_over_Va = L / Va;
+		}
+		const double T = L_over_Va;
+		const double feedback_input = sqrt(T * (1.0 / Pi)) * Noise;
+		const double e1 = Integrator1.X - feedback_input;
+		const double e2 = Integrator2.X - feedback_input;
+
+		const double OneMinusE = -expm1(-Dt / T);
+		const double E = 1.0 - OneMinusE;
+		const double g_p1_next = Integrator1.X - OneMinusE * e1;
+		const double g_p2_next = Integrator2.X - OneMinusE * e2 + E * (1.0 - sqrt(3.0)) * (Dt / T) * e1;
+
+		// The integrator inputs are kept as the rates at the new state (as per the trapezoidal filter).
+		const double w1 = (feedback_input - g_p1_next) / T;
+		const double w2 = (g_p1_next + sqrt(3.0) * T * w1 - g_p2_next) / T;
+		Integrator1.SetState(static_cast<float>(g_p1_next), static_cast<float>(w1));
+		Integrator2.SetState(static_cast<float>(g_p2_next), static_cast<float>(w2));
+		return Sigma * Integrator2.X;
+	}
+
+	FVector3 FDrydenTurbulenceModel::GetTurbulenceBodyFrame(float Dt, float Va, float Altitude, float WindSpeed)
+	{
+		// Convert to Imperial for Future Calcs
+		float AltitudeFt = Altitude * MToFt;
+		float AirspeedFtS = Va * MToFt;
+
+		// Get Setup Params
+		FVector3 ScaleLengths = GetTurbulenceScaleLengths(AltitudeFt);
+		FVector3 RMSIntensities = GetTurbulenceRMSIntensities(AltitudeFt, WindSpeed);
+
+		// Calculate Turbulence in body frame
+		FVector3 Vwg = FVector3::Zero();
+
+		if (bEnableHu)
+		{
+			Vwg.x() = Hu.GetTurbulence(AirspeedFtS, Dt, ScaleLengths.x(), RMSIntensities.x()) / MToFt;
+		}
+
+		if (bEnableHv)
+		{
+			Vwg.y() = Hv.GetTurbulence(AirspeedFtS, Dt, ScaleLengths.y(), RMSIntensities.y()) / MToFt;
+		}
+
+		if (bEnableHw)
+		{
+			Vwg.z() = Hw.GetTurbulence(AirspeedFtS, Dt, ScaleLengths.z(), RMSIntensities.z()) / MToFt;
+		}
+
+		return Vwg;
+	}
+
+	float FDrydenTurbulenceModel::GetCharacteristicRate(float Va, float Altitude) const
+	{
+		const bool bTrapezoidal = (bEnableHu && Hu.GetIntegrationMethod() == EFilterIntegrationMethod::Trapezoidal)
+			|| (bEnableHv && Hv.GetIntegrationMethod() == EFilterIntegrationMethod::Trapezoidal)
+			|| (bEnableHw && Hw.GetIntegrationMethod() == EFilterIntegrationMethod::Trapezoidal);
+
+		return bTrapezoidal ? CalculateCharacteristicRate(Va, Altitude) : 0.0f;
+	}
+
+	void FDrydenTurbulenceModel::SetSeed(uint64_t Seed)
+	{
+		Hu.SetSeed(FRandomStream::DeriveSeed(Seed, 0));
+		Hv.SetSeed(FRandomStream::DeriveSeed(Seed, 1));
+		Hw.SetSeed(FRandomStream::DeriveSeed(Seed, 2));
+	}
+
+	FVector3 FDrydenTurbulenceModel::GetTurbulenceScaleLengths(float Altitude)
+	{
+		float Lwg = 0.0f;
+		float LugLvg = 0.0f;
+
+		if (Altitude >= 10.0f)
+		{
+			float ClampedAltitude = Clamp(Altitude, 10.0f, 1000.0f);  // Constrain h to 10ft < h < 1000ft
+
+			Lwg = ClampedAltitude;
+			LugLvg = ClampedAltitude / pow(0.177f + 0.000823f * ClampedAltitude, 1.2f); // MIL-F-8785C pg. 55, Figure 10
+		}
+
+		return FVector3(LugLvg, LugLvg, Lwg);
+	}
+
+	float FDrydenTurbulenceModel::CalculateCharacteristicRate(float Va, float Altitude)
+	{
+		// Below 10ft there is no turbulence (the scale lengths are 0)
+		const FVector3 ScaleLengths = GetTurbulenceScaleLengths(Altitude * MToFt);
+		const float MinScaleLength = ScaleLengths.minCoeff();
+
+		return MinScaleLength > 0.0f ? (Va * MToFt) / MinScaleLength : 0.0f;
+	}
+
+	FVector3 FDrydenTurbulenceModel::GetTurbulenceRMSIntensities(float Altitude, float WindSpeed20Ft)
+	{
+		float AltitudeClamped = Clamp(Altitude, 0.0f, 1000.0f);  // Constrain h to 0ft < h < 1000ft
+		float SigmaW = 0.1f * WindSpeed20Ft;
+
+		float SigmaUSigmaV = SigmaW / pow(0.177f + 0.000823f * AltitudeClamped, 0.4f); // MIL-F-8785C pg. 56, Figure 11
+
+		return FVector3(SigmaUSigmaV, SigmaUSigmaV, SigmaW);
+	}
+}
@@ -0,0 +1,120 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cstdint>
+
+#include "SkyPhysCore/Common/Integrator.h"
+#include "SkyPhysCore/Common/StateHash.h"
+
+namespace SkyPhysCore
+{
+	enum class EActuatorModelType : uint8_t
+	{
+		None,			// Straight feedthrough (no dynamics)
+		FirstOrder,		// wn/(s+wn)
+		SecondOrder		// wn^2/(s^2 + 2*zeta*wn + wn^2)
+	};
+
+	struct FActuatorParameters
+	{
+		EActuatorModelType Type = EActuatorModelType::None;
+
+		float wn = 0.0f; // Natural frequency of the filter (rad/s)
+		float zeta = 0.0f; // Damping ratio of the filter (unitless), only used by second order actuators
+		float DCGain = 1.0f; // DC Gain of the filter (unitless)
+
+		// How the filter is advanced over each command. Exponential is exact (for the command held over DeltaTime) and stable for any wn, so
+		// fast actuators don't need small steps.
+		EFilterIntegrationMethod IntegrationMethod = EFilterIntegrationMethod::Trapezoidal;
+
+		float RateLimit = 0.0f; // 0 disables the rate limit
+		float UpperSaturation = 0.0f; // 0 disables the upper saturation limit
+		float LowerSaturation = 0.0f; // 0 disables the lower saturation limit
+		float InitialActuatorState = 0.0f;
+	};
+
+	// The complete dynamic state of an FActuatorModel (trivially copyable)
+	struct FActuatorSnapshot
+	{
+		Integrator Integrator1;
+		Integrator Integrator2;
+		float ActuatorState;
+		bool bActuatorInitialised;
+	};
+
+	// Engine-independent actuator model, which handles the dynamics of both first and second order actuators (ie. servos and motors).
+	class SKYPHYSCORE_API FActuatorModel
+	{
+	public:
+		FActuatorModel() {};
+		FActuatorModel(const FActuatorParameters& Parameters) : Parameters(Parameters) {};
+
+		// Apply a new command to the actuator.
+		//
+		// @param Command - The new command to apply to the actuator (unit depends on actuator)
+		// @param DeltaTime - The amount of time since the last actuator command was provided (s)
+		//
+		// @return The latest state of the actuator (unit depends on the actuator)
+		float ApplyActuatorCommand(float Command, float DeltaTime);
+
+		// Get the current state of the actuator.
+		//
+		// @return The latest state of the actuator (unit depends on the actuator)
+		float GetActuatorState() const { return ActuatorState; };
+
+		// Reset the actuator to its initial state.
+		void InitialiseActuator();
+
+		const FActuatorParameters& GetParameters() const { return Parameters; };
+
+		// Get the fastest rate of the actuator dynamics (ie. the magnitude of its fastest pole) (1/s), or 0 for a feedthrough actuator.
+		// Exponential actuators are stable for any step, so don't limit the step size either (ie. they are also 0).
+		float GetCharacteristicRate() const;
+
+		// Save or restore the complete dynamic state of the actuator.
+		void SaveSnapshot(FActuatorSnapshot& Snapshot) const
+		{
+			Snapshot.Integrator1 = Integrator1;
+			Snapshot.Integrator2 = Integrator2;
+			Snapshot.ActuatorState = ActuatorState;
+			Snapshot.bActuatorInitialised = bActuatorInitialised;
+		};
+
+		void RestoreSnapshot(const FActuatorSnapshot& Snapshot)
+		{
+			Integrator1 = Snapshot.Integrator1;
+			Integrator2 = Snapshot.Integrator2;
+			ActuatorState = Snapshot.ActuatorState;
+			bActuatorInitialised = Snapshot.bActuatorInitialised;
+		};
+
+		// Add the actuator state (including the filter integrators) to a state hash.
+		void AddToHash(FStateHash& Hash) const
+		{
+			Hash.Add(ActuatorState);
+			Hash.Add(Integrator1.X);
+			Hash.Add(Integrator1.UPrev);
+			Hash.Add(Integrator2.X);
+			Hash.Add(Integrator2.UPrev);
+		};
+
+	private:
+
+		float ApplyFirstOrderDynamics(float Command, float DeltaTime);
+		float ApplySecondOrderDynamics(float Command, float DeltaTime);
+		float ApplyFirstOrderExponential(float Command, float DeltaTime);
+		float ApplySecondOrderExponential(float Command, float DeltaTime);
+
+		// Apply the rate and saturation limits to the output of the filter.
+		float ApplyLimits(float Current, float Expected, float DeltaTime) const;
+
+		FActuatorParameters Parameters;
+
+		Integrator Integrator1;
+		Integrator Integrator2;
+
+		float ActuatorState = 0.0f;
+		bool bActuatorInitialised = false;
+	};
+}
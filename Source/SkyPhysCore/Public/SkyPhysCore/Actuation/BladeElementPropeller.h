@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "SkyPhysCore/Actuation/PropellerPerformanceTable.h"
+#include "SkyPhysCore/Common/TaskPool.h"
+
+namespace SkyPhysCore
+{
+	// The lift and drag of the blade sections against angle of attack.
+	struct SKYPHYSCORE_API FAirfoilPolar
+	{
+		// The angle over which the polar blends into a flat plate beyond either end of its data (rad)
+		static constexpr float StallBlendAngle = 0.2f;
+
+		// Lift and drag coefficients against angle of attack (rad, sorted in ascending order). Beyond this data the section is taken to be stalled,
+		// and blends into a flat plate. If there's no data, a thin airfoil (CL = 2 * Pi * alpha, CD = 0.01) up to +-0.2 rad (~11 degrees) is used.
+		std::vector<float> Alpha;
+		std::vector<float> CL;
+		std::vector<float> CD;
+
+		// Get the lift and drag coefficients at any angle of attack.
+		//
+		// @param Alpha: Angle of attack (rad), which is wrapped to +-Pi
+		// @param OutCL: Set to the lift coefficient
+		// @param OutCD: Set to the drag coefficient
+		void Evaluate(float Alpha, float& OutCL, float& OutCD) const;
+	};
+
+	struct FBladeStation
+	{
+		// As per the UIUC propeller database geometry files
+		float r = 0.0f; // Radius (r/R)
+		float Chord = 0.0f; // Chord (c/R)
+		float Twist = 0.0f; // Pitch of the section chord to the propeller plane (rad)
+	};
+
+	// The geometry of a propeller's blades, from which the blade element solver works out its performance (rather than from measured data).
+	struct FBladeElementPropellerGeometry
+	{
+		float D = 0.0f; // Propeller diameter (m)
+		int NumBlades = 2;
+		std::vector<FBladeStation> Stations; // Sorted by radius, from the root (the first station is the edge of the hub) to the tip
+		FAirfoilPolar Airfoil;
+	};
+
+	// The extent and resolution of a performance table built by the blade element solver.
+	struct FBladeElementTableResolution
+	{
+		// Propeller speed (RPM). This only matters through the Mach number of the blade sections, so it can be coarse.
+		float NMin = 1000.0f;
+		float NMax = 20000.0f;
+		int NumN = 8;
+
+		// Advance ratio (from 0), and inflow angle (from 0 to Pi)
+		float JMax = 1.5f;
+		int NumJ = 31;
+		int NumInflowAngles = 13;
+	};
+
+	// Blade element momentum theory settings
+	namespace BladeElement
+	{
+		constexpr int NumAnnuli = 20; // Radial elements, from the hub to the tip
+		constexpr int NumAzimuths = 8; // Blade positions around the disc, averaged over for oblique inflow
+		constexpr int NumIterations = 30; // Bisection steps for the induced velocity of each annulus
+		constexpr float SpeedOfSound = 340.3f; // (m/s), for the compressibility (Prandtl-Glauert) correction of the section lift
+		constexpr float MaxMachNumber = 0.9f; // Limit of the compressibility correction
+	}
+
+	// Solve the performance of a propeller at one operating point with blade element momentum theory.
+	//
+	// Each annulus of the disc balances the thrust of its blade elements (averaged over the blade positions around the disc, which differ in
+	// oblique inflow) against that of the momentum of the flow through it (as per Glauert, which holds through edgewise flight), with Prandtl's
+	// tip loss. The induced velocity is found by bisection, bracketed by the sign of the blade thrust: from zero upwards when the blades push,
+	// and down to half of the axial airspeed (the limit of momentum theory, beyond which the wake is turbulent) when they windmill.
+	//
+	// @param Geometry: The propeller blades
+	// @param n: Propeller speed (RPM)
+	// @param J: Advance ratio (unitless)
+	// @param InflowAngle: Angle between the airspeed and the propeller axis (rad, see FPropellerPerformanceTable)
+	//
+	// @return The performance coefficients
+	SKYPHYSCORE_API FPropellerPerformance SolveBladeElementPerformance(const FBladeElementPropellerGeometry& Geometry, float n, float J, float InflowAngle);
+
+	// Precompute the performance of a propeller over the full envelope, so that using it is just a table lookup (see FBladeElementPropellerModel).
+	//
+	// @param Geometry: The propeller blades
+	// @param Resolution: The extent and resolution of the table
+	// @param ParallelFor: How to spread the work (eg. FTaskPool::AsParallelFor(), or ParallelFor in Unreal)
+	//
+	// @return The table, which is immutable and can be shared by every propeller of this type
+	SKYPHYSCORE_API std::shared_ptr<const FPropellerPerformanceTable> BuildBladeElementPerformanceTable(const FBladeElementPropellerGeometry& Geometry,
+		const FBladeElementTableResolution& Resolution = FBladeElementTableResolution(), const FParallelFor& ParallelFor = SerialFor);
+}
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <memory>
+
+#include "SkyPhysCore/Common/CoreTypes.h"
+#include "SkyPhysCore/Actuation/PropellerPerformanceTable.h"
+
+namespace SkyPhysCore
+{
+	struct FBladeElementPropellerParameters
+	{
+		float RotationDirection = 1.0f; // The rotation direction of the propeller (Right Hand Rule) about the Z axis (+1 or -1).
+		float Izz = 0.0f; // Mass moment of inertia of the propeller about the Z axis (kg.m^2)
+		float D = 0.0f; // Propeller diameter (m), as per the blade geometry the table was built from
+	};
+
+	// Engine-independent propeller model, based on a performance table precomputed from the blade geometry (see BuildBladeElementPerformanceTable),
+	// so propellers without measured data can be simulated, and the in-plane force and the effect of oblique inflow come from the blades
+	// themselves (rather than the lumped drag model of FPropellerModel). Each step is just a table lookup.
+	// All calculations are done in the propeller frame, with thrust acting along -Z.
+	class SKYPHYSCORE_API FBladeElementPropellerModel
+	{
+	public:
+		FBladeElementPropellerModel();
+
+		// @param Parameters: The propeller parameters
+		// @param Table: The performance of this type of propeller, which may be shared (if null, the propeller has no thrust or torque)
+		FBladeElementPropellerModel(const FBladeElementPropellerParameters& Parameters, std::shared_ptr<const FPropellerPerformanceTable> Table);
+
+		// Set the propeller rotational speed (rad/s), generally from the motor actuator.
+		void SetRotationalSpeed(float InOmega) { omega = InOmega; };
+
+		// Get the current propeller speed (in SI units)
+		//
+		// @return The current propeller speed (rad/s)
+		float GetMotionState() const { return omega; };
+
+		// Get the angular momentum of the propeller about its spin axis (kg.m^2/s)
+		float GetAngularMomentum() const { return Parameters.Izz * omega; };
+
+		// Calculate the forces and moments generated by this propeller in the propeller frame, at the origin of the propeller frame
+		// (ie. the moments do not include the effect of the forces at a distance).
+		//
+		// @param Rho: Air density (kg/m^3)
+		// @param Va: Airspeed of the propeller (ie. propeller velocity less wind velocity) in the propeller frame (m/s)
+		// @param SystemOmega: Root body rotational velocity in the propeller frame (rad/s)
+		//
+		// @return The forces and moments generated by this propeller in the propeller frame (N, Nm)
+		FForcesAndMoments CalculateForcesAndMoments(float Rho, const FVector3& Va, const FVector3& SystemOmega) const;
+
+		const FBladeElementPropellerParameters& GetParameters() const { return Parameters; };
+		const FPropellerPerformanceTable& GetTable() const { return *Table; };
+		const std::shared_ptr<const FPropellerPerformanceTable>& GetSharedTable() const { return Table; };
+
+	private:
+		FBladeElementPropellerParameters Parameters;
+
+		// Never null
+		std::shared_ptr<const FPropellerPerformanceTable> Table;
+
+		float omega = 0.0f; // Current propeller rotational speed (rad/s)
+	};
+}
@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "SkyPhysCore/Actuation/PropellerTable.h"
+
+namespace SkyPhysCore
+{
+	// The binary layout of a propeller database file (in the byte order of the host which wrote it, see ByteOrderMark). The file is memory mapped and used in place, so these are
+	// only ever read through pointers into the mapping, and never parsed.
+	//
+	// [FPropellerDatabaseHeader][FPropellerDatabaseEntry x NumPropellers (sorted by name)][padding][coefficients of each propeller]...
+	struct FPropellerDatabaseHeader
+	{
+		char Magic[8]; // FPropellerDatabase::Magic
+		uint32_t Version; // FPropellerDatabase::Version
+		uint32_t ByteOrderMark; // FPropellerDatabase::ByteOrderMark, as written by the host (so a file of the other byte order is rejected)
+		uint32_t NumPropellers;
+		uint32_t Reserved;
+		uint64_t FileSize; // (bytes), so a truncated file is rejected
+	};
+
+	struct FPropellerDatabaseEntry
+	{
+		static constexpr int MaxNameLength = 63;
+
+		char Name[MaxNameLength + 1]; // Null terminated (a file with any name which isn't is rejected by FPropellerDatabase::Open)
+		float NMin, NMax; // Propeller speed axis (RPM)
+		float JMin, JMax; // Advance ratio axis (unitless)
+		uint32_t NumN, NumJ;
+		uint64_t CoefficientsOffset; // From the start of the file (bytes, aligned to FPropellerDatabase::Alignment), see FPropellerTable::GetCoefficients
+	};
+
+	static_assert(sizeof(FPropellerDatabaseHeader) == 32 && std::is_trivially_copyable<FPropellerDatabaseHeader>::value, "The propeller database header layout is part of the file format");
+	static_assert(sizeof(FPropellerDatabaseEntry) == 96 && std::is_trivially_copyable<FPropellerDatabaseEntry>::value, "The propeller database entry layout is part of the file format");
+
+	// A library of propeller tables (see FPropellerTable), cooked offline (eg. by the SkyPhysPropellerImporter tool, from UIUC propeller
+	// database files) into one versioned binary file, which is memory mapped when opened. Opening one only checks its header and entries
+	// (not the tables, which are checked when first used), so only the pages of the propellers which are actually used are ever read in.
+	// The tables are used in place (with no parsing or copying), and keep the mapping alive for as long as any of them are in use.
+	class SKYPHYSCORE_API FPropellerDatabase
+	{
+	public:
+		static constexpr char Magic[8] = { 'S', 'K', 'Y', 'P', 'R', 'O', 'P', '\0' };
+		static constexpr uint32_t Version = 1;
+		static constexpr uint32_t ByteOrderMark = 0x01020304;
+		static constexpr uint64_t Alignment = 16;
+
+		// Open (memory map) a database file. A file which is already open is shared, rather than mapped again.
+		//
+		// @param Path: The database file
+		//
+		// @return The database, or null if the file couldn't be mapped, isn't a database of this version and byte order, or is malformed
+		static std::shared_ptr<const FPropellerDatabase> Open(const std::string& Path);
+
+		// Write a database file.
+		//
+		// @param Path: The database file
+		// @param Propellers: The name (up to FPropellerDatabaseEntry::MaxNameLength characters, and unique) and table of each propeller
+		//
+		// @return False if a name is too long or repeated, or the file couldn't be written
+		static bool Write(const std::string& Path, const std::vector<std::pair<std::string, FPropellerTable>>& Propellers);
+
+		int GetNumPropellers() const { return static_cast<int>(Header->NumPropellers); };
+		const char* GetName(int Index) const { return Entries[Index].Name; };
+
+		// Find a propeller by name (binary search).
+		//
+		// @return The index of the propeller, or -1 if there's no propeller of that name
+		int Find(const std::string& Name) const;
+
+		// Get the table of a propeller, in place in the mapped file.
+		//
+		// @return The table, or null if the entry of the propeller doesn't fit the file
+		std::shared_ptr<const FPropellerTable> GetTable(int Index) const;
+
+		// As per GetTable, by name.
+		//
+		// @return The table, or null if there's no (valid) propeller of that name
+		std::shared_ptr<const FPropellerTable> FindTable(const std::string& Name) const;
+
+	private:
+		// A read only memory mapping of a whole file (see PropellerDatabase.cpp).
+		class FMappedFile;
+
+		explicit FPropellerDatabase(std::shared_ptr<const FMappedFile> File);
+
+		std::shared_ptr<const FMappedFile> File;
+
+		const FPropellerDatabaseHeader* Header = nullptr;
+		const FPropellerDatabaseEntry* Entries = nullptr;
+	};
+}
@@ -0,0 +1,186 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cfloat>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "SkyPhysCore/Common/CoreTypes.h"
+#include "SkyPhysCore/Common/MathUtils.h"
+#include "SkyPhysCore/Actuation/PropellerTable.h"
+
+namespace SkyPhysCore
+{
+	struct FPropellerParameters
+	{
+		// We will have a set of propeller parameters, based on the propeller speed (sorted by ascending speed).
+		std::vector<FConstantSpeedPropellerData> ConstantSpeedData;
+
+		float RotationDirection = 1.0f; // The rotation direction of the propeller (Right Hand Rule) about the Z axis (+1 or -1).
+		float Cd = 0.01f; // Lumped drag coefficient (default as per Bangura, 2017) (Unitless)
+		float Izz = 0.0f; // Mass moment of inertia of the propeller about the Z axis (kg.m^2)
+		float D = 0.0f; // True propeller diameter (m)
+	};
+
+	// State Structs
+	struct FPropellerState
+	{
+		FVector3 V = FVector3::Zero(); // Current propeller airstream inflow velocity in the propeller frame (m/s)
+
+		float omega = 0.0f; // Current propeller rotational speed (rad/s)
+		float Rho = 0.0f; // Current air density at the propeller (kg/m^3)
+		float J = 0.0f; // Current advance ratio (unitless)
+		float AerodynamicConstant = 0.0f; // The aerodynamic constant for thrust (rho * n^2 * D^4).
+	};
+
+	// Partial derivatives of the propeller forces and moments (rows: Fx, Fy, Fz, l, m, n, in the propeller frame) with respect to the propeller
+	// airspeed (in the propeller frame), the root body rotational velocity (in the propeller frame) and the propeller rotational speed, in that column order.
+	using FPropellerJacobian = Eigen::Matrix<float, 6, 7>;
+
+	// Engine-independent propeller model, based on measured CT and CP data (as per the UIUC propeller database).
+	// All calculations are done in the propeller frame, with thrust acting along -Z.
+	//
+	// The data is only held in its resampled table (see FPropellerTable), which is immutable, so it can be shared by every propeller of the
+	// same type (eg. across a fleet), rather than each holding its own copy.
+	class SKYPHYSCORE_API FPropellerModel
+	{
+	public:
+		FPropellerModel();
+
+		// Resample the parameters' data into a table for this propeller alone.
+		FPropellerModel(const FPropellerParameters& Parameters);
+
+		// Use a table which has already been built (and may be shared), rather than the parameters' data (which is ignored).
+		//
+		// @param Parameters: The propeller parameters
+		// @param Table: The resampled CT and CP data of this type of propeller (if null, the propeller has no data, so no thrust or torque)
+		FPropellerModel(const FPropellerParameters& Parameters, std::shared_ptr<const FPropellerTable> Table);
+
+		// Set the propeller rotational speed (rad/s), generally from the motor actuator.
+		void SetRotationalSpeed(float omega) { PropellerState.omega = omega; };
+
+		// Get the current propeller speed (in SI units)
+		//
+		// @return The current propeller speed (rad/s)
+		float GetMotionState() const { return PropellerState.omega; };
+
+		// Get the angular momentum of the propeller about its spin axis (kg.m^2/s)
+		float GetAngularMomentum() const { return Parameters.Izz * PropellerState.omega; };
+
+		// Calculate the forces and moments generated by this propeller in the propeller frame, at the origin of the propeller frame
+		// (ie. the moments do not include the effect of the forces at a distance).
+		//
+		// @param Rho: Air density (kg/m^3)
+		// @param Va: Airspeed of the propeller (ie. propeller velocity less wind velocity) in the propeller frame (m/s)
+		// @param SystemOmega: Root body rotational velocity in the propeller frame (rad/s)
+		//
+		// @return The forces and moments generated by this propeller in the propeller frame (N, Nm)
+		FForcesAndMoments CalculateForcesAndMoments(float Rho, const FVector3& Va, const FVector3& SystemOmega);
+
+		// Calculate the forces and moments as per CalculateForcesAndMoments, but at the given rotational speed and without updating the propeller state
+		// (so this can be called concurrently), along with their partial derivatives, for linearisation and trim.
+		// CT and CP are bilinear in n and J within each cell of the table, so their derivatives are those of the cell (and 0 outside the data).
+		// The advance ratio isn't differentiable at zero airspeed, where its derivative is taken as 0.
+		//
+		// @param Rho: Air density (kg/m^3)
+		// @param Va: Airspeed of the propeller in the propeller frame (m/s)
+		// @param SystemOmega: Root body rotational velocity in the propeller frame (rad/s)
+		// @param omega: Propeller rotational speed (rad/s)
+		// @param Jacobian: Set to the partial derivatives, as per FPropellerJacobian
+		//
+		// @return The forces and moments generated by this propeller in the propeller frame (N, Nm)
+		FForcesAndMoments CalculateForcesAndMomentsJacobian(float Rho, const FVector3& Va, const FVector3& SystemOmega, float omega, FPropellerJacobian& Jacobian) const;
+
+		// Calculate the forces and moments as per CalculateForcesAndMoments, but at the given rotational speed and without updating the propeller state,
+		// in any scalar type (eg. FDual, to differentiate them, see Sensitivity.h). Cd and Izz are passed in rather than taken from the parameters,
+		// so that they can be differentiated with respect to as well.
+		//
+		// @param Rho: Air density (kg/m^3)
+		// @param Va: Airspeed of the propeller in the propeller frame (m/s)
+		// @param SystemOmega: Root body rotational velocity in the propeller frame (rad/s)
+		// @param omega: Propeller rotational speed (rad/s)
+		// @param Cd: Lumped drag coefficient (unitless)
+		// @param Izz: Mass moment of inertia of the propeller about the Z axis (kg.m^2)
+		//
+		// @return The forces and moments generated by this propeller in the propeller frame (N, Nm)
+		template<typename TScalar>
+		TForcesAndMoments<TScalar> CalculateForcesAndMoments(TScalar Rho, const TVector3<TScalar>& Va, const TVector3<TScalar>& SystemOmega, TScalar omega, TScalar Cd, TScalar Izz) const
+		{
+			using TVector = TVector3<TScalar>;
+
+			const float D = Parameters.D;
+			const float RotationDirection = Parameters.RotationDirection;
+
+			// Propeller state (as per UpdatePropellerState)
+			const TVector V = RemoveNumericalErrors(Va);
+			const TScalar VNorm = V.norm();
+			const TScalar n = omega / (2 * Pi);
+
+			TScalar J = TScalar(0);
+			if (!IsNearlyZero(VNorm))
+			{
+				J = IsNearlyZero(n) ? TScalar(-FLT_MAX) : VNorm / (n * D);
+			}
+
+			const TScalar AerodynamicConstant = Rho * n * n * (D * D * D * D);
+			const TAerodynamicConstantResults<TScalar> Constants = GetAerodynamicConstants(RadPerSToRPM(omega), J);
+
+			// Thrust, T, and side forces, H = -|T| * Cd * (Vx, Vy, 0) (as per CalculateSideForces, which always oppose the airspeed)
+			using std::fabs;
+			const TScalar T = Constants.CT * AerodynamicConstant;
+			TVector Forces(TScalar(0), TScalar(0), -T);
+			if (!IsNearlyZero(T) && !IsNearlyZero(VNorm))
+			{
+				const TScalar AbsT = fabs(T);
+				Forces.x() = -AbsT * Cd * V.x();
+				Forces.y() = -AbsT * Cd * V.y();
+			}
+
+			// Aerodynamic moments, Q = -RotationDirection * CP / (2 * Pi) * AerodynamicConstant * D
+			const TScalar Q = -RotationDirection * (Constants.CP / (2.0f * Pi)) * AerodynamicConstant * D;
+
+			// Gyroscopic moments, G = RotationDirection * Izz * omega * (SystemOmega x k)
+			const TVector G = (RotationDirection * Izz * omega) * SystemOmega.cross(TVector::UnitZ());
+
+			return TForcesAndMoments<TScalar>(Forces, TVector(TScalar(0), TScalar(0), Q) + G);
+		};
+
+		// Get aerodynamic constants from the resampled data (see FPropellerTable), in any scalar type.
+		//
+		// @param n Propeller speed (RPM)
+		// @param J Advance ratio (unitless)
+		//
+		// @return Aerodynamic Constants
+		template<typename TScalar>
+		TAerodynamicConstantResults<TScalar> GetAerodynamicConstants(TScalar n, TScalar J) const { return Table->Lookup(n, J); };
+
+		// The propeller parameters, without their ConstantSpeedData (which is only kept in the table).
+		const FPropellerParameters& GetParameters() const { return Parameters; };
+		const FPropellerTable& GetTable() const { return *Table; };
+		const std::shared_ptr<const FPropellerTable>& GetSharedTable() const { return Table; };
+		const FPropellerState& GetPropellerState() const { return PropellerState; };
+
+	private:
+		// Update the system parameters
+		void UpdatePropellerState(float Rho, const FVector3& Va);
+
+		// Thrust, T, forces on the propeller (ie. in the (0, 0, Vz)b direction)
+		FVector3 CalculateThrustForces(float CT) const;
+		// Side, H forces on the propeller (ie. in the (Vx, Vy, 0)b plane)
+		FVector3 CalculateSideForces(float T) const;
+		// Calculate the aerodynamic moments on the propeller (ie. via CQ)
+		FVector3 CalculateAerodynamicMoments(float CP) const;
+		// Calculate the gyroscopic moments on the propeller
+		FVector3 CalculateGyroscopicMoments(const FVector3& SystemOmega) const;
+
+		FPropellerParameters Parameters;
+
+		// CT and CP, resampled from the parameters' data onto a uniform grid (never null).
+		std::shared_ptr<const FPropellerTable> Table;
+
+		// State Parameters
+		FPropellerState PropellerState;
+	};
+}
@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <vector>
+
+#include "SkyPhysCore/Actuation/PropellerTable.h"
+
+namespace SkyPhysCore
+{
+	// The performance coefficients of a propeller at one operating point (all based on n in rev/s and the diameter D, as per the UIUC propeller database).
+	struct FPropellerPerformance
+	{
+		float CT = 0.0f; // Thrust coefficient, T / (rho * n^2 * D^4), along the propeller axis (-Z)
+		float CP = 0.0f; // Power coefficient, P / (rho * n^3 * D^5)
+		float CH = 0.0f; // In-plane (hub) force coefficient, H / (rho * n^2 * D^4), against the in-plane airspeed
+	};
+
+	// The performance coefficients of a propeller on a uniformly spaced (n, J, inflow angle) grid, where the inflow angle is that between the
+	// airspeed and the propeller axis (0 for pure axial flight along the thrust, Pi / 2 for edgewise flight, and Pi for axial descent). This covers
+	// the full flight envelope (including oblique inflow), and is filled in once (eg. by a blade element solver, see BladeElementPropeller.h),
+	// so that each lookup is just index arithmetic and a trilinear blend. As per FPropellerTable, each value is clamped to its axis.
+	class SKYPHYSCORE_API FPropellerPerformanceTable
+	{
+	public:
+		using FAxis = FPropellerTable::FAxis;
+
+		FPropellerPerformanceTable();
+
+		// A table of 0s, to be filled in with SetPerformance.
+		//
+		// @param NAxis: The propeller speed (RPM) axis (at least 2 points)
+		// @param JAxis: The advance ratio axis (at least 2 points)
+		// @param AngleAxis: The inflow angle (rad) axis (at least 2 points)
+		FPropellerPerformanceTable(const FAxis& NAxis, const FAxis& JAxis, const FAxis& AngleAxis);
+
+		void SetPerformance(int ni, int ji, int ai, const FPropellerPerformance& Performance);
+		const FPropellerPerformance& GetPerformance(int ni, int ji, int ai) const { return Performance[GetIndex(ni, ji, ai)]; };
+
+		// Get the performance coefficients, interpolated trilinearly between the grid points.
+		//
+		// @param n Propeller speed (RPM)
+		// @param J Advance ratio (unitless)
+		// @param InflowAngle Angle between the airspeed and the propeller axis (rad)
+		//
+		// @return The performance coefficients
+		FPropellerPerformance Lookup(float n, float J, float InflowAngle) const;
+
+		const FAxis& GetNAxis() const { return NAxis; };
+		const FAxis& GetJAxis() const { return JAxis; };
+		const FAxis& GetAngleAxis() const { return AngleAxis; };
+
+	private:
+		FAxis NAxis;
+		FAxis JAxis;
+		FAxis AngleAxis;
+
+		// Contiguous along the inflow angle, then J, for each n
+		std::vector<FPropellerPerformance> Performance;
+
+		int GetIndex(int ni, int ji, int ai) const { return (ni * JAxis.Num + ji) * AngleAxis.Num + ai; };
+	};
+}
@@ -0,0 +1,139 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "SkyPhysCore/Common/MathUtils.h"
+
+namespace SkyPhysCore
+{
+	struct FConstantSpeedPropellerData
+	{
+		// These are our propeller parameters for a specific propeller speed.
+		float n = 0.0f; // RPM
+		std::vector<float> J;
+		std::vector<float> CT;
+		std::vector<float> CP;
+	};
+
+	// Results Structs
+	template<typename TScalar>
+	struct TAerodynamicConstantResults
+	{
+		TScalar CT;
+		TScalar CP;
+
+		TAerodynamicConstantResults(TScalar CT, TScalar CP) : CT(CT), CP(CP) {};
+	};
+
+	using FAerodynamicConstantResults = TAerodynamicConstantResults<float>;
+
+	// CT and CP of a propeller on a uniformly spaced (n, J) grid, resampled once from the measured data (which has its own, irregular, J points
+	// for each propeller speed, as per the UIUC propeller database), so a lookup is just index arithmetic and a bilinear blend.
+	//
+	// The grid spans the data (n and J are clamped to it, as per the data), at the finest spacing of the data along each axis divided by
+	// Oversampling (up to MaxNumSamples points), so data which is already uniformly spaced is reproduced exactly, and the error elsewhere
+	// (where a breakpoint of the data falls between grid points) is halved for each doubling of Oversampling. Each axis has at least 2 points
+	// (a single propeller speed is repeated), and an empty table holds 0s, so the lookup never branches on the shape of the data.
+	//
+	// The grid can also be used in place from memory the table doesn't own (eg. a memory mapped FPropellerDatabase), which it keeps alive.
+	class SKYPHYSCORE_API FPropellerTable
+	{
+	public:
+		// The most points along either axis of the grid
+		static constexpr int MaxNumSamples = 256;
+		// The grid points per finest interval of the data
+		static constexpr int Oversampling = 2;
+
+		// One axis of the grid, with Num points evenly spaced from Min to Max.
+		struct FAxis
+		{
+			float Min = 0.0f;
+			float Max = 0.0f;
+			float InvStep = 0.0f; // 0 if Min == Max
+			int Num = 2;
+
+			FAxis() {};
+			FAxis(float Min, float Max, int Num) : Min(Min), Max(Max), InvStep(Max > Min ? (Num - 1) / (Max - Min) : 0.0f), Num(Num) {};
+
+			// The grid point below a value, and the fraction of the way to the next one.
+			template<typename TScalar>
+			void Locate(TScalar Value, int& Index, TScalar& Frac) const
+			{
+				const TScalar Position = (Clamp(Value, TScalar(Min), TScalar(Max)) - Min) * InvStep;
+				Index = std::min(static_cast<int>(GetValue(Position)), Num - 2);
+				Frac = Position - static_cast<float>(Index);
+			};
+
+			// Whether the derivative of a value carries through Locate (ie. it isn't clamped, as per Clamp).
+			bool IsInside(float Value) const { return Value >= Min && Value < Max; };
+
+			float GetPoint(int Index) const { return Index == Num - 1 ? Max : Min + (Max - Min) * Index / (Num - 1); };
+		};
+
+		FPropellerTable();
+
+		// Resample the measured data onto the grid.
+		//
+		// @param ConstantSpeedData: The data for each propeller speed (sorted by ascending speed, with each J sorted in ascending order)
+		explicit FPropellerTable(const std::vector<FConstantSpeedPropellerData>& ConstantSpeedData);
+
+		// Use a grid which has already been resampled, in place.
+		//
+		// @param NAxis: The propeller speed (RPM) axis (at least 2 points)
+		// @param JAxis: The advance ratio axis (at least 2 points)
+		// @param Coefficients: NAxis.Num * JAxis.Num (CT, CP) pairs, contiguous along J, for each n
+		// @param Owner: Whatever owns the memory of Coefficients, which is kept alive for as long as the table (or any copy of it)
+		FPropellerTable(const FAxis& NAxis, const FAxis& JAxis, const float* Coefficients, std::shared_ptr<const void> Owner);
+
+		// Get aerodynamic constants, interpolated bilinearly between the grid points, in any scalar type (where the interpolation fractions carry
+		// the derivatives of n and J, which are 0 where they are clamped to the grid).
+		//
+		// @param n Propeller speed (RPM)
+		// @param J Advance ratio (unitless)
+		//
+		// @return Aerodynamic Constants
+		template<typename TScalar>
+		TAerodynamicConstantResults<TScalar> Lookup(TScalar n, TScalar J) const
+		{
+			int ni, ji;
+			TScalar nFrac, jFrac;
+			NAxis.Locate(n, ni, nFrac);
+			JAxis.Locate(J, ji, jFrac);
+
+			// The (CT, CP) pairs at (n1, j1) and (n1, j2), and then the same at n2
+			const float* C1 = Coefficients + (ni * JAxis.Num + ji) * 2;
+			const float* C2 = C1 + JAxis.Num * 2;
+
+			// Interpolate along the J axis for n1 and n2, and then along the n axis between them (as per the measured data)
+			const TScalar CT1 = C1[0] + jFrac * (C1[2] - C1[0]);
+			const TScalar CP1 = C1[1] + jFrac * (C1[3] - C1[1]);
+			const TScalar CT2 = C2[0] + jFrac * (C2[2] - C2[0]);
+			const TScalar CP2 = C2[1] + jFrac * (C2[3] - C2[1]);
+
+			return TAerodynamicConstantResults<TScalar>(CT1 + nFrac * (CT2 - CT1), CP1 + nFrac * (CP2 - CP1));
+		};
+
+		// As per Lookup, along with the derivatives of CT and CP with respect to n (per RPM) and J.
+		FAerodynamicConstantResults Lookup(float n, float J, FAerodynamicConstantResults& dn, FAerodynamicConstantResults& dJ) const;
+
+		int GetNumN() const { return NAxis.Num; };
+		int GetNumJ() const { return JAxis.Num; };
+		const FAxis& GetNAxis() const { return NAxis; };
+		const FAxis& GetJAxis() const { return JAxis; };
+
+		// The (CT, CP) pairs of the grid, contiguous along J, for each n (GetNumN() * GetNumJ() * 2 floats).
+		const float* GetCoefficients() const { return Coefficients; };
+
+	private:
+		FAxis NAxis;
+		FAxis JAxis;
+
+		// (CT, CP) pairs, contiguous along J, for each n, and whatever owns them.
+		const float* Coefficients = nullptr;
+		std::shared_ptr<const void> Owner;
+	};
+}
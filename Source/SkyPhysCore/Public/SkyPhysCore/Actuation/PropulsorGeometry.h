@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "SkyPhysCore/Common/CoreTypes.h"
+
+namespace SkyPhysCore
+{
+	// Where a propulsor sits on the airframe, relative to the CoG and in the body frame.
+	// This doesn't change during flight, so is captured once (eg. at BeginPlay) rather than being queried every substep.
+	struct FPropulsorGeometry
+	{
+		FVector3 Position = FVector3::Zero(); // Position of the propulsor origin relative to the CoG, in the body frame (m)
+		FMatrix3 Rotation = FMatrix3::Identity(); // Rotation from the propulsor frame to the body frame
+
+		// Calculate the airspeed of the propulsor in the propulsor frame. The propulsor moves with the airframe, so its velocity is that of
+		// the CoG plus the rotational component (v + omega x r).
+		//
+		// @param Vb: Body velocity in the body frame (m/s)
+		// @param Omegab: Body rotational velocity in the body frame (rad/s)
+		// @param Vwb: Wind velocity in the body frame (m/s)
+		FVector3 CalculateAirspeed(const FVector3& Vb, const FVector3& Omegab, const FVector3& Vwb) const
+		{
+			return Rotation.transpose() * (Vb + Omegab.cross(Position) - Vwb);
+		};
+
+		// Rotate a vector from the body frame into the propulsor frame
+		FVector3 BodyToPropulsor(const FVector3& BodyVector) const { return Rotation.transpose() * BodyVector; };
+
+		// Rotate forces and moments from the propulsor frame into the body frame (still acting at the propulsor origin)
+		FForcesAndMoments PropulsorToBody(const FForcesAndMoments& PropulsorForcesAndMoments) const
+		{
+			return FForcesAndMoments(Rotation * PropulsorForcesAndMoments.Forces, Rotation * PropulsorForcesAndMoments.Moments);
+		};
+
+		// Calculate the moment about the CoG due to a force (in the body frame) acting at the propulsor origin (r x F)
+		FVector3 CalculateMomentAboutCoG(const FVector3& Forcesb) const { return Position.cross(Forcesb); };
+	};
+}
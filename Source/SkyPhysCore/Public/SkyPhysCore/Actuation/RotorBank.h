@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <vector>
+
+#include "SkyPhysCore/Common/CoreTypes.h"
+#include "SkyPhysCore/Actuation/PropellerModel.h"
+#include "SkyPhysCore/Actuation/PropulsorGeometry.h"
+
+namespace SkyPhysCore
+{
+	// Evaluates all the propellers of a vehicle (eg. the 4, 6 or 8 rotors of a multirotor) at once. Each rotor is a lane of structure of arrays
+	// storage, so the inflow, advance ratio, table lookup, forces and moments, and their moments about the CoG are each evaluated across every
+	// rotor in a single vectorised (SIMD) pass, rather than one propeller at a time. Only the table coefficients are gathered per rotor
+	// (as each may use a different table), and the rotors are summed in order, so the result doesn't depend on the SIMD width.
+	//
+	// This follows FPropellerModel::CalculateForcesAndMoments and FPropulsorGeometry exactly, but doesn't update the propeller state.
+	class SKYPHYSCORE_API FRotorBank
+	{
+	public:
+		// The lanes are padded to a multiple of this (the widest SIMD width we target), so every pass is made of whole packets, with no scalar tail.
+		static constexpr int LaneMultiple = 8;
+
+		// Resize the bank. Existing rotors are not preserved.
+		void Resize(int Num);
+
+		int Num() const { return NumRotors; };
+
+		// Set a single rotor of the bank from its propeller (including its current rotational speed) and where it sits on the airframe.
+		// The propeller's table is referenced rather than copied, so must outlive the next evaluation.
+		void SetRotor(int Index, const FPropellerModel& Propeller, const FPropulsorGeometry& Geometry);
+
+		// Calculate the forces and moments of all the rotors in the bank.
+		//
+		// @param Rho: Air density (kg/m^3)
+		// @param Vb: Body velocity in the body frame (m/s)
+		// @param Omegab: Body rotational velocity in the body frame (rad/s)
+		// @param Vwb: Wind velocity in the body frame (m/s)
+		//
+		// @return The forces and moments generated by all the rotors, to be applied at the CoG, expressed in the body frame.
+		FForcesAndMoments CalculateForcesAndMoments(float Rho, const FVector3& Vb, const FVector3& Omegab, const FVector3& Vwb);
+
+		// Get the result of the last evaluation for a single rotor in the bank.
+		//
+		// @return The forces and moments generated by the rotor, to be applied at the CoG, expressed in the body frame.
+		FForcesAndMoments GetForcesAndMoments(int Index) const;
+
+		// Geometry (position relative to the CoG, and the rotation from the propeller frame to the body frame, by row and column)
+		FBatchArray Px, Py, Pz;
+		FBatchArray R00, R01, R02, R10, R11, R12, R20, R21, R22;
+
+		// Propeller parameters (D4 is D^4, which is only recalculated when D changes)
+		FBatchArray RotationDirection, Cd, Izz, D, D4;
+
+		// Propeller table axes (see FPropellerTable::FAxis), with the last cell of each axis (Num - 2)
+		FBatchArray NMin, NMax, NInvStep, NLastCell;
+		FBatchArray JMin, JMax, JInvStep, JLastCell;
+
+		// Propeller rotational speed (rad/s)
+		FBatchArray omega;
+
+		// Outputs (body frame, at the CoG)
+		FBatchArray Fx, Fy, Fz, Mx, My, Mz;
+
+	private:
+		int NumRotors = 0;
+
+		// The table of each rotor
+		std::vector<const FPropellerTable*> Tables;
+
+		// Scratch arrays, kept between evaluations so that stepping the bank doesn't allocate.
+		FBatchArray Wx, Wy, Wz, Vx, Vy, Vz, Omegax, Omegay, HasNaN, VNorm;
+		FBatchArray n, J, AerodynamicConstant, NPosition, JPosition, NCell, JCell, NFrac, JFrac;
+		FBatchArray CT11, CP11, CT12, CP12, CT21, CP21, CT22, CP22, CT, CP;
+		FBatchArray T, H, Gyroscopic, Q;
+	};
+}
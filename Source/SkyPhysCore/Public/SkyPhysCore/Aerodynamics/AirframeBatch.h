@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "SkyPhysCore/Common/CoreTypes.h"
+#include "SkyPhysCore/Aerodynamics/AirframeModel.h"
+
+namespace SkyPhysCore
+{
+	// The airframe coefficients of every vehicle in a batch, stored as one contiguous array per coefficient (structure of arrays).
+	struct FAirframeBatchCoefficients
+	{
+		// Lift
+		FBatchArray CL0, CLAlpha, CLq, CLde;
+		// Drag
+		FBatchArray CD0, CDAlpha, CDAlpha2, CDq, CDBeta, CDBeta2, CDde;
+		// Side Force
+		FBatchArray CY0, CYBeta, CYp, CYr, CYda, CYdr;
+		// Roll Moment
+		FBatchArray CI0, CIBeta, CIp, CIr, CIda, CIdr;
+		// Pitch Moment
+		FBatchArray Cm0, CmAlpha, Cmq, Cmde;
+		// Yaw Moment
+		FBatchArray Cn0, CnBeta, Cnp, Cnr, Cnda, Cndr;
+
+		// Stall Model (StallEnabled is 1 where the stall model is enabled and 0 otherwise)
+		FBatchArray StallEnabled, Alpha0, M, Cmfp;
+
+		// Geometry
+		FBatchArray b, c, Ax, Ay, Az;
+
+		void Resize(int Num);
+		void Set(int Index, const FAirframeModel& Airframe);
+	};
+
+	// Evaluates the linear coefficient model (including the flat plate stall model) of FAirframeModel for many vehicles at once.
+	// All inputs, outputs and coefficients are stored in structure of arrays form, so that each term of the model is evaluated across
+	// the whole batch in a single vectorised (SIMD) pass, rather than one vehicle at a time.
+	class SKYPHYSCORE_API FAirframeBatch
+	{
+	public:
+		// Resize the batch. Existing entries are not preserved.
+		void Resize(int Num);
+
+		int Num() const { return static_cast<int>(alpha.size()); };
+
+		// Set the airframe used by a single vehicle in the batch. This only needs to be done when the airframe changes.
+		void SetAirframe(int Index, const FAirframeModel& Airframe) { Coefficients.Set(Index, Airframe); };
+
+		// Set the inputs of a single vehicle in the batch for the next evaluation.
+		//
+		// @param Index: The vehicle index in the batch
+		// @param AirspeedState: The current airspeed state
+		// @param Omegab: Body rotational velocity in the body frame (rad/s)
+		// @param Rho: Air density (kg/m^3)
+		// @param Deflections: The current control surface deflections (rad)
+		void SetInputs(int Index, const FAirspeedState& AirspeedState, const FVector3& Omegab, float Rho, const FControlSurfaceDeflections& Deflections);
+
+		// Calculate the airframe forces and moments of all vehicles in the batch.
+		void CalculateForcesAndMoments();
+
+		// Get the result of the last evaluation for a single vehicle in the batch.
+		//
+		// @return The forces and moments generated by the airframe, to be applied at the CoG, expressed in the body frame.
+		FForcesAndMoments GetForcesAndMoments(int Index) const;
+
+		FAirframeBatchCoefficients Coefficients;
+
+		// Inputs
+		FBatchArray alpha, beta, Va, p, q, r, Rho, de, da, dr;
+
+		// Outputs (body frame)
+		FBatchArray Fx, Fy, Fz, Mx, My, Mz;
+
+	private:
+		// Scratch arrays, kept between evaluations so that stepping the batch doesn't allocate.
+		FBatchArray DynamicPressure, cOver2Va, bOver2Va, SigmaAlpha, ExpLower, ExpUpper;
+		FBatchArray sa, ca, sb, cb;
+		FBatchArray CDCalc, CYCalc, CLCalc;
+	};
+}
@@ -0,0 +1,340 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cfloat>
+#include <cmath>
+
+#include "SkyPhysCore/Common/CoreTypes.h"
+#include "SkyPhysCore/Common/MathUtils.h"
+#include "SkyPhysCore/Aerodynamics/AirframeModel.h"
+
+namespace SkyPhysCore
+{
+	// ########### Airframe Configuration Policies ########### //
+
+	// Each configuration states which control surface inputs it has, so that the control derivative terms of any missing surfaces are
+	// removed at compile time (rather than multiplying zero derivatives by zero deflections every substep).
+
+	// No control surfaces (eg. a multirotor body)
+	struct FMultiRotorAirframe
+	{
+		static constexpr EAirframeConfiguration Configuration = EAirframeConfiguration::MultiRotor;
+		static constexpr bool bHasElevator = false;
+		static constexpr bool bHasAileron = false;
+		static constexpr bool bHasRudder = false;
+	};
+
+	// Elevons (mixed into de and da), without a rudder
+	struct FFlyingWingAirframe
+	{
+		static constexpr EAirframeConfiguration Configuration = EAirframeConfiguration::FlyingWing;
+		static constexpr bool bHasElevator = true;
+		static constexpr bool bHasAileron = true;
+		static constexpr bool bHasRudder = false;
+	};
+
+	// Ruddervators (mixed into de and dr) and ailerons
+	struct FVTailAirframe
+	{
+		static constexpr EAirframeConfiguration Configuration = EAirframeConfiguration::VTail;
+		static constexpr bool bHasElevator = true;
+		static constexpr bool bHasAileron = true;
+		static constexpr bool bHasRudder = true;
+	};
+
+	// Elevator, ailerons and rudder
+	struct FStandardAirframe
+	{
+		static constexpr EAirframeConfiguration Configuration = EAirframeConfiguration::Standard;
+		static constexpr bool bHasElevator = true;
+		static constexpr bool bHasAileron = true;
+		static constexpr bool bHasRudder = true;
+	};
+
+	// ################ Stall Model Policies ################ //
+
+	// Each is templated on the scalar type, as per the kernel.
+
+	// Linear coefficients only (the "alpha" parts of CL, CD and Cm are left as they are).
+	struct FNoStallModel
+	{
+		template<typename TScalar>
+		static TScalar CalculateSigmaAlpha(const FAerodynamicStallParameters& /*StallParameters*/, TScalar /*alpha*/) { return TScalar(0); };
+
+		template<typename TScalar>
+		static void ApplyForces(const FAerodynamicStallParameters& /*StallParameters*/, TScalar /*SigmaAlpha*/, TScalar /*alpha*/, TScalar /*sa*/, TScalar /*ca*/, TScalar& /*CLALPHA*/, TScalar& /*CDALPHA*/) {};
+		template<typename TScalar>
+		static void ApplyMoments(const FAerodynamicStallParameters& /*StallParameters*/, TScalar /*SigmaAlpha*/, TScalar /*alpha*/, TScalar /*sa*/, TScalar& /*CmALPHA*/) {};
+	};
+
+	// Flat plate stall model, which blends between 0 stall and full stall (which occurs at the stall angle, Alpha0) using a transition rate, M,
+	// and a sigmoid mixing function. The scaling parameter used is SigmaAlpha.
+	struct FFlatPlateStallModel
+	{
+		template<typename TScalar>
+		static TScalar CalculateSigmaAlpha(const FAerodynamicStallParameters& StallParameters, TScalar alpha)
+		{
+			const TScalar M = StallParameters.M;
+			const TScalar Alpha0 = StallParameters.Alpha0;
+
+			const TScalar ExpLower = exp(-M * (alpha - Alpha0));
+			const TScalar ExpUpper = exp(M * (alpha + Alpha0));
+
+			// Clamp our numerator and denominator to be between 1 and FLT_MAX, to ensure that we don't get any strange numerical artifacts.
+			const TScalar Numerator = Clamp(1 + ExpLower + ExpUpper, TScalar(1), TScalar(FLT_MAX));
+			const TScalar Denominator = Clamp((1 + ExpLower) * (1 + ExpUpper), TScalar(1), TScalar(FLT_MAX));
+
+			const TScalar SigmaAlpha = Numerator / Denominator;
+
+			// If we still get a NaN SigmaAlpha, then just conservatively assume we are fully stalling.
+			using std::isnan;
+			return isnan(SigmaAlpha) ? TScalar(1) : SigmaAlpha;
+		};
+
+		template<typename TScalar>
+		static void ApplyForces(const FAerodynamicStallParameters& /*StallParameters*/, TScalar SigmaAlpha, TScalar alpha, TScalar sa, TScalar ca, TScalar& CLALPHA, TScalar& CDALPHA)
+		{
+			CLALPHA = (1 - SigmaAlpha) * CLALPHA + SigmaAlpha * 2 * Sign(alpha) * (sa * sa * ca);
+			CDALPHA = (1 - SigmaAlpha) * CDALPHA + SigmaAlpha * 2 * Sign(alpha) * (sa * sa * sa);
+		};
+
+		template<typename TScalar>
+		static void ApplyMoments(const FAerodynamicStallParameters& StallParameters, TScalar SigmaAlpha, TScalar alpha, TScalar sa, TScalar& CmALPHA)
+		{
+			CmALPHA = (1 - SigmaAlpha) * CmALPHA + SigmaAlpha * (StallParameters.Cmfp * Sign(alpha) * sa * sa);
+		};
+	};
+
+	// ##################### Kernel ##################### //
+
+	// The airframe aerodynamics (coefficient build-up, stall blending and wind to body rotation), specialised on the airframe configuration
+	// and stall model. Everything is inline, so each instantiation compiles down to a single straight-line function with the unused terms
+	// folded away. FAirframeModel::CalculateForcesAndMoments selects the instantiation from its Configuration and stall settings, but a
+	// caller which knows its airframe at compile time can use this directly.
+	// The state and result are in TScalar (float for the simulation, double for the reference path, or FDual for sensitivities). The coefficients
+	// are those of the model type, TModel, which is either the FAirframeModel itself (float coefficients) or a TAirframeParameters.
+	template<typename TConfiguration, typename TStallModel, typename TScalar = float>
+	struct TAirframeKernel
+	{
+		using FVector3 = TVector3<TScalar>;
+
+		// @param Model: The airframe model or parameters (coefficients, control derivatives, stall parameters and geometry)
+		// @param AirspeedState: The current airspeed state
+		// @param Omegab: Body rotational velocity in the body frame (rad/s)
+		// @param Rho: Air density (kg/m^3)
+		// @param Deflections: The current control surface deflections (rad)
+		//
+		// @return The forces and moments generated by the airframe, to be applied at the CoG, expressed in the body frame.
+		template<typename TModel = FAirframeModel>
+		static TForcesAndMoments<TScalar> CalculateForcesAndMoments(const TModel& Model, const TAirspeedState<TScalar>& AirspeedState, const FVector3& Omegab, TScalar Rho, const TControlSurfaceDeflections<TScalar>& Deflections)
+		{
+			// ********************* Set Up Constant Parameters ********************** //
+
+			const auto& C = Model.Coefficients;
+			const auto& Ctrl = Model.ControlDerivatives;
+			const FGeometricCharacteristics& Geometry = Model.Geometry;
+
+			// Only read the deflections of the surfaces this configuration actually has.
+			const TScalar de = TConfiguration::bHasElevator ? Deflections.de : TScalar(0);
+			const TScalar da = TConfiguration::bHasAileron ? Deflections.da : TScalar(0);
+			const TScalar dr = TConfiguration::bHasRudder ? Deflections.dr : TScalar(0);
+
+			// *********************************************************************** //
+
+			// ******************* Aerodynamic Calculation Parameters ****************** //
+
+			// Velocity
+			const TScalar p = Omegab.x();
+			const TScalar q = Omegab.y();
+			const TScalar r = Omegab.z();
+
+			// Airspeed Params
+			const TScalar Va = AirspeedState.Va;
+			const TScalar alpha = AirspeedState.alpha;
+			const TScalar beta = AirspeedState.beta;
+
+			TAerodynamicCalculationParameters<TScalar> Parameters;
+
+			// If Va isn't 0, we update the below params to their actual values
+			if (!IsNearlyZero(Va))
+			{
+				Parameters.bOver2Va = Geometry.b / (2 * Va);
+				Parameters.cOver2Va = Geometry.c / (2 * Va);
+			}
+
+			Parameters.DynamicPressure = TScalar(0.5) * Rho * Va * Va;
+			Parameters.SigmaAlpha = TStallModel::CalculateSigmaAlpha(Model.StallParameters, alpha);
+
+			const FVector3 AerodynamicMultiple = Parameters.DynamicPressure * Geometry.A.template cast<TScalar>();
+			const TScalar bOver2Va = Parameters.bOver2Va;
+			const TScalar cOver2Va = Parameters.cOver2Va;
+
+			const TScalar sa = sin(alpha);
+			const TScalar ca = cos(alpha);
+			const TScalar sb = sin(beta);
+			const TScalar cb = cos(beta);
+
+			// *********************************************************************** //
+
+			// ******************************** Forces ******************************* //
+
+			// We isolate our "alpha" parts of our coefficients as these will be impacted by our stall model (if enabled).
+			TScalar CDALPHA = C.CD.CD0 + C.CD.CDAlpha * alpha + C.CD.CDAlpha2 * alpha * alpha;
+			TScalar CLALPHA = C.CL.CL0 + C.CL.CLAlpha * alpha;
+			TStallModel::ApplyForces(Model.StallParameters, Parameters.SigmaAlpha, alpha, sa, ca, CLALPHA, CDALPHA);
+
+			// Now add the rest of the coefficient impacts
+			TScalar CDCalc = CDALPHA + C.CD.CDq * cOver2Va * q + C.CD.CDBeta * beta + C.CD.CDBeta2 * beta * beta;
+			TScalar CLCalc = CLALPHA + C.CL.CLq * cOver2Va * q;
+			TScalar CYCalc = C.CY.CY0 + C.CY.CYBeta * beta + C.CY.CYp * bOver2Va * p + C.CY.CYr * bOver2Va * r;
+
+			if (TConfiguration::bHasElevator)
+			{
+				CDCalc += Ctrl.CDde * de;
+				CLCalc += Ctrl.CLde * de;
+			}
+			if (TConfiguration::bHasAileron)
+			{
+				CYCalc += Ctrl.CYda * da;
+			}
+			if (TConfiguration::bHasRudder)
+			{
+				CYCalc += Ctrl.CYdr * dr;
+			}
+
+			// We know that CD and CL will be in the negative direction in the wind frame.
+			// We need to rotate our aerodynamic forces, which are in the wind frame, to the body frame. We do this with a rotation by alpha (pitch) and beta (yaw),
+			// using the same convention as FRotator(alpha, beta, 0).RotateVector().
+			const FVector3 Fw(-CDCalc, CYCalc, -CLCalc);
+			const FVector3 Fxyz(
+				Fw.x() * ca * cb - Fw.y() * sb - Fw.z() * sa * cb,
+				Fw.x() * ca * sb + Fw.y() * cb - Fw.z() * sa * sb,
+				Fw.x() * sa + Fw.z() * ca
+			);
+
+			// ******************************* Moments ******************************* //
+
+			TScalar CmALPHA = C.Cm.Cm0 + C.Cm.CmAlpha * alpha;
+			TStallModel::ApplyMoments(Model.StallParameters, Parameters.SigmaAlpha, alpha, sa, CmALPHA);
+
+			TScalar CICalc = C.CI.CI0 + C.CI.CIBeta * beta + C.CI.CIp * bOver2Va * p + C.CI.CIr * bOver2Va * r;
+			TScalar CmCalc = CmALPHA + C.Cm.Cmq * cOver2Va * q;
+			TScalar CnCalc = C.Cn.Cn0 + C.Cn.CnBeta * beta + C.Cn.Cnp * bOver2Va * p + C.Cn.Cnr * bOver2Va * r;
+
+			if (TConfiguration::bHasElevator)
+			{
+				CmCalc += Ctrl.Cmde * de;
+			}
+			if (TConfiguration::bHasAileron)
+			{
+				CICalc += Ctrl.CIda * da;
+				CnCalc += Ctrl.Cnda * da;
+			}
+			if (TConfiguration::bHasRudder)
+			{
+				CICalc += Ctrl.CIdr * dr;
+				CnCalc += Ctrl.Cndr * dr;
+			}
+
+			const FVector3 Mxyz(CICalc * Geometry.b, CmCalc * Geometry.c, CnCalc * Geometry.b);
+
+			// *********************************************************************** //
+
+			return TForcesAndMoments<TScalar>(Fxyz.cwiseProduct(AerodynamicMultiple), Mxyz.cwiseProduct(AerodynamicMultiple));
+		};
+	};
+
+	// Signature shared by every kernel instantiation of a scalar (and model) type
+	template<typename TScalar, typename TModel = FAirframeModel>
+	using TAirframeKernelFunction = TForcesAndMoments<TScalar>(*)(const TModel&, const TAirspeedState<TScalar>&, const TVector3<TScalar>&, TScalar, const TControlSurfaceDeflections<TScalar>&);
+
+	using FAirframeKernelFunction = TAirframeKernelFunction<float>;
+
+	// Select the kernel instantiation for a runtime airframe configuration and stall model setting.
+	// This is instantiated (in AirframeModel.cpp) for float and double, with the model itself.
+	template<typename TScalar, typename TModel = FAirframeModel>
+	TAirframeKernelFunction<TScalar, TModel> SelectAirframeKernel(EAirframeConfiguration Configuration, bool bEnableStallModel)
+	{
+		switch (Configuration)
+		{
+		case EAirframeConfiguration::MultiRotor:
+			return bEnableStallModel ? &TAirframeKernel<FMultiRotorAirframe, FFlatPlateStallModel, TScalar>::template CalculateForcesAndMoments<TModel> : &TAirframeKernel<FMultiRotorAirframe, FNoStallModel, TScalar>::template CalculateForcesAndMoments<TModel>;
+		case EAirframeConfiguration::FlyingWing:
+			return bEnableStallModel ? &TAirframeKernel<FFlyingWingAirframe, FFlatPlateStallModel, TScalar>::template CalculateForcesAndMoments<TModel> : &TAirframeKernel<FFlyingWingAirframe, FNoStallModel, TScalar>::template CalculateForcesAndMoments<TModel>;
+		case EAirframeConfiguration::VTail:
+			return bEnableStallModel ? &TAirframeKernel<FVTailAirframe, FFlatPlateStallModel, TScalar>::template CalculateForcesAndMoments<TModel> : &TAirframeKernel<FVTailAirframe, FNoStallModel, TScalar>::template CalculateForcesAndMoments<TModel>;
+		case EAirframeConfiguration::Standard:
+		default:
+			return bEnableStallModel ? &TAirframeKernel<FStandardAirframe, FFlatPlateStallModel, TScalar>::template CalculateForcesAndMoments<TModel> : &TAirframeKernel<FStandardAirframe, FNoStallModel, TScalar>::template CalculateForcesAndMoments<TModel>;
+		}
+	}
+
+	extern template SKYPHYSCORE_API TAirframeKernelFunction<float> SelectAirframeKernel<float>(EAirframeConfiguration, bool);
+	extern template SKYPHYSCORE_API TAirframeKernelFunction<double> SelectAirframeKernel<double>(EAirframeConfiguration, bool);
+
+	// The control surfaces of a runtime airframe configuration, as per its configuration policy above.
+	// Paths that don't go through the kernel (eg. FAirframeBatch, and the analytic Jacobian) use this to drop the same terms.
+	struct FAirframeControlSurfaces
+	{
+		bool bHasElevator = false;
+		bool bHasAileron = false;
+		bool bHasRudder = false;
+	};
+
+	template<typename TConfiguration>
+	constexpr FAirframeControlSurfaces GetAirframeControlSurfaces()
+	{
+		return { TConfiguration::bHasElevator, TConfiguration::bHasAileron, TConfiguration::bHasRudder };
+	}
+
+	inline FAirframeControlSurfaces GetAirframeControlSurfaces(EAirframeConfiguration Configuration)
+	{
+		switch (Configuration)
+		{
+		case EAirframeConfiguration::MultiRotor:
+			return GetAirframeControlSurfaces<FMultiRotorAirframe>();
+		case EAirframeConfiguration::FlyingWing:
+			return GetAirframeControlSurfaces<FFlyingWingAirframe>();
+		case EAirframeConfiguration::VTail:
+			return GetAirframeControlSurfaces<FVTailAirframe>();
+		case EAirframeConfiguration::Standard:
+		default:
+			return GetAirframeControlSurfaces<FStandardAirframe>();
+		}
+	}
+
+	// Calculate the airspeed params from the body velocity and the wind velocity (both in the body frame), in any scalar type.
+	// See CalculateAirspeedState.
+	template<typename TScalar>
+	TAirspeedState<TScalar> CalculateAirspeedStateT(const TVector3<TScalar>& Vb, const TVector3<TScalar>& Vwb)
+	{
+		using std::isnan;
+
+		// Now calculate the airspeed in the body frame
+		TVector3<TScalar> Vab = Vb - Vwb;
+
+		// Just make sure our airspeed vector makes sense.
+		Vab = RemoveNumericalErrors(Vab);
+
+		// Now calculate our airspeed params
+		TScalar Va = Vab.norm();
+		// Assume alpha and beta are 0 if Va is close to 0 (as they are then technically undefined).
+		TScalar alpha = TScalar(0);
+		TScalar beta = TScalar(0);
+		if (!IsNearlyZero(Va) && !isnan(Va))
+		{
+			// If Va is not nearly zero, then we can get an alpha and beta.
+			alpha = atan2(Vab.z(), Vab.x());
+			beta = asin(Vab.y() / Va);
+		}
+
+		TAirspeedState<TScalar> AirspeedState;
+		AirspeedState.Vwb = Vwb;
+		AirspeedState.Vab = Vab;
+		AirspeedState.Va = Va;
+		AirspeedState.alpha = alpha;
+		AirspeedState.beta = beta;
+		return AirspeedState;
+	}
+}
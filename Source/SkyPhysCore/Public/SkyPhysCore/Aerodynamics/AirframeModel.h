@@ -0,0 +1,245 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cstdint>
+
+#include "SkyPhysCore/Common/CoreTypes.h"
+
+namespace SkyPhysCore
+{
+	// ################# Aerodynamics ################# //
+
+	// The airframe layout, which determines which control surface inputs (and so control derivatives) are present.
+	enum class EAirframeConfiguration : uint8_t
+	{
+		MultiRotor,		// No control surfaces
+		FlyingWing,		// Elevons (de, da)
+		VTail,			// Ruddervators and ailerons (de, da, dr)
+		Standard		// Elevator, ailerons and rudder (de, da, dr)
+	};
+
+	// These mirror the editor structs in the SkyPhys module, which are converted into these at BeginPlay.
+	// The coefficients are templated on the scalar type, so that they can also be differentiated with respect to (see TAirframeParameters).
+
+	// Force Coefficients
+
+	// Lift Force Aerodynamic Coefficients
+	template<typename TScalar>
+	struct TCL
+	{
+		TScalar CL0 = TScalar(0);
+		TScalar CLAlpha = TScalar(0);
+		TScalar CLq = TScalar(0);
+	};
+
+	// Drag Force Aerodynamic Coefficients
+	template<typename TScalar>
+	struct TCD
+	{
+		TScalar CD0 = TScalar(0);
+		TScalar CDAlpha = TScalar(0);
+		TScalar CDAlpha2 = TScalar(0);
+		TScalar CDq = TScalar(0);
+		TScalar CDBeta = TScalar(0);
+		TScalar CDBeta2 = TScalar(0);
+	};
+
+	// Side Force Aerodynamic Coefficients
+	template<typename TScalar>
+	struct TCY
+	{
+		TScalar CY0 = TScalar(0);
+		TScalar CYBeta = TScalar(0);
+		TScalar CYp = TScalar(0);
+		TScalar CYr = TScalar(0);
+	};
+
+	// Moment Coefficients
+
+	// Roll Moment Coefficients (Actually Cl, but use "CI" for unique name purposes)
+	template<typename TScalar>
+	struct TCI
+	{
+		TScalar CI0 = TScalar(0);
+		TScalar CIBeta = TScalar(0);
+		TScalar CIp = TScalar(0);
+		TScalar CIr = TScalar(0);
+	};
+
+	// Pitch Moment Coefficients
+	template<typename TScalar>
+	struct TCm
+	{
+		TScalar Cm0 = TScalar(0);
+		TScalar CmAlpha = TScalar(0);
+		TScalar Cmq = TScalar(0);
+	};
+
+	// Yaw Moment Coefficients
+	template<typename TScalar>
+	struct TCn
+	{
+		TScalar Cn0 = TScalar(0);
+		TScalar CnBeta = TScalar(0);
+		TScalar Cnp = TScalar(0);
+		TScalar Cnr = TScalar(0);
+	};
+
+	// Aerodynamic Coefficients
+	template<typename TScalar>
+	struct TAerodynamicCoefficients
+	{
+		TCL<TScalar> CL;
+		TCD<TScalar> CD;
+		TCY<TScalar> CY;
+		TCI<TScalar> CI;
+		TCm<TScalar> Cm;
+		TCn<TScalar> Cn;
+	};
+
+	// Aerodynamic Control Derivatives (zero for airframes without control surfaces)
+	template<typename TScalar>
+	struct TAerodynamicControlDerivatives
+	{
+		TScalar CLde = TScalar(0);
+		TScalar CDde = TScalar(0);
+		TScalar CYda = TScalar(0);
+		TScalar CYdr = TScalar(0);
+		TScalar CIda = TScalar(0);
+		TScalar CIdr = TScalar(0);
+		TScalar Cmde = TScalar(0);
+		TScalar Cnda = TScalar(0);
+		TScalar Cndr = TScalar(0);
+	};
+
+	using FCL = TCL<float>;
+	using FCD = TCD<float>;
+	using FCY = TCY<float>;
+	using FCI = TCI<float>;
+	using FCm = TCm<float>;
+	using FCn = TCn<float>;
+	using FAerodynamicCoefficients = TAerodynamicCoefficients<float>;
+	using FAerodynamicControlDerivatives = TAerodynamicControlDerivatives<float>;
+
+	// Stall Model
+	struct FAerodynamicStallParameters
+	{
+		bool bEnableStallModel = false;
+		float Alpha0 = 0.0f; // Stall angle, Alpha 0 (rad)
+		float M = 0.0f; // Transition Rate, M
+		float Cmfp = 0.0f; // Pitching Moment Flat Plate Coefficient, Cmfp
+	};
+
+	struct FGeometricCharacteristics
+	{
+		float b = 0; // Wing Span, b (m)
+		float c = 0; // Mean Aerodynamic Chord, c (m)
+		FVector3 A = FVector3::Zero(); // Reference Areas (m^2). Wing Area, S, for a fixed wing.
+	};
+
+	// ################################################ //
+
+	// State Structs (templated on the scalar type, as per CoreTypes.h)
+
+	template<typename TScalar>
+	struct TAirspeedState
+	{
+		TVector3<TScalar> Vwb = TVector3<TScalar>::Zero(); // Wind speed (m/s) in the body frame
+		TVector3<TScalar> Vab = TVector3<TScalar>::Zero(); // Airspeed (m/s) in the body frame (ie. Vb - Vwb)
+
+		TScalar Va = TScalar(0); // Airspeed (m/s)
+		TScalar alpha = TScalar(0); // Angle of attack (rad)
+		TScalar beta = TScalar(0); // Sideslip angle (rad)
+	};
+
+	// The control surface deflections (rad)
+	template<typename TScalar>
+	struct TControlSurfaceDeflections
+	{
+		TScalar de = TScalar(0); // Elevator angle (rad)
+		TScalar da = TScalar(0); // Aileron angle (rad)
+		TScalar dr = TScalar(0); // Rudder angle (rad)
+	};
+
+	using FAirspeedState = TAirspeedState<float>;
+	using FControlSurfaceDeflections = TControlSurfaceDeflections<float>;
+
+	using FAirspeedStated = TAirspeedState<double>;
+	using FControlSurfaceDeflectionsd = TControlSurfaceDeflections<double>;
+
+	// Partial derivatives of the airframe forces and moments (rows: Fx, Fy, Fz, l, m, n, in the body frame) with respect to the airspeed
+	// in the body frame (u, v, w), the body rotational velocity (p, q, r) and the control surface deflections (de, da, dr), in that column order.
+	using FAirframeJacobian = Eigen::Matrix<float, 6, 9>;
+
+	// Calculation Structs
+
+	template<typename TScalar>
+	struct TAerodynamicCalculationParameters
+	{
+		TScalar DynamicPressure = TScalar(0); // Current dynamic pressure of the aircraft (0.5 * rho * Va^2)
+		TScalar cOver2Va = TScalar(0);
+		TScalar bOver2Va = TScalar(0);
+		TScalar SigmaAlpha = TScalar(0); // Stall blending parameter (0 when the stall model is disabled)
+	};
+
+	using FAerodynamicCalculationParameters = TAerodynamicCalculationParameters<float>;
+
+	// Calculate the airspeed params from the body velocity and the wind velocity (both in the body frame).
+	// This is CalculateAirspeedStateT (see AirframeKernel.h) for each precision.
+	//
+	// @param Vb: Body velocity in the body frame (m/s)
+	// @param Vwb: Wind velocity in the body frame (m/s)
+	SKYPHYSCORE_API FAirspeedState CalculateAirspeedState(const FVector3& Vb, const FVector3& Vwb);
+	SKYPHYSCORE_API FAirspeedStated CalculateAirspeedState(const FVector3d& Vb, const FVector3d& Vwb);
+
+	// Engine-independent airframe aerodynamics, using standard aerodynamic and control coefficients with an optional flat plate stall model.
+	// The calculation itself is done by the TAirframeKernel instantiation (see AirframeKernel.h) for this Configuration and stall model.
+	class SKYPHYSCORE_API FAirframeModel
+	{
+	public:
+		// Calculate the Airframe Forces and Moments (excludes all propulsion elements)
+		// 
+		// @param AirspeedState: The current airspeed state
+		// @param Omegab: Body rotational velocity in the body frame (rad/s)
+		// @param Rho: Air density (kg/m^3)
+		// @param Deflections: The current control surface deflections (rad)
+		//
+		// @return The forces and moments generated by the airframe, to be applied at the CoG, expressed in the body frame.
+		FForcesAndMoments CalculateForcesAndMoments(const FAirspeedState& AirspeedState, const FVector3& Omegab, float Rho, const FControlSurfaceDeflections& Deflections) const;
+
+		// As above, in double precision throughout (the reference path). The coefficients themselves are only held in float.
+		FForcesAndMomentsd CalculateForcesAndMoments(const FAirspeedStated& AirspeedState, const FVector3d& Omegab, double Rho, const FControlSurfaceDeflectionsd& Deflections) const;
+
+		// Calculate the partial derivatives of CalculateForcesAndMoments analytically (including the stall model), for linearisation and trim.
+		// The airspeed parameters (Va, alpha, beta) are differentiated through to the airspeed in the body frame. At zero airspeed these
+		// are undefined, so only the control derivatives (which are then also zero) are returned.
+		// 
+		// @param AirspeedState: The current airspeed state
+		// @param Omegab: Body rotational velocity in the body frame (rad/s)
+		// @param Rho: Air density (kg/m^3)
+		// @param Deflections: The current control surface deflections (rad)
+		//
+		// @return The partial derivatives, as per FAirframeJacobian
+		FAirframeJacobian CalculateJacobian(const FAirspeedState& AirspeedState, const FVector3& Omegab, float Rho, const FControlSurfaceDeflections& Deflections) const;
+
+		EAirframeConfiguration Configuration = EAirframeConfiguration::Standard;
+
+		FAerodynamicCoefficients Coefficients;
+		FAerodynamicControlDerivatives ControlDerivatives;
+		FAerodynamicStallParameters StallParameters;
+		FGeometricCharacteristics Geometry;
+	};
+
+	// The coefficients and control derivatives of an airframe model in another scalar type (eg. FDual, so that the forces and moments can be
+	// differentiated with respect to them), which can be passed to the airframe kernel in place of the model itself (see SelectAirframeKernel).
+	// The stall parameters and geometry stay as they are.
+	template<typename TScalar>
+	struct TAirframeParameters
+	{
+		TAerodynamicCoefficients<TScalar> Coefficients;
+		TAerodynamicControlDerivatives<TScalar> ControlDerivatives;
+		FAerodynamicStallParameters StallParameters;
+		FGeometricCharacteristics Geometry;
+	};
+}
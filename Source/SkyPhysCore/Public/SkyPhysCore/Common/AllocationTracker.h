@@ -0,0 +1,126 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace SkyPhysCore
+{
+	// Heap allocations made through operator new (by any thread), since the process started.
+	struct FAllocationCounts
+	{
+		uint64_t NumAllocations = 0;
+		uint64_t NumBytes = 0;
+
+		FAllocationCounts operator-(const FAllocationCounts& Other) const
+		{
+			FAllocationCounts Result;
+			Result.NumAllocations = NumAllocations - Other.NumAllocations;
+			Result.NumBytes = NumBytes - Other.NumBytes;
+			return Result;
+		};
+	};
+
+	// Counts the heap allocations of the whole process (including task pool workers), for checking the no allocation contract of the
+	// step functions (FVehicle::Step / StepAdaptive, FFleet::Step and AFlyingPawn::SubstepTick), which only allocate while a vehicle is
+	// being built or its first steps are taken.
+	//
+	// Nothing is counted unless the executable replaces the global operator new and delete with SKYPHYSCORE_TRACK_ALLOCATIONS()
+	// (placed once, at global scope, in a single translation unit), so this is for headless tools only. Unreal has its own allocator.
+	// Only operator new is hooked: Eigen's dynamically sized arrays and matrices (eg. of FRotorBank and FAirframeBatch) allocate with
+	// malloc, so are checked by building with EIGEN_RUNTIME_NO_MALLOC instead (see Tools/AllocationReport).
+	class SKYPHYSCORE_API FAllocationTracker
+	{
+	public:
+		// Record an allocation of Size bytes (called by the replaced operator new, on any thread).
+		static void RecordAllocation(size_t Size);
+
+		// Get the allocations made so far. Subtract two of these to get the allocations in between.
+		static FAllocationCounts GetCounts();
+
+		// Whether the allocations are actually being recorded (ie. SKYPHYSCORE_TRACK_ALLOCATIONS() is in this executable).
+		static bool IsTracking();
+	};
+
+	namespace AllocationTrackerDetail
+	{
+		// Aligned allocations, by over-allocating and storing the pointer to free just before the aligned block.
+		inline void* AllocateAligned(size_t Size, size_t Alignment)
+		{
+			void* Raw = std::malloc(Size + Alignment + sizeof(void*));
+			if (Raw == nullptr)
+			{
+				return nullptr;
+			}
+
+			const uintptr_t Aligned = (reinterpret_cast<uintptr_t>(Raw) + sizeof(void*) + Alignment - 1) & ~(static_cast<uintptr_t>(Alignment) - 1);
+			reinterpret_cast<void**>(Aligned)[-1] = Raw;
+			return reinterpret_cast<void*>(Aligned);
+		}
+
+		inline void FreeAligned(void* Ptr)
+		{
+			if (Ptr != nullptr)
+			{
+				std::free(reinterpret_cast<void**>(Ptr)[-1]);
+			}
+		}
+
+		// The core is built without exceptions (as in Unreal), so running out of memory aborts instead of throwing std::bad_alloc.
+		inline void* Allocate(size_t Size)
+		{
+			FAllocationTracker::RecordAllocation(Size);
+			void* Ptr = std::malloc(Size > 0 ? Size : 1);
+			if (Ptr == nullptr)
+			{
+				std::abort();
+			}
+			return Ptr;
+		}
+
+#if defined(__cpp_aligned_new)
+		inline void* Allocate(size_t Size, std::align_val_t Alignment)
+		{
+			FAllocationTracker::RecordAllocation(Size);
+			void* Ptr = AllocateAligned(Size > 0 ? Size : 1, static_cast<size_t>(Alignment));
+			if (Ptr == nullptr)
+			{
+				std::abort();
+			}
+			return Ptr;
+		}
+#endif
+
+		// Set by SKYPHYSCORE_TRACK_ALLOCATIONS()
+		extern SKYPHYSCORE_API bool bTracking;
+	}
+}
+
+// The aligned forms of operator new and delete (C++17), which are only replaced where the language has them.
+#if defined(__cpp_aligned_new)
+	#define SKYPHYSCORE_TRACK_ALIGNED_ALLOCATIONS() \
+		void* operator new(size_t Size, std::align_val_t Alignment) { return SkyPhysCore::AllocationTrackerDetail::Allocate(Size, Alignment); } \
+		void* operator new[](size_t Size, std::align_val_t Alignment) { return SkyPhysCore::AllocationTrackerDetail::Allocate(Size, Alignment); } \
+		void operator delete(void* Ptr, std::align_val_t) noexcept { SkyPhysCore::AllocationTrackerDetail::FreeAligned(Ptr); } \
+		void operator delete[](void* Ptr, std::align_val_t) noexcept { SkyPhysCore::AllocationTrackerDetail::FreeAligned(Ptr); } \
+		void operator delete(void* Ptr, size_t, std::align_val_t) noexcept { SkyPhysCore::AllocationTrackerDetail::FreeAligned(Ptr); } \
+		void operator delete[](void* Ptr, size_t, std::align_val_t) noexcept { SkyPhysCore::AllocationTrackerDetail::FreeAligned(Ptr); }
+#else
+	#define SKYPHYSCORE_TRACK_ALIGNED_ALLOCATIONS()
+#endif
+
+// Replace the global operator new and delete with ones which count every allocation (see FAllocationTracker).
+#define SKYPHYSCORE_TRACK_ALLOCATIONS() \
+	namespace { struct FEnableAllocationTracking { FEnableAllocationTracking() { SkyPhysCore::AllocationTrackerDetail::bTracking = true; } } GEnableAllocationTracking; } \
+	void* operator new(size_t Size) { return SkyPhysCore::AllocationTrackerDetail::Allocate(Size); } \
+	void* operator new[](size_t Size) { return SkyPhysCore::AllocationTrackerDetail::Allocate(Size); } \
+	void* operator new(size_t Size, const std::nothrow_t&) noexcept { return SkyPhysCore::AllocationTrackerDetail::Allocate(Size); } \
+	void* operator new[](size_t Size, const std::nothrow_t&) noexcept { return SkyPhysCore::AllocationTrackerDetail::Allocate(Size); } \
+	void operator delete(void* Ptr) noexcept { std::free(Ptr); } \
+	void operator delete[](void* Ptr) noexcept { std::free(Ptr); } \
+	void operator delete(void* Ptr, size_t) noexcept { std::free(Ptr); } \
+	void operator delete[](void* Ptr, size_t) noexcept { std::free(Ptr); } \
+	SKYPHYSCORE_TRACK_ALIGNED_ALLOCATIONS()
@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Eigen/Eigen"
+
+// Everything in SkyPhysCore is engine-independent (ie. no UE4 types), so that the flight dynamics can be stepped and tested without a UE4 world.
+// The SkyPhys module converts between these types and the UE4 equivalents at its boundary.
+//
+// The models which carry the vehicle state (the rigid body and the airframe aerodynamics) are templated on their scalar type, so that the same
+// code runs as the float fast path (the F* names below, used by the simulation itself) or as a double reference path (the F*d names, used
+// to validate the float path and measure its error). Each path works in its own precision throughout, with no conversions per call.
+namespace SkyPhysCore
+{
+	template<typename TScalar> using TVector3 = Eigen::Matrix<TScalar, 3, 1>;
+	template<typename TScalar> using TMatrix3 = Eigen::Matrix<TScalar, 3, 3>;
+	template<typename TScalar> using TQuaternion = Eigen::Quaternion<TScalar>;
+
+	using FVector3 = TVector3<float>;
+	using FMatrix3 = TMatrix3<float>;
+	using FQuaternion = TQuaternion<float>;
+
+	using FVector3d = TVector3<double>;
+	using FMatrix3d = TMatrix3<double>;
+	using FQuaterniond = TQuaternion<double>;
+
+	// One value per member of a batch (eg. per vehicle, or per rotor), stored contiguously so that the batch is evaluated in vectorised (SIMD) passes.
+	using FBatchArray = Eigen::ArrayXf;
+
+	template<typename TScalar>
+	struct TForcesAndMoments
+	{
+		TVector3<TScalar>	Forces = TVector3<TScalar>::Zero(); // (Fx, Fy, Fz)
+		TVector3<TScalar>	Moments = TVector3<TScalar>::Zero(); // (l, m, n)
+
+		TForcesAndMoments() {}
+		TForcesAndMoments(const TVector3<TScalar>& Forces, const TVector3<TScalar>& Moments) : Forces(Forces), Moments(Moments) {}
+
+		inline TForcesAndMoments operator+(const TForcesAndMoments& Sum) const
+		{
+			return TForcesAndMoments(Forces + Sum.Forces, Moments + Sum.Moments);
+		};
+
+		inline TForcesAndMoments& operator+=(const TForcesAndMoments& Sum)
+		{
+			Forces += Sum.Forces;
+			Moments += Sum.Moments;
+			return *this;
+		};
+
+		// Convert to another precision (eg. to compare the float and double paths)
+		template<typename TOther>
+		TForcesAndMoments<TOther> Cast() const
+		{
+			return TForcesAndMoments<TOther>(Forces.template cast<TOther>(), Moments.template cast<TOther>());
+		};
+	};
+
+	using FForcesAndMoments = TForcesAndMoments<float>;
+	using FForcesAndMomentsd = TForcesAndMoments<double>;
+}
@@ -0,0 +1,259 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include "Eigen/Eigen"
+
+namespace SkyPhysCore
+{
+	// The dual number and its math functions are in their own namespace, so that the functions are only found (by argument dependent lookup) for
+	// dual numbers, rather than hiding the standard ones from everything else in SkyPhysCore.
+	namespace Dual
+	{
+		// A dual number for forward-mode automatic differentiation: a value and its derivatives with respect to NumDerivatives directions,
+		// which are carried through every operation by the chain rule. The scalar templated models (see CoreTypes.h) can be run in this type
+		// to get their exact derivatives in a single evaluation, rather than by finite differences (see Sensitivity.h).
+		//
+		// Comparisons (and so every branch in the models) only look at the value. Where a derivative is undefined (eg. sqrt or fabs at 0), it is
+		// taken as 0, as per the analytic Jacobians.
+		template<typename TValue, int NumDerivatives>
+		struct TDual
+		{
+			using FDerivatives = Eigen::Matrix<TValue, NumDerivatives, 1>;
+
+			static constexpr int NumDirections = NumDerivatives;
+
+			TValue Value;
+			FDerivatives Derivatives;
+
+			TDual() : Value(TValue(0)), Derivatives(FDerivatives::Zero()) {}
+
+			// A constant (ie. all derivatives 0), from any arithmetic type
+			template<typename TArithmetic, typename = typename std::enable_if<std::is_arithmetic<TArithmetic>::value>::type>
+			TDual(TArithmetic Value) : Value(static_cast<TValue>(Value)), Derivatives(FDerivatives::Zero()) {}
+
+			TDual(TValue Value, const FDerivatives& Derivatives) : Value(Value), Derivatives(Derivatives) {}
+
+			// A variable, which is the Direction-th direction being differentiated with respect to (ie. its derivative is 1 in that direction only)
+			static TDual Variable(TValue Value, int Direction)
+			{
+				TDual Dual(Value);
+				Dual.Derivatives(Direction) = TValue(1);
+				return Dual;
+			};
+
+			// Explicit conversion back to an arithmetic type (dropping the derivatives), as used by Eigen's cast<>()
+			template<typename TArithmetic, typename = typename std::enable_if<std::is_arithmetic<TArithmetic>::value>::type>
+			explicit operator TArithmetic() const { return static_cast<TArithmetic>(Value); }
+
+			TDual& operator+=(const TDual& Other) { Value += Other.Value; Derivatives += Other.Derivatives; return *this; };
+			TDual& operator-=(const TDual& Other) { Value -= Other.Value; Derivatives -= Other.Derivatives; return *this; };
+			TDual& operator*=(const TDual& Other) { *this = *this * Other; return *this; };
+			TDual& operator/=(const TDual& Other) { *this = *this / Other; return *this; };
+
+			TDual operator-() const { return TDual(-Value, -Derivatives); };
+			TDual operator+() const { return *this; };
+
+			friend TDual operator+(const TDual& A, const TDual& B) { return TDual(A.Value + B.Value, A.Derivatives + B.Derivatives); };
+			friend TDual operator-(const TDual& A, const TDual& B) { return TDual(A.Value - B.Value, A.Derivatives - B.Derivatives); };
+			friend TDual operator*(const TDual& A, const TDual& B) { return TDual(A.Value * B.Value, B.Value * A.Derivatives + A.Value * B.Derivatives); };
+			friend TDual operator/(const TDual& A, const TDual& B)
+			{
+				const TValue Inverse = TValue(1) / B.Value;
+				const TValue Value = A.Value * Inverse;
+				return TDual(Value, (A.Derivatives - Value * B.Derivatives) * Inverse);
+			};
+
+			// Constants only scale (or offset) the derivatives, so skip the full product rule.
+			friend TDual operator+(const TDual& A, TValue B) { return TDual(A.Value + B, A.Derivatives); };
+			friend TDual operator+(TValue A, const TDual& B) { return TDual(A + B.Value, B.Derivatives); };
+			friend TDual operator-(const TDual& A, TValue B) { return TDual(A.Value - B, A.Derivatives); };
+			friend TDual operator-(TValue A, const TDual& B) { return TDual(A - B.Value, -B.Derivatives); };
+			friend TDual operator*(const TDual& A, TValue B) { return TDual(A.Value * B, A.Derivatives * B); };
+			friend TDual operator*(TValue A, const TDual& B) { return TDual(A * B.Value, A * B.Derivatives); };
+			friend TDual operator/(const TDual& A, TValue B) { return TDual(A.Value / B, A.Derivatives / B); };
+
+			friend bool operator==(const TDual& A, const TDual& B) { return A.Value == B.Value; };
+			friend bool operator!=(const TDual& A, const TDual& B) { return A.Value != B.Value; };
+			friend bool operator<(const TDual& A, const TDual& B) { return A.Value < B.Value; };
+			friend bool operator<=(const TDual& A, const TDual& B) { return A.Value <= B.Value; };
+			friend bool operator>(const TDual& A, const TDual& B) { return A.Value > B.Value; };
+			friend bool operator>=(const TDual& A, const TDual& B) { return A.Value >= B.Value; };
+		};
+
+		// Mixed operations with the other arithmetic types (eg. the float coefficients and literals in the models)
+
+		template<typename TValue, int N, typename TArithmetic, typename = typename std::enable_if<std::is_arithmetic<TArithmetic>::value>::type>
+		inline TDual<TValue, N> operator+(const TDual<TValue, N>& A, TArithmetic B) { return A + static_cast<TValue>(B); }
+		template<typename TValue, int N, typename TArithmetic, typename = typename std::enable_if<std::is_arithmetic<TArithmetic>::value>::type>
+		inline TDual<TValue, N> operator+(TArithmetic A, const TDual<TValue, N>& B) { return static_cast<TValue>(A) + B; }
+		template<typename TValue, int N, typename TArithmetic, typename = typename std::enable_if<std::is_arithmetic<TArithmetic>::value>::type>
+		inline TDual<TValue, N> operator-(const TDual<TValue, N>& A, TArithmetic B) { return A - static_cast<TValue>(B); }
+		template<typename TValue, int N, typename TArithmetic, typename = typename std::enable_if<std::is_arithmetic<TArithmetic>::value>::type>
+		inline TDual<TValue, N> operator-(TArithmetic A, const TDual<TValue, N>& B) { return static_cast<TValue>(A) - B; }
+		template<typename TValue, int N, typename TArithmetic, typename = typename std::enable_if<std::is_arithmetic<TArithmetic>::value>::type>
+		inline TDual<TValue, N> operator*(const TDual<TValue, N>& A, TArithmetic B) { return A * static_cast<TValue>(B); }
+		template<typename TValue, int N, typename TArithmetic, typename = typename std::enable_if<std::is_arithmetic<TArithmetic>::value>::type>
+		inline TDual<TValue, N> operator*(TArithmetic A, const TDual<TValue, N>& B) { return static_cast<TValue>(A) * B; }
+		template<typename TValue, int N, typename TArithmetic, typename = typename std::enable_if<std::is_arithmetic<TArithmetic>::value>::type>
+		inline TDual<TValue, N> operator/(const TDual<TValue, N>& A, TArithmetic B) { return A / static_cast<TValue>(B); }
+		template<typename TValue, int N, typename TArithmetic, typename = typename std::enable_if<std::is_arithmetic<TArithmetic>::value>::type>
+		inline TDual<TValue, N> operator/(TArithmetic A, const TDual<TValue, N>& B) { return TDual<TValue, N>(A) / B; }
+
+		template<typename TValue, int N, typename TArithmetic, typename = typename std::enable_if<std::is_arithmetic<TArithmetic>::value>::type>
+		inline bool operator==(const TDual<TValue, N>& A, TArithmetic B) { return A.Value == static_cast<TValue>(B); }
+		template<typename TValue, int N, typename TArithmetic, typename = typename std::enable_if<std::is_arithmetic<TArithmetic>::value>::type>
+		inline bool operator==(TArithmetic A, const TDual<TValue, N>& B) { return static_cast<TValue>(A) == B.Value; }
+		template<typename TValue, int N, typename TArithmetic, typename = typename std::enable_if<std::is_arithmetic<TArithmetic>::value>::type>
+		inline bool operator!=(const TDual<TValue, N>& A, TArithmetic B) { return A.Value != static_cast<TValue>(B); }
+		template<typename TValue, int N, typename TArithmetic, typename = typename std::enable_if<std::is_arithmetic<TArithmetic>::value>::type>
+		inline bool operator!=(TArithmetic A, const TDual<TValue, N>& B) { return static_cast<TValue>(A) != B.Value; }
+		template<typename TValue, int N, typename TArithmetic, typename = typename std::enable_if<std::is_arithmetic<TArithmetic>::value>::type>
+		inline bool operator<(const TDual<TValue, N>& A, TArithmetic B) { return A.Value < static_cast<TValue>(B); }
+		template<typename TValue, int N, typename TArithmetic, typename = typename std::enable_if<std::is_arithmetic<TArithmetic>::value>::type>
+		inline bool operator<(TArithmetic A, const TDual<TValue, N>& B) { return static_cast<TValue>(A) < B.Value; }
+		template<typename TValue, int N, typename TArithmetic, typename = typename std::enable_if<std::is_arithmetic<TArithmetic>::value>::type>
+		inline bool operator<=(const TDual<TValue, N>& A, TArithmetic B) { return A.Value <= static_cast<TValue>(B); }
+		template<typename TValue, int N, typename TArithmetic, typename = typename std::enable_if<std::is_arithmetic<TArithmetic>::value>::type>
+		inline bool operator<=(TArithmetic A, const TDual<TValue, N>& B) { return static_cast<TValue>(A) <= B.Value; }
+		template<typename TValue, int N, typename TArithmetic, typename = typename std::enable_if<std::is_arithmetic<TArithmetic>::value>::type>
+		inline bool operator>(const TDual<TValue, N>& A, TArithmetic B) { return A.Value > static_cast<TValue>(B); }
+		template<typename TValue, int N, typename TArithmetic, typename = typename std::enable_if<std::is_arithmetic<TArithmetic>::value>::type>
+		inline bool operator>(TArithmetic A, const TDual<TValue, N>& B) { return static_cast<TValue>(A) > B.Value; }
+		template<typename TValue, int N, typename TArithmetic, typename = typename std::enable_if<std::is_arithmetic<TArithmetic>::value>::type>
+		inline bool operator>=(const TDual<TValue, N>& A, TArithmetic B) { return A.Value >= static_cast<TValue>(B); }
+		template<typename TValue, int N, typename TArithmetic, typename = typename std::enable_if<std::is_arithmetic<TArithmetic>::value>::type>
+		inline bool operator>=(TArithmetic A, const TDual<TValue, N>& B) { return static_cast<TValue>(A) >= B.Value; }
+
+		// Math functions, found by argument dependent lookup from the models (which call them unqualified, after "using std::...").
+		// Each returns f(x) with the derivatives f'(x) * dx.
+
+		template<typename TValue, int N>
+		inline TDual<TValue, N> sin(const TDual<TValue, N>& x) { using std::sin; using std::cos; return TDual<TValue, N>(sin(x.Value), cos(x.Value) * x.Derivatives); }
+
+		template<typename TValue, int N>
+		inline TDual<TValue, N> cos(const TDual<TValue, N>& x) { using std::sin; using std::cos; return TDual<TValue, N>(cos(x.Value), -sin(x.Value) * x.Derivatives); }
+
+		template<typename TValue, int N>
+		inline TDual<TValue, N> tan(const TDual<TValue, N>& x)
+		{
+			using std::tan;
+			const TValue Value = tan(x.Value);
+			return TDual<TValue, N>(Value, (TValue(1) + Value * Value) * x.Derivatives);
+		}
+
+		template<typename TValue, int N>
+		inline TDual<TValue, N> asin(const TDual<TValue, N>& x) { using std::asin; using std::sqrt; return TDual<TValue, N>(asin(x.Value), x.Derivatives / sqrt(TValue(1) - x.Value * x.Value)); }
+
+		template<typename TValue, int N>
+		inline TDual<TValue, N> acos(const TDual<TValue, N>& x) { using std::acos; using std::sqrt; return TDual<TValue, N>(acos(x.Value), -x.Derivatives / sqrt(TValue(1) - x.Value * x.Value)); }
+
+		template<typename TValue, int N>
+		inline TDual<TValue, N> atan(const TDual<TValue, N>& x) { using std::atan; return TDual<TValue, N>(atan(x.Value), x.Derivatives / (TValue(1) + x.Value * x.Value)); }
+
+		template<typename TValue, int N>
+		inline TDual<TValue, N> atan2(const TDual<TValue, N>& y, const TDual<TValue, N>& x)
+		{
+			using std::atan2;
+			const TValue SquaredNorm = x.Value * x.Value + y.Value * y.Value;
+			if (SquaredNorm == TValue(0))
+			{
+				return TDual<TValue, N>(atan2(y.Value, x.Value));
+			}
+			return TDual<TValue, N>(atan2(y.Value, x.Value), (x.Value * y.Derivatives - y.Value * x.Derivatives) / SquaredNorm);
+		}
+
+		template<typename TValue, int N>
+		inline TDual<TValue, N> sqrt(const TDual<TValue, N>& x)
+		{
+			using std::sqrt;
+			const TValue Value = sqrt(x.Value);
+			if (Value == TValue(0))
+			{
+				return TDual<TValue, N>(Value);
+			}
+			return TDual<TValue, N>(Value, x.Derivatives / (TValue(2) * Value));
+		}
+
+		template<typename TValue, int N>
+		inline TDual<TValue, N> exp(const TDual<TValue, N>& x) { using std::exp; const TValue Value = exp(x.Value); return TDual<TValue, N>(Value, Value * x.Derivatives); }
+
+		template<typename TValue, int N>
+		inline TDual<TValue, N> log(const TDual<TValue, N>& x) { using std::log; return TDual<TValue, N>(log(x.Value), x.Derivatives / x.Value); }
+
+		template<typename TValue, int N>
+		inline TDual<TValue, N> pow(const TDual<TValue, N>& x, TValue Exponent)
+		{
+			using std::pow;
+			if (x.Value == TValue(0))
+			{
+				return TDual<TValue, N>(pow(x.Value, Exponent));
+			}
+			return TDual<TValue, N>(pow(x.Value, Exponent), Exponent * pow(x.Value, Exponent - TValue(1)) * x.Derivatives);
+		}
+
+		template<typename TValue, int N>
+		inline TDual<TValue, N> pow(const TDual<TValue, N>& x, const TDual<TValue, N>& Exponent)
+		{
+			return exp(Exponent * log(x));
+		}
+
+		template<typename TValue, int N>
+		inline TDual<TValue, N> fabs(const TDual<TValue, N>& x) { return x.Value < TValue(0) ? -x : (x.Value > TValue(0) ? x : TDual<TValue, N>(TValue(0))); }
+
+		template<typename TValue, int N>
+		inline TDual<TValue, N> abs(const TDual<TValue, N>& x) { return fabs(x); }
+
+		template<typename TValue, int N>
+		inline bool isnan(const TDual<TValue, N>& x) { using std::isnan; return isnan(x.Value); }
+
+		template<typename TValue, int N>
+		inline bool isfinite(const TDual<TValue, N>& x) { using std::isfinite; return isfinite(x.Value); }
+
+		template<typename TValue, int N>
+		inline bool isinf(const TDual<TValue, N>& x) { using std::isinf; return isinf(x.Value); }
+
+		// The value of a dual number, without its derivatives (see GetValue in MathUtils.h)
+		template<typename TValue, int N>
+		inline TValue GetValue(const TDual<TValue, N>& x) { return x.Value; }
+	}
+
+	using Dual::TDual;
+
+	// The dual number used for sensitivities. Double precision, as per the reference path, with enough directions for the state and inputs
+	// of most vehicles in one evaluation (any more are covered by further evaluations).
+	using FDual = TDual<double, 32>;
+}
+
+namespace Eigen
+{
+	template<typename TValue, int N>
+	struct NumTraits<SkyPhysCore::Dual::TDual<TValue, N>> : NumTraits<TValue>
+	{
+		using Real = SkyPhysCore::Dual::TDual<TValue, N>;
+		using NonInteger = SkyPhysCore::Dual::TDual<TValue, N>;
+		using Nested = SkyPhysCore::Dual::TDual<TValue, N>;
+		using Literal = SkyPhysCore::Dual::TDual<TValue, N>;
+
+		enum
+		{
+			IsComplex = 0,
+			IsInteger = 0,
+			IsSigned = 1,
+			RequireInitialization = 1,
+			ReadCost = N + 1,
+			AddCost = N + 1,
+			MulCost = 2 * N + 1
+		};
+
+		static inline Real epsilon() { return Real(NumTraits<TValue>::epsilon()); }
+		static inline Real dummy_precision() { return Real(NumTraits<TValue>::dummy_precision()); }
+		static inline Real highest() { return Real(NumTraits<TValue>::highest()); }
+		static inline Real lowest() { return Real(NumTraits<TValue>::lowest()); }
+		static inline int digits10() { return NumTraits<TValue>::digits10(); }
+	};
+}
@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cstdint>
+
+namespace SkyPhysCore
+{
+	// How the linear filters (the actuators and the turbulence filters) are advanced over a step.
+	enum class EFilterIntegrationMethod : uint8_t
+	{
+		Trapezoidal,	// Trapezoidal integrators (as per Simulink), with the feedback held over the step. Only stable while the filter rate * Dt is small.
+		Exponential		// The exact solution for the input held over the step. Unconditionally stable, and O(1) for any Dt.
+	};
+
+	class Integrator
+	{
+	public:
+		Integrator() {};
+		Integrator(float InitialState) : X(InitialState), UPrev(InitialState), Y(InitialState) {};
+		Integrator(float InitialState, float DtMin) : X(InitialState), UPrev(InitialState), Y(InitialState), DtMin(DtMin) {};
+
+		float Integrate(const float Dt, const float U)
+		{
+			// Integrate multiple time-steps worth if our dt is larger than the minimum dt we have defined.
+			// The input is held over all of them, so only the first sees UPrev, and the rest can be taken in one go (O(1) for any Dt).
+			if (Dt > DtMin) {
+				Run(DtMin, U);
+				Y = X + (Dt - DtMin) * U;
+				X = Y;
+				return Y;
+			}
+			else
+			{
+				return Run(Dt, U);
+			}
+		}
+
+		// Set the state directly, for filters which are solved in closed form rather than integrated.
+		//
+		// @param State: The new integrator state (ie. its output)
+		// @param U: The integrator input at that state (ie. the rate of the state)
+		float SetState(const float State, const float U)
+		{
+			X = State;
+			Y = State;
+			UPrev = U;
+			return Y;
+		}
+
+		float X = 0.0f;
+		float UPrev = 0;
+		float Y = 0.0f;
+
+	private:
+
+		float Run(const float Dt, const float U)
+		{
+			//Trapezoidal integration as per https://www.mathworks.com/help/simulink/slref/discretetimeintegrator.html with variable T
+			Y = X + (Dt / 2.0f) * (U + UPrev);
+
+			X = Y; //ie. x(n+1) = y(n)
+			UPrev = U; //ie. u(n-1) = u(n)
+
+			return Y;
+		}
+
+		float DtMin = 0.01f;
+
+	};
+}
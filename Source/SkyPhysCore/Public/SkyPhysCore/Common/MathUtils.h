@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cfloat>
+#include <cmath>
+
+#include "SkyPhysCore/Common/CoreTypes.h"
+
+// Engine-independent equivalents of the FMath utilities used throughout the flight dynamics.
+namespace SkyPhysCore
+{
+	constexpr float Pi = 3.1415926535897932f;
+	constexpr float SmallNumber = 1.e-8f;
+	constexpr float MToCm = 100.0f;
+	constexpr float MToFt = 3.28084f;
+
+	// These are templated on the scalar type, for the models which are (see CoreTypes.h). The math functions are called unqualified,
+	// so that those of any other scalar type (eg. TDual, see Dual.h) are found.
+
+	template<typename TScalar>
+	inline bool IsNearlyZero(TScalar Value, TScalar ErrorTolerance = TScalar(SmallNumber))
+	{
+		using std::fabs;
+		return fabs(Value) <= ErrorTolerance;
+	}
+
+	// The value of a scalar, without any derivatives (see Dual.h). For float and double this is the scalar itself.
+	template<typename TScalar>
+	inline TScalar GetValue(TScalar Value)
+	{
+		return Value;
+	}
+
+	template<typename TScalar>
+	inline TScalar Sign(TScalar Value)
+	{
+		return (Value > TScalar(0)) ? TScalar(1) : ((Value < TScalar(0)) ? TScalar(-1) : TScalar(0));
+	}
+
+	template<typename TScalar>
+	inline TScalar Clamp(TScalar Value, TScalar Min, TScalar Max)
+	{
+		return Value < Min ? Min : (Value < Max ? Value : Max);
+	}
+
+	inline float RadiansToDegrees(float Rad)
+	{
+		return Rad * (180.0f / Pi);
+	}
+
+	inline float DegreesToRadians(float Deg)
+	{
+		return Deg * (Pi / 180.0f);
+	}
+
+	// Helper function to get from rad/s to RPM
+	template<typename TScalar>
+	inline TScalar RadPerSToRPM(TScalar RadPerS)
+	{
+		return (RadPerS / (2.0f * Pi)) * 60.0f;
+	}
+
+	// Helper function to get from RPM to rad/s
+	template<typename TScalar>
+	inline TScalar RPMToRadPerS(TScalar RPM)
+	{
+		return (RPM / 60.0f) * 2.0f * Pi;
+	}
+
+	// Move Current toward Target at a constant rate of InterpSpeed (units/s), as per FMath::FInterpConstantTo.
+	inline float InterpConstantTo(float Current, float Target, float DeltaTime, float InterpSpeed)
+	{
+		const float Dist = Target - Current;
+
+		// If distance is too small, just set the desired location
+		if (Dist * Dist < SmallNumber)
+		{
+			return Target;
+		}
+
+		const float Step = InterpSpeed * DeltaTime;
+		return Current + Clamp(Dist, -Step, Step);
+	}
+
+	// Remove small numerical errors like small accumulation errors, NaNs etc. (as per SkyPhysHelpers::RemoveNumericalErrors)
+	template<typename TDerived>
+	inline TVector3<typename TDerived::Scalar> RemoveNumericalErrors(const Eigen::MatrixBase<TDerived>& Vector)
+	{
+		using TScalar = typename TDerived::Scalar;
+
+		TVector3<TScalar> TestVector = Vector;
+
+		// Return 0 if our vector contains NaNs... as something has then gone wrong.
+		if (TestVector.hasNaN())
+		{
+			return TVector3<TScalar>::Zero();
+		}
+
+		// Remove small numerical errors due to floating points, given that we're integrating these.
+		// Only the value is removed, so any derivatives carry on through (ie. this is treated as the identity when differentiating).
+		const TScalar ErrorTolerance = TScalar(0.0001);
+		for (int i = 0; i < 3; i++)
+		{
+			if (IsNearlyZero(TestVector(i), ErrorTolerance))
+			{
+				TestVector(i) -= GetValue(TestVector(i));
+			}
+		}
+
+		return TestVector;
+	}
+}
@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace SkyPhysCore
+{
+	// A small, seeded random number stream (PCG32, XSH RR variant) whose sequence is fully specified, so the same seed gives the same
+	// numbers on every platform and standard library (unlike std::default_random_engine and std::normal_distribution, which are
+	// implementation defined). The normal samples use std::log and std::sqrt, so are exact wherever the maths library is.
+	class FRandomStream
+	{
+	public:
+		FRandomStream() { Seed(0); };
+		explicit FRandomStream(uint64_t InSeed, uint64_t InStream = 0) { Seed(InSeed, InStream); };
+
+		// Restart the stream. Different Streams with the same seed give independent sequences.
+		void Seed(uint64_t InSeed, uint64_t InStream = 0)
+		{
+			State = 0;
+			Increment = (InStream << 1u) | 1u;
+			NextUInt32();
+			State += InSeed;
+			NextUInt32();
+			bHaveSpareNormal = false;
+		};
+
+		uint32_t NextUInt32()
+		{
+			const uint64_t OldState = State;
+			State = OldState * 6364136223846793005ULL + Increment;
+			const uint32_t XorShifted = static_cast<uint32_t>(((OldState >> 18u) ^ OldState) >> 27u);
+			const uint32_t Rotation = static_cast<uint32_t>(OldState >> 59u);
+			return (XorShifted >> Rotation) | (XorShifted << ((32u - Rotation) & 31u));
+		};
+
+		// Uniform in [0, 1), from the top 24 bits (ie. every representable step of a float in that range)
+		float NextUniform()
+		{
+			return static_cast<float>(NextUInt32() >> 8) * (1.0f / 16777216.0f);
+		};
+
+		// Standard normal (mean 0, standard deviation 1), using the Marsaglia polar method (which produces samples in pairs).
+		float NextNormal()
+		{
+			if (bHaveSpareNormal)
+			{
+				bHaveSpareNormal = false;
+				return SpareNormal;
+			}
+
+			float U, V, S;
+			do
+			{
+				U = 2.0f * NextUniform() - 1.0f;
+				V = 2.0f * NextUniform() - 1.0f;
+				S = U * U + V * V;
+			} while (S >= 1.0f || S == 0.0f);
+
+			const float Scale = std::sqrt(-2.0f * std::log(S) / S);
+			SpareNormal = V * Scale;
+			bHaveSpareNormal = true;
+			return U * Scale;
+		};
+
+		// Derive the seed of a sub-stream (eg. per vehicle, then per model) from a parent seed, so that one top level seed fixes everything.
+		static uint64_t DeriveSeed(uint64_t ParentSeed, uint64_t SubStream)
+		{
+			// SplitMix64 finaliser
+			uint64_t Z = ParentSeed + (SubStream + 1) * 0x9E3779B97F4A7C15ULL;
+			Z = (Z ^ (Z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			Z = (Z ^ (Z >> 27)) * 0x94D049BB133111EBULL;
+			return Z ^ (Z >> 31);
+		};
+
+	private:
+		uint64_t State = 0;
+		uint64_t Increment = 1;
+
+		bool bHaveSpareNormal = false;
+		float SpareNormal = 0.0f;
+	};
+}
@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "SkyPhysCore/Common/CoreTypes.h"
+
+namespace SkyPhysCore
+{
+	// Plain float copies of the Eigen types, for use in snapshots. Eigen types aren't trivially copyable (they declare their own copy
+	// constructors), so snapshots store these instead, which keeps the snapshots themselves trivially copyable (ie. memcpy-able).
+
+	struct FSnapshotVector3
+	{
+		float X, Y, Z;
+	};
+
+	struct FSnapshotQuaternion
+	{
+		float X, Y, Z, W;
+	};
+
+	inline FSnapshotVector3 ToSnapshot(const FVector3& Vector)
+	{
+		return FSnapshotVector3{ Vector.x(), Vector.y(), Vector.z() };
+	}
+
+	inline FVector3 FromSnapshot(const FSnapshotVector3& Vector)
+	{
+		return FVector3(Vector.X, Vector.Y, Vector.Z);
+	}
+
+	inline FSnapshotQuaternion ToSnapshot(const FQuaternion& Quaternion)
+	{
+		return FSnapshotQuaternion{ Quaternion.x(), Quaternion.y(), Quaternion.z(), Quaternion.w() };
+	}
+
+	inline FQuaternion FromSnapshot(const FSnapshotQuaternion& Quaternion)
+	{
+		return FQuaternion(Quaternion.W, Quaternion.X, Quaternion.Y, Quaternion.Z);
+	}
+}
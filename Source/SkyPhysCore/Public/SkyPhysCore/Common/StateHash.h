@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "SkyPhysCore/Common/CoreTypes.h"
+
+namespace SkyPhysCore
+{
+	// Incremental 64 bit FNV-1a hash over the exact bit patterns of the values added, for cheaply checking that two runs are bit-identical
+	// (eg. comparing one hash per step over a long run, instead of dumping the full state).
+	class FStateHash
+	{
+	public:
+		void Add(uint64_t Value)
+		{
+			for (int i = 0; i < 8; i++)
+			{
+				Hash ^= (Value >> (8 * i)) & 0xFFu;
+				Hash *= 0x100000001B3ULL;
+			}
+		};
+
+		void Add(float Value)
+		{
+			uint32_t Bits;
+			std::memcpy(&Bits, &Value, sizeof(Bits));
+			Add(static_cast<uint64_t>(Bits));
+		};
+
+		void Add(const FVector3& Value)
+		{
+			Add(Value.x());
+			Add(Value.y());
+			Add(Value.z());
+		};
+
+		void Add(const FQuaternion& Value)
+		{
+			Add(Value.w());
+			Add(Value.x());
+			Add(Value.y());
+			Add(Value.z());
+		};
+
+		uint64_t Get() const { return Hash; };
+
+	private:
+		uint64_t Hash = 0xCBF29CE484222325ULL;
+	};
+}
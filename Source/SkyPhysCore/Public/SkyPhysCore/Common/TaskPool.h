@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SkyPhysCore
+{
+	// Signature of a parallel for: call Body(i) for every i in [0, Num), returning once all calls are complete.
+	// In Unreal this is provided by ParallelFor, and headless by FTaskPool.
+	using FParallelFor = std::function<void(int Num, const std::function<void(int)>& Body)>;
+
+	// Run Body(i) for every i in [0, Num) on the calling thread.
+	inline void SerialFor(int Num, const std::function<void(int)>& Body)
+	{
+		for (int i = 0; i < Num; i++)
+		{
+			Body(i);
+		}
+	}
+
+	// A small, persistent pool of worker threads for headless (non-Unreal) simulation.
+	// Each ParallelFor splits the range into contiguous chunks, one per thread (including the calling thread).
+	class SKYPHYSCORE_API FTaskPool
+	{
+	public:
+		// @param NumWorkers: Number of worker threads in addition to the calling thread (0 runs everything on the calling thread)
+		explicit FTaskPool(int NumWorkers);
+		~FTaskPool();
+
+		FTaskPool(const FTaskPool&) = delete;
+		FTaskPool& operator=(const FTaskPool&) = delete;
+
+		void ParallelFor(int Num, const std::function<void(int)>& Body);
+
+		// Get a FParallelFor which runs on this pool (the pool must outlive it).
+		FParallelFor AsParallelFor() { return [this](int Num, const std::function<void(int)>& Body) { ParallelFor(Num, Body); }; };
+
+		// The number of threads which share the work (workers + the calling thread)
+		int NumThreads() const { return static_cast<int>(Workers.size()) + 1; };
+
+	private:
+		void WorkerLoop(int ThreadIndex);
+		void RunChunk(int ThreadIndex);
+
+		std::vector<std::thread> Workers;
+
+		std::mutex Mutex;
+		std::condition_variable WorkReady;
+		std::condition_variable WorkDone;
+
+		// Current job
+		const std::function<void(int)>* Body = nullptr;
+		int Num = 0;
+		uint64_t Generation = 0;
+		int NumPending = 0;
+		bool bStop = false;
+	};
+}
@@ -0,0 +1,235 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cstdint>
+
+#include "SkyPhysCore/Common/CoreTypes.h"
+#include "SkyPhysCore/Common/Dual.h"
+
+namespace SkyPhysCore
+{
+	// Everything here is templated on the scalar type (see CoreTypes.h), and instantiated for float and double, as well as FDual (see Sensitivity.h).
+
+	template<typename TScalar>
+	struct TMassProperties
+	{
+		TScalar Mass = TScalar(1); // (kg)
+		TScalar Ixx = TScalar(0); // (kg.m^2)
+		TScalar Iyy = TScalar(0); // (kg.m^2)
+		TScalar Izz = TScalar(0); // (kg.m^2)
+		TScalar Ixz = TScalar(0); // Assumed same as Izx (kg.m^2)
+
+		// We will pre-calculate J and JInverse as these aren't going to change during runtime.
+		// These are held in the same precision as the state, so that the kinematics don't need to convert anything.
+		TMatrix3<TScalar> J = TMatrix3<TScalar>::Identity();
+		TMatrix3<TScalar> JInverse = TMatrix3<TScalar>::Identity();
+
+		// Pre-Calculate our Inertia Tensor and Inverse from the above.
+		void PreCalculate();
+
+		// Convert to another precision. J and JInverse are recalculated in that precision.
+		template<typename TOther>
+		TMassProperties<TOther> Cast() const
+		{
+			TMassProperties<TOther> Other;
+			Other.Mass = static_cast<TOther>(Mass);
+			Other.Ixx = static_cast<TOther>(Ixx);
+			Other.Iyy = static_cast<TOther>(Iyy);
+			Other.Izz = static_cast<TOther>(Izz);
+			Other.Ixz = static_cast<TOther>(Ixz);
+			Other.PreCalculate();
+			return Other;
+		};
+	};
+
+	// Rigid body state, with the world frame defined as NED and the body frame as FRD.
+	template<typename TScalar>
+	struct TRigidBodyState
+	{
+		TVector3<TScalar> Position = TVector3<TScalar>::Zero(); // (N, E, D) (m)
+		TQuaternion<TScalar> Attitude = TQuaternion<TScalar>::Identity(); // Rotation from the body to the world frame
+		TVector3<TScalar> Vb = TVector3<TScalar>::Zero(); // (u, v, w) (m/s)
+		TVector3<TScalar> Omegab = TVector3<TScalar>::Zero(); // (p, q, r) (rad/s)
+
+		// Convert to another precision (eg. to start the double reference path from the float state)
+		template<typename TOther>
+		TRigidBodyState<TOther> Cast() const
+		{
+			TRigidBodyState<TOther> Other;
+			Other.Position = Position.template cast<TOther>();
+			Other.Attitude = Attitude.template cast<TOther>();
+			Other.Vb = Vb.template cast<TOther>();
+			Other.Omegab = Omegab.template cast<TOther>();
+			return Other;
+		};
+	};
+
+	enum class EIntegrationMethod : uint8_t
+	{
+		SemiImplicitEuler,	// First order, with one force evaluation per step. Velocities are updated first and then used to update the pose.
+		Heun,				// Second order (explicit trapezoidal), with two force evaluations per step.
+		RK4					// Fourth order (classic Runge-Kutta), with four force evaluations per step.
+	};
+
+	// The rigid body state in the form integrated by the multi-stage methods. The linear velocity is in the world frame, so that we don't need
+	// to account for the rotating body frame, and the attitude is held as raw quaternion coefficients (x, y, z, w), so that stages can be summed.
+	// This is also used for the time derivative of the state.
+	template<typename TScalar>
+	struct TRigidBodyStage
+	{
+		using FVector4 = Eigen::Matrix<TScalar, 4, 1>;
+
+		TVector3<TScalar> Position = TVector3<TScalar>::Zero(); // (N, E, D) (m)
+		TVector3<TScalar> Vw = TVector3<TScalar>::Zero(); // (m/s)
+		FVector4 Attitude = FVector4(TScalar(0), TScalar(0), TScalar(0), TScalar(1));
+		TVector3<TScalar> Omegab = TVector3<TScalar>::Zero(); // (p, q, r) (rad/s)
+
+		static TRigidBodyStage FromState(const TRigidBodyState<TScalar>& State);
+
+		// Get the equivalent rigid body state (with the attitude normalised)
+		TRigidBodyState<TScalar> ToState() const;
+
+		// Advance along a derivative (ie. this + Derivative * DeltaTime)
+		TRigidBodyStage Advance(const TRigidBodyStage& Derivative, TScalar DeltaTime) const;
+	};
+
+	// 6-DoF rigid body kinematics.
+	template<typename TScalar>
+	class TRigidBodyModel
+	{
+	public:
+		using FVector3 = TVector3<TScalar>;
+		using FForcesAndMoments = TForcesAndMoments<TScalar>;
+		using FRigidBodyState = TRigidBodyState<TScalar>;
+		using FRigidBodyStage = TRigidBodyStage<TScalar>;
+
+		// Calculate the velocity increments due to the forces and moments in the body frame, over DeltaTime.
+		// This is used when the integration itself is handled elsewhere (eg. PhysX).
+		//
+		// @param Omegab: Body rotational velocity in the body frame (rad/s)
+		// @param ForcesAndMoments: Forces and moments at the CoG in the body frame (N, Nm)
+		// @param DeltaTime: Time step (s)
+		// @param dVb: Linear velocity increment in the body frame (m/s)
+		// @param dOmegab: Angular velocity increment in the body frame (rad/s)
+		void CalculateVelocityIncrements(const FVector3& Omegab, const FForcesAndMoments& ForcesAndMoments, TScalar DeltaTime, FVector3& dVb, FVector3& dOmegab) const;
+
+		// Integrate the rigid body state over DeltaTime (semi-implicit Euler, consistent with how PhysX applies our velocity increments).
+		//
+		// @param State: The state to integrate
+		// @param ForcesAndMoments: Forces and moments at the CoG in the body frame, excluding gravity (N, Nm)
+		// @param Gravity: Gravitational acceleration in the world frame (m/s^2)
+		// @param DeltaTime: Time step (s)
+		void Integrate(FRigidBodyState& State, const FForcesAndMoments& ForcesAndMoments, const FVector3& Gravity, TScalar DeltaTime) const;
+
+		// Integrate the rigid body state over DeltaTime with the given method, re-evaluating the forces and moments at each intermediate stage.
+		//
+		// @param State: The state to integrate
+		// @param Gravity: Gravitational acceleration in the world frame (m/s^2)
+		// @param DeltaTime: Time step (s)
+		// @param Method: The integration method
+		// @param CalculateForcesAndMoments: Callable taking a const FRigidBodyState& and returning the FForcesAndMoments at the CoG in the body frame, excluding gravity (N, Nm).
+		//									 It is first called with State itself.
+		template<typename TForcesAndMomentsFunction>
+		void Integrate(FRigidBodyState& State, const FVector3& Gravity, TScalar DeltaTime, EIntegrationMethod Method, TForcesAndMomentsFunction&& CalculateForcesAndMoments) const
+		{
+			if (Method == EIntegrationMethod::SemiImplicitEuler)
+			{
+				Integrate(State, CalculateForcesAndMoments(State), Gravity, DeltaTime);
+				return;
+			}
+
+			State = IntegrateStages(State, Gravity, DeltaTime, Method, CalculateForcesAndMoments).ToState();
+		};
+
+		// Calculate the velocity increments over DeltaTime with the given method, re-evaluating the forces and moments at each intermediate stage.
+		// This is used when the pose itself is integrated elsewhere (eg. PhysX), in which case gravity is also expected to be applied elsewhere.
+		//
+		// @param State: The current state
+		// @param Gravity: Gravitational acceleration in the world frame (m/s^2), which is used for the intermediate stages but excluded from dVw
+		// @param DeltaTime: Time step (s)
+		// @param Method: The integration method
+		// @param CalculateForcesAndMoments: As per Integrate
+		// @param dVw: Linear velocity increment in the world frame, excluding gravity (m/s)
+		// @param dOmegab: Angular velocity increment in the body frame (rad/s)
+		template<typename TForcesAndMomentsFunction>
+		void CalculateVelocityIncrements(const FRigidBodyState& State, const FVector3& Gravity, TScalar DeltaTime, EIntegrationMethod Method, TForcesAndMomentsFunction&& CalculateForcesAndMoments, FVector3& dVw, FVector3& dOmegab) const
+		{
+			if (Method == EIntegrationMethod::SemiImplicitEuler)
+			{
+				FVector3 dVb;
+				CalculateVelocityIncrements(State.Omegab, CalculateForcesAndMoments(State), DeltaTime, dVb, dOmegab);
+				dVw = State.Attitude * dVb;
+				return;
+			}
+
+			const FRigidBodyStage Initial = FRigidBodyStage::FromState(State);
+			const FRigidBodyStage Final = IntegrateStages(State, Gravity, DeltaTime, Method, CalculateForcesAndMoments);
+
+			// Gravity is constant over the step, so its contribution to the velocity is exactly Gravity * DeltaTime.
+			dVw = Final.Vw - Initial.Vw - Gravity * DeltaTime;
+			dOmegab = Final.Omegab - Initial.Omegab;
+		};
+
+		// Calculate the time derivative of a stage
+		//
+		// @param Stage: The stage
+		// @param ForcesAndMoments: Forces and moments at the CoG in the body frame, excluding gravity (N, Nm)
+		// @param Gravity: Gravitational acceleration in the world frame (m/s^2)
+		FRigidBodyStage CalculateDerivative(const FRigidBodyStage& Stage, const FForcesAndMoments& ForcesAndMoments, const FVector3& Gravity) const;
+
+		TMassProperties<TScalar> MassProperties;
+
+	private:
+		template<typename TForcesAndMomentsFunction>
+		FRigidBodyStage IntegrateStages(const FRigidBodyState& State, const FVector3& Gravity, TScalar DeltaTime, EIntegrationMethod Method, TForcesAndMomentsFunction& CalculateForcesAndMoments) const
+		{
+			const FRigidBodyStage S0 = FRigidBodyStage::FromState(State);
+
+			auto Derivative = [&](const FRigidBodyStage& Stage)
+			{
+				return CalculateDerivative(Stage, CalculateForcesAndMoments(Stage.ToState()), Gravity);
+			};
+
+			// The first stage is evaluated at the state we were given, rather than its round trip through a stage.
+			const FRigidBodyStage k1 = CalculateDerivative(S0, CalculateForcesAndMoments(State), Gravity);
+
+			if (Method == EIntegrationMethod::Heun)
+			{
+				const FRigidBodyStage k2 = Derivative(S0.Advance(k1, DeltaTime));
+
+				return S0.Advance(k1, DeltaTime / TScalar(2)).Advance(k2, DeltaTime / TScalar(2));
+			}
+
+			// RK4
+			const FRigidBodyStage k2 = Derivative(S0.Advance(k1, DeltaTime / TScalar(2)));
+			const FRigidBodyStage k3 = Derivative(S0.Advance(k2, DeltaTime / TScalar(2)));
+			const FRigidBodyStage k4 = Derivative(S0.Advance(k3, DeltaTime));
+
+			return S0.Advance(k1, DeltaTime / TScalar(6)).Advance(k2, DeltaTime / TScalar(3)).Advance(k3, DeltaTime / TScalar(3)).Advance(k4, DeltaTime / TScalar(6));
+		};
+	};
+
+	// The float fast path, used by the simulation
+	using FMassProperties = TMassProperties<float>;
+	using FRigidBodyState = TRigidBodyState<float>;
+	using FRigidBodyStage = TRigidBodyStage<float>;
+	using FRigidBodyModel = TRigidBodyModel<float>;
+
+	// The double reference path
+	using FMassPropertiesd = TMassProperties<double>;
+	using FRigidBodyStated = TRigidBodyState<double>;
+	using FRigidBodyStaged = TRigidBodyStage<double>;
+	using FRigidBodyModeld = TRigidBodyModel<double>;
+
+	// These are all instantiated in RigidBodyModel.cpp
+	extern template struct SKYPHYSCORE_API TMassProperties<float>;
+	extern template struct SKYPHYSCORE_API TMassProperties<double>;
+	extern template struct SKYPHYSCORE_API TMassProperties<FDual>;
+	extern template struct SKYPHYSCORE_API TRigidBodyStage<float>;
+	extern template struct SKYPHYSCORE_API TRigidBodyStage<double>;
+	extern template struct SKYPHYSCORE_API TRigidBodyStage<FDual>;
+	extern template class SKYPHYSCORE_API TRigidBodyModel<float>;
+	extern template class SKYPHYSCORE_API TRigidBodyModel<double>;
+	extern template class SKYPHYSCORE_API TRigidBodyModel<FDual>;
+}
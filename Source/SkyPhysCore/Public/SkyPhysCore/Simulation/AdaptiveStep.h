@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "SkyPhysCore/Common/CoreTypes.h"
+#include "SkyPhysCore/Aerodynamics/AirframeModel.h"
+#include "SkyPhysCore/Dynamics/RigidBodyModel.h"
+
+namespace SkyPhysCore
+{
+	struct FAdaptiveStepParameters
+	{
+		float MinStep = 0.0005f; // Smallest step the controller will choose (s)
+		float MaxStep = 0.02f; // Largest step the controller will choose (s)
+		float Tolerance = 0.01f; // Allowed local error estimate per step, on the linear (m/s) and angular (rad/s) velocities
+		float StabilityFactor = 0.5f; // Step limit as a fraction of the fastest time constant of the vehicle (ie. StabilityFactor / fastest rate)
+	};
+
+	// Statistics on the steps chosen by an FAdaptiveStepController, since it was last reset.
+	struct FAdaptiveStepStats
+	{
+		int NumSteps = 0;
+		int NumStiffnessLimitedSteps = 0; // Steps where the stiffness limit (rather than the error estimate) set the step size
+		float SimulatedTime = 0.0f; // (s)
+		float MinStepTaken = 0.0f; // (s)
+		float MaxStepTaken = 0.0f; // (s)
+		float LastStep = 0.0f; // (s)
+		float LastErrorEstimate = 0.0f; // Local error estimate of the last completed step
+
+		float GetMeanStep() const { return NumSteps > 0 ? SimulatedTime / NumSteps : 0.0f; };
+	};
+
+	// Chooses the step size for a single vehicle, from an estimate of the local truncation error and the stiffness of the vehicle.
+	//
+	// The error of each step is estimated from the change in acceleration between the start of consecutive steps, which is the difference between
+	// an Euler and a trapezoidal (Heun) step, 0.5 * h * |a(t + h) - a(t)|. This needs no extra force evaluations, but is only known once the next
+	// step has started, so it is used to size the following step rather than to reject (and redo) a step. As this is a first order estimate, it is
+	// conservative for the higher order integration methods.
+	//
+	// The stiffness limit caps the step at a fraction of the fastest time constant of the vehicle (aerodynamic damping, actuators, turbulence filters,
+	// gyroscopic coupling), as the error estimate can't see dynamics which are faster than the step.
+	class SKYPHYSCORE_API FAdaptiveStepController
+	{
+	public:
+		// Get the size of the next step.
+		//
+		// @param RemainingTime: The time still to be covered (s). The step never overshoots this, and avoids leaving a sliver at the end.
+		// @param MaxCharacteristicRate: The fastest characteristic rate of the vehicle (1/s), or 0 if there is no stiffness limit
+		//
+		// @return The step size (s)
+		float CalculateNextStep(float RemainingTime, float MaxCharacteristicRate);
+
+		// Update the error estimate with the accelerations at the start of the step just taken (ie. evaluated with the forces and moments of its first stage).
+		//
+		// @param LinearAcceleration: Linear acceleration in the body frame, excluding gravity (m/s^2)
+		// @param AngularAcceleration: Angular acceleration in the body frame (rad/s^2)
+		void Update(const FVector3& LinearAcceleration, const FVector3& AngularAcceleration);
+
+		// Forget the error history (eg. after the vehicle is teleported), without clearing the stats.
+		void Reset();
+
+		void ResetStats() { Stats = FAdaptiveStepStats(); };
+		const FAdaptiveStepStats& GetStats() const { return Stats; };
+
+		FAdaptiveStepParameters Parameters;
+
+	private:
+		float ErrorStep = 0.0f; // The step allowed by the error estimate (0 until we have one)
+		float CurrentStep = 0.0f; // The step currently being taken
+		float PreviousStep = 0.0f; // The step before that (which the next error estimate applies to)
+
+		bool bHaveAccelerations = false;
+		FVector3 PreviousLinearAcceleration = FVector3::Zero();
+		FVector3 PreviousAngularAcceleration = FVector3::Zero();
+
+		FAdaptiveStepStats Stats;
+	};
+
+	// Characteristic rates (1/s), ie. the inverse of the time constants, of the elements which limit the step size.
+
+	// The fastest rate of the airframe aerodynamics: the roll, pitch and yaw damping, heave damping and pitch stiffness at the given airspeed.
+	//
+	// @param Airframe: The airframe model
+	// @param MassProperties: The rigid body mass properties
+	// @param Va: Airspeed (m/s)
+	// @param Rho: Air density (kg/m^3)
+	SKYPHYSCORE_API float CalculateAirframeCharacteristicRate(const FAirframeModel& Airframe, const FMassProperties& MassProperties, float Va, float Rho);
+
+	// The rate of gyroscopic coupling due to a spinning propulsor (ie. its angular momentum over the smallest body moment of inertia).
+	//
+	// @param AngularMomentum: Angular momentum of the propulsor about its spin axis (kg.m^2/s)
+	// @param MassProperties: The rigid body mass properties
+	SKYPHYSCORE_API float CalculateGyroscopicCharacteristicRate(float AngularMomentum, const FMassProperties& MassProperties);
+}
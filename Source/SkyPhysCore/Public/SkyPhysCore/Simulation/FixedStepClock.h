@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cstdint>
+
+namespace SkyPhysCore
+{
+	// Turns variable frame times into a whole number of fixed steps, carrying the remainder over to the next frame, so that the simulation
+	// only ever sees one step size (and so gives the same result for the same inputs, however the frames happened to fall).
+	class FFixedStepClock
+	{
+	public:
+		FFixedStepClock() {};
+		explicit FFixedStepClock(float FixedDeltaTime, int MaxStepsPerAdvance = 16) : FixedDeltaTime(FixedDeltaTime), MaxStepsPerAdvance(MaxStepsPerAdvance) {};
+
+		// Add a frame's worth of time.
+		//
+		// @param FrameDeltaTime: Wall clock (or game) time since the last frame (s)
+		//
+		// @return The number of fixed steps to take this frame. This is capped at MaxStepsPerAdvance (dropping any time beyond that), so that
+		// a long hitch doesn't cause an ever growing backlog of steps.
+		int Advance(float FrameDeltaTime)
+		{
+			Accumulator += FrameDeltaTime;
+
+			int NumSteps = static_cast<int>(Accumulator / FixedDeltaTime);
+			if (NumSteps > MaxStepsPerAdvance)
+			{
+				NumSteps = MaxStepsPerAdvance;
+				Accumulator = 0.0;
+			}
+			else
+			{
+				Accumulator -= NumSteps * static_cast<double>(FixedDeltaTime);
+			}
+
+			StepIndex += NumSteps;
+			return NumSteps;
+		};
+
+		void Reset()
+		{
+			Accumulator = 0.0;
+			StepIndex = 0;
+		};
+
+		float GetFixedDeltaTime() const { return FixedDeltaTime; };
+
+		// The number of fixed steps since the clock was reset
+		int64_t GetStepIndex() const { return StepIndex; };
+
+		// Simulated time since the clock was reset (s), exact in the step index
+		double GetSimulatedTime() const { return StepIndex * static_cast<double>(FixedDeltaTime); };
+
+		// How far we are between the last step and the next one (0 -> 1), eg. for interpolating what is rendered.
+		float GetInterpolationAlpha() const { return static_cast<float>(Accumulator / FixedDeltaTime); };
+
+	private:
+		float FixedDeltaTime = 0.01f; // (s)
+		int MaxStepsPerAdvance = 16;
+
+		double Accumulator = 0.0; // Time not yet stepped (s)
+		int64_t StepIndex = 0;
+	};
+}
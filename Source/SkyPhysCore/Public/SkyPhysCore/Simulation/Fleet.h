@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <vector>
+
+#include "SkyPhysCore/Aerodynamics/AirframeBatch.h"
+#include "SkyPhysCore/Common/TaskPool.h"
+#include "SkyPhysCore/Simulation/FixedStepClock.h"
+#include "SkyPhysCore/Simulation/Vehicle.h"
+
+namespace SkyPhysCore
+{
+	// Simulated vs. wall clock time of the lockstep steps taken by an FFleet (see FFleet::Step(int, float)).
+	struct FLockstepStats
+	{
+		long long NumSteps = 0;
+		double SimulatedTime = 0.0; // (s)
+		double WallTime = 0.0; // (s)
+
+		// How many times faster than real time the steps ran (ie. simulated time over wall clock time)
+		double GetRealTimeFactor() const { return WallTime > 0.0 ? SimulatedTime / WallTime : 0.0; };
+	};
+
+	// Steps many independent vehicles per call.
+	// The per-vehicle states (atmosphere, airspeed and actuators) are updated per vehicle, after which the airframe aerodynamics of the
+	// whole fleet are evaluated in a single vectorised pass over structure of arrays data (see FAirframeBatch), before each vehicle adds
+	// its propulsion and integrates. The result is the same as calling FVehicle::Step on each vehicle (to within the rounding of the
+	// vectorised maths functions), which the Fleet suite of CoreTests checks.
+	class SKYPHYSCORE_API FFleet
+	{
+	public:
+		// Add a vehicle to the fleet.
+		//
+		// @return The index of the vehicle in the fleet
+		int AddVehicle(const FVehicle& Vehicle);
+
+		// Remove all vehicles from the fleet.
+		void Reset();
+
+		// Step every vehicle in the fleet forward by DeltaTime (s)
+		// As with FVehicle::Step, this doesn't allocate (beyond whatever the ParallelFor itself does), once the fleet is built.
+		void Step(float DeltaTime);
+
+		// Step every vehicle in the fleet NumSteps times with a fixed DeltaTime (s), as fast as possible (ie. decoupled from any wall clock).
+		// The time taken is added to the lockstep stats.
+		//
+		// @return The stats of just these steps
+		FLockstepStats Step(int NumSteps, float DeltaTime);
+
+		// Step the fleet by however many whole fixed steps of Clock are due after FrameDeltaTime (s) of (eg. wall clock) time,
+		// carrying the remainder over to the next call. The fleet only ever sees Clock's fixed step, so runs are reproducible.
+		//
+		// @return The number of steps taken
+		int Advance(float FrameDeltaTime);
+
+		// Seed every vehicle in the fleet, each from its own stream of the given seed (by index, so the fleet must be built in the same order).
+		void SetRandomSeed(uint64_t Seed);
+
+		// Hash of the complete dynamic state of every vehicle, in index order (see FVehicle::CalculateStateHash).
+		uint64_t CalculateStateHash() const;
+
+		// The fixed step clock used by Advance
+		FFixedStepClock Clock;
+
+		// Get the stats of all lockstep steps since the fleet was created (or the stats were reset).
+		const FLockstepStats& GetLockstepStats() const { return LockstepStats; };
+		void ResetLockstepStats() { LockstepStats = FLockstepStats(); };
+
+		// Set how the per-vehicle work is spread over threads (eg. FTaskPool::AsParallelFor()). Vehicles are stepped serially by default.
+		void SetParallelFor(FParallelFor InParallelFor) { ParallelFor = InParallelFor ? InParallelFor : FParallelFor(SerialFor); };
+
+		// Update the batched airframe of a vehicle, which is required if its FAirframeModel is changed after it has been added.
+		void RefreshAirframe(int Index) { AirframeBatch.SetAirframe(Index, Vehicles[Index].AirframeModel); };
+
+		int Num() const { return static_cast<int>(Vehicles.size()); };
+
+		FVehicle& GetVehicle(int Index) { return Vehicles[Index]; };
+		const FVehicle& GetVehicle(int Index) const { return Vehicles[Index]; };
+
+	private:
+		std::vector<FVehicle> Vehicles;
+		FAirframeBatch AirframeBatch;
+
+		FParallelFor ParallelFor = SerialFor;
+
+		FLockstepStats LockstepStats;
+	};
+}
@@ -0,0 +1,134 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cstdint>
+
+namespace SkyPhysCore
+{
+	// The models of a vehicle step which can be updated at a slower rate than the rigid body (which is integrated on every step).
+	enum class EScheduledModel : uint8_t
+	{
+		Turbulence,		// Turbulence filters
+		Actuators,		// Control surface and motor actuators (and so the propeller speeds)
+		Aerodynamics,	// Airframe and propulsion forces and moments
+		Num
+	};
+
+	// When a model last ran, as tracked by FMultiRateScheduler.
+	struct FScheduledModelClock
+	{
+		float ElapsedTime = 0.0f; // Since the latest update (s)
+		float DeltaTime = 0.0f; // Covered by the latest update (s)
+		int64_t NumUpdates = 0;
+		bool bStarted = false;
+		bool bDue = false;
+	};
+
+	// The dynamic state of an FMultiRateScheduler (trivially copyable). This doesn't include the periods, which are configuration, so
+	// restoring an older snapshot keeps the rates the scheduler has now.
+	struct FMultiRateSchedulerSnapshot
+	{
+		FScheduledModelClock Clocks[static_cast<int>(EScheduledModel::Num)];
+	};
+
+	// Runs each model of a vehicle step at its own period, on the steps of the rigid body (the base rate), so the CPU time goes to the dynamics
+	// which need it (eg. the turbulence changes on a ~0.1s scale, while fast servos need ~1kHz).
+	//
+	// A model is due on the step nearest to its period since it last ran (and always on the first step), and is then given the whole of the
+	// time since (so none is lost to the rounding, and the models which integrate, like the actuators and turbulence filters, cover the same
+	// time as the rigid body). In between, the owner of the model holds (or interpolates) its outputs. A period of 0 runs the model on
+	// every step, which is the same as not scheduling it at all.
+	class FMultiRateScheduler
+	{
+	public:
+		// Set the time between updates of a model (s), or 0 to update it on every step.
+		void SetPeriod(EScheduledModel Model, float Period) { Periods[static_cast<int>(Model)] = Period > 0.0f ? Period : 0.0f; };
+		float GetPeriod(EScheduledModel Model) const { return Periods[static_cast<int>(Model)]; };
+
+		// Whether any model runs slower than the base rate.
+		bool IsMultiRate() const
+		{
+			for (const float Period : Periods)
+			{
+				if (Period > 0.0f)
+				{
+					return true;
+				}
+			}
+			return false;
+		};
+
+		// Start a step of the base rate, and work out which models are due on it.
+		//
+		// @param DeltaTime: The step of the rigid body (s)
+		void Advance(float DeltaTime)
+		{
+			for (int i = 0; i < static_cast<int>(EScheduledModel::Num); i++)
+			{
+				FScheduledModelClock& Clock = Clocks[i];
+				Clock.ElapsedTime += DeltaTime;
+				Clock.bDue = !Clock.bStarted || (Clock.ElapsedTime + 0.5f * DeltaTime >= Periods[i]);
+
+				if (Clock.bDue)
+				{
+					Clock.DeltaTime = Clock.ElapsedTime;
+					Clock.ElapsedTime = 0.0f;
+					Clock.bStarted = true;
+					Clock.NumUpdates++;
+				}
+			}
+		};
+
+		// Whether a model is updated on the current step.
+		bool IsDue(EScheduledModel Model) const { return Clocks[static_cast<int>(Model)].bDue; };
+
+		// The time the latest update of a model covers, ie. since the update before it (s).
+		float GetDeltaTime(EScheduledModel Model) const { return Clocks[static_cast<int>(Model)].DeltaTime; };
+
+		// How far the current step is from the latest update of a model to the next one (0 on the step it updates, up to 1), for interpolating
+		// from its previous output to its latest. This is always 1 for a model updated on every step.
+		float GetInterpolationAlpha(EScheduledModel Model) const
+		{
+			const float Period = Periods[static_cast<int>(Model)];
+			if (Period <= 0.0f)
+			{
+				return 1.0f;
+			}
+			const float Alpha = Clocks[static_cast<int>(Model)].ElapsedTime / Period;
+			return Alpha < 1.0f ? Alpha : 1.0f;
+		};
+
+		// The number of updates of a model since the scheduler was reset.
+		int64_t GetNumUpdates(EScheduledModel Model) const { return Clocks[static_cast<int>(Model)].NumUpdates; };
+
+		// Forget when each model last ran (so they are all due on the next step), keeping their periods.
+		void Reset()
+		{
+			for (FScheduledModelClock& Clock : Clocks)
+			{
+				Clock = FScheduledModelClock();
+			}
+		};
+
+		// Save or restore when each model last ran. The periods are left as they are.
+		void SaveSnapshot(FMultiRateSchedulerSnapshot& Snapshot) const
+		{
+			for (int i = 0; i < static_cast<int>(EScheduledModel::Num); i++)
+			{
+				Snapshot.Clocks[i] = Clocks[i];
+			}
+		};
+		void RestoreSnapshot(const FMultiRateSchedulerSnapshot& Snapshot)
+		{
+			for (int i = 0; i < static_cast<int>(EScheduledModel::Num); i++)
+			{
+				Clocks[i] = Snapshot.Clocks[i];
+			}
+		};
+
+	private:
+		float Periods[static_cast<int>(EScheduledModel::Num)] = {}; // (s)
+		FScheduledModelClock Clocks[static_cast<int>(EScheduledModel::Num)];
+	};
+}
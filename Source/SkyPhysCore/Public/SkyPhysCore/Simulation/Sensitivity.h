@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "SkyPhysCore/Common/CoreTypes.h"
+#include "SkyPhysCore/Dynamics/RigidBodyModel.h"
+
+namespace SkyPhysCore
+{
+	class FVehicle;
+
+	// The model parameters to differentiate a step with respect to (as well as its state and inputs).
+	// Each enabled group adds its parameters to the columns of FStepSensitivity::ParameterJacobian, in the order listed here.
+	struct FSensitivityParameters
+	{
+		bool bMassProperties = false; // Mass, Ixx, Iyy, Izz and Ixz
+		bool bPropellers = false; // Cd and then Izz of each propeller, in propulsor order
+		bool bAerodynamicCoefficients = false; // Each of FAerodynamicCoefficients, in declaration order (CL0, CLAlpha, ..., Cnr)
+		bool bControlDerivatives = false; // Each of FAerodynamicControlDerivatives, in declaration order (CLde, ..., Cndr)
+	};
+
+	// The first order sensitivity of one step of a vehicle, x(k+1) = f(x(k), u(k), p), to its state, inputs and parameters:
+	// x(k+1) - NextState ~= StateJacobian * dx(k) + InputJacobian * du(k) + ParameterJacobian * dp
+	//
+	// States are (N, E, D, AttitudeX, AttitudeY, AttitudeZ, u, v, w, p, q, r), where the attitude is a small rotation vector in the body
+	// frame (ie. the perturbed attitude is Attitude * exp(dAttitude)), so there is no singularity.
+	// Inputs are as per FLinearModel (de, da, dr, omega_0, ..., omega_n-1), ie. the actuator outputs held over the step.
+	struct FStepSensitivity
+	{
+		enum EState { North, East, Down, AttitudeX, AttitudeY, AttitudeZ, U, V, W, P, Q, R, NumStates };
+
+		// The state after the step, in double. This matches the rigid body integration of FVehicle::Step (ie. ApplyForcesAndMoments with the
+		// vehicle's current actuator outputs, wind and density).
+		FRigidBodyStated NextState;
+
+		Eigen::MatrixXd StateJacobian;
+		Eigen::MatrixXd InputJacobian;
+		Eigen::MatrixXd ParameterJacobian;
+
+		// The number of evaluations of the step it took (each covers FDual::NumDirections of the states, inputs and parameters)
+		int NumEvaluations = 0;
+	};
+
+	// Differentiate one step of a vehicle from its current state, by evaluating the step in dual numbers (see Dual.h), so the derivatives are
+	// exact (for the model) rather than finite differences. The airframe aerodynamics, propellers (including their data interpolation) and rigid
+	// body integration (with the vehicle's IntegrationMethod) are all differentiated through, in double precision.
+	// As per FVehicle's intermediate stages, the actuator outputs, wind (including any turbulence) and air density are held over the step, so the
+	// actuator and turbulence dynamics aren't included.
+	//
+	// @param Vehicle: The vehicle, at the state to differentiate the step from
+	// @param DeltaTime: Time step (s)
+	// @param Parameters: The parameters to also differentiate with respect to
+	SKYPHYSCORE_API FStepSensitivity CalculateStepSensitivity(const FVehicle& Vehicle, float DeltaTime, const FSensitivityParameters& Parameters = FSensitivityParameters());
+}
@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <vector>
+
+#include "SkyPhysCore/Common/CoreTypes.h"
+#include "SkyPhysCore/Common/TaskPool.h"
+#include "SkyPhysCore/Actuation/PropellerModel.h"
+#include "SkyPhysCore/Actuation/PropulsorGeometry.h"
+#include "SkyPhysCore/Aerodynamics/AirframeModel.h"
+#include "SkyPhysCore/Dynamics/RigidBodyModel.h"
+
+namespace SkyPhysCore
+{
+	class FVehicle;
+
+	// A propulsor, as seen by the trim solver.
+	struct FTrimPropulsor
+	{
+		FPropellerModel Propeller;
+		FPropulsorGeometry Geometry;
+		float MaxSpeed = 0.0f; // Maximum propeller rotational speed (rad/s)
+	};
+
+	// The flight condition to trim for: steady, straight, wings level flight in still air.
+	struct FTrimCondition
+	{
+		float Airspeed = 0.0f; // (m/s). 0 trims for hover.
+		float FlightPathAngle = 0.0f; // Climb angle (rad, positive up)
+		float Rho = 1.225f; // Air density (kg/m^3), ie. the altitude
+	};
+
+	struct FTrimSettings
+	{
+		int MaxIterations = 100;
+		float Tolerance = 1.e-4f; // Trimmed once every residual (the accelerations, in m/s^2 and rad/s^2, and the climb rate error, in m/s) is within this
+	};
+
+	// Linear state space model about a trim point, d(x - X0)/dt = A * (x - X0) + B * (u - U0).
+	// States are (u, v, w, p, q, r, phi, theta, psi, N, E, D), with ZYX Euler angles (rad) from the world frame (NED) to the body frame (FRD).
+	// Inputs are (de, da, dr, omega_0, ..., omega_n-1), ie. the control surface deflections (rad) and then the propeller speeds (rad/s), so the
+	// actuator dynamics are not included.
+	struct FLinearModel
+	{
+		enum EState { U, V, W, P, Q, R, Phi, Theta, Psi, North, East, Down, NumStates };
+		enum EInput { Elevator, Aileron, Rudder, FirstPropulsor };
+
+		Eigen::MatrixXf A;
+		Eigen::MatrixXf B;
+		Eigen::VectorXf X0;
+		Eigen::VectorXf U0;
+	};
+
+	struct FTrimResult
+	{
+		bool bConverged = false;
+		int NumIterations = 0;
+		float Residual = 0.0f; // The largest residual at the solution
+
+		float alpha = 0.0f; // Angle of attack (rad)
+		float beta = 0.0f; // Sideslip angle (rad)
+
+		// The trimmed state (at the origin, with a heading of 0) and inputs
+		FRigidBodyState State;
+		FControlSurfaceDeflections Deflections;
+		std::vector<float> PropulsorSpeeds; // (rad/s)
+
+		// Linearisation about the trimmed state and inputs
+		FLinearModel LinearModel;
+	};
+
+	// Trims and linearises a vehicle's flight dynamics, using the analytic partial derivatives of the airframe and propeller models.
+	// Everything here is const, so the same model can be trimmed at many conditions concurrently (see TrimSweep).
+	class SKYPHYSCORE_API FTrimModel
+	{
+	public:
+		FTrimModel() {};
+
+		// Take the models of a vehicle. The control surface limits are the deflections at full command, and the propeller speed limits are
+		// the motor speeds at full command.
+		explicit FTrimModel(const FVehicle& Vehicle);
+
+		// Calculate the state derivative, and optionally its partial derivatives, in still air.
+		//
+		// @param X: State, as per FLinearModel
+		// @param U: Inputs, as per FLinearModel
+		// @param Rho: Air density (kg/m^3)
+		// @param XDot: Set to the state derivative
+		// @param A: If set, set to the partial derivatives of XDot with respect to X
+		// @param B: If set, set to the partial derivatives of XDot with respect to U
+		void CalculateDerivative(const Eigen::VectorXf& X, const Eigen::VectorXf& U, float Rho, Eigen::VectorXf& XDot, Eigen::MatrixXf* A = nullptr, Eigen::MatrixXf* B = nullptr) const;
+
+		// Linearise about any state and inputs (which needn't be trimmed).
+		FLinearModel Linearize(const Eigen::VectorXf& X0, const Eigen::VectorXf& U0, float Rho) const;
+
+		// Solve for the state and inputs which hold the given flight condition (Levenberg-Marquardt), and linearise about them.
+		// The unknowns are the angle of attack, sideslip, pitch attitude, control surface deflections and propeller speeds, held within
+		// their limits. Any which the airframe doesn't have (or which have no limit set) are held at 0.
+		FTrimResult Trim(const FTrimCondition& Condition, const FTrimSettings& Settings = FTrimSettings()) const;
+
+		// Trim at many conditions (eg. an envelope of airspeeds and altitudes), running the conditions in parallel.
+		//
+		// @param ParallelFor: How to run the conditions (eg. FTaskPool::AsParallelFor(), or ParallelFor in Unreal)
+		std::vector<FTrimResult> TrimSweep(const std::vector<FTrimCondition>& Conditions, const FTrimSettings& Settings = FTrimSettings(), const FParallelFor& ParallelFor = SerialFor) const;
+
+		int NumInputs() const { return FLinearModel::FirstPropulsor + static_cast<int>(Propulsors.size()); };
+
+		// Models
+		FMassProperties MassProperties;
+		FAirframeModel AirframeModel;
+		std::vector<FTrimPropulsor> Propulsors;
+
+		FVector3 Gravity = FVector3(0.0f, 0.0f, 9.81f); // (m/s^2)
+
+		// Control surface limits (rad)
+		float MaxElevator = 0.0f;
+		float MaxAileron = 0.0f;
+		float MaxRudder = 0.0f;
+	};
+}
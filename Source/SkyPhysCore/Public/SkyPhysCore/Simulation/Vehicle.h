@@ -0,0 +1,179 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <vector>
+
+#include "SkyPhysCore/Common/CoreTypes.h"
+#include "SkyPhysCore/Actuation/ActuatorModel.h"
+#include "SkyPhysCore/Actuation/PropellerModel.h"
+#include "SkyPhysCore/Actuation/PropulsorGeometry.h"
+#include "SkyPhysCore/Actuation/RotorBank.h"
+#include "SkyPhysCore/Aerodynamics/AirframeModel.h"
+#include "SkyPhysCore/Dynamics/RigidBodyModel.h"
+#include "SkyPhysCore/Simulation/AdaptiveStep.h"
+#include "SkyPhysCore/Simulation/MultiRateScheduler.h"
+#include "SkyPhysCore/Simulation/VehicleSnapshot.h"
+#include "SkyPhysCore/Turbulence/DrydenModel.h"
+
+namespace SkyPhysCore
+{
+	struct FPropulsor
+	{
+		FPropellerModel Propeller;
+		FActuatorModel Motor; // Outputs propeller speed (RPM). A feedthrough actuator with a DCGain of the max speed (RPM) gives no dynamics.
+		FPropulsorGeometry Geometry;
+
+		float Command = 0.0f; // Unitless command (0 -> 1)
+	};
+
+	struct FControlSurface
+	{
+		FActuatorModel Actuator; // Outputs deflection (rad). A feedthrough actuator with a DCGain of the max deflection (rad) gives no dynamics.
+
+		float Command = 0.0f; // Unitless command (-1 -> 1)
+	};
+
+	struct FAtmosphericConditionsState
+	{
+		FVector3 VwLowAltitude = FVector3::Zero(); // Low altitude wind speed (m/s) in world frame
+		FVector3 Vw = FVector3::Zero(); // Wind speed (m/s) in world frame
+		float rho = 1.225f; // Air density (kg/m^3) at current altitude
+	};
+
+	// A complete, engine-independent 6-DoF vehicle, which can be stepped headless.
+	// This follows the same substep process as AFlyingPawn, except that the rigid body is integrated here (including gravity) instead of by PhysX.
+	// Once built, nothing in a step (Step, StepAdaptive, UpdateState / ApplyForcesAndMoments, or saving and restoring a snapshot) allocates
+	// on the heap, so any number of vehicles can be stepped without touching the allocator. See FAllocationTracker for how this is checked.
+	class SKYPHYSCORE_API FVehicle
+	{
+	public:
+		// Step the vehicle forward by DeltaTime (s)
+		void Step(float DeltaTime);
+
+		// Step the vehicle forward by DeltaTime (s), split into as many steps as StepController chooses (within its bounds), based on
+		// the error estimate and stiffness of this vehicle. Benign flight takes few, large steps and aggressive flight many small ones.
+		//
+		// @return The number of steps taken
+		int StepAdaptive(float DeltaTime);
+
+		// Get the fastest characteristic rate (ie. the inverse of the fastest time constant) of this vehicle at its current state (1/s).
+		// This covers the airframe aerodynamics, actuators, turbulence filters and propeller gyroscopic coupling.
+		float CalculateMaxCharacteristicRate() const;
+
+		// The two halves of Step, so that the airframe aerodynamics can be evaluated elsewhere (eg. in a batch by FFleet).
+		// Step(DeltaTime) is equivalent to:
+		//		UpdateState(DeltaTime);
+		//		ApplyForcesAndMoments(AirframeModel.CalculateForcesAndMoments(...), DeltaTime);
+
+		// Start a step (advancing the Scheduler), and update the atmospheric, airspeed and actuator states ahead of calculating any forces and moments.
+		void UpdateState(float DeltaTime);
+
+		// Add the propulsion forces and moments to the given airframe forces and moments, and integrate the rigid body.
+		// With a multi-stage IntegrationMethod, the airframe and propulsion are evaluated again (by this vehicle) at each intermediate stage.
+		// If the aerodynamics aren't due on this step (see Scheduler), the given forces and moments are ignored, and those of the latest
+		// update are held over the whole step instead.
+		//
+		// @param AirframeForcesAndMoments: Airframe forces and moments at the CoG, in the body frame (N, Nm)
+		// @param DeltaTime: Time step (s)
+		void ApplyForcesAndMoments(const FForcesAndMoments& AirframeForcesAndMoments, float DeltaTime);
+
+		// Set the control surface commands (expected Values of -1 -> 1)
+		void SetControlSurfaceCommands(float ElevatorCommand, float AileronCommand, float RudderCommand);
+
+		// Set the command of a single propulsor (expected Value of 0 -> 1)
+		void SetPropulsorCommand(int PropulsorIndex, float Command);
+
+		// Seed every random element of the vehicle (ie. the turbulence), each from its own stream of the given seed.
+		void SetRandomSeed(uint64_t Seed);
+
+		// Hash of the complete dynamic state of the vehicle (rigid body, actuators, propellers, wind and turbulence), which matches
+		// between two runs only if they are bit-identical.
+		uint64_t CalculateStateHash() const;
+
+		// Save the complete dynamic state of the vehicle.
+		//
+		// @return False (leaving the snapshot incomplete) if the vehicle has more propulsors than a snapshot can hold
+		bool SaveSnapshot(FVehicleSnapshot& Snapshot) const;
+
+		// Restore the complete dynamic state of the vehicle, from a snapshot saved from this vehicle (or one built the same way).
+		// The adaptive step controller's error history is reset, as it doesn't carry over a jump in state.
+		//
+		// @return False (leaving the vehicle unchanged) if the snapshot has a different number of propulsors to this vehicle
+		bool RestoreSnapshot(const FVehicleSnapshot& Snapshot);
+
+		// Add the complete dynamic state of the vehicle to a state hash (eg. to combine many vehicles into one hash).
+		void AddToHash(FStateHash& Hash) const;
+
+		// Models
+		FRigidBodyModel RigidBodyModel;
+		FAirframeModel AirframeModel;
+		std::vector<FPropulsor> Propulsors;
+		FControlSurface Elevator;
+		FControlSurface Aileron;
+		FControlSurface Rudder;
+
+		// How the rigid body is integrated. The higher order methods re-evaluate the forces and moments at intermediate stages, so cost more per step,
+		// but allow a much larger step for the same accuracy. The actuators, wind and density are held over each step.
+		EIntegrationMethod IntegrationMethod = EIntegrationMethod::SemiImplicitEuler;
+
+		// Chooses the step sizes for StepAdaptive
+		FAdaptiveStepController StepController;
+
+		// Runs the turbulence, actuators and aerodynamics at their own periods (every step by default). In between updates, the actuator
+		// outputs and the forces and moments are held, and the turbulence is either held or interpolated (bInterpolateTurbulence).
+		FMultiRateScheduler Scheduler;
+
+		// Interpolate the turbulence between its updates, rather than holding it. This delays the turbulence by one period.
+		bool bInterpolateTurbulence = false;
+
+		bool bEnableTurbulenceModel = false;
+		FDrydenTurbulenceModel TurbulenceModel;
+
+		// Environment (world frame, NED)
+		FVector3 SteadyWind = FVector3::Zero(); // (m/s)
+		FVector3 Gravity = FVector3(0.0f, 0.0f, 9.81f); // (m/s^2)
+
+		// State
+		FRigidBodyState RigidBodyState;
+		FAirspeedState AirspeedState;
+		FAtmosphericConditionsState AtmosphericConditionsState;
+		FControlSurfaceDeflections ControlSurfaceDeflections;
+
+	private:
+		// Forces and moments (body frame, at the CoG) of the first stage of the last step, which feed the step controller's error estimate.
+		// These are also the forces and moments held between updates of the aerodynamics.
+		FForcesAndMoments StepStartForcesAndMoments;
+
+		// The previous and latest turbulence updates (body frame, m/s), held or interpolated in between.
+		FVector3 PreviousTurbulence = FVector3::Zero();
+		FVector3 LatestTurbulence = FVector3::Zero();
+
+		// The propellers of all the propulsors, evaluated together (see FRotorBank). This is refreshed from the propulsors at the start of
+		// each step (with the propeller speeds held over the step), so the propulsors can still be changed freely between steps.
+		FRotorBank RotorBank;
+
+		// Update our wind speed (in the world frame), and our density. As well as any other atmospheric parameters (the turbulence only if it is due).
+		void UpdateAtmosphericConditionsState();
+
+		// Update airspeed parameters
+		void UpdateAirspeedState();
+
+		// Update the current actuator state (based on the current actuator commands), if the actuators are due
+		void UpdateActuatorState();
+
+		// Refresh the rotor bank from the propulsors (resizing it only if the number of propulsors has changed)
+		void UpdateRotorBank();
+
+		// Calculate the Propulsion Forces and Moments
+		//
+		// @param State: The rigid body state to evaluate the propulsion at
+		// @param Vwb: Wind velocity in the body frame (m/s)
+		//
+		// @return The forces and moments generated by all propulsion elements, to be applied at the CoG, expressed in the body frame.
+		FForcesAndMoments CalculatePropulsionForcesAndMoments(const FRigidBodyState& State, const FVector3& Vwb);
+
+		// Calculate the airframe and propulsion forces and moments at an intermediate integration stage (with the actuators, wind and density held).
+		FForcesAndMoments CalculateStageForcesAndMoments(const FRigidBodyState& Stage);
+	};
+}
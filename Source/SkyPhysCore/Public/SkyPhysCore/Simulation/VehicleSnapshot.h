@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "SkyPhysCore/Common/Snapshot.h"
+#include "SkyPhysCore/Actuation/ActuatorModel.h"
+#include "SkyPhysCore/Simulation/MultiRateScheduler.h"
+#include "SkyPhysCore/Turbulence/DrydenModel.h"
+
+namespace SkyPhysCore
+{
+	struct FPropulsorSnapshot
+	{
+		FActuatorSnapshot Motor;
+		float omega; // Propeller rotational speed (rad/s)
+		float Command;
+	};
+
+	// The complete dynamic state of an FVehicle (ie. everything which changes as it is stepped), in one contiguous, trivially copyable
+	// block. Saving or restoring one is a handful of copies, so thousands of branches can be forked from the same point (and copied
+	// around with memcpy). The parameters of the models aren't included, so a snapshot can only be restored to a vehicle built the
+	// same way as the one it was saved from.
+	struct FVehicleSnapshot
+	{
+		static constexpr int MaxPropulsors = 8;
+
+		// Rigid body (world frame NED, body frame FRD)
+		FSnapshotVector3 Position;
+		FSnapshotQuaternion Attitude;
+		FSnapshotVector3 Vb;
+		FSnapshotVector3 Omegab;
+
+		// Atmosphere and airspeed
+		FSnapshotVector3 VwLowAltitude;
+		FSnapshotVector3 Vw;
+		float rho;
+		FSnapshotVector3 Vwb;
+		FSnapshotVector3 Vab;
+		float Va;
+		float alpha;
+		float beta;
+
+		// Control surfaces
+		FActuatorSnapshot Elevator;
+		FActuatorSnapshot Aileron;
+		FActuatorSnapshot Rudder;
+		float ElevatorCommand;
+		float AileronCommand;
+		float RudderCommand;
+		float de;
+		float da;
+		float dr;
+
+		// Propulsion
+		int32_t NumPropulsors;
+		FPropulsorSnapshot Propulsors[MaxPropulsors];
+
+		// Turbulence (including the random streams)
+		FDrydenFilterSnapshot Hu;
+		FDrydenFilterSnapshot Hv;
+		FDrydenFilterSnapshot Hw;
+
+		// Multi-rate scheduling (when each model last ran, but not the periods), and the outputs held in between
+		FMultiRateSchedulerSnapshot Scheduler;
+		FSnapshotVector3 PreviousTurbulence;
+		FSnapshotVector3 LatestTurbulence;
+		FSnapshotVector3 HeldForces;
+		FSnapshotVector3 HeldMoments;
+	};
+
+	static_assert(std::is_trivially_copyable<FVehicleSnapshot>::value, "FVehicleSnapshot must stay memcpy-able");
+}
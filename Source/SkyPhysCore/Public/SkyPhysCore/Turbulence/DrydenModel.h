@@ -0,0 +1,134 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cstdint>
+
+#include "SkyPhysCore/Common/CoreTypes.h"
+#include "SkyPhysCore/Common/Integrator.h"
+#include "SkyPhysCore/Common/RandomStream.h"
+#include "SkyPhysCore/Common/StateHash.h"
+
+namespace SkyPhysCore
+{
+	// The body axis which a Dryden transfer function is filtering for.
+	enum class EDrydenAxis : uint8_t
+	{
+		U,	// Hu(s), body i axis (u velocity)
+		V,	// Hv(s), body j axis (v velocity)
+		W	// Hw(s), body k axis (w velocity)
+	};
+
+	// The complete dynamic state of an FDrydenFilter, including its random stream (trivially copyable)
+	struct FDrydenFilterSnapshot
+	{
+		FRandomStream WhiteNoise;
+		Integrator Integrator1;
+		Integrator Integrator2;
+		uint64_t Seed;
+		uint64_t NumSamples;
+		bool IsInitialized;
+	};
+
+	// Dryden model transfer function for a single body axis (Imperial Units).
+	class SKYPHYSCORE_API FDrydenFilter
+	{
+	public:
+		FDrydenFilter() {};
+		FDrydenFilter(EDrydenAxis Axis, uint64_t Seed, float Ts, EFilterIntegrationMethod IntegrationMethod = EFilterIntegrationMethod::Trapezoidal)
+			: Axis(Axis), Seed(Seed), Ts(Ts), IntegrationMethod(IntegrationMethod) {};
+
+		// Get the next turbulence sample (ft/s)
+		//
+		// @param Va: Airspeed (ft/s)
+		// @param Dt: Time since the last sample (s)
+		// @param L: Turbulence scale length (ft)
+		// @param Sigma: Turbulence RMS intensity (ft/s)
+		float GetTurbulence(float Va, float Dt, float L, float Sigma);
+
+		// Set the seed of the white noise, and restart the filter (so the same seed always gives the same turbulence from here on).
+		void SetSeed(uint64_t InSeed);
+
+		// Save or restore the complete dynamic state of the filter (so the turbulence continues exactly as it would have from the save).
+		void SaveSnapshot(FDrydenFilterSnapshot& Snapshot) const;
+		void RestoreSnapshot(const FDrydenFilterSnapshot& Snapshot);
+
+		// Add the filter state (noise stream and integrators) to a state hash.
+		void AddToHash(FStateHash& Hash) const;
+
+		EFilterIntegrationMethod GetIntegrationMethod() const { return IntegrationMethod; };
+
+	private:
+		void Initialize();
+
+		// Perform the actual filtering step (to provide the turbulence value).
+		float Filter(float Dt, float Va, float L, float Sigma, float Noise);
+		float FilterHu(float Dt, float Va, float L, float Sigma, float Noise);
+		float FilterHvHw(float Dt, float Va, float L, float Sigma, float Noise);
+		float FilterHuExponential(float Dt, float Va, float L, float Sigma, float Noise);
+		float FilterHvHwExponential(float Dt, float Va, float L, float Sigma, float Noise);
+
+		EDrydenAxis Axis = EDrydenAxis::U;
+		uint64_t Seed = 0;
+		float Ts = 0.0f; // Sample Time (s)
+
+		// Trapezoidal takes one step of Ts, then extrapolates over the rest of Dt. Exponential solves it exactly for each noise sample held
+		// over Dt, in O(1), and scales the noise to Dt (rather than Ts) so the turbulence has the same spectrum at any frame rate.
+		EFilterIntegrationMethod IntegrationMethod = EFilterIntegrationMethod::Trapezoidal;
+
+		bool IsInitialized = false;
+		FRandomStream WhiteNoise;
+		uint64_t NumSamples = 0;
+
+		// Hu only makes use of the first integrator
+		Integrator Integrator1;
+		Integrator Integrator2;
+	};
+
+	// Dryden turbulence model for low altitude flight (as per MIL-F-8785C).
+	class SKYPHYSCORE_API FDrydenTurbulenceModel
+	{
+	public:
+		// Get the turbulence velocity in the body frame (m/s).
+		//
+		// @param Dt: Time since the last sample (s)
+		// @param Va: Airspeed (m/s)
+		// @param Altitude: Altitude (m)
+		// @param WindSpeed: Low altitude wind speed (m/s)
+		FVector3 GetTurbulenceBodyFrame(float Dt, float Va, float Altitude, float WindSpeed);
+
+		// Takes in altitude and returns (L_ug, L_vg, L_wg)
+		// Note: Assumes only low altitude flight (ie. <300m/1000ft)
+		// Altitude in ft
+		static FVector3 GetTurbulenceScaleLengths(float Altitude);
+
+		// Takes in altitude and airspeed at 20ft (ie. steady airspeed) and returns turbulence intensities (sigma_ug, sigma_vg, sigma_wg)
+		// Note: Assumes only low altitude flight (ie. <300m/1000ft)
+		// Altitude in ft
+		// WindSpeed20Ft in ft/s
+		static FVector3 GetTurbulenceRMSIntensities(float Altitude, float WindSpeed20Ft);
+
+		// Get the fastest rate of the turbulence filters (ie. airspeed over the shortest scale length) (1/s).
+		//
+		// @param Va: Airspeed (m/s)
+		// @param Altitude: Altitude (m)
+		static float CalculateCharacteristicRate(float Va, float Altitude);
+
+		// Get the fastest rate of the enabled filters which limit the step size (ie. 0 if they are all exponential) (1/s).
+		//
+		// @param Va: Airspeed (m/s)
+		// @param Altitude: Altitude (m)
+		float GetCharacteristicRate(float Va, float Altitude) const;
+
+		// Seed all three filters, from independent streams of the given seed.
+		void SetSeed(uint64_t Seed);
+
+		FDrydenFilter Hu;
+		FDrydenFilter Hv;
+		FDrydenFilter Hw;
+
+		bool bEnableHu = true;
+		bool bEnableHv = true;
+		bool bEnableHw = true;
+	};
+}
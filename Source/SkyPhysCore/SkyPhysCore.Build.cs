@@ -0,0 +1,34 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using System.IO;
+using UnrealBuildTool;
+
+public class SkyPhysCore : ModuleRules
+{
+	public SkyPhysCore(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		// The core is C++17 (eg. inline variables and aligned new), as per its CMake target, rather than UE4's default of C++14.
+		CppStandard = CppStandardVersion.Cpp17;
+
+		// This module is intentionally engine-independent (pure C++/Eigen), so that it can also be built with the plain CMake target
+		// alongside it (see CMakeLists.txt) for headless simulation. Only the module boilerplate depends on Core.
+		PublicIncludePaths.AddRange(
+			new string[]
+			{
+				Path.Combine(ModuleDirectory, "Dependencies"),
+				// ... add public include paths required here ...
+			}
+			);
+
+
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				// ... add other public dependencies that you statically link with here ...
+			}
+			);
+	}
+}
@@ -0,0 +1,264 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// Steps each vehicle type until it has settled (any lazily sized buffers have grown), then counts the heap allocations of a number
+// of further steps. Prints the bytes and allocations per step per vehicle, and fails (non-zero exit code) if any steady state step allocated.
+// Eigen's own allocations (which go to malloc, not operator new) are forbidden during the measured steps, so any of those aborts the report.
+
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "SkyPhysCore/Common/AllocationTracker.h"
+#include "SkyPhysCore/Simulation/Fleet.h"
+#include "SkyPhysCore/Simulation/Vehicle.h"
+
+#if !defined(EIGEN_RUNTIME_NO_MALLOC)
+	#error "The allocation report needs EIGEN_RUNTIME_NO_MALLOC (and Eigen's asserts), as set by its CMakeLists.txt, in the core as well as here"
+#endif
+
+SKYPHYSCORE_TRACK_ALLOCATIONS()
+
+using namespace SkyPhysCore;
+
+namespace
+{
+	const float DeltaTime = 0.002f; // (s)
+	const int NumWarmUpSteps = 100;
+	const int NumMeasuredSteps = 1000;
+
+	FPropellerParameters MakePropellerParameters()
+	{
+		FPropellerParameters Parameters;
+		Parameters.D = 0.25f;
+		Parameters.Izz = 1.e-5f;
+
+		FConstantSpeedPropellerData Low;
+		Low.n = 3000.0f;
+		Low.J = { 0.0f, 0.5f, 1.0f };
+		Low.CT = { 0.11f, 0.07f, 0.0f };
+		Low.CP = { 0.05f, 0.04f, 0.01f };
+
+		FConstantSpeedPropellerData High = Low;
+		High.n = 6000.0f;
+		High.CT = { 0.1f, 0.06f, 0.0f };
+
+		Parameters.ConstantSpeedData = { Low, High };
+		return Parameters;
+	}
+
+	FVehicle MakeQuadcopter()
+	{
+		FVehicle Vehicle;
+		FMassProperties& MassProperties = Vehicle.RigidBodyModel.MassProperties;
+		MassProperties.Mass = 1.0f;
+		MassProperties.Ixx = 0.01f;
+		MassProperties.Iyy = 0.01f;
+		MassProperties.Izz = 0.02f;
+		MassProperties.PreCalculate();
+
+		Vehicle.AirframeModel.Configuration = EAirframeConfiguration::MultiRotor;
+		Vehicle.AirframeModel.Geometry.A = FVector3(0.05f, 0.05f, 0.1f);
+		Vehicle.AirframeModel.Coefficients.CD.CD0 = 0.5f;
+
+		// All four propellers are the same type, so share one table.
+		FPropellerParameters PropellerParameters = MakePropellerParameters();
+		const std::shared_ptr<const FPropellerTable> PropellerTable = std::make_shared<const FPropellerTable>(PropellerParameters.ConstantSpeedData);
+		for (int i = 0; i < 4; i++)
+		{
+			FActuatorParameters MotorParameters;
+			MotorParameters.Type = EActuatorModelType::FirstOrder;
+			MotorParameters.wn = 30.0f;
+			MotorParameters.DCGain = 8000.0f;
+
+			FPropulsor Propulsor;
+			Propulsor.Propeller = FPropellerModel(PropellerParameters, PropellerTable);
+			Propulsor.Motor = FActuatorModel(MotorParameters);
+			Propulsor.Geometry.Position = FVector3(i < 2 ? 0.2f : -0.2f, i % 2 ? 0.2f : -0.2f, 0.0f);
+			Vehicle.Propulsors.push_back(Propulsor);
+
+			PropellerParameters.RotationDirection *= -1.0f;
+		}
+
+		Vehicle.RigidBodyState.Position = FVector3(0.0f, 0.0f, -50.0f);
+		for (int i = 0; i < 4; i++)
+		{
+			Vehicle.SetPropulsorCommand(i, 0.6f);
+		}
+		return Vehicle;
+	}
+
+	FVehicle MakeFixedWing()
+	{
+		FVehicle Vehicle;
+		FMassProperties& MassProperties = Vehicle.RigidBodyModel.MassProperties;
+		MassProperties.Mass = 2.0f;
+		MassProperties.Ixx = 0.1f;
+		MassProperties.Iyy = 0.2f;
+		MassProperties.Izz = 0.3f;
+		MassProperties.Ixz = 0.01f;
+		MassProperties.PreCalculate();
+
+		FAirframeModel& Airframe = Vehicle.AirframeModel;
+		Airframe.Configuration = EAirframeConfiguration::Standard;
+		Airframe.Geometry.b = 1.5f;
+		Airframe.Geometry.c = 0.2f;
+		Airframe.Geometry.A = FVector3(0.3f, 0.3f, 0.3f);
+		Airframe.Coefficients.CL.CL0 = 0.2f;
+		Airframe.Coefficients.CL.CLAlpha = 4.5f;
+		Airframe.Coefficients.CL.CLq = 3.0f;
+		Airframe.Coefficients.CD.CD0 = 0.03f;
+		Airframe.Coefficients.CD.CDAlpha2 = 0.5f;
+		Airframe.Coefficients.CY.CYBeta = -0.3f;
+		Airframe.Coefficients.CI.CIp = -0.5f;
+		Airframe.Coefficients.Cm.Cm0 = 0.02f;
+		Airframe.Coefficients.Cm.CmAlpha = -0.8f;
+		Airframe.Coefficients.Cm.Cmq = -10.0f;
+		Airframe.Coefficients.Cn.CnBeta = 0.1f;
+		Airframe.Coefficients.Cn.Cnr = -0.1f;
+		Airframe.ControlDerivatives.Cmde = -0.5f;
+		Airframe.ControlDerivatives.CIda = 0.1f;
+		Airframe.ControlDerivatives.Cndr = -0.05f;
+		Airframe.StallParameters.bEnableStallModel = true;
+		Airframe.StallParameters.Alpha0 = 0.3f;
+		Airframe.StallParameters.M = 50.0f;
+		Airframe.StallParameters.Cmfp = -0.5f;
+
+		FActuatorParameters ServoParameters;
+		ServoParameters.Type = EActuatorModelType::SecondOrder;
+		ServoParameters.wn = 40.0f;
+		ServoParameters.zeta = 0.7f;
+		ServoParameters.DCGain = 0.3f;
+		ServoParameters.RateLimit = 5.0f;
+		Vehicle.Elevator.Actuator = FActuatorModel(ServoParameters);
+		Vehicle.Aileron.Actuator = FActuatorModel(ServoParameters);
+		Vehicle.Rudder.Actuator = FActuatorModel(ServoParameters);
+
+		FActuatorParameters MotorParameters;
+		MotorParameters.Type = EActuatorModelType::FirstOrder;
+		MotorParameters.wn = 20.0f;
+		MotorParameters.DCGain = 6000.0f;
+
+		FPropulsor Propulsor;
+		Propulsor.Propeller = FPropellerModel(MakePropellerParameters());
+		Propulsor.Motor = FActuatorModel(MotorParameters);
+		Propulsor.Geometry.Position = FVector3(0.3f, 0.0f, 0.0f);
+		Propulsor.Geometry.Rotation = Eigen::AngleAxisf(-0.5f * static_cast<float>(EIGEN_PI), FVector3::UnitY()).toRotationMatrix(); // Thrust (-Z) forwards
+		Vehicle.Propulsors.push_back(Propulsor);
+
+		Vehicle.RigidBodyState.Position = FVector3(0.0f, 0.0f, -100.0f);
+		Vehicle.RigidBodyState.Vb = FVector3(15.0f, 0.3f, 1.0f);
+		Vehicle.SetControlSurfaceCommands(0.1f, 0.05f, -0.05f);
+		Vehicle.SetPropulsorCommand(0, 0.5f);
+		return Vehicle;
+	}
+
+	struct FReportCase
+	{
+		std::string Name;
+		int NumVehicles = 1;
+		std::function<void()> Step;
+	};
+
+	// @return Whether the case made no allocations in its measured steps
+	bool RunCase(const FReportCase& Case)
+	{
+		for (int i = 0; i < NumWarmUpSteps; i++)
+		{
+			Case.Step();
+		}
+
+		const FAllocationCounts Start = FAllocationTracker::GetCounts();
+		Eigen::internal::set_is_malloc_allowed(false);
+		for (int i = 0; i < NumMeasuredSteps; i++)
+		{
+			Case.Step();
+		}
+		Eigen::internal::set_is_malloc_allowed(true);
+		const FAllocationCounts Counts = FAllocationTracker::GetCounts() - Start;
+
+		const double NumVehicleSteps = static_cast<double>(NumMeasuredSteps) * Case.NumVehicles;
+		std::printf("%-32s %14.2f %20.4f\n", Case.Name.c_str(), Counts.NumBytes / NumVehicleSteps, Counts.NumAllocations / NumVehicleSteps);
+		return Counts.NumAllocations == 0;
+	}
+}
+
+int main()
+{
+	if (!FAllocationTracker::IsTracking())
+	{
+		std::printf("Allocation tracking is not enabled\n");
+		return 1;
+	}
+
+	FVehicle Quadcopter = MakeQuadcopter();
+
+	FVehicle FixedWing = MakeFixedWing();
+
+	FVehicle TurbulentFixedWing = MakeFixedWing();
+	TurbulentFixedWing.bEnableTurbulenceModel = true;
+	TurbulentFixedWing.TurbulenceModel.Hu = FDrydenFilter(EDrydenAxis::U, 0, DeltaTime);
+	TurbulentFixedWing.TurbulenceModel.Hv = FDrydenFilter(EDrydenAxis::V, 0, DeltaTime);
+	TurbulentFixedWing.TurbulenceModel.Hw = FDrydenFilter(EDrydenAxis::W, 0, DeltaTime);
+	TurbulentFixedWing.SteadyWind = FVector3(3.0f, -2.0f, 0.0f);
+	TurbulentFixedWing.SetRandomSeed(1);
+
+	FVehicle MultiRateFixedWing = MakeFixedWing();
+	MultiRateFixedWing.bEnableTurbulenceModel = true;
+	MultiRateFixedWing.TurbulenceModel = TurbulentFixedWing.TurbulenceModel;
+	MultiRateFixedWing.Scheduler.SetPeriod(EScheduledModel::Turbulence, 0.1f);
+	MultiRateFixedWing.Scheduler.SetPeriod(EScheduledModel::Aerodynamics, 2.0f * DeltaTime);
+	MultiRateFixedWing.bInterpolateTurbulence = true;
+
+	FVehicle RK4FixedWing = MakeFixedWing();
+	RK4FixedWing.IntegrationMethod = EIntegrationMethod::RK4;
+
+	FVehicle AdaptiveFixedWing = MakeFixedWing();
+	AdaptiveFixedWing.IntegrationMethod = EIntegrationMethod::Heun;
+
+	FVehicleSnapshot Snapshot;
+
+	const int FleetSize = 64;
+	FFleet Fleet;
+	FFleet ParallelFleet;
+	for (int i = 0; i < FleetSize; i++)
+	{
+		Fleet.AddVehicle(i % 2 ? MakeFixedWing() : MakeQuadcopter());
+		ParallelFleet.AddVehicle(i % 2 ? MakeFixedWing() : MakeQuadcopter());
+	}
+
+	// The workers' allocations are counted too (the counts are for the whole process), and they're idle in between the steps.
+	FTaskPool TaskPool(3);
+	ParallelFleet.SetParallelFor(TaskPool.AsParallelFor());
+
+	const std::vector<FReportCase> Cases =
+	{
+		{ "Quadcopter", 1, [&]() { Quadcopter.Step(DeltaTime); } },
+		{ "Fixed wing", 1, [&]() { FixedWing.Step(DeltaTime); } },
+		{ "Fixed wing (turbulence)", 1, [&]() { TurbulentFixedWing.Step(DeltaTime); } },
+		{ "Fixed wing (multi-rate)", 1, [&]() { MultiRateFixedWing.Step(DeltaTime); } },
+		{ "Fixed wing (RK4)", 1, [&]() { RK4FixedWing.Step(DeltaTime); } },
+		{ "Fixed wing (adaptive Heun)", 1, [&]() { AdaptiveFixedWing.StepAdaptive(5.0f * DeltaTime); } },
+		{ "Fixed wing (snapshot/restore)", 1, [&]() { FixedWing.SaveSnapshot(Snapshot); FixedWing.Step(DeltaTime); FixedWing.RestoreSnapshot(Snapshot); } },
+		{ "Fleet", FleetSize, [&]() { Fleet.Step(DeltaTime); } },
+		{ "Fleet (task pool)", FleetSize, [&]() { ParallelFleet.Step(DeltaTime); } },
+	};
+
+	std::printf("%-32s %14s %20s\n", "Vehicle", "Bytes/step", "Allocations/step");
+
+	bool bAllocationFree = true;
+	for (const FReportCase& Case : Cases)
+	{
+		bAllocationFree &= RunCase(Case);
+	}
+
+	if (!bAllocationFree)
+	{
+		std::printf("FAILED: steady state steps allocated\n");
+		return 1;
+	}
+	return 0;
+}
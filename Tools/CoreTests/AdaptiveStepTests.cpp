@@ -0,0 +1,231 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// Adaptive step size control, of the controller on its own and of FVehicle::StepAdaptive.
+
+#include "TestHarness.h"
+
+#include "SkyPhysCore/Simulation/AdaptiveStep.h"
+#include "SkyPhysCore/Simulation/Vehicle.h"
+
+using namespace SkyPhysCore;
+
+namespace
+{
+	FPropellerParameters MakePropellerParameters()
+	{
+		FPropellerParameters Parameters;
+		Parameters.D = 0.25f;
+		Parameters.Izz = 1.e-4f;
+		Parameters.Cd = 0.05f;
+
+		FConstantSpeedPropellerData Low;
+		Low.n = 4000.0f;
+		Low.J = { 0.0f, 0.4f, 0.8f, 1.2f };
+		Low.CT = { 0.12f, 0.1f, 0.05f, -0.02f };
+		Low.CP = { 0.05f, 0.05f, 0.035f, 0.01f };
+
+		FConstantSpeedPropellerData High = Low;
+		High.n = 9000.0f;
+		High.CT = { 0.13f, 0.11f, 0.06f, -0.01f };
+		High.CP = { 0.055f, 0.052f, 0.04f, 0.015f };
+
+		Parameters.ConstantSpeedData = { Low, High };
+		return Parameters;
+	}
+
+	// A fixed wing in steady cruise, integrated with Heun's method.
+	FVehicle MakeFixedWing()
+	{
+		FVehicle Vehicle;
+		FMassProperties& MassProperties = Vehicle.RigidBodyModel.MassProperties;
+		MassProperties.Mass = 2.0f;
+		MassProperties.Ixx = 0.1f;
+		MassProperties.Iyy = 0.2f;
+		MassProperties.Izz = 0.3f;
+		MassProperties.Ixz = 0.01f;
+		MassProperties.PreCalculate();
+
+		FAirframeModel& Airframe = Vehicle.AirframeModel;
+		Airframe.Geometry.b = 1.5f;
+		Airframe.Geometry.c = 0.2f;
+		Airframe.Geometry.A = FVector3(0.3f, 0.3f, 0.3f);
+		Airframe.Coefficients.CL.CL0 = 0.2f;
+		Airframe.Coefficients.CL.CLAlpha = 4.5f;
+		Airframe.Coefficients.CL.CLq = 3.0f;
+		Airframe.Coefficients.CD.CD0 = 0.03f;
+		Airframe.Coefficients.CD.CDAlpha2 = 0.5f;
+		Airframe.Coefficients.CY.CYBeta = -0.3f;
+		Airframe.Coefficients.CI.CIp = -0.5f;
+		Airframe.Coefficients.CI.CIBeta = -0.05f;
+		Airframe.Coefficients.Cm.Cm0 = 0.02f;
+		Airframe.Coefficients.Cm.CmAlpha = -0.8f;
+		Airframe.Coefficients.Cm.Cmq = -10.0f;
+		Airframe.Coefficients.Cn.CnBeta = 0.1f;
+		Airframe.Coefficients.Cn.Cnr = -0.1f;
+		Airframe.ControlDerivatives.Cmde = -0.5f;
+		Airframe.ControlDerivatives.CLde = 0.3f;
+		Airframe.ControlDerivatives.CIda = 0.2f;
+		Airframe.ControlDerivatives.Cndr = -0.06f;
+
+		FActuatorParameters ServoParameters;
+		ServoParameters.DCGain = 0.4f;
+		Vehicle.Elevator.Actuator = FActuatorModel(ServoParameters);
+		Vehicle.Aileron.Actuator = FActuatorModel(ServoParameters);
+		Vehicle.Rudder.Actuator = FActuatorModel(ServoParameters);
+
+		FActuatorParameters MotorParameters;
+		MotorParameters.DCGain = 10000.0f;
+
+		FPropulsor Propulsor;
+		Propulsor.Propeller = FPropellerModel(MakePropellerParameters());
+		Propulsor.Motor = FActuatorModel(MotorParameters);
+		Propulsor.Geometry.Position = FVector3(0.3f, 0.0f, 0.05f);
+		Propulsor.Geometry.Rotation = Eigen::AngleAxisf(-0.5f * Pi, FVector3::UnitY()).toRotationMatrix(); // Thrust (-Z) forwards
+		Vehicle.Propulsors.push_back(Propulsor);
+
+		Vehicle.IntegrationMethod = EIntegrationMethod::Heun;
+		Vehicle.SetPropulsorCommand(0, 0.6f);
+		Vehicle.RigidBodyState.Position = FVector3(0.0f, 0.0f, -50.0f);
+		Vehicle.RigidBodyState.Vb = FVector3(18.0f, 0.0f, 1.0f);
+		return Vehicle;
+	}
+
+	// Step the vehicle adaptively over Interval (s), NumIntervals times.
+	//
+	// @return The stats of the last interval
+	FAdaptiveStepStats StepIntervals(FVehicle& Vehicle, int NumIntervals, float Interval)
+	{
+		for (int i = 0; i < NumIntervals; i++)
+		{
+			Vehicle.StepController.ResetStats();
+			const int NumSteps = Vehicle.StepAdaptive(Interval);
+
+			// Every interval is covered exactly, without leaving a sliver of a step at the end
+			const FAdaptiveStepStats& Stats = Vehicle.StepController.GetStats();
+			SKYPHYS_CHECK(NumSteps == Stats.NumSteps);
+			SKYPHYS_CHECK_NEAR(Stats.SimulatedTime, Interval, 1.e-6f);
+			SKYPHYS_CHECK(Stats.MinStepTaken >= 0.5f * Vehicle.StepController.Parameters.MinStep);
+		}
+		return Vehicle.StepController.GetStats();
+	}
+}
+
+SKYPHYS_TEST(AdaptiveStep, ShrinksOnATransientAndGrowsBack)
+{
+	FAdaptiveStepController Controller;
+	const FAdaptiveStepParameters& Parameters = Controller.Parameters;
+
+	// Quiet: constant accelerations keep the largest step
+	for (int i = 0; i < 5; i++)
+	{
+		SKYPHYS_CHECK(Controller.CalculateNextStep(1.0f, 0.0f) == Parameters.MaxStep);
+		Controller.Update(FVector3(0.0f, 0.0f, -9.81f), FVector3::Zero());
+	}
+
+	// A sudden change in acceleration cuts the step (by at most a factor of 5 per step)
+	Controller.CalculateNextStep(1.0f, 0.0f);
+	Controller.Update(FVector3(50.0f, 0.0f, -9.81f), FVector3(0.0f, 80.0f, 0.0f));
+	const float Shrunk = Controller.CalculateNextStep(1.0f, 0.0f);
+	SKYPHYS_CHECK_NEAR(Shrunk, 0.2f * Parameters.MaxStep, 1.e-6f);
+	Controller.Update(FVector3(50.0f, 0.0f, -9.81f), FVector3(0.0f, 80.0f, 0.0f));
+
+	// Then grows back (by at most a factor of 2 per step) once it is quiet again, up to the largest step
+	float Previous = Shrunk;
+	for (int i = 0; i < 10; i++)
+	{
+		const float Step = Controller.CalculateNextStep(1.0f, 0.0f);
+		Controller.Update(FVector3(50.0f, 0.0f, -9.81f), FVector3(0.0f, 80.0f, 0.0f));
+		SKYPHYS_CHECK(Step >= Previous && Step <= 2.0f * Previous + 1.e-6f);
+		Previous = Step;
+	}
+	SKYPHYS_CHECK(Previous == Parameters.MaxStep);
+}
+
+SKYPHYS_TEST(AdaptiveStep, RespectsTheBoundsAndStiffnessLimit)
+{
+	FAdaptiveStepController Controller;
+	const FAdaptiveStepParameters& Parameters = Controller.Parameters;
+
+	// However large the error, the step stays at or above MinStep
+	for (int i = 0; i < 10; i++)
+	{
+		const float Step = Controller.CalculateNextStep(1.0f, 0.0f);
+		SKYPHYS_CHECK(Step >= Parameters.MinStep && Step <= Parameters.MaxStep);
+		Controller.Update(FVector3((i % 2) * 1.e4f, 0.0f, 0.0f), FVector3::Zero());
+	}
+	SKYPHYS_CHECK(Controller.GetStats().MinStepTaken == Parameters.MinStep);
+
+	// The stiffness limit caps the step at StabilityFactor over the fastest rate, even when the error would allow more
+	Controller = FAdaptiveStepController();
+	SKYPHYS_CHECK_NEAR(Controller.CalculateNextStep(1.0f, 100.0f), Parameters.StabilityFactor / 100.0f, 1.e-6f);
+	SKYPHYS_CHECK(Controller.GetStats().NumStiffnessLimitedSteps == 1);
+
+	// But not below MinStep
+	SKYPHYS_CHECK(Controller.CalculateNextStep(1.0f, 1.e5f) == Parameters.MinStep);
+	SKYPHYS_CHECK(Controller.GetStats().NumStiffnessLimitedSteps == 2);
+
+	// And a rate that allows more than MaxStep has no effect
+	SKYPHYS_CHECK(Controller.CalculateNextStep(1.0f, 1.0f) == Parameters.MaxStep);
+	SKYPHYS_CHECK(Controller.GetStats().NumStiffnessLimitedSteps == 2);
+}
+
+SKYPHYS_TEST(AdaptiveStep, LandsExactlyOnTheInterval)
+{
+	for (const float Interval : { 0.1f, 0.0333f, 0.05f, 0.0007f })
+	{
+		FAdaptiveStepController Controller;
+		Controller.Parameters.MaxStep = 0.03f;
+
+		float RemainingTime = Interval;
+		int NumSteps = 0;
+		while (RemainingTime > 0.0f && NumSteps < 100)
+		{
+			const float Step = Controller.CalculateNextStep(RemainingTime, 0.0f);
+			SKYPHYS_CHECK(Step <= RemainingTime);
+			RemainingTime -= Step;
+			NumSteps++;
+		}
+		SKYPHYS_CHECK(RemainingTime == 0.0f);
+
+		// The last two steps are split evenly, rather than leaving a short one at the end
+		SKYPHYS_CHECK(Controller.GetStats().MinStepTaken >= 0.5f * std::fmin(Interval, Controller.Parameters.MaxStep));
+	}
+}
+
+SKYPHYS_TEST(AdaptiveStep, VehicleStepFollowsTheFlight)
+{
+	FVehicle Vehicle = MakeFixedWing();
+	const float Interval = 0.1f;
+	const float MaxStep = Vehicle.StepController.Parameters.MaxStep;
+
+	// Benign cruise takes the largest steps
+	const FAdaptiveStepStats Cruise = StepIntervals(Vehicle, 10, Interval);
+	SKYPHYS_CHECK(Cruise.MinStepTaken == MaxStep);
+
+	// A sudden upset (eg. a strong gust) shrinks the step
+	Vehicle.RigidBodyState.Omegab = FVector3(6.0f, -4.0f, 3.0f);
+	Vehicle.RigidBodyState.Vb.z() = 8.0f;
+	const FAdaptiveStepStats Upset = StepIntervals(Vehicle, 1, Interval);
+	SKYPHYS_CHECK(Upset.NumSteps > 2 * Cruise.NumSteps);
+	SKYPHYS_CHECK(Upset.MinStepTaken < 0.25f * MaxStep);
+
+	// And once it has been damped out, the steps grow back
+	const FAdaptiveStepStats Recovered = StepIntervals(Vehicle, 20, Interval);
+	SKYPHYS_CHECK(Recovered.NumSteps < Upset.NumSteps / 2);
+	SKYPHYS_CHECK(Recovered.MinStepTaken > 2.0f * Upset.MinStepTaken);
+}
+
+SKYPHYS_TEST(AdaptiveStep, VehicleStepRespectsTheStiffnessLimit)
+{
+	// A fast motor (integrated by sub-stepping, so it limits the step) caps every step, however benign the flight
+	FVehicle Vehicle = MakeFixedWing();
+	FActuatorParameters MotorParameters = Vehicle.Propulsors[0].Motor.GetParameters();
+	MotorParameters.Type = EActuatorModelType::FirstOrder;
+	MotorParameters.wn = 400.0f;
+	Vehicle.Propulsors[0].Motor = FActuatorModel(MotorParameters);
+
+	const FAdaptiveStepParameters& Parameters = Vehicle.StepController.Parameters;
+	const FAdaptiveStepStats Stats = StepIntervals(Vehicle, 5, 0.1f);
+	SKYPHYS_CHECK(Stats.MaxStepTaken <= Parameters.StabilityFactor / 400.0f + 1.e-6f);
+	SKYPHYS_CHECK(Stats.NumStiffnessLimitedSteps == Stats.NumSteps);
+}
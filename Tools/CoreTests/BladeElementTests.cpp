@@ -0,0 +1,133 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// The blade element solver, against momentum theory.
+
+#include "TestHarness.h"
+
+#include <cmath>
+
+#include "SkyPhysCore/Actuation/BladeElementPropeller.h"
+
+using namespace SkyPhysCore;
+
+namespace
+{
+	// A hovering rotor with ideal twist (Twist = TipTwist / (r/R)) and a linear, drag free airfoil, for which the induced velocity is the same
+	// over the whole disc. With many narrow blades the tip loss is small, so the performance follows from momentum theory alone.
+	const float HoverTipTwist = 0.1f;
+	const float HoverChord = 0.02f; // (c/R)
+	const float HoverRootRadius = 0.4f; // (r/R)
+	const float HoverLiftSlope = 2.0f * Pi;
+
+	FBladeElementPropellerGeometry MakeIdealTwistRotor()
+	{
+		FBladeElementPropellerGeometry Geometry;
+		Geometry.D = 1.0f;
+		Geometry.NumBlades = 20;
+		Geometry.Airfoil.Alpha = { -0.3f, 0.3f };
+		Geometry.Airfoil.CL = { -0.3f * HoverLiftSlope, 0.3f * HoverLiftSlope };
+		Geometry.Airfoil.CD = { 0.0f, 0.0f };
+		for (int i = 0; i <= 12; i++)
+		{
+			const float r = HoverRootRadius + 0.05f * i;
+			Geometry.Stations.push_back({ r, HoverChord, HoverTipTwist / r });
+		}
+		return Geometry;
+	}
+
+	// A 10x4.7 style propeller (two blades, with the default thin airfoil).
+	FBladeElementPropellerGeometry MakePropeller()
+	{
+		FBladeElementPropellerGeometry Geometry;
+		Geometry.D = 0.254f;
+		const float R = 0.5f * Geometry.D;
+		const float Pitch = 4.7f * 0.0254f;
+		for (int i = 0; i <= 10; i++)
+		{
+			const float r = 0.15f + 0.085f * i;
+			Geometry.Stations.push_back({ r, 0.12f + 0.1f * std::sin(Pi * r) - 0.05f * r, std::atan(Pitch / (2.0f * Pi * r * R)) });
+		}
+		return Geometry;
+	}
+
+	float CalculateFigureOfMerit(const FPropellerPerformance& Performance)
+	{
+		return std::pow(Performance.CT, 1.5f) / (Performance.CP * std::sqrt(0.5f * Pi));
+	}
+}
+
+SKYPHYS_TEST(BladeElement, MatchesMomentumTheoryInHover)
+{
+	const FBladeElementPropellerGeometry Geometry = MakeIdealTwistRotor();
+	const float n = 600.0f;
+	const float nRPS = n / 60.0f;
+	const float R = 0.5f * Geometry.D;
+	const float Omega = 2.0f * Pi * nRPS;
+	const float Chord = HoverChord * R;
+
+	// The blade and momentum thrust of each annulus balance where 8 * Pi * vi^2 + B * c * a * Omega * vi = B * c * a * Omega^2 * TipTwist * R
+	// (at every radius), and the thrust is then that of the momentum of the flow through the disc (outside the hub).
+	const float b = Geometry.NumBlades * Chord * HoverLiftSlope * Omega;
+	const float vi = (-b + std::sqrt(b * b + 32.0f * Pi * b * Omega * HoverTipTwist * R)) / (16.0f * Pi);
+	const float rHub = HoverRootRadius * R;
+	const float Thrust = 2.0f * Pi * vi * vi * (R * R - rHub * rHub);
+	const float ExpectedCT = Thrust / (nRPS * nRPS);
+
+	// The ideal power is just the induced power, so the figure of merit only falls short of 1 because the hub carries no thrust (and the
+	// ideal power of the disc is worked out from its full area).
+	const float ExpectedFigureOfMerit = std::sqrt(1.0f - (rHub / R) * (rHub / R));
+
+	const FPropellerPerformance Performance = SolveBladeElementPerformance(Geometry, n, 0.0f, 0.0f);
+	SKYPHYS_CHECK_NEAR(Performance.CT, ExpectedCT, 0.02f * ExpectedCT);
+	SKYPHYS_CHECK_NEAR(CalculateFigureOfMerit(Performance), ExpectedFigureOfMerit, 0.01f);
+
+	// The table holds the same at its points
+	FBladeElementTableResolution Resolution;
+	Resolution.NMin = n;
+	Resolution.NMax = 2.0f * n;
+	Resolution.NumN = 2;
+	Resolution.NumJ = 4;
+	Resolution.NumInflowAngles = 3;
+	const FPropellerPerformance TablePerformance = BuildBladeElementPerformanceTable(Geometry, Resolution)->Lookup(n, 0.0f, 0.0f);
+	SKYPHYS_CHECK_NEAR(TablePerformance.CT, Performance.CT, 1.e-6f);
+	SKYPHYS_CHECK_NEAR(TablePerformance.CP, Performance.CP, 1.e-6f);
+}
+
+SKYPHYS_TEST(BladeElement, WindmillsAtHighAdvanceRatio)
+{
+	const FBladeElementPropellerGeometry Geometry = MakePropeller();
+	const float n = 6000.0f;
+
+	// The thrust falls steadily with the advance ratio, through zero and into windmilling (for both the narrow blades and much wider ones,
+	// which slow the flow through the disc more)
+	for (const float ChordScale : { 1.0f, 3.0f })
+	{
+		FBladeElementPropellerGeometry Scaled = Geometry;
+		for (FBladeStation& Station : Scaled.Stations)
+		{
+			Station.Chord *= ChordScale;
+		}
+
+		float PreviousCT = SolveBladeElementPerformance(Scaled, n, 0.0f, 0.0f).CT;
+		SKYPHYS_CHECK(PreviousCT > 0.0f);
+		for (int j = 1; j <= 40; j++)
+		{
+			const float J = 0.05f * j;
+			const FPropellerPerformance Performance = SolveBladeElementPerformance(Scaled, n, J, 0.0f);
+			SKYPHYS_CHECK(Performance.CT < PreviousCT);
+			SKYPHYS_CHECK(PreviousCT - Performance.CT < 0.05f * ChordScale);
+			PreviousCT = Performance.CT;
+
+			// A windmill can't take more power from the flow than the Betz limit (16/27 of that through the disc)
+			SKYPHYS_CHECK(-Performance.CP < (16.0f / 27.0f) * (Pi / 8.0f) * J * J * J);
+		}
+
+		// Well beyond the zero thrust advance ratio (about the pitch over the diameter), the propeller windmills, with drag and driving the shaft
+		const FPropellerPerformance Windmilling = SolveBladeElementPerformance(Scaled, n, 1.5f, 0.0f);
+		SKYPHYS_CHECK(Windmilling.CT < 0.0f);
+		SKYPHYS_CHECK(Windmilling.CP < 0.0f);
+
+		// As it does in oblique inflow
+		SKYPHYS_CHECK(SolveBladeElementPerformance(Scaled, n, 1.5f, 0.6f).CT < 0.0f);
+	}
+}
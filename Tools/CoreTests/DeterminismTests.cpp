@@ -0,0 +1,165 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// Reproducibility: state hashes, seeding and snapshots.
+
+#include "TestHarness.h"
+
+#include "SkyPhysCore/Simulation/Vehicle.h"
+#include "SkyPhysCore/Simulation/VehicleSnapshot.h"
+
+using namespace SkyPhysCore;
+
+namespace
+{
+	FPropellerParameters MakePropellerParameters()
+	{
+		FPropellerParameters Parameters;
+		Parameters.D = 0.25f;
+		Parameters.Izz = 1.e-4f;
+
+		FConstantSpeedPropellerData Low;
+		Low.n = 4000.0f;
+		Low.J = { 0.0f, 0.4f, 0.8f, 1.2f };
+		Low.CT = { 0.12f, 0.1f, 0.05f, -0.02f };
+		Low.CP = { 0.05f, 0.05f, 0.035f, 0.01f };
+
+		FConstantSpeedPropellerData High = Low;
+		High.n = 9000.0f;
+		High.CT = { 0.13f, 0.11f, 0.06f, -0.01f };
+		High.CP = { 0.055f, 0.052f, 0.04f, 0.015f };
+
+		Parameters.ConstantSpeedData = { Low, High };
+		return Parameters;
+	}
+
+	// A fixed wing in turbulence, with its turbulence and aerodynamics at their own (interpolated) rates, integrated with RK4, and with
+	// servo and motor dynamics (so every part of the state moves).
+	FVehicle MakeTurbulentFixedWing(float DeltaTime)
+	{
+		FVehicle Vehicle;
+		FMassProperties& MassProperties = Vehicle.RigidBodyModel.MassProperties;
+		MassProperties.Mass = 2.0f;
+		MassProperties.Ixx = 0.1f;
+		MassProperties.Iyy = 0.2f;
+		MassProperties.Izz = 0.3f;
+		MassProperties.Ixz = 0.01f;
+		MassProperties.PreCalculate();
+
+		FAirframeModel& Airframe = Vehicle.AirframeModel;
+		Airframe.Geometry.b = 1.5f;
+		Airframe.Geometry.c = 0.2f;
+		Airframe.Geometry.A = FVector3(0.3f, 0.3f, 0.3f);
+		Airframe.Coefficients.CL.CL0 = 0.2f;
+		Airframe.Coefficients.CL.CLAlpha = 4.5f;
+		Airframe.Coefficients.CL.CLq = 3.0f;
+		Airframe.Coefficients.CD.CD0 = 0.03f;
+		Airframe.Coefficients.CD.CDAlpha2 = 0.5f;
+		Airframe.Coefficients.CY.CYBeta = -0.3f;
+		Airframe.Coefficients.CI.CIp = -0.5f;
+		Airframe.Coefficients.CI.CIBeta = -0.05f;
+		Airframe.Coefficients.Cm.Cm0 = 0.02f;
+		Airframe.Coefficients.Cm.CmAlpha = -0.8f;
+		Airframe.Coefficients.Cm.Cmq = -10.0f;
+		Airframe.Coefficients.Cn.CnBeta = 0.1f;
+		Airframe.Coefficients.Cn.Cnr = -0.1f;
+		Airframe.ControlDerivatives.Cmde = -0.5f;
+		Airframe.ControlDerivatives.CLde = 0.3f;
+		Airframe.ControlDerivatives.CIda = 0.2f;
+		Airframe.ControlDerivatives.Cndr = -0.06f;
+
+		FActuatorParameters ServoParameters;
+		ServoParameters.Type = EActuatorModelType::SecondOrder;
+		ServoParameters.wn = 40.0f;
+		ServoParameters.zeta = 0.7f;
+		ServoParameters.DCGain = 0.4f;
+		Vehicle.Elevator.Actuator = FActuatorModel(ServoParameters);
+		Vehicle.Aileron.Actuator = FActuatorModel(ServoParameters);
+		Vehicle.Rudder.Actuator = FActuatorModel(ServoParameters);
+
+		FActuatorParameters MotorParameters;
+		MotorParameters.Type = EActuatorModelType::FirstOrder;
+		MotorParameters.wn = 20.0f;
+		MotorParameters.DCGain = 10000.0f;
+
+		FPropulsor Propulsor;
+		Propulsor.Propeller = FPropellerModel(MakePropellerParameters());
+		Propulsor.Motor = FActuatorModel(MotorParameters);
+		Propulsor.Geometry.Position = FVector3(0.3f, 0.0f, 0.05f);
+		Propulsor.Geometry.Rotation = Eigen::AngleAxisf(-0.5f * Pi, FVector3::UnitY()).toRotationMatrix(); // Thrust (-Z) forwards
+		Vehicle.Propulsors.push_back(Propulsor);
+
+		Vehicle.bEnableTurbulenceModel = true;
+		Vehicle.TurbulenceModel.Hu = FDrydenFilter(EDrydenAxis::U, 0, DeltaTime);
+		Vehicle.TurbulenceModel.Hv = FDrydenFilter(EDrydenAxis::V, 0, DeltaTime);
+		Vehicle.TurbulenceModel.Hw = FDrydenFilter(EDrydenAxis::W, 0, DeltaTime);
+		Vehicle.SteadyWind = FVector3(3.0f, -2.0f, 0.0f);
+
+		Vehicle.Scheduler.SetPeriod(EScheduledModel::Turbulence, 10.0f * DeltaTime);
+		Vehicle.Scheduler.SetPeriod(EScheduledModel::Aerodynamics, 2.0f * DeltaTime);
+		Vehicle.bInterpolateTurbulence = true;
+		Vehicle.IntegrationMethod = EIntegrationMethod::RK4;
+
+		Vehicle.RigidBodyState.Position = FVector3(0.0f, 0.0f, -50.0f);
+		Vehicle.RigidBodyState.Vb = FVector3(18.0f, 0.0f, 1.0f);
+		Vehicle.SetControlSurfaceCommands(0.2f, -0.3f, 0.4f);
+		Vehicle.SetPropulsorCommand(0, 0.6f);
+		return Vehicle;
+	}
+
+	void Step(FVehicle& Vehicle, int NumSteps, float DeltaTime)
+	{
+		for (int i = 0; i < NumSteps; i++)
+		{
+			Vehicle.Step(DeltaTime);
+		}
+	}
+}
+
+SKYPHYS_TEST(Determinism, SnapshotRoundTripReproducesTheHash)
+{
+	const float DeltaTime = 0.01f;
+	FVehicle Vehicle = MakeTurbulentFixedWing(DeltaTime);
+	Vehicle.SetRandomSeed(7);
+
+	// Save part way through a turbulence period (and between aerodynamics updates), so the scheduler clocks are mid-period too.
+	Step(Vehicle, 13, DeltaTime);
+	FVehicleSnapshot Snapshot;
+	SKYPHYS_CHECK(Vehicle.SaveSnapshot(Snapshot));
+	const uint64_t SavedHash = Vehicle.CalculateStateHash();
+
+	Step(Vehicle, 40, DeltaTime);
+	const uint64_t SteppedHash = Vehicle.CalculateStateHash();
+	SKYPHYS_CHECK(SteppedHash != SavedHash);
+
+	SKYPHYS_CHECK(Vehicle.RestoreSnapshot(Snapshot));
+	SKYPHYS_CHECK(Vehicle.CalculateStateHash() == SavedHash);
+
+	Step(Vehicle, 40, DeltaTime);
+	SKYPHYS_CHECK(Vehicle.CalculateStateHash() == SteppedHash);
+
+	// A fresh vehicle restored from the snapshot continues the same way
+	FVehicle Restored = MakeTurbulentFixedWing(DeltaTime);
+	SKYPHYS_CHECK(Restored.RestoreSnapshot(Snapshot));
+	Step(Restored, 40, DeltaTime);
+	SKYPHYS_CHECK(Restored.CalculateStateHash() == SteppedHash);
+}
+
+SKYPHYS_TEST(Determinism, SeedDeterminesTheHash)
+{
+	const float DeltaTime = 0.01f;
+	FVehicle A = MakeTurbulentFixedWing(DeltaTime);
+	FVehicle B = MakeTurbulentFixedWing(DeltaTime);
+	FVehicle C = MakeTurbulentFixedWing(DeltaTime);
+	A.SetRandomSeed(42);
+	B.SetRandomSeed(42);
+	C.SetRandomSeed(43);
+
+	Step(A, 30, DeltaTime);
+	Step(B, 30, DeltaTime);
+	Step(C, 30, DeltaTime);
+	SKYPHYS_CHECK(A.CalculateStateHash() == B.CalculateStateHash());
+	SKYPHYS_CHECK(A.CalculateStateHash() != C.CalculateStateHash());
+
+	// Only the turbulence is random, so the seeds differ in the flight itself (not just in the noise streams)
+	SKYPHYS_CHECK(A.RigidBodyState.Vb != C.RigidBodyState.Vb);
+}
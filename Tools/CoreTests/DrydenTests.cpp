@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// The Dryden turbulence filters, against the spectrum they model.
+
+#include "TestHarness.h"
+
+#include "SkyPhysCore/Turbulence/DrydenModel.h"
+
+using namespace SkyPhysCore;
+
+namespace
+{
+	// The variance of the turbulence (ft^2/s^2), over a long run at a fixed step.
+	double CalculateVariance(FDrydenFilter& Filter, float Va, float Dt, float L, float Sigma, float Duration)
+	{
+		// Let the filter settle from rest first
+		for (int i = 0; i < static_cast<int>(10.0f / Dt); i++)
+		{
+			Filter.GetTurbulence(Va, Dt, L, Sigma);
+		}
+
+		const int NumSamples = static_cast<int>(Duration / Dt);
+		double Sum = 0.0;
+		double SumSquares = 0.0;
+		for (int i = 0; i < NumSamples; i++)
+		{
+			const double Turbulence = Filter.GetTurbulence(Va, Dt, L, Sigma);
+			Sum += Turbulence;
+			SumSquares += Turbulence * Turbulence;
+		}
+		const double Mean = Sum / NumSamples;
+		return SumSquares / NumSamples - Mean * Mean;
+	}
+}
+
+SKYPHYS_TEST(Dryden, ExponentialVarianceMatchesTheSpectrumAtAnyStep)
+{
+	// The Dryden spectra all integrate to Sigma^2. The exponential filters scale their noise to the step (rather than the sample time,
+	// which neither step is), so the intensity is the same however often they're sampled.
+	const float Ts = 0.01f;
+	const float Va = 100.0f;
+	const float L = 50.0f; // (a time constant of 0.5s)
+	const float Sigma = 3.0f;
+
+	for (const EDrydenAxis Axis : { EDrydenAxis::U, EDrydenAxis::W })
+	{
+		for (const float Dt : { 0.002f, 0.05f })
+		{
+			FDrydenFilter Filter(Axis, 1, Ts, EFilterIntegrationMethod::Exponential);
+			SKYPHYS_CHECK_NEAR(CalculateVariance(Filter, Va, Dt, L, Sigma, 1000.0f), Sigma * Sigma, 0.1 * Sigma * Sigma);
+		}
+	}
+}
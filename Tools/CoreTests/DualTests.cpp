@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// Forward-mode dual numbers.
+
+#include "TestHarness.h"
+
+#include "SkyPhysCore/Common/Dual.h"
+
+using namespace SkyPhysCore;
+
+SKYPHYS_TEST(Dual, Arithmetic)
+{
+	const FDual x = FDual::Variable(3.0, 0);
+	const FDual y = FDual::Variable(-2.0, 1);
+
+	// f = x * y / (x + 1) - 2 * y, df/dx = y / (x + 1)^2, df/dy = x / (x + 1) - 2
+	const FDual f = x * y / (x + 1.0) - 2.0 * y;
+	SKYPHYS_CHECK_NEAR(f.Value, -1.5 + 4.0, 1.e-12);
+	SKYPHYS_CHECK_NEAR(f.Derivatives(0), -2.0 / 16.0, 1.e-12);
+	SKYPHYS_CHECK_NEAR(f.Derivatives(1), 0.75 - 2.0, 1.e-12);
+	SKYPHYS_CHECK(f.Derivatives.tail<FDual::NumDirections - 2>().isZero());
+}
+
+SKYPHYS_TEST(Dual, MathFunctions)
+{
+	// Each function's derivative against a central difference of the standard one.
+	const double x0 = 0.37;
+	const double h = 1.e-6;
+	const FDual x = FDual::Variable(x0, 0);
+
+	auto CheckDerivative = [&](const FDual& Result, double (*Function)(double))
+	{
+		SKYPHYS_CHECK_NEAR(Result.Value, Function(x0), 1.e-12);
+		SKYPHYS_CHECK_NEAR(Result.Derivatives(0), (Function(x0 + h) - Function(x0 - h)) / (2.0 * h), 1.e-7);
+	};
+
+	CheckDerivative(Dual::sin(x), [](double Value) { return std::sin(Value); });
+	CheckDerivative(Dual::cos(x), [](double Value) { return std::cos(Value); });
+	CheckDerivative(Dual::tan(x), [](double Value) { return std::tan(Value); });
+	CheckDerivative(Dual::asin(x), [](double Value) { return std::asin(Value); });
+	CheckDerivative(Dual::acos(x), [](double Value) { return std::acos(Value); });
+	CheckDerivative(Dual::atan(x), [](double Value) { return std::atan(Value); });
+	CheckDerivative(Dual::sqrt(x), [](double Value) { return std::sqrt(Value); });
+	CheckDerivative(Dual::exp(x), [](double Value) { return std::exp(Value); });
+	CheckDerivative(Dual::log(x), [](double Value) { return std::log(Value); });
+	CheckDerivative(Dual::pow(x, 2.5), [](double Value) { return std::pow(Value, 2.5); });
+	CheckDerivative(Dual::fabs(-x), [](double Value) { return std::fabs(-Value); });
+}
+
+SKYPHYS_TEST(Dual, Atan2)
+{
+	const FDual y = FDual::Variable(0.4, 0);
+	const FDual x = FDual::Variable(-1.2, 1);
+	const FDual Angle = Dual::atan2(y, x);
+
+	const double SquaredNorm = 0.4 * 0.4 + 1.2 * 1.2;
+	SKYPHYS_CHECK_NEAR(Angle.Value, std::atan2(0.4, -1.2), 1.e-12);
+	SKYPHYS_CHECK_NEAR(Angle.Derivatives(0), -1.2 / SquaredNorm, 1.e-12);
+	SKYPHYS_CHECK_NEAR(Angle.Derivatives(1), -0.4 / SquaredNorm, 1.e-12);
+
+	// Undefined at the origin, where it is taken as 0
+	const FDual Origin = Dual::atan2(FDual::Variable(0.0, 0), FDual::Variable(0.0, 1));
+	SKYPHYS_CHECK(Origin.Derivatives.isZero());
+}
+
+SKYPHYS_TEST(Dual, ThroughEigen)
+{
+	// The models run Eigen vector expressions in dual numbers, eg. d|v|/dv = v / |v|
+	using FVector3Dual = Eigen::Matrix<FDual, 3, 1>;
+	const FVector3Dual v(FDual::Variable(1.0, 0), FDual::Variable(2.0, 1), FDual::Variable(-2.0, 2));
+	const FDual Norm = v.norm();
+
+	SKYPHYS_CHECK_NEAR(Norm.Value, 3.0, 1.e-12);
+	SKYPHYS_CHECK_NEAR(Norm.Derivatives(0), 1.0 / 3.0, 1.e-12);
+	SKYPHYS_CHECK_NEAR(Norm.Derivatives(1), 2.0 / 3.0, 1.e-12);
+	SKYPHYS_CHECK_NEAR(Norm.Derivatives(2), -2.0 / 3.0, 1.e-12);
+
+	// (a x b) . a = 0, whatever the direction of the derivatives
+	const FVector3Dual b(FDual(0.5), FDual::Variable(-1.0, 3), FDual(4.0));
+	const FDual Triple = v.cross(b).dot(v);
+	SKYPHYS_CHECK_NEAR(Triple.Value, 0.0, 1.e-12);
+	SKYPHYS_CHECK(Triple.Derivatives.cwiseAbs().maxCoeff() < 1.e-12);
+}
@@ -0,0 +1,137 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// The batched fleet step, against stepping each vehicle on its own.
+
+#include "TestHarness.h"
+
+#include <vector>
+
+#include "SkyPhysCore/Simulation/Fleet.h"
+#include "SkyPhysCore/Simulation/Vehicle.h"
+
+using namespace SkyPhysCore;
+
+namespace
+{
+	// A fixed wing in forward flight, with every control derivative set (so any surface the configuration lacks would show up).
+	FVehicle MakeVehicle(EAirframeConfiguration Configuration, bool bEnableStallModel)
+	{
+		FVehicle Vehicle;
+		FMassProperties& MassProperties = Vehicle.RigidBodyModel.MassProperties;
+		MassProperties.Mass = 2.0f;
+		MassProperties.Ixx = 0.1f;
+		MassProperties.Iyy = 0.2f;
+		MassProperties.Izz = 0.3f;
+		MassProperties.Ixz = 0.01f;
+		MassProperties.PreCalculate();
+
+		FAirframeModel& Airframe = Vehicle.AirframeModel;
+		Airframe.Configuration = Configuration;
+		Airframe.StallParameters.bEnableStallModel = bEnableStallModel;
+		Airframe.StallParameters.Alpha0 = 0.3f;
+		Airframe.StallParameters.M = 50.0f;
+		Airframe.StallParameters.Cmfp = -0.5f;
+		Airframe.Geometry.b = 1.5f;
+		Airframe.Geometry.c = 0.2f;
+		Airframe.Geometry.A = FVector3(0.3f, 0.3f, 0.3f);
+		Airframe.Coefficients.CL.CL0 = 0.2f;
+		Airframe.Coefficients.CL.CLAlpha = 4.5f;
+		Airframe.Coefficients.CL.CLq = 3.0f;
+		Airframe.Coefficients.CD.CD0 = 0.03f;
+		Airframe.Coefficients.CD.CDAlpha2 = 0.5f;
+		Airframe.Coefficients.CY.CYBeta = -0.3f;
+		Airframe.Coefficients.CI.CIp = -0.5f;
+		Airframe.Coefficients.CI.CIBeta = -0.05f;
+		Airframe.Coefficients.Cm.Cm0 = 0.02f;
+		Airframe.Coefficients.Cm.CmAlpha = -0.8f;
+		Airframe.Coefficients.Cm.Cmq = -10.0f;
+		Airframe.Coefficients.Cn.CnBeta = 0.1f;
+		Airframe.Coefficients.Cn.Cnr = -0.1f;
+
+		FAerodynamicControlDerivatives& Ctrl = Airframe.ControlDerivatives;
+		Ctrl.CLde = 0.3f;
+		Ctrl.CDde = 0.02f;
+		Ctrl.Cmde = -0.5f;
+		Ctrl.CYda = 0.01f;
+		Ctrl.CIda = 0.2f;
+		Ctrl.Cnda = -0.01f;
+		Ctrl.CYdr = 0.15f;
+		Ctrl.CIdr = 0.005f;
+		Ctrl.Cndr = -0.06f;
+
+		FActuatorParameters ServoParameters;
+		ServoParameters.DCGain = 0.4f;
+		Vehicle.Elevator.Actuator = FActuatorModel(ServoParameters);
+		Vehicle.Aileron.Actuator = FActuatorModel(ServoParameters);
+		Vehicle.Rudder.Actuator = FActuatorModel(ServoParameters);
+
+		Vehicle.RigidBodyState.Vb = FVector3(18.0f, 1.0f, 2.0f);
+		Vehicle.RigidBodyState.Omegab = FVector3(0.1f, 0.2f, -0.1f);
+		return Vehicle;
+	}
+
+	// Step the vehicles through a fleet, and each on its own, and check they stay together.
+	// The batch evaluates the same model with vectorised maths functions, so they match closely rather than bit for bit.
+	void CheckFleetMatchesVehicles(std::vector<FVehicle> Vehicles, int NumSteps, float DeltaTime)
+	{
+		FFleet Fleet;
+		for (const FVehicle& Vehicle : Vehicles)
+		{
+			Fleet.AddVehicle(Vehicle);
+		}
+
+		for (int Step = 0; Step < NumSteps; Step++)
+		{
+			Fleet.Step(DeltaTime);
+			for (FVehicle& Vehicle : Vehicles)
+			{
+				Vehicle.Step(DeltaTime);
+			}
+		}
+
+		for (int i = 0; i < Fleet.Num(); i++)
+		{
+			const FRigidBodyState& Batched = Fleet.GetVehicle(i).RigidBodyState;
+			const FRigidBodyState& Single = Vehicles[i].RigidBodyState;
+			for (int Axis = 0; Axis < 3; Axis++)
+			{
+				SKYPHYS_CHECK_NEAR(Batched.Position(Axis), Single.Position(Axis), 1.e-3f * (1.0f + std::fabs(Single.Position(Axis))));
+				SKYPHYS_CHECK_NEAR(Batched.Vb(Axis), Single.Vb(Axis), 1.e-3f * (1.0f + std::fabs(Single.Vb(Axis))));
+				SKYPHYS_CHECK_NEAR(Batched.Omegab(Axis), Single.Omegab(Axis), 1.e-4f * (1.0f + std::fabs(Single.Omegab(Axis))));
+			}
+		}
+	}
+}
+
+SKYPHYS_TEST(Fleet, MatchesVehicleStepForEachConfiguration)
+{
+	// One vehicle per configuration, each commanding all three surfaces (whether it has them or not).
+	for (const EAirframeConfiguration Configuration : { EAirframeConfiguration::MultiRotor, EAirframeConfiguration::FlyingWing,
+		EAirframeConfiguration::VTail, EAirframeConfiguration::Standard })
+	{
+		FVehicle Vehicle = MakeVehicle(Configuration, false);
+		Vehicle.SetControlSurfaceCommands(0.5f, -0.4f, 0.8f);
+		CheckFleetMatchesVehicles({ Vehicle }, 50, 0.01f);
+	}
+}
+
+SKYPHYS_TEST(Fleet, MatchesVehicleStepForMixedFleets)
+{
+	// Fleets smaller than, equal to and not a multiple of the vector width, each vehicle with its own configuration, stall setting,
+	// deflections and state (with some flying well beyond the stall angle).
+	const EAirframeConfiguration Configurations[] = { EAirframeConfiguration::Standard, EAirframeConfiguration::VTail,
+		EAirframeConfiguration::FlyingWing, EAirframeConfiguration::MultiRotor };
+
+	for (const int Num : { 1, 8, 13 })
+	{
+		std::vector<FVehicle> Vehicles;
+		for (int i = 0; i < Num; i++)
+		{
+			FVehicle Vehicle = MakeVehicle(Configurations[i % 4], i % 3 != 1);
+			Vehicle.SetControlSurfaceCommands(0.6f - 0.1f * i, 0.05f * i - 0.3f, (i % 3 - 1) * 0.7f);
+			Vehicle.RigidBodyState.Vb.z() = 1.5f * i - 2.0f;
+			Vehicles.push_back(Vehicle);
+		}
+		CheckFleetMatchesVehicles(Vehicles, 50, 0.01f);
+	}
+}
@@ -0,0 +1,142 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// Rigid body integration methods and the actuator filter integration.
+
+#include "TestHarness.h"
+
+#include "SkyPhysCore/Actuation/ActuatorModel.h"
+#include "SkyPhysCore/Dynamics/RigidBodyModel.h"
+
+using namespace SkyPhysCore;
+
+namespace
+{
+	const EIntegrationMethod Methods[] = { EIntegrationMethod::SemiImplicitEuler, EIntegrationMethod::Heun, EIntegrationMethod::RK4 };
+
+	FRigidBodyModeld MakeRigidBody()
+	{
+		FRigidBodyModeld Model;
+		Model.MassProperties.Mass = 2.0;
+		Model.MassProperties.Ixx = 0.1;
+		Model.MassProperties.Iyy = 0.2;
+		Model.MassProperties.Izz = 0.3;
+		Model.MassProperties.PreCalculate();
+		return Model;
+	}
+
+	// The error in the position of a mass on a spring (a body frame force of -k * North, with the body level) after 1s.
+	double CalculateSpringError(EIntegrationMethod Method, int NumSteps)
+	{
+		const FRigidBodyModeld Model = MakeRigidBody();
+		const double Stiffness = 8.0; // (N/m), ie. a natural frequency of 2 rad/s
+		const double DeltaTime = 1.0 / NumSteps;
+
+		FRigidBodyStated State;
+		State.Position = Eigen::Vector3d(1.0, 0.0, 0.0);
+		for (int i = 0; i < NumSteps; i++)
+		{
+			Model.Integrate(State, Eigen::Vector3d::Zero(), DeltaTime, Method, [&](const FRigidBodyStated& Stage)
+				{
+					return FForcesAndMomentsd(Eigen::Vector3d(-Stiffness * Stage.Position.x(), 0.0, 0.0), Eigen::Vector3d::Zero());
+				});
+		}
+
+		return std::fabs(State.Position.x() - std::cos(2.0));
+	}
+}
+
+SKYPHYS_TEST(Integrator, FreeFall)
+{
+	// Constant acceleration is integrated exactly by the multi-stage methods, and with an error of g * t * dt / 2 by semi-implicit Euler
+	// (which moves with the velocity at the end of each step).
+	const FRigidBodyModeld Model = MakeRigidBody();
+	const Eigen::Vector3d Gravity(0.0, 0.0, 9.81);
+	const double DeltaTime = 0.01;
+	const int NumSteps = 100;
+
+	for (EIntegrationMethod Method : Methods)
+	{
+		FRigidBodyStated State;
+		for (int i = 0; i < NumSteps; i++)
+		{
+			Model.Integrate(State, Gravity, DeltaTime, Method, [](const FRigidBodyStated&) { return FForcesAndMomentsd(); });
+		}
+
+		const double Expected = 0.5 * 9.81 + (Method == EIntegrationMethod::SemiImplicitEuler ? 0.5 * 9.81 * DeltaTime : 0.0);
+		SKYPHYS_CHECK_NEAR(State.Position.z(), Expected, 1.e-9);
+		SKYPHYS_CHECK_NEAR(State.Vb.z(), 9.81, 1.e-9);
+		SKYPHYS_CHECK_NEAR(State.Position.x(), 0.0, 1.e-12);
+	}
+}
+
+SKYPHYS_TEST(Integrator, ConvergenceOrder)
+{
+	// Halving the step divides the error by 2^order.
+	const double Orders[] = { 1.0, 2.0, 4.0 };
+	for (int m = 0; m < 3; m++)
+	{
+		const double Coarse = CalculateSpringError(Methods[m], 20);
+		const double Fine = CalculateSpringError(Methods[m], 40);
+		const double Order = std::log2(Coarse / Fine);
+		SKYPHYS_CHECK_NEAR(Order, Orders[m], 0.2);
+	}
+}
+
+SKYPHYS_TEST(Integrator, TorqueFreeSpinConservesAngularMomentum)
+{
+	// An asymmetric body spinning close to its intermediate axis tumbles, but its angular momentum in the world frame stays fixed.
+	const FRigidBodyModeld Model = MakeRigidBody();
+	const Eigen::Matrix3d& J = Model.MassProperties.J;
+
+	FRigidBodyStated State;
+	State.Omegab = Eigen::Vector3d(0.05, 5.0, 0.05);
+	const Eigen::Vector3d InitialMomentum = State.Attitude * (J * State.Omegab);
+	const double InitialEnergy = 0.5 * State.Omegab.dot(J * State.Omegab);
+
+	for (int i = 0; i < 2000; i++)
+	{
+		Model.Integrate(State, Eigen::Vector3d::Zero(), 0.001, EIntegrationMethod::RK4, [](const FRigidBodyStated&) { return FForcesAndMomentsd(); });
+	}
+
+	const Eigen::Vector3d Momentum = State.Attitude * (J * State.Omegab);
+	SKYPHYS_CHECK((Momentum - InitialMomentum).norm() < 1.e-6 * InitialMomentum.norm());
+	SKYPHYS_CHECK_NEAR(0.5 * State.Omegab.dot(J * State.Omegab), InitialEnergy, 1.e-6 * InitialEnergy);
+	SKYPHYS_CHECK_NEAR(State.Attitude.norm(), 1.0, 1.e-9);
+
+	// It has actually tumbled (rather than just spun about its initial axis)
+	SKYPHYS_CHECK(State.Omegab.y() < 4.0);
+}
+
+SKYPHYS_TEST(Integrator, FirstOrderActuatorStepResponse)
+{
+	// Both filter integration methods follow 2 * (1 - exp(-wn * t)). The exponential one is exact (for the held command), and the trapezoidal one
+	// (with its feedback held over each step) is within O(wn * dt) of it.
+	for (EFilterIntegrationMethod FilterMethod : { EFilterIntegrationMethod::Trapezoidal, EFilterIntegrationMethod::Exponential })
+	{
+		FActuatorParameters Parameters;
+		Parameters.Type = EActuatorModelType::FirstOrder;
+		Parameters.wn = 20.0f;
+		Parameters.DCGain = 2.0f;
+		Parameters.IntegrationMethod = FilterMethod;
+		FActuatorModel Actuator(Parameters);
+
+		const float DeltaTime = 0.001f;
+		float State = 0.0f;
+		for (int i = 0; i < 100; i++)
+		{
+			State = Actuator.ApplyActuatorCommand(1.0f, DeltaTime);
+		}
+
+		const float Tolerance = FilterMethod == EFilterIntegrationMethod::Exponential ? 1.e-5f : 2.0f * Parameters.wn * DeltaTime;
+		SKYPHYS_CHECK_NEAR(State, 2.0f * (1.0f - std::exp(-2.0f)), Tolerance);
+	}
+
+	// Exponential is also exact for a step much longer than 1 / wn
+	FActuatorParameters Parameters;
+	Parameters.Type = EActuatorModelType::FirstOrder;
+	Parameters.wn = 500.0f;
+	Parameters.IntegrationMethod = EFilterIntegrationMethod::Exponential;
+	FActuatorModel FastActuator(Parameters);
+	FastActuator.ApplyActuatorCommand(1.0f, 0.0f);
+	SKYPHYS_CHECK_NEAR(FastActuator.ApplyActuatorCommand(1.0f, 0.01f), 1.0f - std::exp(-5.0f), 1.e-4f);
+}
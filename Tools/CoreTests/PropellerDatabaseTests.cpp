@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// The memory mapped propeller database, and its rejection of malformed files.
+
+#include "TestHarness.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "SkyPhysCore/Actuation/PropellerDatabase.h"
+
+using namespace SkyPhysCore;
+
+namespace
+{
+	std::vector<std::pair<std::string, FPropellerTable>> MakePropellers()
+	{
+		FConstantSpeedPropellerData Low;
+		Low.n = 3000.0f;
+		Low.J = { 0.0f, 0.5f, 1.0f };
+		Low.CT = { 0.11f, 0.07f, 0.0f };
+		Low.CP = { 0.05f, 0.04f, 0.01f };
+
+		FConstantSpeedPropellerData High = Low;
+		High.n = 6000.0f;
+		High.CT = { 0.1f, 0.06f, 0.0f };
+
+		return { { "apc_10x7", FPropellerTable({ Low, High }) }, { "apc_8x4", FPropellerTable({ Low }) } };
+	}
+
+	// Write a database, and then change its bytes (as a corrupt or hostile file would).
+	void WriteModifiedDatabase(const std::string& Path, void (*Modify)(std::vector<char>& Bytes))
+	{
+		SKYPHYS_CHECK(FPropellerDatabase::Write(Path, MakePropellers()));
+
+		std::vector<char> Bytes;
+		{
+			std::ifstream Stream(Path, std::ios::binary);
+			Bytes.assign(std::istreambuf_iterator<char>(Stream), std::istreambuf_iterator<char>());
+		}
+		Modify(Bytes);
+
+		std::ofstream Stream(Path, std::ios::binary | std::ios::trunc);
+		Stream.write(Bytes.data(), static_cast<std::streamsize>(Bytes.size()));
+	}
+
+	FPropellerDatabaseEntry& GetEntry(std::vector<char>& Bytes, int Index)
+	{
+		return reinterpret_cast<FPropellerDatabaseEntry*>(Bytes.data() + sizeof(FPropellerDatabaseHeader))[Index];
+	}
+}
+
+SKYPHYS_TEST(PropellerDatabase, RoundTrips)
+{
+	const std::string Path = "PropellerDatabaseRoundTrip.skyprop";
+	SKYPHYS_CHECK(FPropellerDatabase::Write(Path, MakePropellers()));
+
+	const std::shared_ptr<const FPropellerDatabase> Database = FPropellerDatabase::Open(Path);
+	SKYPHYS_CHECK(Database != nullptr);
+	if (Database)
+	{
+		SKYPHYS_CHECK(Database->GetNumPropellers() == 2);
+		SKYPHYS_CHECK(Database->Find("apc_8x4") == 1);
+		SKYPHYS_CHECK(Database->Find("apc_9x4") == -1);
+
+		const std::shared_ptr<const FPropellerTable> Table = Database->FindTable("apc_10x7");
+		SKYPHYS_CHECK(Table != nullptr);
+		if (Table)
+		{
+			SKYPHYS_CHECK_NEAR(Table->Lookup(3000.0f, 0.5f).CT, 0.07f, 1.e-5f);
+		}
+	}
+	std::remove(Path.c_str());
+}
+
+SKYPHYS_TEST(PropellerDatabase, RejectsCoefficientsOutsideTheFile)
+{
+	// An offset so large that adding the size of the coefficients to it wraps around
+	const std::string Path = "PropellerDatabaseOffset.skyprop";
+	WriteModifiedDatabase(Path, [](std::vector<char>& Bytes)
+		{
+			GetEntry(Bytes, 0).CoefficientsOffset = UINT64_MAX - FPropellerDatabase::Alignment + 1;
+			GetEntry(Bytes, 1).CoefficientsOffset = Bytes.size() - FPropellerDatabase::Alignment;
+		});
+
+	const std::shared_ptr<const FPropellerDatabase> Database = FPropellerDatabase::Open(Path);
+	SKYPHYS_CHECK(Database != nullptr);
+	if (Database)
+	{
+		SKYPHYS_CHECK(Database->GetTable(0) == nullptr);
+		SKYPHYS_CHECK(Database->GetTable(1) == nullptr);
+	}
+	std::remove(Path.c_str());
+}
+
+SKYPHYS_TEST(PropellerDatabase, RejectsUnterminatedNames)
+{
+	const std::string Path = "PropellerDatabaseName.skyprop";
+	WriteModifiedDatabase(Path, [](std::vector<char>& Bytes)
+		{
+			FPropellerDatabaseEntry& Entry = GetEntry(Bytes, 1);
+			std::memset(Entry.Name, 'x', sizeof(Entry.Name));
+		});
+
+	SKYPHYS_CHECK(FPropellerDatabase::Open(Path) == nullptr);
+	std::remove(Path.c_str());
+}
@@ -0,0 +1,190 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// The propeller model: its analytic Jacobian, and agreement between its evaluation paths (including the rotor bank).
+
+#include "TestHarness.h"
+
+#include <vector>
+
+#include "SkyPhysCore/Actuation/PropellerModel.h"
+#include "SkyPhysCore/Actuation/RotorBank.h"
+#include "SkyPhysCore/Common/Dual.h"
+
+using namespace SkyPhysCore;
+
+namespace
+{
+	// CT goes negative beyond J = 1.1 (the propeller windmills).
+	FPropellerParameters MakePropellerParameters()
+	{
+		FPropellerParameters Parameters;
+		Parameters.D = 0.25f;
+		Parameters.Izz = 1.e-4f;
+		Parameters.Cd = 0.05f;
+
+		FConstantSpeedPropellerData Low;
+		Low.n = 4000.0f;
+		Low.J = { 0.0f, 0.4f, 0.8f, 1.2f };
+		Low.CT = { 0.12f, 0.1f, 0.05f, -0.04f };
+		Low.CP = { 0.05f, 0.05f, 0.035f, 0.01f };
+
+		FConstantSpeedPropellerData High = Low;
+		High.n = 9000.0f;
+		High.CT = { 0.13f, 0.11f, 0.06f, -0.03f };
+		High.CP = { 0.055f, 0.052f, 0.04f, 0.015f };
+
+		Parameters.ConstantSpeedData = { Low, High };
+		return Parameters;
+	}
+
+	// The forces and moments as one vector, of the inputs (Va, SystemOmega, omega) as one vector (the layout of FPropellerJacobian).
+	Eigen::Matrix<float, 6, 1> Evaluate(const FPropellerModel& Propeller, float Rho, const Eigen::Matrix<float, 7, 1>& Inputs)
+	{
+		FPropellerJacobian Unused;
+		const FForcesAndMoments Result = Propeller.CalculateForcesAndMomentsJacobian(Rho, Inputs.head<3>(), Inputs.segment<3>(3), Inputs(6), Unused);
+		Eigen::Matrix<float, 6, 1> Output;
+		Output << Result.Forces, Result.Moments;
+		return Output;
+	}
+
+	void CheckJacobian(const FPropellerModel& Propeller, float Rho, const Eigen::Matrix<float, 7, 1>& Inputs)
+	{
+		FPropellerJacobian Jacobian;
+		Propeller.CalculateForcesAndMomentsJacobian(Rho, Inputs.head<3>(), Inputs.segment<3>(3), Inputs(6), Jacobian);
+
+		for (int i = 0; i < 7; i++)
+		{
+			const float h = i < 6 ? 1.e-2f : 1.e-1f;
+			Eigen::Matrix<float, 7, 1> Plus = Inputs, Minus = Inputs;
+			Plus(i) += h;
+			Minus(i) -= h;
+			const Eigen::Matrix<float, 6, 1> Column = (Evaluate(Propeller, Rho, Plus) - Evaluate(Propeller, Rho, Minus)) / (2.0f * h);
+			SKYPHYS_CHECK((Jacobian.col(i) - Column).cwiseAbs().maxCoeff() < 1.e-2f * (1.0f + Column.cwiseAbs().maxCoeff()));
+		}
+	}
+}
+
+SKYPHYS_TEST(PropellerModel, JacobianMatchesFiniteDifferences)
+{
+	const FPropellerModel Propeller(MakePropellerParameters());
+
+	Eigen::Matrix<float, 7, 1> Inputs;
+	Inputs << 3.0f, -2.0f, -8.0f, 0.5f, -0.3f, 0.2f, 700.0f;
+	CheckJacobian(Propeller, 1.225f, Inputs);
+}
+
+SKYPHYS_TEST(PropellerModel, JacobianMatchesFiniteDifferencesAtNegativeThrust)
+{
+	const FPropellerModel Propeller(MakePropellerParameters());
+
+	// J ~= 1.15, where CT < 0
+	Eigen::Matrix<float, 7, 1> Inputs;
+	Inputs << 4.0f, 3.0f, -22.4f, 0.5f, -0.3f, 0.2f, 500.0f;
+
+	FPropellerJacobian Jacobian;
+	const FForcesAndMoments Result = Propeller.CalculateForcesAndMomentsJacobian(1.225f, Inputs.head<3>(), Inputs.segment<3>(3), Inputs(6), Jacobian);
+	SKYPHYS_CHECK(Result.Forces.z() > 0.0f);
+
+	// The side force still opposes the in-plane airspeed
+	SKYPHYS_CHECK(Result.Forces.x() < 0.0f && Result.Forces.y() < 0.0f);
+
+	CheckJacobian(Propeller, 1.225f, Inputs);
+}
+
+SKYPHYS_TEST(PropellerModel, EvaluationPathsAgreeAtNegativeThrust)
+{
+	FPropellerModel Propeller(MakePropellerParameters());
+	const float Rho = 1.225f;
+	const FVector3 Va(4.0f, 3.0f, -22.4f);
+	const FVector3 SystemOmega(0.0f, 0.0f, 0.0f);
+	const float omega = 500.0f;
+	const float Cd = Propeller.GetParameters().Cd;
+	const float Izz = Propeller.GetParameters().Izz;
+
+	Propeller.SetRotationalSpeed(omega);
+	const FForcesAndMoments Scalar = Propeller.CalculateForcesAndMoments(Rho, Va, SystemOmega);
+	SKYPHYS_CHECK(Scalar.Forces.z() > 0.0f);
+
+	const FForcesAndMoments Templated = Propeller.CalculateForcesAndMoments<float>(Rho, Va, SystemOmega, omega, Cd, Izz);
+
+	using namespace SkyPhysCore::Dual;
+	const TForcesAndMoments<FDual> Differentiable = Propeller.CalculateForcesAndMoments<FDual>(FDual(Rho), Va.cast<FDual>(), SystemOmega.cast<FDual>(),
+		FDual(omega), FDual(Cd), FDual(Izz));
+
+	// A single rotor at the CoG, without wind or body rotation, sees the body velocity as its airspeed.
+	FRotorBank Bank;
+	Bank.Resize(1);
+	Bank.SetRotor(0, Propeller, FPropulsorGeometry());
+	const FForcesAndMoments Banked = Bank.CalculateForcesAndMoments(Rho, Va, SystemOmega, FVector3::Zero());
+
+	for (int i = 0; i < 3; i++)
+	{
+		const float Tolerance = 1.e-4f * (1.0f + std::fabs(Scalar.Forces(i)));
+		SKYPHYS_CHECK_NEAR(Templated.Forces(i), Scalar.Forces(i), Tolerance);
+		SKYPHYS_CHECK_NEAR(static_cast<float>(Differentiable.Forces(i).Value), Scalar.Forces(i), Tolerance);
+		SKYPHYS_CHECK_NEAR(Banked.Forces(i), Scalar.Forces(i), Tolerance);
+	}
+}
+
+SKYPHYS_TEST(PropellerModel, RotorBankMatchesPropulsorGeometry)
+{
+	// Offset, tilted rotors spinning both ways (one windmilling), on a rotating body in wind
+	const float Rho = 1.225f;
+	const FVector3 Vb(8.0f, 2.0f, -3.0f);
+	const FVector3 Omegab(0.4f, -0.3f, 0.6f);
+	const FVector3 Vwb(1.0f, -2.0f, 0.5f);
+
+	const int NumRotors = 5;
+	std::vector<FPropellerModel> Propellers;
+	std::vector<FPropulsorGeometry> Geometries;
+	for (int i = 0; i < NumRotors; i++)
+	{
+		FPropellerParameters Parameters = MakePropellerParameters();
+		Parameters.RotationDirection = i % 2 ? -1.0f : 1.0f;
+		FPropellerModel Propeller(Parameters);
+		Propeller.SetRotationalSpeed(i == 4 ? 150.0f : 400.0f + 100.0f * i);
+		Propellers.push_back(Propeller);
+
+		FPropulsorGeometry Geometry;
+		Geometry.Position = FVector3(0.3f * (i - 2), i % 2 ? 0.25f : -0.25f, -0.05f * i);
+		Geometry.Rotation = (Eigen::AngleAxisf(0.4f * i, FVector3::UnitZ()) * Eigen::AngleAxisf(0.2f * i - 0.5f, FVector3::UnitY())).toRotationMatrix();
+		Geometries.push_back(Geometry);
+	}
+	// The last rotor thrusts forwards, but turns too slowly for the flow, so windmills
+	Geometries[4].Rotation = Eigen::AngleAxisf(-0.5f * Pi, FVector3::UnitY()).toRotationMatrix();
+
+	FRotorBank Bank;
+	Bank.Resize(NumRotors);
+	for (int i = 0; i < NumRotors; i++)
+	{
+		Bank.SetRotor(i, Propellers[i], Geometries[i]);
+	}
+	const FForcesAndMoments Banked = Bank.CalculateForcesAndMoments(Rho, Vb, Omegab, Vwb);
+
+	FForcesAndMoments Total(FVector3::Zero(), FVector3::Zero());
+	for (int i = 0; i < NumRotors; i++)
+	{
+		// Each propeller in its own frame, rotated into the body frame, plus the moment of its force about the CoG
+		const FPropulsorGeometry& Geometry = Geometries[i];
+		const FForcesAndMoments Propulsor = Propellers[i].CalculateForcesAndMoments(Rho, Geometry.CalculateAirspeed(Vb, Omegab, Vwb), Geometry.BodyToPropulsor(Omegab));
+		SKYPHYS_CHECK((Propulsor.Forces.z() > 0.0f) == (i == 4));
+
+		FForcesAndMoments Expected = Geometry.PropulsorToBody(Propulsor);
+		Expected.Moments += Geometry.CalculateMomentAboutCoG(Expected.Forces);
+		Total.Forces += Expected.Forces;
+		Total.Moments += Expected.Moments;
+
+		const FForcesAndMoments Rotor = Bank.GetForcesAndMoments(i);
+		for (int Axis = 0; Axis < 3; Axis++)
+		{
+			SKYPHYS_CHECK_NEAR(Rotor.Forces(Axis), Expected.Forces(Axis), 1.e-4f * (1.0f + std::fabs(Expected.Forces(Axis))));
+			SKYPHYS_CHECK_NEAR(Rotor.Moments(Axis), Expected.Moments(Axis), 1.e-4f * (1.0f + std::fabs(Expected.Moments(Axis))));
+		}
+	}
+
+	for (int Axis = 0; Axis < 3; Axis++)
+	{
+		SKYPHYS_CHECK_NEAR(Banked.Forces(Axis), Total.Forces(Axis), 1.e-4f * (1.0f + std::fabs(Total.Forces(Axis))));
+		SKYPHYS_CHECK_NEAR(Banked.Moments(Axis), Total.Moments(Axis), 1.e-4f * (1.0f + std::fabs(Total.Moments(Axis))));
+	}
+}
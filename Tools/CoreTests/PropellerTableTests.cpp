@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// The resampled (n, J) propeller table.
+
+#include "TestHarness.h"
+
+#include "SkyPhysCore/Actuation/PropellerTable.h"
+
+using namespace SkyPhysCore;
+
+namespace
+{
+	// Uniformly spaced data (J every 0.25, at 3000 and 6000 RPM), which the table should hold exactly.
+	std::vector<FConstantSpeedPropellerData> MakeUniformData()
+	{
+		FConstantSpeedPropellerData Low;
+		Low.n = 3000.0f;
+		Low.J = { 0.0f, 0.25f, 0.5f, 0.75f };
+		Low.CT = { 0.12f, 0.1f, 0.07f, 0.02f };
+		Low.CP = { 0.05f, 0.048f, 0.04f, 0.025f };
+
+		FConstantSpeedPropellerData High = Low;
+		High.n = 6000.0f;
+		High.CT = { 0.13f, 0.11f, 0.08f, 0.03f };
+		High.CP = { 0.055f, 0.05f, 0.043f, 0.03f };
+
+		return { Low, High };
+	}
+}
+
+SKYPHYS_TEST(PropellerTable, ReproducesUniformData)
+{
+	const std::vector<FConstantSpeedPropellerData> Data = MakeUniformData();
+	const FPropellerTable Table(Data);
+
+	for (const FConstantSpeedPropellerData& ConstantSpeed : Data)
+	{
+		for (size_t j = 0; j < ConstantSpeed.J.size(); j++)
+		{
+			const FAerodynamicConstantResults Constants = Table.Lookup(ConstantSpeed.n, ConstantSpeed.J[j]);
+			SKYPHYS_CHECK_NEAR(Constants.CT, ConstantSpeed.CT[j], 1.e-6f);
+			SKYPHYS_CHECK_NEAR(Constants.CP, ConstantSpeed.CP[j], 1.e-6f);
+		}
+	}
+}
+
+SKYPHYS_TEST(PropellerTable, InterpolatesBilinearly)
+{
+	const FPropellerTable Table(MakeUniformData());
+
+	// Half way along both axes of the cell (3000 -> 6000 RPM, J 0.25 -> 0.5)
+	const FAerodynamicConstantResults Constants = Table.Lookup(4500.0f, 0.375f);
+	SKYPHYS_CHECK_NEAR(Constants.CT, 0.25f * (0.1f + 0.07f + 0.11f + 0.08f), 1.e-6f);
+	SKYPHYS_CHECK_NEAR(Constants.CP, 0.25f * (0.048f + 0.04f + 0.05f + 0.043f), 1.e-6f);
+}
+
+SKYPHYS_TEST(PropellerTable, ClampsToData)
+{
+	const FPropellerTable Table(MakeUniformData());
+
+	const FAerodynamicConstantResults Below = Table.Lookup(100.0f, -5.0f);
+	SKYPHYS_CHECK_NEAR(Below.CT, 0.12f, 1.e-6f);
+
+	const FAerodynamicConstantResults Above = Table.Lookup(20000.0f, 3.0f);
+	SKYPHYS_CHECK_NEAR(Above.CT, 0.03f, 1.e-6f);
+	SKYPHYS_CHECK_NEAR(Above.CP, 0.03f, 1.e-6f);
+
+	// An empty table is all 0s
+	const FPropellerTable Empty;
+	SKYPHYS_CHECK(Empty.Lookup(5000.0f, 0.5f).CT == 0.0f);
+}
+
+SKYPHYS_TEST(PropellerTable, DerivativesMatchFiniteDifferences)
+{
+	const FPropellerTable Table(MakeUniformData());
+	const float n = 4100.0f;
+	const float J = 0.6f;
+
+	FAerodynamicConstantResults dn(0.0f, 0.0f);
+	FAerodynamicConstantResults dJ(0.0f, 0.0f);
+	Table.Lookup(n, J, dn, dJ);
+
+	const float hn = 10.0f;
+	const float hJ = 1.e-3f;
+	const FAerodynamicConstantResults nPlus = Table.Lookup(n + hn, J);
+	const FAerodynamicConstantResults nMinus = Table.Lookup(n - hn, J);
+	const FAerodynamicConstantResults JPlus = Table.Lookup(n, J + hJ);
+	const FAerodynamicConstantResults JMinus = Table.Lookup(n, J - hJ);
+
+	SKYPHYS_CHECK_NEAR(dn.CT, (nPlus.CT - nMinus.CT) / (2.0f * hn), 1.e-7f);
+	SKYPHYS_CHECK_NEAR(dn.CP, (nPlus.CP - nMinus.CP) / (2.0f * hn), 1.e-7f);
+	SKYPHYS_CHECK_NEAR(dJ.CT, (JPlus.CT - JMinus.CT) / (2.0f * hJ), 1.e-3f);
+	SKYPHYS_CHECK_NEAR(dJ.CP, (JPlus.CP - JMinus.CP) / (2.0f * hJ), 1.e-3f);
+
+	// Clamped to the data, there is no derivative
+	Table.Lookup(n, 2.0f, dn, dJ);
+	SKYPHYS_CHECK(dJ.CT == 0.0f);
+}
@@ -0,0 +1,44 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// Multi-rate scheduling.
+
+#include "TestHarness.h"
+
+#include "SkyPhysCore/Simulation/MultiRateScheduler.h"
+
+using namespace SkyPhysCore;
+
+SKYPHYS_TEST(Scheduler, RunsModelsAtTheirPeriods)
+{
+	FMultiRateScheduler Scheduler;
+	Scheduler.SetPeriod(EScheduledModel::Turbulence, 0.01f);
+
+	// Due on the first step, then on every 5th (given the whole time since)
+	for (int i = 0; i < 11; i++)
+	{
+		Scheduler.Advance(0.002f);
+		SKYPHYS_CHECK(Scheduler.IsDue(EScheduledModel::Aerodynamics));
+		SKYPHYS_CHECK(Scheduler.IsDue(EScheduledModel::Turbulence) == (i % 5 == 0));
+	}
+	SKYPHYS_CHECK(Scheduler.GetNumUpdates(EScheduledModel::Turbulence) == 3);
+	SKYPHYS_CHECK_NEAR(Scheduler.GetDeltaTime(EScheduledModel::Turbulence), 0.01f, 1.e-6f);
+}
+
+SKYPHYS_TEST(Scheduler, RestoringASnapshotKeepsThePeriods)
+{
+	FMultiRateScheduler Scheduler;
+	Scheduler.SetPeriod(EScheduledModel::Turbulence, 0.01f);
+	Scheduler.Advance(0.002f);
+	Scheduler.Advance(0.002f);
+
+	FMultiRateSchedulerSnapshot Snapshot;
+	Scheduler.SaveSnapshot(Snapshot);
+
+	// A rate changed after the snapshot was saved stays changed
+	Scheduler.SetPeriod(EScheduledModel::Turbulence, 0.1f);
+	Scheduler.Advance(0.002f);
+	Scheduler.RestoreSnapshot(Snapshot);
+	SKYPHYS_CHECK(Scheduler.GetPeriod(EScheduledModel::Turbulence) == 0.1f);
+	SKYPHYS_CHECK(Scheduler.GetNumUpdates(EScheduledModel::Turbulence) == 1);
+	SKYPHYS_CHECK_NEAR(Scheduler.GetInterpolationAlpha(EScheduledModel::Turbulence), 0.002f / 0.1f, 1.e-6f);
+}
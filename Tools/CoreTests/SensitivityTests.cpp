@@ -0,0 +1,195 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// Step sensitivities, against finite differences of FVehicle::Step.
+
+#include "TestHarness.h"
+
+#include <functional>
+
+#include "SkyPhysCore/Simulation/Sensitivity.h"
+#include "SkyPhysCore/Simulation/Vehicle.h"
+
+using namespace SkyPhysCore;
+
+namespace
+{
+	using FState = Eigen::Matrix<double, FStepSensitivity::NumStates, 1>;
+
+	FPropellerParameters MakePropellerParameters()
+	{
+		FPropellerParameters Parameters;
+		Parameters.D = 0.25f;
+		Parameters.Izz = 1.e-4f;
+		Parameters.Cd = 0.05f;
+
+		FConstantSpeedPropellerData Low;
+		Low.n = 4000.0f;
+		Low.J = { 0.0f, 0.4f, 0.8f, 1.2f };
+		Low.CT = { 0.12f, 0.1f, 0.05f, -0.02f };
+		Low.CP = { 0.05f, 0.05f, 0.035f, 0.01f };
+
+		FConstantSpeedPropellerData High = Low;
+		High.n = 9000.0f;
+		High.CT = { 0.13f, 0.11f, 0.06f, -0.01f };
+		High.CP = { 0.055f, 0.052f, 0.04f, 0.015f };
+
+		Parameters.ConstantSpeedData = { Low, High };
+		return Parameters;
+	}
+
+	// A fixed wing in a climbing, rolling turn, with its propeller spinning. The actuators are feedthrough, so the deflections and propeller
+	// speed follow the commands exactly (which lets the inputs be perturbed through the commands).
+	FVehicle MakeFixedWing()
+	{
+		FVehicle Vehicle;
+		FMassProperties& MassProperties = Vehicle.RigidBodyModel.MassProperties;
+		MassProperties.Mass = 2.0f;
+		MassProperties.Ixx = 0.1f;
+		MassProperties.Iyy = 0.2f;
+		MassProperties.Izz = 0.3f;
+		MassProperties.Ixz = 0.01f;
+		MassProperties.PreCalculate();
+
+		FAirframeModel& Airframe = Vehicle.AirframeModel;
+		Airframe.Geometry.b = 1.5f;
+		Airframe.Geometry.c = 0.2f;
+		Airframe.Geometry.A = FVector3(0.3f, 0.3f, 0.3f);
+		Airframe.Coefficients.CL.CL0 = 0.2f;
+		Airframe.Coefficients.CL.CLAlpha = 4.5f;
+		Airframe.Coefficients.CL.CLq = 3.0f;
+		Airframe.Coefficients.CD.CD0 = 0.03f;
+		Airframe.Coefficients.CD.CDAlpha2 = 0.5f;
+		Airframe.Coefficients.CY.CYBeta = -0.3f;
+		Airframe.Coefficients.CI.CIp = -0.5f;
+		Airframe.Coefficients.CI.CIBeta = -0.05f;
+		Airframe.Coefficients.Cm.Cm0 = 0.02f;
+		Airframe.Coefficients.Cm.CmAlpha = -0.8f;
+		Airframe.Coefficients.Cm.Cmq = -10.0f;
+		Airframe.Coefficients.Cn.CnBeta = 0.1f;
+		Airframe.Coefficients.Cn.Cnr = -0.1f;
+		Airframe.ControlDerivatives.Cmde = -0.5f;
+		Airframe.ControlDerivatives.CLde = 0.3f;
+		Airframe.ControlDerivatives.CIda = 0.2f;
+		Airframe.ControlDerivatives.Cndr = -0.06f;
+
+		FActuatorParameters ServoParameters;
+		ServoParameters.DCGain = 0.4f;
+		Vehicle.Elevator.Actuator = FActuatorModel(ServoParameters);
+		Vehicle.Aileron.Actuator = FActuatorModel(ServoParameters);
+		Vehicle.Rudder.Actuator = FActuatorModel(ServoParameters);
+
+		FActuatorParameters MotorParameters;
+		MotorParameters.DCGain = 10000.0f;
+
+		FPropulsor Propulsor;
+		Propulsor.Propeller = FPropellerModel(MakePropellerParameters());
+		Propulsor.Motor = FActuatorModel(MotorParameters);
+		Propulsor.Geometry.Position = FVector3(0.3f, 0.0f, 0.05f);
+		Propulsor.Geometry.Rotation = Eigen::AngleAxisf(-0.5f * Pi, FVector3::UnitY()).toRotationMatrix(); // Thrust (-Z) forwards
+		Vehicle.Propulsors.push_back(Propulsor);
+
+		Vehicle.IntegrationMethod = EIntegrationMethod::RK4;
+		Vehicle.SteadyWind = FVector3(2.0f, -1.0f, 0.0f);
+		Vehicle.SetControlSurfaceCommands(0.2f, -0.3f, 0.4f);
+		Vehicle.SetPropulsorCommand(0, 0.6f);
+
+		// Take a step, so the actuator outputs and wind are those the next step holds.
+		Vehicle.RigidBodyState.Position = FVector3(1.0f, -2.0f, -10.0f);
+		Vehicle.RigidBodyState.Attitude = FQuaternion(Eigen::AngleAxisf(0.3f, FVector3::UnitX()) * Eigen::AngleAxisf(0.1f, FVector3::UnitY()));
+		Vehicle.RigidBodyState.Vb = FVector3(18.0f, 1.0f, 2.0f);
+		Vehicle.RigidBodyState.Omegab = FVector3(0.4f, 0.2f, -0.3f);
+		Vehicle.Step(0.01f);
+		return Vehicle;
+	}
+
+	// The state after a step, as per FStepSensitivity (with the attitude as a small rotation vector in the body frame, from Reference).
+	FState GetState(const FRigidBodyState& State, const FQuaterniond& Reference)
+	{
+		FState Result;
+		Result << State.Position.cast<double>(), 2.0 * (Reference.conjugate() * State.Attitude.cast<double>()).vec(),
+			State.Vb.cast<double>(), State.Omegab.cast<double>();
+		return Result;
+	}
+
+	// Central differences of the state after a step of the vehicle, with respect to a change (of size h) made by Perturb.
+	FState CalculateFiniteDifference(const FVehicle& Vehicle, float DeltaTime, const FQuaterniond& Reference, float h,
+		const std::function<void(FVehicle&, float)>& Perturb)
+	{
+		FVehicle Plus = Vehicle;
+		FVehicle Minus = Vehicle;
+		Perturb(Plus, h);
+		Perturb(Minus, -h);
+		Plus.Step(DeltaTime);
+		Minus.Step(DeltaTime);
+		return (GetState(Plus.RigidBodyState, Reference) - GetState(Minus.RigidBodyState, Reference)) / (2.0 * h);
+	}
+
+	void CheckColumn(const Eigen::MatrixXd& Jacobian, int Column, const FState& Expected)
+	{
+		SKYPHYS_CHECK((Jacobian.col(Column) - Expected).cwiseAbs().maxCoeff() < 1.e-2 * (1.0 + Expected.cwiseAbs().maxCoeff()));
+	}
+}
+
+SKYPHYS_TEST(Sensitivity, MatchesFiniteDifferencesOfStep)
+{
+	const FVehicle Vehicle = MakeFixedWing();
+	const float DeltaTime = 0.01f;
+
+	FSensitivityParameters Parameters;
+	Parameters.bMassProperties = true;
+	const FStepSensitivity Sensitivity = CalculateStepSensitivity(Vehicle, DeltaTime, Parameters);
+
+	// The double precision step matches the float one
+	FVehicle Stepped = Vehicle;
+	Stepped.Step(DeltaTime);
+	const FQuaterniond& Reference = Sensitivity.NextState.Attitude;
+	const FState Next = GetState(Stepped.RigidBodyState, Reference);
+	SKYPHYS_CHECK(Next.head<3>().isApprox(Sensitivity.NextState.Position, 1.e-5));
+	SKYPHYS_CHECK(Next.segment<3>(3).norm() < 1.e-5);
+	SKYPHYS_CHECK(Next.segment<3>(6).isApprox(Sensitivity.NextState.Vb, 1.e-5));
+	SKYPHYS_CHECK(Next.tail<3>().isApprox(Sensitivity.NextState.Omegab, 1.e-4));
+
+	// States (position, attitude as a body frame rotation vector, velocity and body rates)
+	for (int i = 0; i < FStepSensitivity::NumStates; i++)
+	{
+		CheckColumn(Sensitivity.StateJacobian, i, CalculateFiniteDifference(Vehicle, DeltaTime, Reference, 1.e-2f, [i](FVehicle& Perturbed, float h)
+			{
+				FRigidBodyState& State = Perturbed.RigidBodyState;
+				const int Axis = i % 3;
+				switch (i / 3)
+				{
+				case 0: State.Position(Axis) += h; break;
+				case 1: State.Attitude = State.Attitude * FQuaternion(Eigen::AngleAxisf(h, FVector3::Unit(Axis))); break;
+				case 2: State.Vb(Axis) += h; break;
+				default: State.Omegab(Axis) += h; break;
+				}
+			}));
+	}
+
+	// Inputs, through the feedthrough actuators (de, da and dr in rad, then the propeller speed in rad/s)
+	for (int i = 0; i < 3; i++)
+	{
+		CheckColumn(Sensitivity.InputJacobian, i, CalculateFiniteDifference(Vehicle, DeltaTime, Reference, 1.e-2f, [i](FVehicle& Perturbed, float h)
+			{
+				FControlSurface* Surfaces[] = { &Perturbed.Elevator, &Perturbed.Aileron, &Perturbed.Rudder };
+				Surfaces[i]->Command += h / Surfaces[i]->Actuator.GetParameters().DCGain;
+			}));
+	}
+	CheckColumn(Sensitivity.InputJacobian, 3, CalculateFiniteDifference(Vehicle, DeltaTime, Reference, 2.0f, [](FVehicle& Perturbed, float h)
+		{
+			FPropulsor& Propulsor = Perturbed.Propulsors[0];
+			Propulsor.Command += h * 60.0f / (2.0f * Pi) / Propulsor.Motor.GetParameters().DCGain;
+		}));
+
+	// Parameters (the mass and then the inertias)
+	for (int i = 0; i < 5; i++)
+	{
+		CheckColumn(Sensitivity.ParameterJacobian, i, CalculateFiniteDifference(Vehicle, DeltaTime, Reference, i == 0 ? 1.e-2f : 1.e-3f, [i](FVehicle& Perturbed, float h)
+			{
+				FMassProperties& MassProperties = Perturbed.RigidBodyModel.MassProperties;
+				float* Values[] = { &MassProperties.Mass, &MassProperties.Ixx, &MassProperties.Iyy, &MassProperties.Izz, &MassProperties.Ixz };
+				*Values[i] += h;
+				MassProperties.PreCalculate();
+			}));
+	}
+}
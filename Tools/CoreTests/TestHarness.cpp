@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// Runs every test of the suites named on the command line (or all of them), and fails (non-zero exit code) if any check failed.
+
+#include "TestHarness.h"
+
+#include <cstring>
+
+namespace SkyPhysCoreTests
+{
+	namespace
+	{
+		int NumFailures = 0;
+	}
+
+	std::vector<FTestCase>& GetTestCases()
+	{
+		static std::vector<FTestCase> TestCases;
+		return TestCases;
+	}
+
+	void ReportFailure(const char* File, int Line, const std::string& Message)
+	{
+		std::printf("  %s(%d): %s\n", File, Line, Message.c_str());
+		NumFailures++;
+	}
+}
+
+int main(int NumArguments, char** Arguments)
+{
+	using namespace SkyPhysCoreTests;
+
+	int NumRun = 0;
+	int NumFailed = 0;
+	for (const FTestCase& TestCase : GetTestCases())
+	{
+		bool bSelected = NumArguments <= 1;
+		for (int i = 1; i < NumArguments; i++)
+		{
+			bSelected |= std::strcmp(Arguments[i], TestCase.Suite) == 0;
+		}
+		if (!bSelected)
+		{
+			continue;
+		}
+
+		std::printf("%s.%s\n", TestCase.Suite, TestCase.Name);
+		const int NumFailuresBefore = NumFailures;
+		TestCase.Function();
+		NumRun++;
+		NumFailed += NumFailures > NumFailuresBefore ? 1 : 0;
+	}
+
+	std::printf("%d tests, %d failed\n", NumRun, NumFailed);
+	return NumRun > 0 && NumFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// A minimal test harness for the SkyPhysCore behaviour checks (the core has no dependencies beyond Eigen, so neither do its tests).
+// Each test belongs to a suite, which ctest runs as its own test (see CMakeLists.txt).
+namespace SkyPhysCoreTests
+{
+	struct FTestCase
+	{
+		const char* Suite;
+		const char* Name;
+		void (*Function)();
+	};
+
+	std::vector<FTestCase>& GetTestCases();
+
+	// Record a failed check of the running test.
+	void ReportFailure(const char* File, int Line, const std::string& Message);
+
+	struct FRegisterTest
+	{
+		FRegisterTest(const char* Suite, const char* Name, void (*Function)()) { GetTestCases().push_back({ Suite, Name, Function }); };
+	};
+}
+
+#define SKYPHYS_TEST(Suite, Name) \
+	static void Suite##_##Name(); \
+	static const SkyPhysCoreTests::FRegisterTest Suite##_##Name##_Registration(#Suite, #Name, &Suite##_##Name); \
+	static void Suite##_##Name()
+
+#define SKYPHYS_CHECK(Condition) \
+	do { if (!(Condition)) { SkyPhysCoreTests::ReportFailure(__FILE__, __LINE__, #Condition); } } while (0)
+
+// Check that two values are within Tolerance of each other
+#define SKYPHYS_CHECK_NEAR(A, B, Tolerance) \
+	do \
+	{ \
+		const double CheckA = static_cast<double>(A); \
+		const double CheckB = static_cast<double>(B); \
+		if (!(std::fabs(CheckA - CheckB) <= static_cast<double>(Tolerance))) \
+		{ \
+			char CheckMessage[256]; \
+			std::snprintf(CheckMessage, sizeof(CheckMessage), "%s (%.9g) is not within %g of %s (%.9g)", #A, CheckA, static_cast<double>(Tolerance), #B, CheckB); \
+			SkyPhysCoreTests::ReportFailure(__FILE__, __LINE__, CheckMessage); \
+		} \
+	} while (0)
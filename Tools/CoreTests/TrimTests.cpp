@@ -0,0 +1,216 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// Trim and linearisation.
+
+#include "TestHarness.h"
+
+#include "SkyPhysCore/Simulation/Trim.h"
+#include "SkyPhysCore/Simulation/Vehicle.h"
+
+using namespace SkyPhysCore;
+
+namespace
+{
+	FPropellerParameters MakePropellerParameters()
+	{
+		FPropellerParameters Parameters;
+		Parameters.D = 0.25f;
+		Parameters.Izz = 1.e-4f;
+
+		FConstantSpeedPropellerData Low;
+		Low.n = 4000.0f;
+		Low.J = { 0.0f, 0.4f, 0.8f, 1.2f };
+		Low.CT = { 0.12f, 0.1f, 0.05f, -0.02f };
+		Low.CP = { 0.05f, 0.05f, 0.035f, 0.01f };
+
+		FConstantSpeedPropellerData High = Low;
+		High.n = 9000.0f;
+		High.CT = { 0.13f, 0.11f, 0.06f, -0.01f };
+		High.CP = { 0.055f, 0.052f, 0.04f, 0.015f };
+
+		Parameters.ConstantSpeedData = { Low, High };
+		return Parameters;
+	}
+
+	FVehicle MakeQuadcopter()
+	{
+		FVehicle Vehicle;
+		FMassProperties& MassProperties = Vehicle.RigidBodyModel.MassProperties;
+		MassProperties.Mass = 1.0f;
+		MassProperties.Ixx = 0.01f;
+		MassProperties.Iyy = 0.01f;
+		MassProperties.Izz = 0.02f;
+		MassProperties.PreCalculate();
+
+		Vehicle.AirframeModel.Configuration = EAirframeConfiguration::MultiRotor;
+		Vehicle.AirframeModel.Geometry.A = FVector3(0.05f, 0.05f, 0.1f);
+		Vehicle.AirframeModel.Coefficients.CD.CD0 = 0.5f;
+
+		FPropellerParameters PropellerParameters = MakePropellerParameters();
+		for (int i = 0; i < 4; i++)
+		{
+			FActuatorParameters MotorParameters;
+			MotorParameters.DCGain = 10000.0f;
+
+			FPropulsor Propulsor;
+			Propulsor.Propeller = FPropellerModel(PropellerParameters);
+			Propulsor.Motor = FActuatorModel(MotorParameters);
+			Propulsor.Geometry.Position = FVector3(i < 2 ? 0.2f : -0.2f, i % 2 ? 0.2f : -0.2f, 0.0f);
+			Vehicle.Propulsors.push_back(Propulsor);
+
+			PropellerParameters.RotationDirection *= -1.0f;
+		}
+		return Vehicle;
+	}
+
+	FVehicle MakeFixedWing()
+	{
+		FVehicle Vehicle;
+		FMassProperties& MassProperties = Vehicle.RigidBodyModel.MassProperties;
+		MassProperties.Mass = 2.0f;
+		MassProperties.Ixx = 0.1f;
+		MassProperties.Iyy = 0.2f;
+		MassProperties.Izz = 0.3f;
+		MassProperties.Ixz = 0.01f;
+		MassProperties.PreCalculate();
+
+		FAirframeModel& Airframe = Vehicle.AirframeModel;
+		Airframe.Geometry.b = 1.5f;
+		Airframe.Geometry.c = 0.2f;
+		Airframe.Geometry.A = FVector3(0.3f, 0.3f, 0.3f);
+		Airframe.Coefficients.CL.CL0 = 0.2f;
+		Airframe.Coefficients.CL.CLAlpha = 4.5f;
+		Airframe.Coefficients.CL.CLq = 3.0f;
+		Airframe.Coefficients.CD.CD0 = 0.03f;
+		Airframe.Coefficients.CD.CDAlpha2 = 0.5f;
+		Airframe.Coefficients.CY.CYBeta = -0.3f;
+		Airframe.Coefficients.CI.CIp = -0.5f;
+		Airframe.Coefficients.CI.CIBeta = -0.05f;
+		Airframe.Coefficients.Cm.Cm0 = 0.02f;
+		Airframe.Coefficients.Cm.CmAlpha = -0.8f;
+		Airframe.Coefficients.Cm.Cmq = -10.0f;
+		Airframe.Coefficients.Cn.CnBeta = 0.1f;
+		Airframe.Coefficients.Cn.Cnr = -0.1f;
+		Airframe.ControlDerivatives.Cmde = -0.5f;
+		Airframe.ControlDerivatives.CLde = 0.3f;
+		Airframe.ControlDerivatives.CIda = 0.2f;
+		Airframe.ControlDerivatives.Cndr = -0.06f;
+
+		FActuatorParameters ServoParameters;
+		ServoParameters.DCGain = 0.4f;
+		Vehicle.Elevator.Actuator = FActuatorModel(ServoParameters);
+		Vehicle.Aileron.Actuator = FActuatorModel(ServoParameters);
+		Vehicle.Rudder.Actuator = FActuatorModel(ServoParameters);
+
+		FActuatorParameters MotorParameters;
+		MotorParameters.DCGain = 10000.0f;
+
+		FPropulsor Propulsor;
+		Propulsor.Propeller = FPropellerModel(MakePropellerParameters());
+		Propulsor.Motor = FActuatorModel(MotorParameters);
+		Propulsor.Geometry.Position = FVector3(0.3f, 0.0f, 0.05f);
+		Propulsor.Geometry.Rotation = Eigen::AngleAxisf(-0.5f * Pi, FVector3::UnitY()).toRotationMatrix(); // Thrust (-Z) forwards
+		Vehicle.Propulsors.push_back(Propulsor);
+		return Vehicle;
+	}
+
+	// The largest difference between the analytic A and B matrices and central differences of the derivative.
+	void CheckJacobians(const FTrimModel& Model, const Eigen::VectorXf& X, const Eigen::VectorXf& U, float Rho)
+	{
+		Eigen::VectorXf XDot;
+		Eigen::MatrixXf A, B;
+		Model.CalculateDerivative(X, U, Rho, XDot, &A, &B);
+
+		for (int i = 0; i < X.size(); i++)
+		{
+			const float h = 1.e-3f;
+			Eigen::VectorXf XPlus = X, XMinus = X, XDotPlus, XDotMinus;
+			XPlus(i) += h;
+			XMinus(i) -= h;
+			Model.CalculateDerivative(XPlus, U, Rho, XDotPlus);
+			Model.CalculateDerivative(XMinus, U, Rho, XDotMinus);
+			const Eigen::VectorXf Column = (XDotPlus - XDotMinus) / (2.0f * h);
+			SKYPHYS_CHECK((A.col(i) - Column).cwiseAbs().maxCoeff() < 1.e-2f * (1.0f + Column.cwiseAbs().maxCoeff()));
+		}
+
+		for (int i = 0; i < U.size(); i++)
+		{
+			const float h = i < FLinearModel::FirstPropulsor ? 1.e-3f : 1.0f;
+			Eigen::VectorXf UPlus = U, UMinus = U, XDotPlus, XDotMinus;
+			UPlus(i) += h;
+			UMinus(i) -= h;
+			Model.CalculateDerivative(X, UPlus, Rho, XDotPlus);
+			Model.CalculateDerivative(X, UMinus, Rho, XDotMinus);
+			const Eigen::VectorXf Column = (XDotPlus - XDotMinus) / (2.0f * h);
+			SKYPHYS_CHECK((B.col(i) - Column).cwiseAbs().maxCoeff() < 1.e-2f * (1.0f + Column.cwiseAbs().maxCoeff()));
+		}
+	}
+}
+
+SKYPHYS_TEST(Trim, QuadcopterHover)
+{
+	const FVehicle Vehicle = MakeQuadcopter();
+	const FTrimModel Model(Vehicle);
+
+	const FTrimResult Result = Model.Trim(FTrimCondition());
+	SKYPHYS_CHECK(Result.bConverged);
+	SKYPHYS_CHECK(Result.PropulsorSpeeds.size() == 4);
+
+	// Level, with the four (symmetric) propellers sharing the weight: 4 * CT * rho * n^2 * D^4 = m * g
+	SKYPHYS_CHECK(std::fabs(Result.State.Attitude.vec().norm()) < 1.e-3f);
+	const float n = Result.PropulsorSpeeds[0] / (2.0f * Pi);
+	const float CT = Vehicle.Propulsors[0].Propeller.GetAerodynamicConstants(RadPerSToRPM(Result.PropulsorSpeeds[0]), 0.0f).CT;
+	SKYPHYS_CHECK_NEAR(4.0f * CT * 1.225f * n * n * std::pow(0.25f, 4.0f), 9.81f, 1.e-2f);
+
+	// Stepping the trimmed vehicle holds it there
+	FVehicle Flown = Vehicle;
+	Flown.RigidBodyState = Result.State;
+	for (int i = 0; i < 4; i++)
+	{
+		Flown.SetPropulsorCommand(i, RadPerSToRPM(Result.PropulsorSpeeds[i]) / 10000.0f);
+	}
+	for (int i = 0; i < 500; i++)
+	{
+		Flown.Step(0.002f);
+	}
+	SKYPHYS_CHECK(Flown.RigidBodyState.Vb.norm() < 1.e-2f);
+	SKYPHYS_CHECK(Flown.RigidBodyState.Omegab.norm() < 1.e-2f);
+}
+
+SKYPHYS_TEST(Trim, FixedWingCruise)
+{
+	const FVehicle Vehicle = MakeFixedWing();
+	const FTrimModel Model(Vehicle);
+
+	FTrimCondition Condition;
+	Condition.Airspeed = 16.0f;
+	Condition.FlightPathAngle = 0.05f;
+	const FTrimResult Result = Model.Trim(Condition);
+	SKYPHYS_CHECK(Result.bConverged);
+	SKYPHYS_CHECK(Result.Residual <= FTrimSettings().Tolerance);
+	SKYPHYS_CHECK_NEAR(Result.State.Vb.norm(), 16.0f, 1.e-3f);
+	SKYPHYS_CHECK(Result.alpha > 0.0f && Result.alpha < 0.3f);
+
+	// The derivative at the trim point is 0 in everything but position
+	Eigen::VectorXf XDot;
+	Model.CalculateDerivative(Result.LinearModel.X0, Result.LinearModel.U0, Condition.Rho, XDot);
+	SKYPHYS_CHECK(XDot.head<FLinearModel::North>().cwiseAbs().maxCoeff() < 1.e-3f);
+	SKYPHYS_CHECK_NEAR(-XDot(FLinearModel::Down), 16.0f * std::sin(0.05f), 1.e-3f);
+}
+
+SKYPHYS_TEST(Trim, JacobiansMatchFiniteDifferences)
+{
+	const FTrimModel FixedWing(MakeFixedWing());
+	Eigen::VectorXf X(FLinearModel::NumStates);
+	X << 15.0f, 0.8f, 1.5f, 0.2f, 0.1f, -0.15f, 0.1f, 0.08f, 0.3f, 0.0f, 0.0f, -50.0f;
+	Eigen::VectorXf U(FixedWing.NumInputs());
+	U << 0.05f, -0.02f, 0.03f, 600.0f;
+	CheckJacobians(FixedWing, X, U, 1.2f);
+
+	const FTrimModel Quadcopter(MakeQuadcopter());
+	Eigen::VectorXf XQuad(FLinearModel::NumStates);
+	XQuad << 2.0f, -1.0f, 0.5f, 0.1f, -0.2f, 0.05f, 0.05f, -0.1f, 0.0f, 0.0f, 0.0f, -20.0f;
+	Eigen::VectorXf UQuad(Quadcopter.NumInputs());
+	UQuad << 0.0f, 0.0f, 0.0f, 500.0f, 520.0f, 480.0f, 510.0f;
+	CheckJacobians(Quadcopter, XQuad, UQuad, 1.225f);
+}
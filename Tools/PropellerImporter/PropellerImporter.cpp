@@ -0,0 +1,325 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// Cooks propeller performance data, as published by the UIUC propeller database (https://m-selig.ae.illinois.edu/props/propDB.html),
+// into a SkyPhysCore propeller database file, which is memory mapped at runtime (see FPropellerDatabase).
+//
+// Usage: SkyPhysPropellerImporter <Output.skyprop> <Input>...
+//
+// Each input is a data file, or a directory of them (not recursive). Data files are text (.txt, whitespace separated, as per UIUC) or
+// CSV (.csv), with any header lines, and are named as per UIUC:
+// - <Propeller>_static_<Test>.txt: Static data (J = 0), with columns RPM, CT, CP.
+// - <Propeller>_<Test>_<RPM>.txt: Data for a propeller speed, with columns J, CT, CP (and optionally eta, which is ignored).
+// - <Propeller>_geom.txt: Geometry, which is skipped.
+// All files of the same propeller name are combined into one entry of the database. Where the data for a propeller speed doesn't start
+// at J = 0, the static data (interpolated to that speed) is added at J = 0, and a propeller with only static data has a single J of 0.
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "SkyPhysCore/Actuation/PropellerDatabase.h"
+
+using namespace SkyPhysCore;
+
+namespace
+{
+	// All of the data files of one propeller.
+	struct FPropellerFiles
+	{
+		// Static data rows (RPM, CT, CP)
+		std::vector<std::vector<float>> StaticRows;
+
+		// Data rows (J, CT, CP) for each propeller speed (RPM)
+		std::map<float, std::vector<std::vector<float>>> SpeedRows;
+	};
+
+	std::string ToLower(std::string String)
+	{
+		std::transform(String.begin(), String.end(), String.begin(), [](unsigned char Character) { return static_cast<char>(std::tolower(Character)); });
+		return String;
+	}
+
+	bool IsInteger(const std::string& String)
+	{
+		return !String.empty() && std::all_of(String.begin(), String.end(), [](unsigned char Character) { return std::isdigit(Character) != 0; });
+	}
+
+	// Read the rows of numbers of a data file, skipping any which don't start with a number (ie. headers), or have fewer than 3 columns.
+	bool ReadRows(const std::filesystem::path& Path, std::vector<std::vector<float>>& Rows)
+	{
+		std::ifstream Stream(Path);
+		if (!Stream)
+		{
+			return false;
+		}
+
+		std::string Line;
+		while (std::getline(Stream, Line))
+		{
+			std::replace_if(Line.begin(), Line.end(), [](char Character) { return Character == ',' || Character == ';' || Character == '\t' || Character == '\r'; }, ' ');
+
+			std::istringstream LineStream(Line);
+			std::vector<float> Row;
+			std::string Token;
+			while (LineStream >> Token)
+			{
+				char* End = nullptr;
+				const float Value = std::strtof(Token.c_str(), &End);
+				if (End == Token.c_str() || *End != '\0')
+				{
+					break;
+				}
+				Row.push_back(Value);
+			}
+
+			if (Row.size() >= 3)
+			{
+				Rows.push_back(Row);
+			}
+		}
+		return true;
+	}
+
+	// Add a data file to the propeller it belongs to (by its name).
+	bool AddFile(const std::filesystem::path& Path, std::map<std::string, FPropellerFiles>& Propellers)
+	{
+		const std::string Extension = ToLower(Path.extension().string());
+		if (Extension != ".txt" && Extension != ".csv")
+		{
+			return true;
+		}
+
+		// Split the name into its parts, eg. apcsp_7x9_kt0995_4014 or apcsp_7x9_static_kt0995.
+		std::vector<std::string> Parts;
+		std::istringstream NameStream(Path.stem().string());
+		std::string Part;
+		while (std::getline(NameStream, Part, '_'))
+		{
+			Parts.push_back(Part);
+		}
+
+		auto JoinParts = [&Parts](size_t NumParts)
+		{
+			std::string Name;
+			for (size_t i = 0; i < NumParts; i++)
+			{
+				Name += (i > 0 ? "_" : "") + Parts[i];
+			}
+			return Name;
+		};
+
+		const auto StaticPart = std::find_if(Parts.begin(), Parts.end(), [](const std::string& Part) { return ToLower(Part) == "static"; });
+		const bool bGeometry = std::any_of(Parts.begin(), Parts.end(), [](const std::string& Part) { return ToLower(Part) == "geom"; });
+		if (bGeometry)
+		{
+			return true;
+		}
+
+		std::vector<std::vector<float>> Rows;
+		if (!ReadRows(Path, Rows))
+		{
+			std::printf("Couldn't read %s\n", Path.string().c_str());
+			return false;
+		}
+
+		if (StaticPart != Parts.end() && StaticPart != Parts.begin())
+		{
+			FPropellerFiles& Propeller = Propellers[JoinParts(StaticPart - Parts.begin())];
+			Propeller.StaticRows.insert(Propeller.StaticRows.end(), Rows.begin(), Rows.end());
+			return true;
+		}
+
+		if (Parts.size() >= 2 && IsInteger(Parts.back()))
+		{
+			// The test name (if any) comes between the propeller name and the speed.
+			const float n = std::strtof(Parts.back().c_str(), nullptr);
+			FPropellerFiles& Propeller = Propellers[JoinParts(Parts.size() >= 3 ? Parts.size() - 2 : 1)];
+			if (Propeller.SpeedRows.count(n))
+			{
+				std::printf("Skipping %s, as there's already data for this propeller at %.0f RPM\n", Path.string().c_str(), n);
+				return true;
+			}
+			Propeller.SpeedRows[n] = Rows;
+			return true;
+		}
+
+		std::printf("Skipping %s, as its name isn't a UIUC data file name\n", Path.string().c_str());
+		return true;
+	}
+
+	// The static CT and CP at a propeller speed (interpolated linearly, and clamped to the data).
+	FAerodynamicConstantResults InterpolateStatic(const std::vector<std::vector<float>>& StaticRows, float n)
+	{
+		const auto Upper = std::upper_bound(StaticRows.begin(), StaticRows.end(), n, [](float Value, const std::vector<float>& Row) { return Value < Row[0]; });
+		if (Upper == StaticRows.begin())
+		{
+			return FAerodynamicConstantResults(StaticRows.front()[1], StaticRows.front()[2]);
+		}
+		if (Upper == StaticRows.end())
+		{
+			return FAerodynamicConstantResults(StaticRows.back()[1], StaticRows.back()[2]);
+		}
+
+		const std::vector<float>& Row1 = *(Upper - 1);
+		const std::vector<float>& Row2 = *Upper;
+		const float Frac = Row2[0] > Row1[0] ? (n - Row1[0]) / (Row2[0] - Row1[0]) : 0.0f;
+		return FAerodynamicConstantResults(Row1[1] + Frac * (Row2[1] - Row1[1]), Row1[2] + Frac * (Row2[2] - Row1[2]));
+	}
+
+	// Combine the data files of a propeller into the data of each propeller speed.
+	std::vector<FConstantSpeedPropellerData> MakeConstantSpeedData(FPropellerFiles& Files)
+	{
+		auto ByFirstColumn = [](const std::vector<float>& A, const std::vector<float>& B) { return A[0] < B[0]; };
+		std::sort(Files.StaticRows.begin(), Files.StaticRows.end(), ByFirstColumn);
+
+		std::vector<FConstantSpeedPropellerData> ConstantSpeedData;
+
+		if (Files.SpeedRows.empty())
+		{
+			for (const std::vector<float>& Row : Files.StaticRows)
+			{
+				if (!ConstantSpeedData.empty() && ConstantSpeedData.back().n == Row[0])
+				{
+					continue;
+				}
+
+				FConstantSpeedPropellerData Data;
+				Data.n = Row[0];
+				Data.J = { 0.0f };
+				Data.CT = { Row[1] };
+				Data.CP = { Row[2] };
+				ConstantSpeedData.push_back(Data);
+			}
+			return ConstantSpeedData;
+		}
+
+		// The map is already sorted by speed.
+		for (std::pair<const float, std::vector<std::vector<float>>>& Speed : Files.SpeedRows)
+		{
+			std::vector<std::vector<float>>& Rows = Speed.second;
+			std::sort(Rows.begin(), Rows.end(), ByFirstColumn);
+
+			FConstantSpeedPropellerData Data;
+			Data.n = Speed.first;
+			if (!Files.StaticRows.empty() && (Rows.empty() || Rows.front()[0] > 0.0f))
+			{
+				const FAerodynamicConstantResults Static = InterpolateStatic(Files.StaticRows, Data.n);
+				Data.J.push_back(0.0f);
+				Data.CT.push_back(Static.CT);
+				Data.CP.push_back(Static.CP);
+			}
+			for (const std::vector<float>& Row : Rows)
+			{
+				Data.J.push_back(Row[0]);
+				Data.CT.push_back(Row[1]);
+				Data.CP.push_back(Row[2]);
+			}
+			ConstantSpeedData.push_back(Data);
+		}
+		return ConstantSpeedData;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		std::printf("Usage: SkyPhysPropellerImporter <Output.skyprop> <Input>...\n");
+		return 1;
+	}
+
+	// Group the data files by propeller.
+	std::map<std::string, FPropellerFiles> PropellerFiles;
+	for (int i = 2; i < argc; i++)
+	{
+		const std::filesystem::path Input(argv[i]);
+
+		std::vector<std::filesystem::path> Files;
+		std::error_code Error;
+		if (std::filesystem::is_directory(Input, Error))
+		{
+			for (const std::filesystem::directory_entry& Entry : std::filesystem::directory_iterator(Input, Error))
+			{
+				if (Entry.is_regular_file())
+				{
+					Files.push_back(Entry.path());
+				}
+			}
+			// Directory order isn't defined, so sort the files to keep which duplicates are skipped the same.
+			std::sort(Files.begin(), Files.end());
+		}
+		else
+		{
+			Files.push_back(Input);
+		}
+
+		for (const std::filesystem::path& File : Files)
+		{
+			if (!AddFile(File, PropellerFiles))
+			{
+				return 1;
+			}
+		}
+	}
+
+	// Resample each propeller's data into its table.
+	std::vector<std::pair<std::string, FPropellerTable>> Propellers;
+	for (std::pair<const std::string, FPropellerFiles>& Files : PropellerFiles)
+	{
+		const std::vector<FConstantSpeedPropellerData> ConstantSpeedData = MakeConstantSpeedData(Files.second);
+		if (ConstantSpeedData.empty())
+		{
+			std::printf("Skipping %s, as it has no data\n", Files.first.c_str());
+			continue;
+		}
+		if (Files.first.size() > FPropellerDatabaseEntry::MaxNameLength)
+		{
+			std::printf("Skipping %s, as its name is longer than %d characters\n", Files.first.c_str(), FPropellerDatabaseEntry::MaxNameLength);
+			continue;
+		}
+
+		Propellers.emplace_back(Files.first, FPropellerTable(ConstantSpeedData));
+
+		const FPropellerTable& Table = Propellers.back().second;
+		std::printf("%-32s %3d speeds (%5.0f - %5.0f RPM), J %.2f - %.2f, grid %3d x %3d\n", Files.first.c_str(), static_cast<int>(ConstantSpeedData.size()),
+			Table.GetNAxis().Min, Table.GetNAxis().Max, Table.GetJAxis().Min, Table.GetJAxis().Max, Table.GetNumN(), Table.GetNumJ());
+	}
+
+	const std::string OutputPath = argv[1];
+	if (!FPropellerDatabase::Write(OutputPath, Propellers))
+	{
+		std::printf("Couldn't write %s\n", OutputPath.c_str());
+		return 1;
+	}
+
+	// Check that the database reads back as written.
+	const std::shared_ptr<const FPropellerDatabase> Database = FPropellerDatabase::Open(OutputPath);
+	if (!Database || Database->GetNumPropellers() != static_cast<int>(Propellers.size()))
+	{
+		std::printf("Couldn't read back %s\n", OutputPath.c_str());
+		return 1;
+	}
+	for (const std::pair<std::string, FPropellerTable>& Propeller : Propellers)
+	{
+		const std::shared_ptr<const FPropellerTable> Table = Database->FindTable(Propeller.first);
+		const size_t NumBytes = static_cast<size_t>(Propeller.second.GetNumN()) * Propeller.second.GetNumJ() * 2 * sizeof(float);
+		if (!Table || Table->GetNumN() != Propeller.second.GetNumN() || Table->GetNumJ() != Propeller.second.GetNumJ()
+			|| std::memcmp(Table->GetCoefficients(), Propeller.second.GetCoefficients(), NumBytes) != 0)
+		{
+			std::printf("%s doesn't read back from %s as written\n", Propeller.first.c_str(), OutputPath.c_str());
+			return 1;
+		}
+	}
+
+	std::printf("Wrote %d propellers to %s (%llu bytes)\n", Database->GetNumPropellers(), OutputPath.c_str(),
+		static_cast<unsigned long long>(std::filesystem::file_size(OutputPath)));
+	return 0;
+}